@@ -62,7 +62,7 @@ AS       := E:/MinGW/bin/as.exe
 ## User defined environment variables
 ##
 CodeLiteDir:=E:\Program Files\CodeLite
-Objects0=$(IntermediateDirectory)/src_series.c$(ObjectSuffix) $(IntermediateDirectory)/src_film.c$(ObjectSuffix) $(IntermediateDirectory)/src_view.c$(ObjectSuffix) $(IntermediateDirectory)/src_favorite.c$(ObjectSuffix) $(IntermediateDirectory)/src_user.c$(ObjectSuffix) 
+Objects0=$(IntermediateDirectory)/src_series.c$(ObjectSuffix) $(IntermediateDirectory)/src_film.c$(ObjectSuffix) $(IntermediateDirectory)/src_view.c$(ObjectSuffix) $(IntermediateDirectory)/src_favorite.c$(ObjectSuffix) $(IntermediateDirectory)/src_user.c$(ObjectSuffix) $(IntermediateDirectory)/src_hash.c$(ObjectSuffix) $(IntermediateDirectory)/src_table.c$(ObjectSuffix) $(IntermediateDirectory)/src_intern.c$(ObjectSuffix) $(IntermediateDirectory)/src_loader.c$(ObjectSuffix) $(IntermediateDirectory)/src_snapshot.c$(ObjectSuffix) $(IntermediateDirectory)/src_journal.c$(ObjectSuffix) $(IntermediateDirectory)/src_sync.c$(ObjectSuffix) $(IntermediateDirectory)/src_shardlog.c$(ObjectSuffix) $(IntermediateDirectory)/src_report.c$(ObjectSuffix) $(IntermediateDirectory)/src_topk.c$(ObjectSuffix) $(IntermediateDirectory)/src_mem.c$(ObjectSuffix) $(IntermediateDirectory)/src_trace.c$(ObjectSuffix) $(IntermediateDirectory)/src_arena.c$(ObjectSuffix) $(IntermediateDirectory)/src_recommend.c$(ObjectSuffix) $(IntermediateDirectory)/src_ingest.c$(ObjectSuffix) $(IntermediateDirectory)/src_segment.c$(ObjectSuffix) 
 
 
 
@@ -136,6 +136,134 @@ $(IntermediateDirectory)/src_user.c$(PreprocessSuffix): src/user.c
 	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_user.c$(PreprocessSuffix) src/user.c
 
 
+$(IntermediateDirectory)/src_hash.c$(ObjectSuffix): src/hash.c $(IntermediateDirectory)/src_hash.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/hash.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_hash.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_hash.c$(DependSuffix): src/hash.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_hash.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_hash.c$(DependSuffix) -MM src/hash.c
+
+$(IntermediateDirectory)/src_hash.c$(PreprocessSuffix): src/hash.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_hash.c$(PreprocessSuffix) src/hash.c
+
+$(IntermediateDirectory)/src_table.c$(ObjectSuffix): src/table.c $(IntermediateDirectory)/src_table.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/table.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_table.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_table.c$(DependSuffix): src/table.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_table.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_table.c$(DependSuffix) -MM src/table.c
+
+$(IntermediateDirectory)/src_table.c$(PreprocessSuffix): src/table.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_table.c$(PreprocessSuffix) src/table.c
+
+$(IntermediateDirectory)/src_intern.c$(ObjectSuffix): src/intern.c $(IntermediateDirectory)/src_intern.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/intern.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_intern.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_intern.c$(DependSuffix): src/intern.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_intern.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_intern.c$(DependSuffix) -MM src/intern.c
+
+$(IntermediateDirectory)/src_intern.c$(PreprocessSuffix): src/intern.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_intern.c$(PreprocessSuffix) src/intern.c
+
+$(IntermediateDirectory)/src_loader.c$(ObjectSuffix): src/loader.c $(IntermediateDirectory)/src_loader.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/loader.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_loader.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_loader.c$(DependSuffix): src/loader.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_loader.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_loader.c$(DependSuffix) -MM src/loader.c
+
+$(IntermediateDirectory)/src_loader.c$(PreprocessSuffix): src/loader.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_loader.c$(PreprocessSuffix) src/loader.c
+
+$(IntermediateDirectory)/src_snapshot.c$(ObjectSuffix): src/snapshot.c $(IntermediateDirectory)/src_snapshot.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/snapshot.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_snapshot.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_snapshot.c$(DependSuffix): src/snapshot.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_snapshot.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_snapshot.c$(DependSuffix) -MM src/snapshot.c
+
+$(IntermediateDirectory)/src_snapshot.c$(PreprocessSuffix): src/snapshot.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_snapshot.c$(PreprocessSuffix) src/snapshot.c
+
+$(IntermediateDirectory)/src_journal.c$(ObjectSuffix): src/journal.c $(IntermediateDirectory)/src_journal.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/journal.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_journal.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_journal.c$(DependSuffix): src/journal.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_journal.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_journal.c$(DependSuffix) -MM src/journal.c
+
+$(IntermediateDirectory)/src_journal.c$(PreprocessSuffix): src/journal.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_journal.c$(PreprocessSuffix) src/journal.c
+
+$(IntermediateDirectory)/src_sync.c$(ObjectSuffix): src/sync.c $(IntermediateDirectory)/src_sync.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/sync.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_sync.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_sync.c$(DependSuffix): src/sync.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_sync.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_sync.c$(DependSuffix) -MM src/sync.c
+
+$(IntermediateDirectory)/src_sync.c$(PreprocessSuffix): src/sync.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_sync.c$(PreprocessSuffix) src/sync.c
+
+$(IntermediateDirectory)/src_shardlog.c$(ObjectSuffix): src/shardlog.c $(IntermediateDirectory)/src_shardlog.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/shardlog.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_shardlog.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_shardlog.c$(DependSuffix): src/shardlog.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_shardlog.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_shardlog.c$(DependSuffix) -MM src/shardlog.c
+
+$(IntermediateDirectory)/src_shardlog.c$(PreprocessSuffix): src/shardlog.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_shardlog.c$(PreprocessSuffix) src/shardlog.c
+
+$(IntermediateDirectory)/src_report.c$(ObjectSuffix): src/report.c $(IntermediateDirectory)/src_report.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/report.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_report.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_report.c$(DependSuffix): src/report.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_report.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_report.c$(DependSuffix) -MM src/report.c
+
+$(IntermediateDirectory)/src_report.c$(PreprocessSuffix): src/report.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_report.c$(PreprocessSuffix) src/report.c
+
+$(IntermediateDirectory)/src_topk.c$(ObjectSuffix): src/topk.c $(IntermediateDirectory)/src_topk.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/topk.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_topk.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_topk.c$(DependSuffix): src/topk.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_topk.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_topk.c$(DependSuffix) -MM src/topk.c
+
+$(IntermediateDirectory)/src_topk.c$(PreprocessSuffix): src/topk.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_topk.c$(PreprocessSuffix) src/topk.c
+
+$(IntermediateDirectory)/src_mem.c$(ObjectSuffix): src/mem.c $(IntermediateDirectory)/src_mem.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/mem.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_mem.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_mem.c$(DependSuffix): src/mem.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_mem.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_mem.c$(DependSuffix) -MM src/mem.c
+
+$(IntermediateDirectory)/src_mem.c$(PreprocessSuffix): src/mem.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_mem.c$(PreprocessSuffix) src/mem.c
+
+$(IntermediateDirectory)/src_trace.c$(ObjectSuffix): src/trace.c $(IntermediateDirectory)/src_trace.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/trace.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_trace.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_trace.c$(DependSuffix): src/trace.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_trace.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_trace.c$(DependSuffix) -MM src/trace.c
+
+$(IntermediateDirectory)/src_trace.c$(PreprocessSuffix): src/trace.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_trace.c$(PreprocessSuffix) src/trace.c
+
+$(IntermediateDirectory)/src_arena.c$(ObjectSuffix): src/arena.c $(IntermediateDirectory)/src_arena.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/arena.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_arena.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_arena.c$(DependSuffix): src/arena.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_arena.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_arena.c$(DependSuffix) -MM src/arena.c
+
+$(IntermediateDirectory)/src_arena.c$(PreprocessSuffix): src/arena.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_arena.c$(PreprocessSuffix) src/arena.c
+
+$(IntermediateDirectory)/src_recommend.c$(ObjectSuffix): src/recommend.c $(IntermediateDirectory)/src_recommend.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/recommend.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_recommend.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_recommend.c$(DependSuffix): src/recommend.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_recommend.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_recommend.c$(DependSuffix) -MM src/recommend.c
+
+$(IntermediateDirectory)/src_recommend.c$(PreprocessSuffix): src/recommend.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_recommend.c$(PreprocessSuffix) src/recommend.c
+
+$(IntermediateDirectory)/src_ingest.c$(ObjectSuffix): src/ingest.c $(IntermediateDirectory)/src_ingest.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/ingest.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_ingest.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_ingest.c$(DependSuffix): src/ingest.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_ingest.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_ingest.c$(DependSuffix) -MM src/ingest.c
+
+$(IntermediateDirectory)/src_ingest.c$(PreprocessSuffix): src/ingest.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_ingest.c$(PreprocessSuffix) src/ingest.c
+
+$(IntermediateDirectory)/src_segment.c$(ObjectSuffix): src/segment.c $(IntermediateDirectory)/src_segment.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlix/src/segment.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_segment.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_segment.c$(DependSuffix): src/segment.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_segment.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_segment.c$(DependSuffix) -MM src/segment.c
+
+$(IntermediateDirectory)/src_segment.c$(PreprocessSuffix): src/segment.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_segment.c$(PreprocessSuffix) src/segment.c
+
 -include $(IntermediateDirectory)/*$(DependSuffix)
 ##
 ## Clean
@@ -0,0 +1,53 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+#include "mem.h"
+
+// Default size of the chunks of an arena
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+// Chunk of memory of an arena. Blocks are taken from its end
+typedef struct tArenaChunk {
+    struct tArenaChunk* next;
+    size_t capacity;
+    size_t used;
+} tArenaChunk;
+
+// Region of memory where blocks are allocated by moving a pointer, and
+// that are all released at once with the arena. Tables bound to an arena
+// allocate their elements, strings and indexes in it. The arena is used by
+// one thread at a time, and it must not be moved once initialized
+typedef struct tArena {
+    // Allocator that takes the blocks from the arena
+    tAllocator allocator;
+    // Chunks, starting with the one in use
+    tArenaChunk* chunks;
+    // Size of the new chunks
+    size_t chunkSize;
+    // Bytes of the blocks given by the arena
+    size_t used;
+    // Bytes of all the chunks
+    size_t reserved;
+} tArena;
+
+// Initialize an empty arena, with chunks of chunkSize bytes (0 for the default size)
+void arena_init(tArena* arena, size_t chunkSize);
+
+// Release all the memory of the arena. The tables bound to it must be released before
+void arena_free(tArena* arena);
+
+// Get a block from the arena. Returns NULL if there is no memory
+void* arena_alloc(tArena* arena, size_t size);
+
+// Get the bytes of the blocks given by the arena
+size_t arena_used(tArena* arena);
+
+// Make the blocks of the calling thread be allocated in an arena, and get 
+// what has to be given to arena_leave. A NULL arena keeps the current allocator
+const tAllocator* arena_enter(struct tArena* arena);
+
+// Restore the allocator of the calling thread that was in use before arena_enter
+void arena_leave(const tAllocator* previous);
+
+#endif // __ARENA_H__
@@ -16,11 +16,45 @@ typedef struct tNode {
     struct tNode *next;
 } tFavoriteStackNode;
 
+// Multiplier of the fingerprints of the stacks, and its inverse modulo 2^64.
+// It is odd, so the inverse exists and a pop undoes a push
+#define FAVORITE_FINGERPRINT_MULTIPLIER 0x9E3779B97F4A7C15ull
+#define FAVORITE_FINGERPRINT_INVERSE 0xF1DE83E19937733Dull
+
 // Definition of a stack of favorites
+// The last node and the number of nodes are kept to return 
+// all the nodes to the pool at once
 typedef struct {
     tFavoriteStackNode *first;
+    tFavoriteStackNode *last;
+    unsigned int count;
+    // Order sensitive fingerprint of the titles of the films. Each push 
+    // multiplies it by FAVORITE_FINGERPRINT_MULTIPLIER and adds the mixed 
+    // hash of the title, and each pop undoes it. Equal stacks have equal 
+    // fingerprints, so different fingerprints tell the stacks are different
+    unsigned long long fingerprint;
 } tFavoriteStack;
 
+// Read-only cursor over the elements of a stack, from the top to the bottom.
+// The stack must not be modified while it is being iterated
+typedef struct {
+    tFavoriteStackNode *node;
+} tFavoriteStackIterator;
+
+// Function called by favoriteStack_foreach for each element of the stack.
+// Returning false stops the iteration
+typedef bool (*tFavoriteFn)(const tFavorite *favorite, void *context);
+
+// Add n free nodes to the pool of nodes of the calling thread, so the next
+// n pushes do not need to call the system allocator
+tError favoriteNodePool_reserve(unsigned int n);
+
+// Get the number of free nodes in the pool of nodes of the calling thread
+unsigned int favoriteNodePool_available(void);
+
+// Release the free nodes of the pool of nodes of the calling thread
+void favoriteNodePool_release(void);
+
 // Initialize a tFavorite object
 tError favorite_init(tFavorite *object, tFilm film);
 
@@ -60,7 +94,22 @@ tError favoriteStack_pop(tFavoriteStack *stack);
 // Removes all elements in the stack
 void favoriteStack_free(tFavoriteStack *stack);
 
-// Compare two favorites stack
+// Initialize an iterator placed at the top of the stack
+void favoriteStackIterator_init(tFavoriteStackIterator *it, const tFavoriteStack *stack);
+
+// Will return true if the iterator still has elements to visit
+bool favoriteStackIterator_hasNext(const tFavoriteStackIterator *it);
+
+// Returns a pointer to the next element and moves the iterator forward.
+// The element belongs to the stack, it must not be modified or released
+const tFavorite* favoriteStackIterator_next(tFavoriteStackIterator *it);
+
+// Call a function for each element of the stack, from the top to the bottom,
+// without modifying the stack. Returns false if the function stopped the iteration
+bool favoriteStack_foreach(const tFavoriteStack *stack, tFavoriteFn fn, void *context);
+
+// Compare two favorites stack. Stacks with different fingerprints are 
+// rejected without walking them
 bool favoriteStack_compare(tFavoriteStack stack1, tFavoriteStack stack2);
 
 // Iteratively compares two stacks
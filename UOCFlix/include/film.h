@@ -2,18 +2,82 @@
 #define __FILM_H__
 
 #include "series.h"
+#include "hash.h"
+#include "table.h"
+
+// Maximum length stored in the titleLength field of a film. Longer titles
+// store this value
+#define FILM_MAX_TITLE_LENGTH 0xFFFF
 
 // Data type to hold data related to a film/film in the platform
+// The title is shared through the pool of interned strings
 typedef struct { 
-    char* title;    
+    const char* title;    
+    // Hash (see hash_string) and length of the title, set by film_init, as
+    // the fields of the username of tUser. Together with lengthInMin they 
+    // use the padding after the title, so the size of a film does not change
+    unsigned int titleHash;
+    unsigned short titleLength;
     unsigned short lengthInMin;
     tSeries *series;
 } tFilm;
 
+// Films of a series in a table of films
+typedef struct {
+    tSeries* series;
+    // Positions of the films in the table
+    tPostings films;
+} tSeriesFilms;
+
+// Index from the series to their films, with a hash index over the title 
+// of the series. Equal series (see series_equals) share the same entry, 
+// which is removed with the last film of the series
+typedef struct {
+    unsigned int size;
+    unsigned int capacity;
+    tSeriesFilms* elements;
+    tHashIndex index;
+} tSeriesFilmsIndex;
+
+// Offsets of a film in the list of its genre and in the list of its series
+typedef struct {
+    unsigned int genre;
+    unsigned int series;
+} tFilmOffsets;
+
+// Reader-writer lock of the tables (see sync.h)
+struct tRWLock;
+
+// Arena of the tables (see arena.h)
+struct tArena;
+
 // Table of tFilm elements
 typedef struct {
     unsigned int size;    
+    // Number of elements that fit in the allocated memory
+    unsigned int capacity;
     tFilm* elements;
+    // Hash index over the title of the elements
+    tHashIndex index;
+    // How films are removed. In TABLE_REMOVE_TOMBSTONE mode, removed films 
+    // stay in the table with a NULL title, and removed is the number of them
+    tRemoveMode removeMode;
+    unsigned int removed;
+    // Lock taken by the functions of the table, or NULL (see filmTable_setLock)
+    struct tRWLock* lock;
+    // Arena where the memory of the table is allocated, or NULL (see filmTable_setArena)
+    struct tArena* arena;
+    // Positions of the films of each genre and of each series, kept up to 
+    // date when films are added and removed
+    tPostings byGenre[GENRE_QTY];
+    tSeriesFilmsIndex bySeries;
+    // Offsets of the films in those lists, by the position of the film, so 
+    // films are taken out of the lists without searching them
+    tFilmOffsets* offsets;
+    unsigned int offsetsCapacity;
+    // Number of bound logs and recommenders that keep the positions of the 
+    // films (see viewLog_bind and recommender_init)
+    unsigned int references;
 } tFilmTable;
 
 // **** Functions related to management of tFilm objects
@@ -44,6 +108,15 @@ void filmTable_free(tFilmTable* table);
 // Add a new film in the table. In case the film already exists (same title), it will return an error value ERR_DUPLICATED.
 tError filmTable_add(tFilmTable* table, tFilm* film);
 
+// Add count films to the table, as userTable_addMany
+tError filmTable_addMany(tFilmTable* table, tFilm* films, unsigned int count, tError* results);
+
+// Ensure there is memory for at least n films in the table
+tError filmTable_reserve(tFilmTable* table, unsigned int n);
+
+// Release the memory not used by the elements of the table
+tError filmTable_shrinkToFit(tFilmTable* table);
+
  /* a search for an film in the table received as a parameter, by its title. 
   * It will return a pointer to the tFilm type data if found, or NULL otherwise.
   */
@@ -53,10 +126,50 @@ tFilm* filmTable_find (tFilmTable* table, const char* title);
  * title. If an attempt is made to delete a device that 
  * does not exist in the table, the error value ERR_NOT_FOUND will be returned. 
  * Otherwise, it will return the OK value. If there is a problem managing memory, 
- * this function will return an error value ERR_MEMORY_ERROR.
+ * this function will return an error value ERR_MEMORY_ERROR. 
+ * While bound logs or recommenders keep the positions of the films, films 
+ * can only be removed in TABLE_REMOVE_TOMBSTONE mode and the table is not 
+ * compacted. In the other modes it will return ERR_INVALID.
  */
 tError filmTable_remove(tFilmTable* table, tFilm* film);
 
+// Select how films are removed from the table. Leaving the 
+// TABLE_REMOVE_TOMBSTONE mode compacts the table, unless bound logs or 
+// recommenders keep the positions of the films
+void filmTable_setRemoveMode(tFilmTable* table, tRemoveMode mode);
+
+// Remove the tombstones of removed films from the table. 
+// The positions of the films after them change, so it returns ERR_INVALID 
+// while bound logs or recommenders keep the positions of the films
+tError filmTable_compact(tFilmTable* table);
+
+// Get the positions of the films of a genre in the table, in the order of 
+// the table unless films were removed in TABLE_REMOVE_SWAP or 
+// TABLE_REMOVE_TOMBSTONE mode. 
+// Returns NULL if there are no films of the genre
+tPostings* filmTable_getGenreFilms(tFilmTable* table, tGenre genre);
+
+// Get the positions of the films of a series in the table, in the same order 
+// than filmTable_getGenreFilms. Series are found by title, so their titles 
+// must not change while they have films in the table. The list is valid 
+// until films are added to or removed from the table. 
+// Returns NULL if there are no films of the series
+tPostings* filmTable_getSeriesFilms(tFilmTable* table, tSeries* series);
+
+// Use a reader-writer lock to share the table between threads, 
+// as userTable_setLock. A NULL lock (the default) disables locking
+void filmTable_setLock(tFilmTable* table, struct tRWLock* lock);
+
+// Allocate the memory of the table in an arena, as userTable_setArena
+void filmTable_setArena(tFilmTable* table, struct tArena* arena);
+
+// Count a bound log or a recommender that keeps the positions of the films, 
+// as userTable_addReference
+void filmTable_addReference(tFilmTable* table);
+
+// Stop counting a log or a recommender counted with filmTable_addReference
+void filmTable_releaseReference(tFilmTable* table);
+
 // Returns the number of films in the tFilmTable table received as a parameter.
 unsigned int filmTable_size(tFilmTable* table);
 
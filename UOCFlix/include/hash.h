@@ -0,0 +1,75 @@
+#ifndef __HASH_H__
+#define __HASH_H__
+
+#include <stdbool.h>
+#include "error.h"
+
+// Slot of a hash index. Stores the hash of the key and the position of
+// the element in its table, plus one (a position equal to 0 marks an empty slot)
+typedef struct {
+    unsigned int hash;
+    unsigned int position;
+} tHashSlot;
+
+// Open-addressing (linear probing) hash index that maps string keys to
+// positions in a table. Keys are not copied in the index, they are read
+// from the indexed table when two hashes collide
+typedef struct {
+    unsigned int capacity;
+    unsigned int count;
+    tHashSlot* slots;
+} tHashIndex;
+
+// Function used by the index to get the key of the element at a position of the table
+typedef const char* (*tHashKeyFn)(void* table, unsigned int position);
+
+// Get the hash value of a string
+unsigned int hash_string(const char* key);
+
+// Spread the bits of a hash over 64 bits, to combine it with other hashes
+// in a fingerprint. Similar hashes give very different values
+unsigned long long hash_mix64(unsigned int hash);
+
+// Initialize an empty hash index
+void hashIndex_init(tHashIndex* index);
+
+// Release the memory used by a hash index
+void hashIndex_free(tHashIndex* index);
+
+// Remove all the entries of a hash index, keeping its memory
+void hashIndex_clear(tHashIndex* index);
+
+// Ensure the index can hold n keys without growing
+tError hashIndex_reserve(tHashIndex* index, unsigned int n);
+
+// Add the position of a new key in the index.
+// The key must not be already in the index
+tError hashIndex_insert(tHashIndex* index, unsigned int hash, unsigned int position);
+
+// Search a key in the index. If found, returns true and the position of
+// the element in the table is stored in position
+bool hashIndex_find(tHashIndex* index, const char* key, unsigned int hash,
+                    tHashKeyFn getKey, void* table, unsigned int* position);
+
+// Remove a key from the index. Returns false if the key is not in the index
+bool hashIndex_remove(tHashIndex* index, const char* key, unsigned int hash,
+                    tHashKeyFn getKey, void* table);
+
+// Remove the entry of the element at a position of the table, without
+// reading its key. Returns false if the position is not in the index
+bool hashIndex_removePosition(tHashIndex* index, unsigned int hash, unsigned int position);
+
+// Change the position stored for the element at a position of the table,
+// without reading its key. Returns false if the position is not in the index
+bool hashIndex_updatePosition(tHashIndex* index, unsigned int hash, unsigned int position, unsigned int newPosition);
+
+// Change the position stored for a key of the index. 
+// Returns false if the key is not in the index
+bool hashIndex_update(tHashIndex* index, const char* key, unsigned int hash,
+                    tHashKeyFn getKey, void* table, unsigned int position);
+
+// Update positions after removing the element at a position of the table
+// and moving all the elements after it one position to the front
+void hashIndex_shift(tHashIndex* index, unsigned int position);
+
+#endif // __HASH_H__
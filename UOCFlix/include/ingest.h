@@ -0,0 +1,95 @@
+#ifndef __INGEST_H__
+#define __INGEST_H__
+
+#include "error.h"
+#include "view.h"
+#include "sync.h"
+
+// Queue of views in front of a tViewLog, so the threads that receive views
+// do not wait for the log. viewIngest_add copies the view into a bounded
+// ring, without taking any lock, and a consumer thread adds the queued
+// views to the log in batches, taking the lock of the log once per batch.
+// The journal, the indexes and the recommender of the log are updated by
+// viewLog_add as usual. Views are added to the log in the order they were
+// queued, and viewIngest_flush waits until the views queued before it are
+// in the log, so a thread can read the views it added.
+// The view is copied as it is, so its user and film must be kept until the
+// view is in the log: the elements of the tables of a bound log, or objects
+// that live until the next flush. Only the consumer thread changes the log
+// while the queue is running, and other threads read it after a flush or
+// holding the lock of the log (see viewLog_setLock)
+
+// Maximum number of views added to the log under a single lock
+#define VIEWINGEST_MAX_BATCH 256
+
+// Maximum number of views of the queue
+#define VIEWINGEST_MAX_CAPACITY (1u << 24)
+
+// Bytes that keep the fields written by the producers and by the consumer
+// in different cache lines
+#define VIEWINGEST_CACHE_LINE 64
+
+// Slot of the ring. Its sequence tells the producers and the consumer
+// whether it is free for the view at position sequence, or holds the view
+// at position sequence - 1
+typedef struct {
+    volatile unsigned long long sequence;
+    tView view;
+} tViewIngestSlot;
+
+// Queue of views added to a log by a consumer thread
+typedef struct {
+    tViewLog* log;
+    // Number of slots, a power of 2
+    unsigned int capacity;
+    tViewIngestSlot* slots;
+    char padHead[VIEWINGEST_CACHE_LINE];
+    // Next position to be taken by a producer
+    volatile unsigned long long head;
+    char padTail[VIEWINGEST_CACHE_LINE];
+    // Next position to be read by the consumer thread
+    unsigned long long tail;
+    // Number of views the consumer has added to the log, or failed to add
+    volatile unsigned long long done;
+    // Number of views that could not be added, and error of the first
+    // of them since the last flush (as an unsigned tError)
+    volatile unsigned long long failed;
+    volatile unsigned long long error;
+    char padEvents[VIEWINGEST_CACHE_LINE];
+    // Signaled when views are queued while the consumer waits, and
+    // when views are done while producers wait for space or for a flush
+    tEvent queued;
+    tEvent progress;
+    // Number of threads waiting for queued and for progress
+    volatile unsigned int sleeping;
+    volatile unsigned int waiting;
+    // Set to 1 by viewIngest_free to end the consumer, once the queue is empty
+    volatile unsigned int stopping;
+    tThread consumer;
+} tViewIngest;
+
+// Initialize an empty queue with space for capacity views (rounded up to a
+// power of 2) in front of a log, and start its consumer thread. Returns
+// ERR_INVALID if capacity is 0 or over VIEWINGEST_MAX_CAPACITY
+tError viewIngest_init(tViewIngest* ingest, tViewLog* log, unsigned int capacity);
+
+// Add the queued views to the log, stop the consumer thread and release
+// the memory of the queue. No views can be queued at the same time
+void viewIngest_free(tViewIngest* ingest);
+
+// Queue a view to be added to the log. Can be called by many threads at
+// the same time. If the queue is full, waits until the consumer makes space
+tError viewIngest_add(tViewIngest* ingest, tView* view);
+
+// Wait until the views queued before the call are in the log. Returns the
+// error of the first view that could not be added since the previous
+// flush (see viewLog_add), or OK if all of them were added
+tError viewIngest_flush(tViewIngest* ingest);
+
+// Get the number of views queued and not in the log yet
+unsigned int viewIngest_pending(tViewIngest* ingest);
+
+// Get the number of views that could not be added to the log
+unsigned int viewIngest_failed(tViewIngest* ingest);
+
+#endif // __INGEST_H__
@@ -0,0 +1,30 @@
+#ifndef __INTERN_H__
+#define __INTERN_H__
+
+// Pool of interned strings. Equal strings acquired from the pool share the
+// same immutable copy, so they are stored once and can be compared by pointer.
+// Each copy keeps a count of references and is released with the last one.
+// The pool is global and it can be used by several threads at the same time
+
+// Get the shared copy of a string, adding a reference to it. 
+// Returns NULL if there is no memory to create the copy
+const char* intern_acquire(const char* str);
+
+// Remove a reference to a string acquired from the pool. 
+// Accepts NULL, that is ignored
+void intern_release(const char* str);
+
+// Get the number of references to a string acquired from the pool
+unsigned int intern_refs(const char* str);
+
+// Get the hash (see hash_string) of a string acquired from the pool, 
+// without reading the string
+unsigned int intern_hash(const char* str);
+
+// Get the length of a string acquired from the pool, without reading the string
+unsigned int intern_length(const char* str);
+
+// Get the number of different strings in the pool
+unsigned int intern_size(void);
+
+#endif // __INTERN_H__
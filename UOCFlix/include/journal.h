@@ -0,0 +1,67 @@
+#ifndef __JOURNAL_H__
+#define __JOURNAL_H__
+
+#include <stdio.h>
+#include "error.h"
+#include "view.h"
+
+// Append-only journal of the views added to a bound tViewLog. Each view is 
+// a record with the username of its user and the title of its film, its 
+// timestamp fields, score and minutes, and a checksum. Users and films are 
+// found by their keys when the journal is replayed, as their positions in 
+// the tables change when a snapshot drops the removed elements. 
+// Records are written to the file when they are added, but the file is only 
+// synced to disk in groups (group commit), so a crash can lose at most the 
+// last group. The journal is replayed on top of the tables it was written 
+// against, usually just loaded from a snapshot (see snapshot_load)
+
+// Version of the format of the journal files
+#define JOURNAL_VERSION 2
+
+// Maximum length of the username and the title stored in a record
+#define JOURNAL_MAX_KEY_LENGTH 0xFFFF
+
+// Open journal. Groups are synced after syncRecords records, or when a record 
+// is added syncIntervalMs milliseconds after the last sync. A value of 0 
+// disables each condition, and a syncRecords of 1 syncs every record
+typedef struct tJournal {
+    FILE* file;
+    unsigned int syncRecords;
+    unsigned int syncIntervalMs;
+    // Records added since the last sync
+    unsigned int pending;
+    // Time of the last sync, in milliseconds 
+    unsigned long long lastSync;
+    // Number of records and syncs since the journal was opened
+    unsigned int records;
+    unsigned int syncs;
+} tJournal;
+
+// Open a journal to add records at its end, creating it if it does not exist. 
+// A partial record left at the end by a crash is removed. 
+// Returns ERR_INVALID if the file is not a journal or can not be opened, 
+// and ERR_MEMORY_ERROR if there is no memory to read its records
+tError journal_open(tJournal* journal, const char* path, unsigned int syncRecords, unsigned int syncIntervalMs);
+
+// Add the record of a view of a user of a film, syncing the group if needed. 
+// Returns ERR_INVALID if the username or the title are longer than 
+// JOURNAL_MAX_KEY_LENGTH or the record can not be written
+tError journal_append(tJournal* journal, tView* view, const tUser* user, const tFilm* film);
+
+// Write all the pending records to disk
+tError journal_sync(tJournal* journal);
+
+// Remove all the records, usually after saving a snapshot
+tError journal_reset(tJournal* journal);
+
+// Sync the pending records and close the journal
+tError journal_close(tJournal* journal);
+
+// Add the views of a journal to a bound log. Replay stops at the first 
+// incomplete or corrupted record, as it was not completely written. 
+// replayed (can be NULL) gets the number of views added. Returns ERR_NOT_FOUND 
+// if the file does not exist, and ERR_INVALID if it is not a journal or it 
+// references users or films not in the tables of the log (e.g. removed ones)
+tError journal_replay(const char* path, tViewLog* views, unsigned int* replayed);
+
+#endif // __JOURNAL_H__
@@ -0,0 +1,49 @@
+#ifndef __LOADER_H__
+#define __LOADER_H__
+
+#include <stdio.h>
+#include "error.h"
+#include "series.h"
+#include "film.h"
+#include "user.h"
+#include "view.h"
+
+// Bulk loader of delimited text files (CSV, TSV...). Files are read in 
+// chunks, each line is a record and fields are separated by the delimiter. 
+// Empty lines and lines starting with '#' are ignored. Fields can not 
+// contain the delimiter, and are not unquoted. The record formats are:
+//   users:  username, name, mail
+//   series: title, genre (number from 1 to GENRE_QTY - 1)
+//   films:  title, length in minutes, title of the series
+//   views:  username, film title, timestamp (YYYY-MM-DD hh:mm), score, minutes
+
+// Maximum length of a line, including the end of line
+#define LOADER_MAX_LINE 4096
+
+// Counters of a load
+typedef struct {
+    // Number of records read
+    unsigned int records;
+    // Number of records added to the table
+    unsigned int loaded;
+    // Number of records not added, because they were malformed, duplicated, 
+    // too long or referenced users, films or series not found
+    unsigned int skipped;
+} tLoaderStats;
+
+// Load users into a table. stats can be NULL
+tError loader_loadUsers(FILE* file, char delimiter, tUserTable* users, tLoaderStats* stats);
+
+// Load series into a table. stats can be NULL
+tError loader_loadSeries(FILE* file, char delimiter, tSeriesTable* series, tLoaderStats* stats);
+
+// Load films into a table, resolving their series by title. stats can be NULL
+tError loader_loadFilms(FILE* file, char delimiter, tSeriesTable* series, tFilmTable* films, 
+                        tLoaderStats* stats);
+
+// Load views into a log, resolving their users and films by username and title. 
+// Views of a bound log must reference its tables. stats can be NULL
+tError loader_loadViews(FILE* file, char delimiter, tUserTable* users, tFilmTable* films, 
+                        tViewLog* views, tLoaderStats* stats);
+
+#endif // __LOADER_H__
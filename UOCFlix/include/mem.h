@@ -0,0 +1,88 @@
+#ifndef __MEM_H__
+#define __MEM_H__
+
+#include <stddef.h>
+#include <stdio.h>
+#include "error.h"
+
+// Parts of the library that allocate memory. Each one has its own counters
+typedef enum {
+    MEM_USER,
+    MEM_FILM,
+    MEM_SERIES,
+    MEM_VIEW,
+    MEM_FAVORITE,
+    MEM_INDEX,
+    MEM_INTERN,
+    MEM_STORAGE,
+    MEM_REPORT,
+    MEM_ARENA,
+    MEM_RECOMMEND,
+    MEM_SEGMENT,
+    MEM_SUBSYSTEM_QTY
+} tMemSubsystem;
+
+// Functions used by the library to get and release memory, with the
+// semantics of malloc, realloc and free. The context is passed to all of them.
+// A region allocator, that releases all its blocks at once, has no release
+// function. Blocks without a reallocate function are resized with a copy.
+// The blocks of a region are not counted in the live memory of the subsystems
+typedef struct {
+    void* (*allocate)(size_t size, void* context);
+    void* (*reallocate)(void* ptr, size_t size, void* context);
+    void (*release)(void* ptr, void* context);
+    void* context;
+} tAllocator;
+
+// Counters of the memory of a subsystem
+typedef struct {
+    // Bytes of the blocks not released yet
+    unsigned long long liveBytes;
+    // Number of blocks not released yet
+    unsigned long long liveBlocks;
+    // Maximum value reached by liveBytes
+    unsigned long long highWater;
+    // Number of blocks allocated or resized
+    unsigned long long allocations;
+} tMemStats;
+
+// Set the allocator used for the next blocks of the library. A NULL allocator
+// restores malloc, realloc and free. Each block is resized and released with
+// the allocator that created it, so the allocator must be kept while any of
+// its blocks is in use
+void mem_setAllocator(const tAllocator* allocator);
+
+// Set the allocator used for the next blocks of the calling thread, instead 
+// of the allocator of the library, and get the previous one. A NULL allocator
+// restores the allocator of the library
+const tAllocator* mem_setThreadAllocator(const tAllocator* allocator);
+
+// Get the allocator set for the calling thread, or NULL if it has none
+const tAllocator* mem_getThreadAllocator(void);
+
+// Allocate a block of memory for a subsystem. Returns NULL if there is no memory
+void* mem_alloc(tMemSubsystem subsystem, size_t size);
+
+// Allocate a block for n elements of the given size, set to 0
+void* mem_calloc(tMemSubsystem subsystem, size_t n, size_t size);
+
+// Change the size of a block. A NULL block allocates a new one.
+// Returns NULL if there is no memory, keeping the old block
+void* mem_realloc(tMemSubsystem subsystem, void* ptr, size_t size);
+
+// Release a block of memory. Accepts NULL, that is ignored
+void mem_free(void* ptr);
+
+// Get the counters of a subsystem
+void mem_getStats(tMemSubsystem subsystem, tMemStats* stats);
+
+// Get the counters of the whole library
+void mem_getTotalStats(tMemStats* stats);
+
+// Get the name of a subsystem
+const char* mem_subsystemName(tMemSubsystem subsystem);
+
+// Write the counters of all the subsystems
+void mem_dump(FILE* fout);
+
+#endif // __MEM_H__
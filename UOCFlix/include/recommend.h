@@ -0,0 +1,141 @@
+#ifndef __RECOMMEND_H__
+#define __RECOMMEND_H__
+
+#include "error.h"
+#include "hash.h"
+#include "series.h"
+#include "film.h"
+#include "user.h"
+
+// Recommendations of the kind "users who watched X also watched Y", kept up
+// to date as views and favorites are added, so queries do not scan the views.
+// The recommender is bound to a table of users and a table of films, and
+// counts, for each pair of films, the users that watched (or marked as
+// favorite) both of them, and for each pair of series, the users that
+// watched films of both. Each user counts once per pair, however many times
+// it watched the films. Some memory is used for each pair of films of a
+// user, so the counts of a film only store the films it shares users with.
+// As with bound logs, removing users or films from the tables invalidates
+// the counts that reference them
+
+// Events counted by the recommender
+typedef enum {
+    RECOMMEND_VIEWS,
+    RECOMMEND_FAVORITES,
+    RECOMMEND_SOURCE_QTY
+} tRecommendSource;
+
+// Count of an id in a tRecommendCounts
+typedef struct {
+    // Id plus one, or 0 for an empty entry
+    unsigned int key;
+    unsigned int count;
+} tRecommendCount;
+
+// Sparse counts indexed by id (the position of a user, a film or a series).
+// They are stored in an open-addressing hash table, so only the ids with
+// counts use memory. Counts that go back to 0 keep their entry
+typedef struct {
+    unsigned int size;
+    unsigned int capacity;
+    tRecommendCount* entries;
+} tRecommendCounts;
+
+// What the recommender knows of a user
+typedef struct {
+    // Number of times the user added each film, by source
+    tRecommendCounts films[RECOMMEND_SOURCE_QTY];
+    // Number of views of the user of each series, by position in the series of the recommender
+    tRecommendCounts series;
+} tRecommendUser;
+
+// What the recommender knows of a film
+typedef struct {
+    // Number of users that added the film, by source
+    unsigned int users[RECOMMEND_SOURCE_QTY];
+    // Number of users that added both this film and each other film, by source
+    tRecommendCounts pairs[RECOMMEND_SOURCE_QTY];
+} tRecommendFilm;
+
+// What the recommender knows of a series
+typedef struct {
+    tSeries* series;
+    // Number of users that watched films of the series
+    unsigned int users;
+    // Number of users that watched films of both this series and each other series
+    tRecommendCounts pairs;
+} tRecommendSeries;
+
+// Reader-writer lock of the tables (see sync.h)
+struct tRWLock;
+
+// Recommender bound to a table of users and a table of films
+typedef struct tRecommender {
+    tUserTable* users;
+    tFilmTable* films;
+    // Counts of each user and each film, by position in their tables.
+    // The arrays grow when views of new users and films are added
+    unsigned int userCount;
+    tRecommendUser* userCounts;
+    unsigned int filmCount;
+    tRecommendFilm* filmCounts;
+    // Series of the films watched, with a hash index over their title.
+    // Equal series (see series_equals) share the same entry
+    unsigned int seriesSize;
+    unsigned int seriesCapacity;
+    tRecommendSeries* series;
+    tHashIndex seriesIndex;
+    // Lock taken by the functions of the recommender, or NULL (see recommender_setLock)
+    struct tRWLock* lock;
+} tRecommender;
+
+// Initialize an empty recommender bound to a table of users and a table of 
+// films. The counts are kept by the positions of the users and the films, 
+// so until recommender_free the tables do not move them (see userTable_remove)
+void recommender_init(tRecommender* recommender, tUserTable* users, tFilmTable* films);
+
+// Release the memory used by a recommender, and unbind it from its tables
+void recommender_free(tRecommender* recommender);
+
+// Count a view of a user of a film, given by their positions in the tables.
+// O(number of films watched by the user) the first time the user watches
+// the film, and O(1) after that. If there is no memory, nothing is counted
+tError recommender_addView(tRecommender* recommender, unsigned int userId, unsigned int filmId);
+
+// Remove a view counted by recommender_addView. It does not allocate memory.
+// Returns ERR_NOT_FOUND if the user has no view of the film
+tError recommender_removeView(tRecommender* recommender, unsigned int userId, unsigned int filmId);
+
+// Count a favorite of a user, given by the positions of the user and the film in the tables
+tError recommender_addFavorite(tRecommender* recommender, unsigned int userId, unsigned int filmId);
+
+// Remove a favorite counted by recommender_addFavorite.
+// Returns ERR_NOT_FOUND if the user has no such favorite
+tError recommender_removeFavorite(tRecommender* recommender, unsigned int userId, unsigned int filmId);
+
+// Get the number of users that added both films, that must be elements of the table of films
+unsigned int recommender_getPairCount(tRecommender* recommender, tRecommendSource source, tFilm* film1, tFilm* film2);
+
+// Get the number of users that added a film, that must be an element of the table of films
+unsigned int recommender_getUserCount(tRecommender* recommender, tRecommendSource source, tFilm* film);
+
+// Get the k films most added by the users that added a film (an element of
+// the table of films), from the most added to the least. Ties go to the
+// first film of the table. films and counts (that can be NULL) must have
+// space for k elements, and count is the number of films found
+tError recommender_getFilms(tRecommender* recommender, tRecommendSource source, tFilm* film, unsigned int k,
+                            tFilm** films, unsigned int* counts, unsigned int* count);
+
+// Get the k series most watched by the users that watched a series, from the
+// most watched to the least. Ties go to the first series watched. series and
+// counts (that can be NULL) must have space for k elements, and count is the
+// number of series found, or 0 if no film of the series was watched
+tError recommender_getSeries(tRecommender* recommender, tSeries* series, unsigned int k,
+                             tSeries** result, unsigned int* counts, unsigned int* count);
+
+// Use a reader-writer lock to share the recommender between threads. The
+// functions that count views and favorites take the lock for writing, and
+// the queries for reading. A NULL lock disables locking
+void recommender_setLock(tRecommender* recommender, struct tRWLock* lock);
+
+#endif // __RECOMMEND_H__
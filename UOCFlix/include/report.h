@@ -0,0 +1,74 @@
+#ifndef __REPORT_H__
+#define __REPORT_H__
+
+#include "error.h"
+#include "series.h"
+#include "film.h"
+#include "user.h"
+#include "view.h"
+
+// Global reports over all the views of a bound tViewLog, computed in a 
+// single parallel pass. The views are split in contiguous ranges, one per 
+// worker thread, each worker aggregates its range in its own counters, 
+// and the counters are merged at the end. The favorite genre and film of 
+// every user are the same that viewLog_getFavGenre and viewLog_getFavFilm 
+// give, including the way ties are solved. Sealed views (see viewLog_seal) 
+// are decoded by the workers as they are aggregated
+
+// Maximum number of worker threads of a report
+#define REPORT_MAX_THREADS 64
+
+// Aggregates of the views of a film
+typedef struct {
+    unsigned int views;
+    long long scoreSum;
+    unsigned long long minutes;
+} tFilmStats;
+
+// Report of a log
+typedef struct {
+    // Tables the log is bound to
+    tUserTable* users;
+    tFilmTable* films;
+    // Number of views of each genre
+    unsigned int genreViews[GENRE_QTY];
+    // Aggregates of each film, by position in the table of films
+    unsigned int filmCount;
+    tFilmStats* filmStats;
+    // Favorite genre of each user, and position of the favorite film 
+    // (or -1), by position in the table of users
+    unsigned int userCount;
+    tGenre* favGenre;
+    int* favFilm;
+} tLogReport;
+
+// Build the report of a bound log using a number of worker threads. 
+// The log must not change while the report is built. 
+// Returns ERR_INVALID if the log is not bound or threads is 0 or over REPORT_MAX_THREADS
+tError logReport_build(tLogReport* report, tViewLog* log, unsigned int threads);
+
+// Release the memory used by a report
+void logReport_free(tLogReport* report);
+
+// Get the genre with the most views. In case of a tie, the first one. 
+// Returns GENRE_NOT_FOUND if there are no views
+tGenre logReport_getTopGenre(tLogReport* report);
+
+// Get the k films with the most views (the trending films), from the most 
+// viewed to the least. In case of a tie, the first film of the table goes 
+// first. films must have space for k films, and count is the number of films found
+tError logReport_getTopFilms(tLogReport* report, unsigned int k, tFilm** films, unsigned int* count);
+
+// Get the average score of the views of a film, or 0 if it has no views
+float logReport_getAverageScore(tLogReport* report, tFilm* film);
+
+// Get the total minutes watched of the films of a series
+unsigned long long logReport_getSeriesMinutes(tLogReport* report, tSeries* series);
+
+// Get the favorite genre of a user (see viewLog_getFavGenre)
+tGenre logReport_getFavGenre(tLogReport* report, tUser* user);
+
+// Get the favorite film of a user (see viewLog_getFavFilm)
+tFilm* logReport_getFavFilm(tLogReport* report, tUser* user);
+
+#endif // __REPORT_H__
@@ -0,0 +1,75 @@
+#ifndef __SEGMENT_H__
+#define __SEGMENT_H__
+
+#include <stddef.h>
+#include "error.h"
+#include "view.h"
+
+// Immutable compressed copy of a range of views of a bound tViewLog (see
+// viewLog_seal). Old views are rarely queried, so they are kept in a few
+// bytes each and decoded while they are scanned, without building tView
+// objects. Each view is stored as varints in a single stream of bytes:
+// the difference of its timestamp with the previous view, the code of its
+// user and its film in the dictionaries of the segment, and its minutes.
+// The scores are bit-packed in their own array, with the bits needed for
+// the range of scores of the segment
+
+// Not a user: views of all the users (see viewSegment_visit)
+#define VIEWSEGMENT_ALL_USERS 0xFFFFFFFFu
+
+// Compressed range of views
+typedef struct tViewSegment {
+    // Position of the first view among the sealed views of the log, and number of views
+    unsigned int first;
+    unsigned int count;
+    // Lowest and highest timestamp of the views
+    tPackedDateTime minTimestamp;
+    tPackedDateTime maxTimestamp;
+    // Distinct positions of the users and films of the views, sorted. The code
+    // of a user or a film is its index here. Each film keeps its genre too
+    unsigned int userCount;
+    unsigned int* users;
+    unsigned int filmCount;
+    unsigned int* films;
+    unsigned char* genres;
+    // Score of each view, as score - minScore in scoreBits bits
+    short minScore;
+    unsigned int scoreBits;
+    unsigned char* scores;
+    // Varints of the views
+    unsigned int dataSize;
+    unsigned char* data;
+} tViewSegment;
+
+// View decoded from a segment
+typedef struct {
+    // Position of the view among the sealed views of the log
+    unsigned int position;
+    unsigned int userId;
+    unsigned int filmId;
+    unsigned char genre;
+    tPackedDateTime timestamp;
+    unsigned short minutes;
+    short score;
+} tViewRecord;
+
+// Function called by viewSegment_visit for each view
+typedef void (*tViewRecordFn)(const tViewRecord* record, void* context);
+
+// Encode the first count views of a bound log in a segment, where the first
+// view has the given position among the sealed views. count must not be 0
+tError viewSegment_build(tViewSegment* segment, tViewLog* log, unsigned int count, unsigned int first);
+
+// Release the memory used by a segment
+void viewSegment_free(tViewSegment* segment);
+
+// Call a function for each view of a user (or VIEWSEGMENT_ALL_USERS) with a
+// timestamp in the range [from, to), in the order of the log. Segments
+// without views of the user or without views in the range are not decoded
+void viewSegment_visit(const tViewSegment* segment, unsigned int userId, tPackedDateTime from,
+                       tPackedDateTime to, tViewRecordFn fn, void* context);
+
+// Get the bytes of memory used by a segment
+size_t viewSegment_bytes(const tViewSegment* segment);
+
+#endif // __SEGMENT_H__
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include "error.h"
+#include "hash.h"
 
 typedef enum {
     GENRE_NOT_FOUND = 0,
@@ -17,11 +18,23 @@ typedef enum {
 } tGenre;
 
 // Data type to hold data related to a Series in the platform
+// The title is shared through the pool of interned strings
 typedef struct {
-    char* title;
+    const char* title;
     tGenre genre;    
 } tSeries;
 
+// Table of tSeries elements. Each series is allocated on its own, so the 
+// pointers to the series (used by the films) do not change when the table grows
+typedef struct {
+    unsigned int size;
+    // Number of elements that fit in the allocated memory
+    unsigned int capacity;
+    tSeries** elements;
+    // Hash index over the title of the elements
+    tHashIndex index;
+} tSeriesTable;
+
 // Initialize a series object
 tError series_init(tSeries* object, const char* title, tGenre genre);
 
@@ -47,4 +60,29 @@ series_init () over your pointer)
 */
 tError series_cpy(tSeries* dst, tSeries* src); 
 
+// **** Functions related to management of tSeriesTable objects
+
+// Initialize a table of series
+void seriesTable_init(tSeriesTable* table);
+
+// Release the memory used by a table of series, including its series
+void seriesTable_free(tSeriesTable* table);
+
+// Add a copy of a series to the table. In case a series with 
+// the same title already exists, it will return ERR_DUPLICATED
+tError seriesTable_add(tSeriesTable* table, tSeries* series);
+
+// Ensure there is memory for at least n series in the table
+tError seriesTable_reserve(tSeriesTable* table, unsigned int n);
+
+// Get the series with a title, or NULL if it is not in the table
+tSeries* seriesTable_find(tSeriesTable* table, const char* title);
+
+// Get the position in the table of the series with a title. 
+// Returns false if it is not in the table
+bool seriesTable_findPosition(tSeriesTable* table, const char* title, unsigned int* position);
+
+// Get the number of series in the table
+unsigned int seriesTable_size(tSeriesTable* table);
+
 #endif // __SERIES_H__
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef __SHARDLOG_H__
+#define __SHARDLOG_H__
+
+#include "error.h"
+#include "user.h"
+#include "film.h"
+#include "view.h"
+#include "table.h"
+#include "sync.h"
+
+// Log of views split in shards, so many threads can add views at the same 
+// time. Each shard is a bound tViewLog with its own lock, and the views of 
+// a user always go to the same shard (chosen by the hash of the username). 
+// Threads only wait for each other when they add views of users of the 
+// same shard, so ingest scales with the number of shards. 
+// Each view gets a number from a global sequence, that gives the order 
+// in which views were added to the whole log. The views of a user are in 
+// a single shard and in the order of the sequence, so per-user queries 
+// only read that shard and give the same results than a single tViewLog
+
+// Maximum number of shards of a log
+#define SHARDLOG_MAX_SHARDS 256
+
+// Shard of a sharded log
+typedef struct {
+    tRWLock lock;
+    // Views of the shard, bound to the tables of the sharded log. 
+    // Its lock is the lock of the shard
+    tViewLog views;
+    // Number in the global sequence of each view of the shard, increasing
+    tPostings sequence;
+} tViewShard;
+
+// Sharded log of views
+typedef struct {
+    unsigned int count;
+    tViewShard* shards;
+    tUserTable* users;
+    tFilmTable* films;
+    // Next number of the global sequence
+    volatile unsigned int next;
+} tShardedViewLog;
+
+// Initialize an empty sharded log with a number of shards, bound to the 
+// tables of users and films (see viewLog_bind). If the tables are changed 
+// while views are added, they must have a lock (see userTable_setLock). 
+// Returns ERR_INVALID if the number of shards is 0 or over SHARDLOG_MAX_SHARDS
+tError shardedViewLog_init(tShardedViewLog* log, unsigned int shards, tUserTable* users, tFilmTable* films);
+
+// Release the memory used by a sharded log
+void shardedViewLog_free(tShardedViewLog* log);
+
+// Add a view to the shard of its user. Can be called by many threads at the same time
+tError shardedViewLog_add(tShardedViewLog* log, tView* view);
+
+// Get the number of views of the log
+unsigned int shardedViewLog_size(tShardedViewLog* log);
+
+// Keep the index of views per user in each shard (see viewLog_enableUserIndex)
+tError shardedViewLog_enableUserIndex(tShardedViewLog* log);
+
+// Same as viewLog_getFavFilm, over the views of all the shards
+tFilm* shardedViewLog_getFavFilm(tShardedViewLog* log, tUser* user);
+
+// Same as viewLog_getFavGenre, over the views of all the shards
+tGenre shardedViewLog_getFavGenre(tShardedViewLog* log, tUser* user);
+
+// Add all the views of the sharded log to an empty tViewLog bound to the 
+// same tables, merging the shards in the order the views were added. 
+// No views can be added to the sharded log while merging. 
+// Returns ERR_INVALID if the log is not empty or bound to other tables
+tError shardedViewLog_merge(tShardedViewLog* log, tViewLog* views);
+
+#endif // __SHARDLOG_H__
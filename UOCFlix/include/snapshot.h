@@ -0,0 +1,38 @@
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include "error.h"
+#include "series.h"
+#include "film.h"
+#include "user.h"
+#include "view.h"
+
+// Binary snapshot of a whole dataset: series, films, users with their 
+// favorites and the view log. The file has a versioned header followed by 
+// arrays of fixed size records. Records reference other records by their 
+// position and strings by their offset in a final block of strings, so the 
+// file has no pointers and can be loaded at any address. 
+// The file uses the byte order of the machine that wrote it
+
+// Version of the format written by snapshot_save
+#define SNAPSHOT_VERSION 1
+
+// Write a snapshot of the dataset to a file, in one pass over the tables. 
+// Films must belong to series of the table of series, and the views and 
+// favorites must reference users and films of the tables.
+// Returns ERR_NOT_FOUND if a referenced object is not in its table, 
+// and ERR_INVALID if the file can not be written or the log has sealed 
+// views (see viewLog_seal)
+tError snapshot_save(const char* path, tSeriesTable* series, tFilmTable* films, 
+                     tUserTable* users, tViewLog* views);
+
+// Load a snapshot into empty tables, which are initialized by this function. 
+// The file is mapped in memory (read in one block where mmap is not available), 
+// and the tables are reserved once and filled straight from the mapping. 
+// The log is bound to the tables of users and films, so views need no memory. 
+// Returns ERR_NOT_FOUND if the file can not be opened and ERR_INVALID if 
+// it is not a valid snapshot. On error, the tables are left empty
+tError snapshot_load(const char* path, tSeriesTable* series, tFilmTable* films, 
+                     tUserTable* users, tViewLog* views);
+
+#endif // __SNAPSHOT_H__
@@ -0,0 +1,119 @@
+#ifndef __SYNC_H__
+#define __SYNC_H__
+
+#include <stdbool.h>
+#include "error.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// Synchronization helpers used by the concurrency mode of the tables 
+// (see userTable_setLock, filmTable_setLock and viewLog_setLock)
+
+// Maximum number of different locks a thread can hold at the same time
+#define SYNC_MAX_HELD_LOCKS 8
+
+// Reader-writer lock. Many threads can hold it to read, or a single thread 
+// to write. Locks are reentrant: a thread that holds a lock can take it 
+// again (for reading, or for writing if it holds it for writing), so 
+// functions that take the lock can call each other. A thread that holds 
+// a lock for reading can not take it for writing
+typedef struct tRWLock {
+#ifdef _WIN32
+    SRWLOCK handle;
+#else
+    pthread_rwlock_t handle;
+#endif
+} tRWLock;
+
+// Value of a lock defined with static storage, that does not need rwlock_init
+#ifdef _WIN32
+#define RWLOCK_INITIALIZER { SRWLOCK_INIT }
+#else
+#define RWLOCK_INITIALIZER { PTHREAD_RWLOCK_INITIALIZER }
+#endif
+
+// Event a thread can wait for, until another thread signals it. The count 
+// of signals tells a waiter if it missed one: a thread reads the count, 
+// checks its condition, and waits only if it was not signaled since then
+typedef struct {
+#ifdef _WIN32
+    CRITICAL_SECTION mutex;
+    CONDITION_VARIABLE cond;
+#else
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+#endif
+    unsigned long long count;
+} tEvent;
+
+// Function run by a thread
+typedef void (*tThreadFn)(void* context);
+
+// Thread started with thread_create
+typedef struct {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    tThreadFn fn;
+    void* context;
+} tThread;
+
+// Initialize a reader-writer lock
+tError rwlock_init(tRWLock* lock);
+
+// Release a reader-writer lock, that must not be held by any thread
+void rwlock_free(tRWLock* lock);
+
+// Take a lock for reading. A NULL lock does nothing
+void rwlock_readLock(tRWLock* lock);
+
+// Release a lock taken for reading. A NULL lock does nothing
+void rwlock_readUnlock(tRWLock* lock);
+
+// Take a lock for writing. A NULL lock does nothing
+void rwlock_writeLock(tRWLock* lock);
+
+// Release a lock taken for writing. A NULL lock does nothing
+void rwlock_writeUnlock(tRWLock* lock);
+
+// Add delta to a value shared between threads, as a single atomic 
+// operation. Returns the value before the addition
+unsigned int atomic_fetchAdd(volatile unsigned int* value, unsigned int delta);
+
+// Add delta to a 64 bits value shared between threads, as a single atomic 
+// operation. Returns the value before the addition
+unsigned long long atomic_fetchAdd64(volatile unsigned long long* value, unsigned long long delta);
+
+// Set a 64 bits value shared between threads to desired if it is still equal 
+// to expected, as a single atomic operation. Returns true if it was set
+bool atomic_compareExchange64(volatile unsigned long long* value, unsigned long long expected, unsigned long long desired);
+
+// Initialize an event, that has not been signaled
+tError event_init(tEvent* event);
+
+// Release an event, that must not have waiting threads
+void event_free(tEvent* event);
+
+// Get the number of times an event has been signaled
+unsigned long long event_count(tEvent* event);
+
+// Signal an event, waking all the threads waiting for it
+void event_signal(tEvent* event);
+
+// Wait until an event has been signaled more than count times
+void event_wait(tEvent* event, unsigned long long count);
+
+// Start a thread that runs fn(context). The tThread must be kept 
+// until the thread is joined
+tError thread_create(tThread* thread, tThreadFn fn, void* context);
+
+// Wait for the end of a thread
+void thread_join(tThread* thread);
+
+#endif // __SYNC_H__
@@ -0,0 +1,63 @@
+#ifndef __TABLE_H__
+#define __TABLE_H__
+
+#include <stdbool.h>
+#include "error.h"
+
+// Capacity given to a table the first time it allocates memory
+#define TABLE_INITIAL_CAPACITY 8
+
+// Helpers shared by the dynamic tables of the library (tUserTable, tFilmTable, tViewLog)
+
+// Get the capacity a table must grow to in order to hold at least n elements.
+// The capacity is doubled each time, so appending elements is amortized O(1)
+unsigned int table_growCapacity(unsigned int capacity, unsigned int n);
+
+// Ways to remove an element from a table (tUserTable, tFilmTable)
+typedef enum {
+    // Move all the next elements one position to the front. Keeps the order
+    TABLE_REMOVE_SHIFT = 0,
+    // Move the last element to the position of the removed one. O(1), but 
+    // the order of the elements changes
+    TABLE_REMOVE_SWAP = 1,
+    // Leave the released element in its position as a tombstone. O(1) and 
+    // positions do not change until the table is compacted, which is done 
+    // when at least half of the positions are tombstones
+    TABLE_REMOVE_TOMBSTONE = 2
+} tRemoveMode;
+
+// Check if a table with size positions, with removed of them being 
+// tombstones, must be compacted: at least one and at least half of the 
+// positions are tombstones
+bool table_needsCompaction(unsigned int size, unsigned int removed);
+
+// List of positions of the elements of a table, in the order they were added
+// (postings_swapRemoveAt changes it). Used by the secondary indexes of the tables
+typedef struct {
+    unsigned int size;
+    unsigned int capacity;
+    unsigned int* elements;
+} tPostings;
+
+// Initialize an empty list of positions
+void postings_init(tPostings* postings);
+
+// Release the memory used by a list of positions
+void postings_free(tPostings* postings);
+
+// Add a position at the end of the list
+tError postings_add(tPostings* postings, unsigned int position);
+
+// Remove the position stored at an offset of the list, keeping the order 
+// of the others. The positions after it move one offset to the front
+void postings_removeAt(tPostings* postings, unsigned int offset);
+
+// Remove the position stored at an offset of the list in constant time, 
+// moving the last position of the list to that offset
+void postings_swapRemoveAt(tPostings* postings, unsigned int offset);
+
+// Update the positions of the list after removing the element at a position 
+// of the table and moving all the elements after it one position to the front
+void postings_shift(tPostings* postings, unsigned int position);
+
+#endif // __TABLE_H__
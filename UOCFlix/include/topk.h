@@ -0,0 +1,45 @@
+#ifndef __TOPK_H__
+#define __TOPK_H__
+
+#include <stdbool.h>
+#include "error.h"
+
+// Bounded selection of the K best elements of a sequence. The entries 
+// are kept in a binary min-heap with the worst of them at the root, so 
+// adding an element is O(log K) and only K entries are stored, instead 
+// of sorting the whole sequence to take its first K elements
+
+// Element of a ranking. Higher scores go first, and equal scores are 
+// ordered by lower order (e.g. the position where the element was found)
+typedef struct {
+    long long score;
+    unsigned int order;
+    unsigned int id;
+} tRankEntry;
+
+// The K best elements added so far
+typedef struct {
+    unsigned int k;
+    unsigned int size;
+    tRankEntry* entries;
+} tTopK;
+
+// Initialize an empty selection of the k best elements
+tError topK_init(tTopK* top, unsigned int k);
+
+// Release the memory used by a selection
+void topK_free(tTopK* top);
+
+// Add an element to the selection. It is discarded if it is worse than 
+// the K elements already selected
+void topK_add(tTopK* top, long long score, unsigned int order, unsigned int id);
+
+// Add an element to the selection, or replace the entry with the same id 
+// if the new one is better, so each id is selected at most once. O(K)
+void topK_update(tTopK* top, long long score, unsigned int order, unsigned int id);
+
+// Sort the selected entries from the best to the worst. After sorting, 
+// no more elements can be added
+void topK_sort(tTopK* top);
+
+#endif // __TOPK_H__
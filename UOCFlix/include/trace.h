@@ -0,0 +1,103 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdio.h>
+
+// Instrumentation of the entry points of the library. It is only compiled
+// when UOCFLIX_TRACE is defined (for instance, with -DUOCFLIX_TRACE). When it
+// is not defined, the entry points have no instrumentation at all, and the
+// histograms stay empty unless trace_record is called directly
+// #define UOCFLIX_TRACE
+
+// Bits of precision of the buckets of a histogram. Each power of 2 is split
+// in 2^TRACE_SUB_BITS buckets, so a bucket has a relative error under 12.5%
+#define TRACE_SUB_BITS 3
+
+// Number of buckets of a histogram, to cover any 64 bits value
+#define TRACE_BUCKETS ((64 - TRACE_SUB_BITS + 1) << TRACE_SUB_BITS)
+
+// Number of records a thread keeps on its own before merging them
+#define TRACE_MERGE_INTERVAL 1024
+
+// Instrumented entry points
+typedef enum {
+    TRACE_USER_FIND,
+    TRACE_USER_ADD,
+    TRACE_USER_REMOVE,
+    TRACE_FILM_FIND,
+    TRACE_FILM_ADD,
+    TRACE_FILM_REMOVE,
+    TRACE_VIEW_ADD,
+    TRACE_VIEW_GET_FAV_FILM,
+    TRACE_VIEW_GET_FAV_GENRE,
+    TRACE_VIEW_GET_FAV_FILM_IN_RANGE,
+    TRACE_VIEW_GET_FAV_GENRE_IN_RANGE,
+    TRACE_USER_GET_FAVORITE_GENRE,
+    TRACE_USER_GET_FAVS_LENGTH,
+    TRACE_USER_GET_FAVS_PER_SERIES,
+    TRACE_POINT_QTY
+} tTracePoint;
+
+// Histogram of the latencies of an entry point, in nanoseconds
+typedef struct {
+    // Number of calls
+    unsigned long long count;
+    // Sum of the latencies of all the calls
+    unsigned long long totalNs;
+    // Maximum latency
+    unsigned long long maxNs;
+    // Number of calls of each bucket
+    unsigned long long buckets[TRACE_BUCKETS];
+} tTraceHistogram;
+
+// Function called with the latency of each instrumented call
+typedef void (*tTraceFn)(tTracePoint point, unsigned long long ns, void* context);
+
+#ifdef UOCFLIX_TRACE
+// Start measuring an entry point, keeping its start time in var
+#define TRACE_BEGIN(var) unsigned long long var = trace_now()
+// Record the latency of an entry point started with TRACE_BEGIN(var)
+#define TRACE_END(point, var) trace_record((point), trace_now() - (var))
+#else
+#define TRACE_BEGIN(var)
+#define TRACE_END(point, var)
+#endif
+
+// Get the time of a monotonic clock, in nanoseconds
+unsigned long long trace_now(void);
+
+// Record the latency of a call to an entry point
+void trace_record(tTracePoint point, unsigned long long ns);
+
+// Merge the records of the calling thread in the shared histograms. Threads
+// merge their records every TRACE_MERGE_INTERVAL records, and they must call
+// it before ending to not lose the last ones
+void trace_flush(void);
+
+// Set the function called with each record, or NULL to call none.
+// It is called by the thread that records, so it must be thread safe
+void trace_setCallback(tTraceFn fn, void* context);
+
+// Get the histogram of an entry point, with the records merged until now
+void trace_getHistogram(tTracePoint point, tTraceHistogram* histogram);
+
+// Remove all the records of the shared histograms and of the calling thread
+void trace_reset(void);
+
+// Get the name of an entry point
+const char* trace_pointName(tTracePoint point);
+
+// Write count, mean, percentiles and maximum of each entry point with records
+void trace_dump(FILE* fout);
+
+// Get the bucket of a value
+unsigned int traceHistogram_bucket(unsigned long long value);
+
+// Get the lowest value of a bucket
+unsigned long long traceHistogram_bucketLow(unsigned int bucket);
+
+// Get the value under which are the given fraction (0 to 1) of the records.
+// It is the highest value of its bucket, limited to the maximum latency
+unsigned long long traceHistogram_percentile(const tTraceHistogram* histogram, double fraction);
+
+#endif // __TRACE_H__
@@ -4,18 +4,53 @@
 #include <stdbool.h>
 #include "error.h"
 #include "favorite.h"
+#include "hash.h"
+#include "table.h"
+
+// Number of favorites of a user that belong to a series
+typedef struct {
+    tSeries* series;
+    unsigned int count;
+} tSeriesCount;
+
+// Table with the number of favorites of a user per series, 
+// with a hash index over the title of the series. Only series
+// with favorites have an entry
+typedef struct {
+    unsigned int size;
+    unsigned int capacity;
+    tSeriesCount* elements;
+    tHashIndex index;
+} tSeriesCountTable;
 
 // Data type to hold data related to a User in the platform
+// The username is shared through the pool of interned strings
 typedef struct {
-    char* username;
+    const char* username;
+    // Hash (see hash_string) and length of the username, set by user_init. 
+    // They are kept in the element, so indexing and comparing users do not 
+    // read the string. Users filled by hand, as the temporary users of the 
+    // loaders, have no valid values and can only be added to a table
+    unsigned int usernameHash;
+    unsigned int usernameLength;
     char* name;    
     char* mail;
     tFavoriteStack favorites;
+
+    // Aggregates of the favorites, kept up to date by user_addFavorite and 
+    // user_popFavorite, so queries over the favorites do not walk the stack
+    unsigned int favsPerGenre[GENRE_QTY];
+    unsigned int favsLengthInMin;
+    tSeriesCountTable favsPerSeries;
 } tUser;
 
 // Table of tUser elements
 typedef struct {
     unsigned int size;
+
+    // Number of elements that fit in the allocated memory. It grows 
+    // geometrically, so adding an element is amortized O(1)
+    unsigned int capacity;
     
     // Using static memory, the elements is an array of a fixed length MAX_ELEMENTS. 
     // That means that we are using the same amount of memory when the table is empty and 
@@ -27,9 +62,45 @@ typedef struct {
     // when we want to add elements. We can add as many elements as we want, 
     // the only limit is the total amount of memory of our computer.
     tUser* elements;
+
+    // Hash index over the username of the elements, to find users 
+    // without scanning the whole table
+    tHashIndex index;
+
+    // How users are removed from the table. In TABLE_REMOVE_TOMBSTONE mode, 
+    // removed users stay in the table with a NULL username, and removed is 
+    // the number of them. userTable_size gives the number of users
+    tRemoveMode removeMode;
+    unsigned int removed;
+
+    // Order insensitive fingerprint of the usernames, the sum of the mixed
+    // hashes (see hash_mix64) of the users of the table. Tables with the
+    // same users have the same fingerprint, whatever their order
+    unsigned long long fingerprint;
+
+    // Lock taken by the functions of the table, or NULL if the table is 
+    // only used by one thread (see userTable_setLock)
+    struct tRWLock* lock;
+    // Arena where the memory of the table is allocated, or NULL (see userTable_setArena)
+    struct tArena* arena;
+    // Recommender where the favorites added with userTable_addFavorite are 
+    // counted, or NULL (see userTable_attachRecommender)
+    struct tRecommender* recommender;
+    // Number of bound logs and recommenders that keep the positions of the 
+    // users (see viewLog_bind and recommender_init)
+    unsigned int references;
     
 } tUserTable;
 
+// Reader-writer lock of the tables (see sync.h)
+struct tRWLock;
+
+// Arena of the tables (see arena.h)
+struct tArena;
+
+// Recommender that counts the favorites of the users (see recommend.h)
+struct tRecommender;
+
 // **** Functions related to management of tUser objects
 
 // Initialize a user object
@@ -45,25 +116,40 @@ bool user_equals(tUser* user1, tUser* user2);
 tError user_cpy(tUser* dest, tUser* src);
 
 // Remove the spaces at the beginning and end of the name (or name and surname), 
-// capitalize individual words in string
+// capitalize individual words in string. The name is changed in place
 tError user_trimCapitalizeName(tUser* object);
 
-// Returns series with the most films in favorites for the user
+// Normalize the names of an array of users, as user_trimCapitalizeName. 
+// Used to normalize the records of an import at once
+tError user_trimCapitalizeNames(tUser* objects, unsigned int count);
+
+// Returns genre with the most films in favorites for the user
 // given as parameter. 
-// Will return NULL if user has no favorites yet
+// Will return GENRE_NOT_FOUND if user has no favorites yet
 tGenre user_getFavoriteGenre(tUser *object);
 
-// Recursively get the total length of the movies referenced 
+// Get the total length of the movies referenced 
 // in stack1's favorites 
 unsigned user_getFavsLengthInMin(tUser *object);
 
-// Recursively get the number of favorite films of a serie 
+// Get the number of favorite films of a serie 
 // in stacks favorites
 unsigned user_getFavsCntPerSeries(tUser *user, tSeries * serie);
 
+// Get the k series with the most favorite films of a user, from the most 
+// to the least. In case of a tie, the series that was added first to the 
+// favorites goes first. series must have space for k series, counts (if 
+// not NULL) gets the number of favorites of each series, and count is 
+// the number of series found
+tError user_getTopSeries(tUser* object, unsigned int k, tSeries** series, unsigned int* counts, unsigned int* count);
+
 // Adds a favorite in stack of favorites of the user
 tError user_addFavorite(tUser *object, tFilm film);
 
+// Removes the last favorite added to the stack of favorites of the user
+// If the user has no favorites, will return ERR_INVALID
+tError user_popFavorite(tUser *object);
+
 // **** Functions related to management of tUserTable objects
 
 // Initialize the Table of users
@@ -78,13 +164,77 @@ unsigned int userTable_size(tUserTable* table);
 // Add a new user to the table
 tError userTable_add(tUserTable* table, tUser* user);
 
-// Compare two Table of users
+// Add count users to the table, as userTable_add. Memory for all of them 
+// is reserved once, and the lock of the table is taken once. If results is 
+// not NULL, it gets the result of each user. Returns OK if all the users 
+// were added, or the first error otherwise
+tError userTable_addMany(tUserTable* table, tUser* users, unsigned int count, tError* results);
+
+// Ensure there is memory for at least n users in the table
+tError userTable_reserve(tUserTable* table, unsigned int n);
+
+// Release the memory not used by the elements of the table
+tError userTable_shrinkToFit(tUserTable* table);
+
+// Compare two Table of users. Tables with different fingerprints are 
+// rejected without searching their users. The locks of both tables are 
+// held during the comparison, always taken in the same order
 bool userTable_equals(tUserTable* userTable1, tUserTable* userTable2);
 
-// Get user by username
+// Get user by username. If the table has a lock, the user can be changed or 
+// moved by other threads once the function returns, unless the caller holds 
+// the lock for reading (see userTable_setLock)
 tUser* userTable_find(tUserTable* table, const char* username);
 
-// Remove a user from the table
+// Remove a user from the table. While bound logs or recommenders keep the 
+// positions of the users, the other users can not be moved, so users can 
+// only be removed in TABLE_REMOVE_TOMBSTONE mode and the table is not 
+// compacted. Returns ERR_INVALID in the other modes
 tError userTable_remove(tUserTable* table, tUser* user);
 
+// Select how users are removed from the table. Leaving the 
+// TABLE_REMOVE_TOMBSTONE mode compacts the table, unless bound logs or 
+// recommenders keep the positions of the users
+void userTable_setRemoveMode(tUserTable* table, tRemoveMode mode);
+
+// Remove the tombstones of removed users from the table. 
+// The positions of the users after them change, so it returns ERR_INVALID 
+// while bound logs or recommenders keep the positions of the users
+tError userTable_compact(tUserTable* table);
+
+// Use a reader-writer lock to share the table between threads. Queries 
+// (userTable_find, userTable_size, userTable_equals) take the lock for 
+// reading and can run at the same time, and changes to the table take it 
+// for writing. Locks are reentrant, so a thread can hold the lock around 
+// several calls, e.g. to use the users it finds. The same lock can be used 
+// by several tables. A NULL lock (the default) disables locking
+void userTable_setLock(tUserTable* table, struct tRWLock* lock);
+
+// Allocate the elements, the strings and the indexes of the table in an 
+// arena, so they are all released at once with the arena. The table must 
+// be released before the arena. A NULL arena (the default) uses the 
+// allocator of the library for the next changes
+void userTable_setArena(tUserTable* table, struct tArena* arena);
+
+// Count a bound log or a recommender that keeps the positions of the users 
+// of the table, so they are not moved (see userTable_remove)
+void userTable_addReference(tUserTable* table);
+
+// Stop counting a log or a recommender counted with userTable_addReference
+void userTable_releaseReference(tUserTable* table);
+
+// Add a favorite to the user with a given username, holding the lock of 
+// the table for writing. Returns ERR_NOT_FOUND if the user is not in the table. 
+// The favorite is counted in the recommender of the table, if it has one and 
+// the film is in the table of films of the recommender
+tError userTable_addFavorite(tUserTable* table, const char* username, tFilm film);
+
+// Count the favorites of the users of the table in a recommender bound to it, 
+// starting with the favorites the users already have. A NULL recommender stops 
+// counting them. The recommender is not owned by the table. Favorites removed 
+// with user_popFavorite must be removed from the recommender with 
+// recommender_removeFavorite. Returns ERR_INVALID if the recommender is 
+// bound to another table of users
+tError userTable_attachRecommender(tUserTable* table, struct tRecommender* recommender);
+
 #endif // __USER__H__
\ No newline at end of file
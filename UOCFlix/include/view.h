@@ -5,6 +5,7 @@
 #include "error.h"
 #include "user.h"
 #include "film.h"
+#include "table.h"
 
 typedef struct {
     unsigned short year;
@@ -14,19 +15,98 @@ typedef struct {
     unsigned char minute;
 } tDateTime;
 
+// Timestamp packed in a single integer, as minutes since 1970-01-01 00:00. 
+// Packed timestamps keep the order of the dates, so they can be compared directly
+typedef unsigned int tPackedDateTime;
+
+// Number of minutes in a day, to build ranges of packed timestamps
+#define DATETIME_MINUTES_PER_DAY (24 * 60)
+
 // Data type to hold data related to a View in the platform
 typedef struct {       
     tUser *user;
     tFilm *film;
+    // Position of the user and the film in the tables of a bound tViewLog 
+    // (see viewLog_bind). Views stored in a bound log do not use user and film
+    unsigned int userId;
+    unsigned int filmId;
     tDateTime timestamp;
     unsigned short minutes;
     short score;
 } tView;
 
+// Columnar copy of the views of a bound tViewLog. Each field of the views is 
+// stored in its own array, so queries only read the few bytes per view they need
+typedef struct {
+    unsigned int capacity;
+    unsigned int* userId;
+    unsigned int* filmId;
+    unsigned char* genre;
+    short* score;
+    tPackedDateTime* timestamp;
+    unsigned short* minutes;
+} tViewColumns;
+
+// Entry of the time index of a log: the packed timestamp of a view and its position
+typedef struct {
+    tPackedDateTime timestamp;
+    unsigned int position;
+} tViewTimeEntry;
+
+// Positions of the views of a log sorted by their timestamp. Views with 
+// the same timestamp keep the order in which they were added. The index 
+// always has one entry per view of the log
+typedef struct {
+    unsigned int capacity;
+    tViewTimeEntry* entries;
+} tViewTimeIndex;
+
+// Journal where the views added to a log are written (see journal.h)
+struct tJournal;
+
+// Recommender that counts the views added to a log (see recommend.h)
+struct tRecommender;
+
+// Compressed range of sealed views of a log (see segment.h)
+struct tViewSegment;
+
+// Reader-writer lock of the tables (see sync.h)
+struct tRWLock;
+
+// Arena of the tables (see arena.h)
+struct tArena;
+
 // Table of tView objects
 typedef struct {
     unsigned int size;
+    // Number of elements that fit in the allocated memory
+    unsigned int capacity;
     tView* elements;
+    // Tables that own the users and films referenced by the views. 
+    // If NULL, each view stores its own copy of the user and the film
+    tUserTable* users;
+    tFilmTable* films;
+    // Columnar copy of the views, or NULL if not enabled (see viewLog_enableColumns)
+    tViewColumns* columns;
+    // Positions of the views of each user, indexed by the position of the user 
+    // in the table of users, or NULL if not enabled (see viewLog_enableUserIndex)
+    tPostings* byUser;
+    unsigned int byUserCount;
+    // Views sorted by timestamp, or NULL if not enabled (see viewLog_enableTimeIndex)
+    tViewTimeIndex* byTime;
+    // Journal where the added views are written, or NULL (see viewLog_attachJournal)
+    struct tJournal* journal;
+    // Recommender where the added views are counted, or NULL (see viewLog_attachRecommender)
+    struct tRecommender* recommender;
+    // Oldest views of the log, sealed in compressed segments (see viewLog_seal). 
+    // They are before the views of elements, and sealedSize is their number
+    unsigned int segmentCount;
+    struct tViewSegment* segments;
+    unsigned int sealedSize;
+    // Lock taken by the functions of the log, or NULL (see viewLog_setLock)
+    struct tRWLock* lock;
+    // Arena where the memory of the log is allocated, or NULL (see viewLog_setArena)
+    struct tArena* arena;
 } tViewLog;
 
 // **** Functions related to management of tView objects
@@ -34,6 +114,10 @@ typedef struct {
 // Initialize a tView object
 tError view_init(tView* view, tDateTime *timestamp, short score, tUser *user, tFilm *film); 
     
+// Initialize a tView object that references the user and the film, without 
+// copying them. As it owns no memory, it must not be released with view_free
+void view_initRef(tView* view, tDateTime *timestamp, short score, tUser *user, tFilm *film);
+
 // Free the resources stored by an existing tView object
 void view_free(tView* object);
 
@@ -42,12 +126,98 @@ void view_free(tView* object);
 // Add a new visualization in the table, received as a parameter.
 tError viewLog_add(tViewLog* table, tView* view);
 
+// Add count views to the table, as userTable_addMany
+tError viewLog_addMany(tViewLog* table, tView* views, unsigned int count, tError* results);
+
 // Initializes a visualization table.
 void viewLog_init(tViewLog* table);
 
-// Release memory stored by an existing tViewLog object
+// Release memory stored by an existing tViewLog object. A bound log is 
+// unbound from its tables, that can move their elements again
 void viewLog_free(tViewLog* table);
 
+// Bind an empty log to the tables that own the users and the films. 
+// Views added to a bound log only store the position of their user and 
+// film in these tables, so adding views does not copy any data. Moving 
+// any user or film would change the user or film of the views, their 
+// indexes and columns and their sealed segments, so until viewLog_free the 
+// tables only remove elements in TABLE_REMOVE_TOMBSTONE mode and are not 
+// compacted (see userTable_remove). Removing a user or a film invalidates 
+// the views that reference it.
+tError viewLog_bind(tViewLog* table, tUserTable* users, tFilmTable* films);
+
+// Get the user of the view at a given position of the log
+tUser* viewLog_getUser(tViewLog* table, unsigned int position);
+
+// Get the film of the view at a given position of the log
+tFilm* viewLog_getFilm(tViewLog* table, unsigned int position);
+
+// Keep a columnar copy of the views of a bound log, with parallel arrays of 
+// user, film, genre, score, packed timestamp and minutes. Once enabled, 
+// views are added to both representations and queries scan the columns. 
+// Returns ERR_INVALID if the log is not bound.
+tError viewLog_enableColumns(tViewLog* table);
+
+// Keep an index with the positions of the views of each user of a bound log, 
+// so per-user queries only visit the views of that user. 
+// Returns ERR_INVALID if the log is not bound.
+tError viewLog_enableUserIndex(tViewLog* table);
+
+// Get the positions of the views of a user, in the order they were added. 
+// The user index must be enabled. Returns NULL if the user has no views
+tPostings* viewLog_getUserViews(tViewLog* table, tUser* user);
+
+// Keep an index with the views of the log sorted by their timestamp, 
+// so queries on a range of time only visit the views in that range. 
+// Views are usually added in order, so adding them to the index is cheap
+tError viewLog_enableTimeIndex(tViewLog* table);
+
+// Get the views with a timestamp in the range [from, to), sorted by timestamp. 
+// first points to the first entry of the time index in the range, and count 
+// is the number of entries. The entries are valid until the log is modified. 
+// Returns ERR_INVALID if the time index is not enabled.
+tError viewLog_findRange(tViewLog* table, tPackedDateTime from, tPackedDateTime to, 
+                        const tViewTimeEntry** first, unsigned int* count);
+
+// Write each view added to a bound log to a journal, that must be open. 
+// A NULL journal stops writing them. The journal is not owned by the log. 
+// Returns ERR_INVALID if the log is not bound.
+tError viewLog_attachJournal(tViewLog* table, struct tJournal* journal);
+
+// Count the views of a bound log in a recommender bound to the same tables, 
+// starting with the views already in the log. A NULL recommender stops 
+// counting them. The recommender is not owned by the log. Returns ERR_INVALID 
+// if the log is not bound to the tables of the recommender
+tError viewLog_attachRecommender(tViewLog* table, struct tRecommender* recommender);
+
+// Use a reader-writer lock to share the log between threads, as 
+// userTable_setLock. Queries take the lock for reading and can run at the 
+// same time. Queries read the tables of a bound log, so they must use the 
+// same lock as the log. A NULL lock (the default) disables locking
+void viewLog_setLock(tViewLog* table, struct tRWLock* lock);
+
+// Allocate the views, their copies and the indexes of the log in an arena, 
+// as userTable_setArena. Useful for batches of views released together
+void viewLog_setArena(tViewLog* table, struct tArena* arena);
+
+// Ensure there is memory for at least n views in the table
+tError viewLog_reserve(tViewLog* table, unsigned int n);
+
+// Move the oldest views of a bound log, the first ones with a timestamp 
+// before a given one, to a new compressed segment (see segment.h). 
+// viewLog_getFavFilm, viewLog_getFavGenre, their versions in a range of 
+// time, viewLog_getTopFilms and the reports (see report.h) read the sealed 
+// views too. The rest only see the views not sealed: size, the positions 
+// of viewLog_getUser and viewLog_getFilm, and the indexes and columns, 
+// that are updated to the new positions. Views are counted by the journal 
+// and the recommender when they are added, so they must be attached before 
+// sealing. viewLog_shrinkToFit releases the memory of the sealed views. 
+// Returns ERR_INVALID if the log is not bound
+tError viewLog_seal(tViewLog* table, tPackedDateTime before);
+
+// Release the memory not used by the elements of the table
+tError viewLog_shrinkToFit(tViewLog* table);
+
 // Given a username and a table of type tViewLog, it performs a search 
 // of the episode with the highest score (not negative) displayed by the 
 // user, offering us a pointer to it. In case of a tie, offer among the 
@@ -61,7 +231,33 @@ tFilm *viewLog_getFavFilm(tViewLog* object, tUser* user);
 // visualizations, return ERR_NOT_FOUND.
 tGenre viewLog_getFavGenre(tViewLog* table, tUser* user); 
 
-// helper func to get tDateTime for a given timestamp in year, month...
+// Same as viewLog_getFavFilm, but only for the views with a timestamp 
+// in the range [from, to)
+tFilm* viewLog_getFavFilmInRange(tViewLog* table, tUser* user, tPackedDateTime from, tPackedDateTime to);
+
+// Same as viewLog_getFavGenre, but only for the views with a timestamp 
+// in the range [from, to)
+tGenre viewLog_getFavGenreInRange(tViewLog* table, tUser* user, tPackedDateTime from, tPackedDateTime to);
+
+// Get the k films with the highest (positive) score viewed by a user of a 
+// bound log, from the best to the worst. Each film appears once, with the 
+// best score of its views. Ties are solved as in viewLog_getFavFilm, so 
+// the first film is the favorite film. films must have space for k films, 
+// and count is the number of films found. Returns ERR_INVALID if the log is not bound
+tError viewLog_getTopFilms(tViewLog* table, tUser* user, unsigned int k, tFilm** films, unsigned int* count);
+
+// Pack a tDateTime into minutes since 1970-01-01 00:00
+tPackedDateTime dateTime_pack(tDateTime* timestamp);
+
+// Get the tDateTime of a packed timestamp
+tDateTime dateTime_unpack(tPackedDateTime packed);
+
+// Get the tDateTime for a given day, month, year, hour and minute
+tDateTime dateTime_make(unsigned char day, unsigned char month, unsigned short year, 
+                        unsigned char hour, unsigned char minute);
+
+// helper func to get tDateTime for a given timestamp in year, month... 
+// The result is allocated with malloc. Prefer dateTime_make, that does not allocate memory
 tDateTime* setDateTime(unsigned char day, unsigned char month, unsigned short year, 
                         unsigned char hour, unsigned char minute);
 
@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "arena.h"
+#include "mem.h"
+
+// Alignment of the blocks of an arena, the same than the blocks of malloc
+#define ARENA_ALIGNMENT 16
+
+// Size of the header of a chunk, keeping its blocks aligned
+#define ARENA_CHUNK_HEADER ((sizeof(tArenaChunk) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+// Get a block of the arena given as context, with the signature of an allocator
+static void* arena_allocate(size_t size, void* context) {
+    return arena_alloc((tArena*)context, size);
+}
+
+// Initialize an empty arena, with chunks of chunkSize bytes (0 for the default size)
+void arena_init(tArena* arena, size_t chunkSize) {
+    // Verify pre conditions
+    assert(arena != NULL);
+
+    // Blocks are released with the arena, so there is no release function
+    arena->allocator.allocate = arena_allocate;
+    arena->allocator.reallocate = NULL;
+    arena->allocator.release = NULL;
+    arena->allocator.context = arena;
+
+    arena->chunks = NULL;
+    arena->chunkSize = (chunkSize == 0) ? ARENA_DEFAULT_CHUNK_SIZE : chunkSize;
+    arena->used = 0;
+    arena->reserved = 0;
+}
+
+// Release all the memory of the arena
+void arena_free(tArena* arena) {
+    tArenaChunk* chunk;
+
+    // Verify pre conditions
+    assert(arena != NULL);
+
+    while (arena->chunks != NULL) {
+        chunk = arena->chunks;
+        arena->chunks = chunk->next;
+        mem_free(chunk);
+    }
+    arena->used = 0;
+    arena->reserved = 0;
+}
+
+// Get a block from the arena. Returns NULL if there is no memory
+void* arena_alloc(tArena* arena, size_t size) {
+    tArenaChunk* chunk;
+    const tAllocator* previous;
+    size_t capacity;
+    void* block;
+
+    // Verify pre conditions
+    assert(arena != NULL);
+
+    if (size > (size_t)-1 - ARENA_CHUNK_HEADER - ARENA_ALIGNMENT) {
+        return NULL;
+    }
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    // Start a new chunk if the block does not fit in the current one.
+    // Blocks bigger than a chunk get a chunk of their own
+    chunk = arena->chunks;
+    if (chunk == NULL || chunk->capacity - chunk->used < size) {
+        capacity = (size > arena->chunkSize) ? size : arena->chunkSize;
+
+        // The chunks are taken from the allocator of the library, not from the arena
+        previous = mem_setThreadAllocator(NULL);
+        chunk = (tArenaChunk*)mem_alloc(MEM_ARENA, ARENA_CHUNK_HEADER + capacity);
+        mem_setThreadAllocator(previous);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        chunk->capacity = capacity;
+        chunk->used = 0;
+        arena->reserved += capacity;
+
+        // A chunk of a big block is placed after the current one, so the
+        // free space of the current one can still be used
+        if (arena->chunks != NULL && capacity > arena->chunkSize) {
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+        } else {
+            chunk->next = arena->chunks;
+            arena->chunks = chunk;
+        }
+    }
+
+    block = (char*)chunk + ARENA_CHUNK_HEADER + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+
+    return block;
+}
+
+// Get the bytes of the blocks given by the arena
+size_t arena_used(tArena* arena) {
+    // Verify pre conditions
+    assert(arena != NULL);
+
+    return arena->used;
+}
+
+// Make the blocks of the calling thread be allocated in an arena
+const tAllocator* arena_enter(tArena* arena) {
+    if (arena == NULL) {
+        return mem_getThreadAllocator();
+    }
+    return mem_setThreadAllocator(&arena->allocator);
+}
+
+// Restore the allocator of the calling thread that was in use before arena_enter
+void arena_leave(const tAllocator* previous) {
+    mem_setThreadAllocator(previous);
+}
@@ -4,6 +4,107 @@
 #include <limits.h>
 #include "favorite.h"
 #include "film.h"
+#include "mem.h"
+#include "hash.h"
+
+// Storage class of the variables that are private to each thread
+#if defined(_MSC_VER)
+#define FAVORITE_THREAD_LOCAL __declspec(thread)
+#else
+#define FAVORITE_THREAD_LOCAL __thread
+#endif
+
+// Pool of free nodes of favorite stacks. Popped nodes are kept in a free list
+// and reused by the next pushes, so in steady state push and pop do not call
+// the system allocator. Each thread has its own pool, so no locks are needed.
+// Nodes are allocated one by one, so a stack can be released by any thread.
+// The title of the film of a free node is released when the node is reused
+// (or when the pool is released), so whole chains can be returned in O(1)
+typedef struct {
+    tFavoriteStackNode *free;
+    unsigned int available;
+} tFavoriteNodePool;
+
+static FAVORITE_THREAD_LOCAL tFavoriteNodePool favoriteNodePool = { NULL, 0 };
+
+// Allocate a new node with no film
+static tFavoriteStackNode* favoriteNodePool_newNode(void) {
+    tFavoriteStackNode *node;
+    const tAllocator* previous;
+
+    // Released nodes are kept in the pool after their stack is released, 
+    // so they are never allocated in the arena of a table
+    previous = mem_setThreadAllocator(NULL);
+    node = (tFavoriteStackNode *)mem_alloc(MEM_FAVORITE, sizeof(tFavoriteStackNode));
+    mem_setThreadAllocator(previous);
+    if (node != NULL) {
+        node->e.film.title = NULL;
+        node->next = NULL;
+    }
+
+    return node;
+}
+
+// Get a node from the pool, or from the system allocator if the pool is empty
+static tFavoriteStackNode* favoriteNodePool_get(void) {
+    tFavoriteStackNode *node;
+
+    if (favoriteNodePool.free == NULL) {
+        return favoriteNodePool_newNode();
+    }
+
+    node = favoriteNodePool.free;
+    favoriteNodePool.free = node->next;
+    favoriteNodePool.available--;
+
+    // Release the film of the previous use of the node
+    film_free(&node->e.film);
+    node->next = NULL;
+
+    return node;
+}
+
+// Return a chain of count nodes, from first to last, to the pool
+static void favoriteNodePool_put(tFavoriteStackNode *first, tFavoriteStackNode *last, unsigned int count) {
+    last->next = favoriteNodePool.free;
+    favoriteNodePool.free = first;
+    favoriteNodePool.available += count;
+}
+
+// Add n free nodes to the pool of nodes of the calling thread, so the next
+// n pushes do not need to call the system allocator
+tError favoriteNodePool_reserve(unsigned int n) {
+    tFavoriteStackNode *node;
+
+    while (n > 0) {
+        node = favoriteNodePool_newNode();
+        if (node == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+        favoriteNodePool_put(node, node, 1);
+        n--;
+    }
+
+    return OK;
+}
+
+// Get the number of free nodes in the pool of nodes of the calling thread
+unsigned int favoriteNodePool_available(void) {
+    return favoriteNodePool.available;
+}
+
+// Release the free nodes of the pool of nodes of the calling thread
+void favoriteNodePool_release(void) {
+    tFavoriteStackNode *node;
+
+    while (favoriteNodePool.free != NULL) {
+        node = favoriteNodePool.free;
+        favoriteNodePool.free = node->next;
+        film_free(&node->e.film);
+        mem_free(node);
+    }
+    favoriteNodePool.available = 0;
+}
 
 // Initialize a tFavorite object
 tError favorite_init(tFavorite *object, tFilm film) {
@@ -52,8 +153,12 @@ tError favoriteStack_duplicate(tFavoriteStack *dst, tFavoriteStack src) {
    if(nodeR == NULL)
        return OK;  // leave empty, as original stack is empty
    
-   dst->first = (tFavoriteStackNode*)malloc(sizeof(tFavoriteStackNode));
+   dst->first = favoriteNodePool_get();
+   if(dst->first == NULL)
+       return ERR_MEMORY_ERROR;
    nodeW = dst->first;
+   dst->last = nodeW;
+   dst->count = 1;
    
    while(1) {
        favorite_duplicate(&(nodeW->e), nodeR->e);
@@ -61,13 +166,15 @@ tError favoriteStack_duplicate(tFavoriteStack *dst, tFavoriteStack src) {
        // Create new node in new stack, if still another node
        // in input stack
        if(nodeR->next != NULL) {
-           nodeW->next = (tFavoriteStackNode*)malloc(sizeof(tFavoriteStackNode));
+           nodeW->next = favoriteNodePool_get();
            
            if(nodeW->next == NULL)
                return ERR_MEMORY_ERROR;
            
            // place write pointer
            nodeW = nodeW->next;
+           dst->last = nodeW;
+           dst->count++;
            // move read pointer to next position
            nodeR = nodeR->next;
        } else {
@@ -76,6 +183,9 @@ tError favoriteStack_duplicate(tFavoriteStack *dst, tFavoriteStack src) {
        }
    }
    
+   // Same films in the same order
+   dst->fingerprint = src.fingerprint;
+   
    return OK;
 }
 
@@ -86,6 +196,9 @@ void favoriteStack_create(tFavoriteStack *stack) {
     assert(stack != NULL);
     
     stack->first = NULL;
+    stack->last = NULL;
+    stack->count = 0;
+    stack->fingerprint = 0;
 }
 
 // Will return true if stack is empty
@@ -101,14 +214,22 @@ tError favoriteStack_push(tFavoriteStack *stack, tFavorite favorite) {
     assert(stack != NULL);
         
     tFavoriteStackNode *tmp;
-    tmp = (tFavoriteStackNode *)malloc(sizeof(tFavoriteStackNode));
+    tmp = favoriteNodePool_get();
     
     if (tmp == NULL) {
         return ERR_MEMORY_ERROR;
     } else {
-        favorite_duplicate(&tmp->e, favorite);
+        if (favorite_duplicate(&tmp->e, favorite) != OK) {
+            favoriteNodePool_put(tmp, tmp, 1);
+            return ERR_MEMORY_ERROR;
+        }
         tmp->next = stack->first;
         stack->first = tmp;
+        if (stack->last == NULL) {
+            stack->last = tmp;
+        }
+        stack->count++;
+        stack->fingerprint = stack->fingerprint * FAVORITE_FINGERPRINT_MULTIPLIER + hash_mix64(tmp->e.film.titleHash);
     }
     return OK;
 }
@@ -141,7 +262,13 @@ tError favoriteStack_pop(tFavoriteStack *stack) {
     } else {
         tmp = stack->first;
         stack->first = stack->first->next;
-        free(tmp);
+        if (stack->first == NULL) {
+            stack->last = NULL;
+        }
+        stack->count--;
+        stack->fingerprint = (stack->fingerprint - hash_mix64(tmp->e.film.titleHash)) * FAVORITE_FINGERPRINT_INVERSE;
+        // The film of the node is released when the node is reused
+        favoriteNodePool_put(tmp, tmp, 1);
     }
 
     return OK;
@@ -153,30 +280,87 @@ void favoriteStack_free(tFavoriteStack *stack) {
     // PR2 EX2
     assert(stack != NULL);
     
-    while(stack->first){
-        favoriteStack_pop(stack);
+    // Return the whole chain of nodes to the pool at once
+    if (stack->first != NULL) {
+        favoriteNodePool_put(stack->first, stack->last, stack->count);
+    }
+    favoriteStack_create(stack);
+
+}
+
+// Initialize an iterator placed at the top of the stack
+void favoriteStackIterator_init(tFavoriteStackIterator *it, const tFavoriteStack *stack) {
+    assert(it != NULL);
+    assert(stack != NULL);
+
+    it->node = stack->first;
+}
+
+// Will return true if the iterator still has elements to visit
+bool favoriteStackIterator_hasNext(const tFavoriteStackIterator *it) {
+    assert(it != NULL);
+
+    return (it->node != NULL);
+}
+
+// Returns a pointer to the next element and moves the iterator forward.
+// The element belongs to the stack, it must not be modified or released
+const tFavorite* favoriteStackIterator_next(tFavoriteStackIterator *it) {
+    const tFavorite *favorite;
+
+    assert(it != NULL);
+    assert(it->node != NULL);
+
+    favorite = &(it->node->e);
+    it->node = it->node->next;
+
+    return favorite;
+}
+
+// Call a function for each element of the stack, from the top to the bottom,
+// without modifying the stack. Returns false if the function stopped the iteration
+bool favoriteStack_foreach(const tFavoriteStack *stack, tFavoriteFn fn, void *context) {
+    tFavoriteStackIterator it;
+
+    assert(stack != NULL);
+    assert(fn != NULL);
+
+    favoriteStackIterator_init(&it, stack);
+    while (favoriteStackIterator_hasNext(&it)) {
+        if (!fn(favoriteStackIterator_next(&it), context)) {
+            return false;
+        }
     }
 
+    return true;
 }
 
 // Compare two favorites stack
 bool favoriteStack_compare(tFavoriteStack stack1, tFavoriteStack stack2) {
-    bool equals;
-    tFavoriteStack f1_dup, f2_dup;
+    tFavoriteStackIterator it1, it2;
+    const tFavorite *f1, *f2;
+
+    // Stacks with different sizes or fingerprints are different
+    if (stack1.count != stack2.count || stack1.fingerprint != stack2.fingerprint) {
+        return false;
+    }
 
-    // Make a copy of the stacks to avoid modifications
-    favoriteStack_duplicate(&f1_dup, stack1);
-    favoriteStack_duplicate(&f2_dup, stack2);
+    // Walk both stacks in place, no copies are needed as they are not modified
+    favoriteStackIterator_init(&it1, &stack1);
+    favoriteStackIterator_init(&it2, &stack2);
 
-    // Compare both queues
-    //equals = favoriteStack_compareRecursive(&f1_dup, &f2_dup);
-    equals = favoriteStack_compareIterative(&f1_dup, &f2_dup);
+    while (favoriteStackIterator_hasNext(&it1) && favoriteStackIterator_hasNext(&it2)) {
+        f1 = favoriteStackIterator_next(&it1);
+        f2 = favoriteStackIterator_next(&it2);
 
-    // Remove the remaining elements
-    favoriteStack_free(&f1_dup);
-    favoriteStack_free(&f2_dup);
+        if (!film_equals((tFilm*)&f1->film, (tFilm*)&f2->film)) {
+            // The elements are different.
+            return false;
+        }
+    }
 
-    return equals;
+    // Stacks are equal only if both have the same number of elements
+    return !favoriteStackIterator_hasNext(&it1) && !favoriteStackIterator_hasNext(&it2);
 }
 
 // Iteratively compares two stacks
@@ -272,55 +456,54 @@ bool favorite_compare(tFavorite f1, tFavorite f2) {
     return film_equals(&f1.film, &f2.film);
 }
 
+// Add the length of a favorite to the total given as context
+static bool favoriteStack_addLength(const tFavorite *favorite, void *context) {
+    *(unsigned*)context += favorite->film.lengthInMin;
+    return true;
+}
+
 // Recursively get the total length of the movies referenced 
+// Note: kept with its original name, but the stack is walked in place
+// so deep stacks do not need copies or a deep call stack
 unsigned favoriteStack_getFavsLengthInMinRecursive(tFavoriteStack *stack) {
     // PR2 EX3
     assert(stack != NULL);
     unsigned res = 0;
-    tFavorite temp;
-    tFavoriteStack tempStack;
-    
-    // we work with a compy so we don't pop data from original stack
-    favoriteStack_duplicate(&tempStack, *stack);
-    
-    if(favoriteStack_empty(tempStack)){
-        return res;
+
+    favoriteStack_foreach(stack, favoriteStack_addLength, &res);
+
+    return res;
+}
+
+// Context used to count the favorites of a series
+typedef struct {
+    tSeries *series;
+    unsigned count;
+} tFavoriteSeriesCount;
+
+// Count a favorite if it belongs to the series given in the context
+static bool favoriteStack_countSeries(const tFavorite *favorite, void *context) {
+    tFavoriteSeriesCount *counter = (tFavoriteSeriesCount*)context;
+
+    if (favorite->film.series == counter->series || series_equals(favorite->film.series, counter->series)) {
+        counter->count++;
     }
-    
-    favoriteStack_top(&temp, tempStack);
-    
-    res = temp.film.lengthInMin;
-    
-    favoriteStack_pop(&tempStack);
-    
-    return res + favoriteStack_getFavsLengthInMinRecursive(&tempStack);
+    return true;
 }
 
 // Recursively get number of favorite films of a series
+// Note: kept with its original name, but the stack is walked in place
 unsigned favoriteStack_getFavsCntPerSeriesRecursive(tFavoriteStack *stack, tSeries *serie) {
     // PR2 EX3
     assert(stack != NULL);
     assert(serie != NULL);
-    unsigned res = 0;
-    tFavorite temp;
-    tFavoriteStack tempStack;
-    
-    // we work with a compy so we don't pop data from original stack
-    favoriteStack_duplicate(&tempStack, *stack);
-    
-    if (favoriteStack_empty(tempStack)){
-        return res;
-    }
-    
-    favoriteStack_top(&temp, tempStack);
-    
-    if (series_equals(temp.film.series, serie)){
-        res = 1;
-    }
-    
-    favoriteStack_pop(&tempStack);
-    
-    return res + favoriteStack_getFavsCntPerSeriesRecursive(&tempStack, serie);
+    tFavoriteSeriesCount counter;
+
+    counter.series = serie;
+    counter.count = 0;
+    favoriteStack_foreach(stack, favoriteStack_countSeries, &counter);
+
+    return counter.count;
 }
 
 // Helper function - Print a stack in the console - use for debugging
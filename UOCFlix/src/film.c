@@ -3,6 +3,191 @@
 #include <assert.h>
 #include "series.h"
 #include "film.h"
+#include "table.h"
+#include "hash.h"
+#include "intern.h"
+#include "sync.h"
+#include "mem.h"
+#include "trace.h"
+#include "arena.h"
+
+// Get the key used by the hash index of a table of films
+static const char* filmTable_getKey(void* table, unsigned int position) {
+    return ((tFilmTable*)table)->elements[position].title;
+}
+
+// Get the key used by the hash index of the series of a table of films
+static const char* seriesFilmsIndex_getKey(void* index, unsigned int position) {
+    return ((tSeriesFilmsIndex*)index)->elements[position].series->title;
+}
+
+// Get the entry of the films of a series, or NULL if the series has no entry yet
+static tSeriesFilms* filmTable_findSeriesFilms(tFilmTable* table, tSeries* series) {
+    unsigned int position;
+    unsigned int i;
+    tSeriesFilms* entry;
+
+    if (!hashIndex_find(&table->bySeries.index, series->title, hash_string(series->title), 
+            seriesFilmsIndex_getKey, &table->bySeries, &position)) {
+        return NULL;
+    }
+
+    // Series are equal if they have the same title and genre
+    entry = &(table->bySeries.elements[position]);
+    if (entry->series == series || series_equals(entry->series, series)) {
+        return entry;
+    }
+
+    // Same title but other genre. Not expected in a catalog, but also supported
+    for (i = 0; i < table->bySeries.size; i++) {
+        entry = &(table->bySeries.elements[i]);
+        if (series_equals(entry->series, series)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+// Remove the entry of a series with no films. Entries borrow the series of 
+// their first film, which can be released once the series has no films. 
+// The last entry takes its place
+static void filmTable_removeSeriesFilms(tFilmTable* table, tSeriesFilms* entry) {
+    tSeriesFilmsIndex* bySeries = &table->bySeries;
+    unsigned int position = (unsigned int)(entry - bySeries->elements);
+    tSeriesFilms* last;
+
+    postings_free(&entry->films);
+    hashIndex_removePosition(&bySeries->index, hash_string(entry->series->title), position);
+    bySeries->size--;
+    if (position != bySeries->size) {
+        last = &(bySeries->elements[bySeries->size]);
+        hashIndex_updatePosition(&bySeries->index, hash_string(last->series->title), bySeries->size, position);
+        *entry = *last;
+    }
+}
+
+// Add the film at a position of the table to the indexes of genres and series
+static tError filmTable_indexFilm(tFilmTable* table, unsigned int position) {
+    tSeries* series = table->elements[position].series;
+    tSeriesFilmsIndex* bySeries = &table->bySeries;
+    tSeriesFilms* entry;
+    tSeriesFilms* elements;
+    tFilmOffsets* offsets;
+    unsigned int capacity;
+
+    // The offsets follow the capacity of the table, which already has space for the film
+    if (position >= table->offsetsCapacity) {
+        offsets = (tFilmOffsets*)mem_realloc(MEM_INDEX, table->offsets, table->capacity * sizeof(tFilmOffsets));
+        if (offsets == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+        table->offsets = offsets;
+        table->offsetsCapacity = table->capacity;
+    }
+
+    table->offsets[position].genre = table->byGenre[series->genre].size;
+    if (postings_add(&table->byGenre[series->genre], position) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // First film of this series, add a new entry
+    entry = filmTable_findSeriesFilms(table, series);
+    if (entry == NULL) {
+        if (bySeries->size == bySeries->capacity) {
+            capacity = table_growCapacity(bySeries->capacity, bySeries->size + 1);
+            elements = (tSeriesFilms*)mem_realloc(MEM_FILM, bySeries->elements, capacity * sizeof(tSeriesFilms));
+            if (elements == NULL) {
+                table->byGenre[series->genre].size--;
+                return ERR_MEMORY_ERROR;
+            }
+            bySeries->elements = elements;
+            bySeries->capacity = capacity;
+        }
+        if (hashIndex_insert(&bySeries->index, hash_string(series->title), bySeries->size) != OK) {
+            table->byGenre[series->genre].size--;
+            return ERR_MEMORY_ERROR;
+        }
+        entry = &(bySeries->elements[bySeries->size]);
+        entry->series = series;
+        postings_init(&entry->films);
+        bySeries->size++;
+    }
+
+    table->offsets[position].series = entry->films.size;
+    if (postings_add(&entry->films, position) != OK) {
+        table->byGenre[series->genre].size--;
+        if (entry->films.size == 0) {
+            filmTable_removeSeriesFilms(table, entry);
+        }
+        return ERR_MEMORY_ERROR;
+    }
+
+    return OK;
+}
+
+// Remove the film at a position of the table from the indexes of genres 
+// and series. In TABLE_REMOVE_SHIFT mode the lists keep their order, and 
+// the offsets of the films after it are updated. Otherwise the last film 
+// of each list takes its offset, in constant time
+static void filmTable_unindexFilm(tFilmTable* table, unsigned int position) {
+    tSeries* series = table->elements[position].series;
+    tPostings* genreFilms = &table->byGenre[series->genre];
+    tSeriesFilms* entry = filmTable_findSeriesFilms(table, series);
+    tPostings* seriesFilms = &(entry->films);
+    unsigned int genreOffset = table->offsets[position].genre;
+    unsigned int seriesOffset = table->offsets[position].series;
+    unsigned int i;
+
+    if (table->removeMode == TABLE_REMOVE_SHIFT) {
+        postings_removeAt(genreFilms, genreOffset);
+        for (i = genreOffset; i < genreFilms->size; i++) {
+            table->offsets[genreFilms->elements[i]].genre = i;
+        }
+        postings_removeAt(seriesFilms, seriesOffset);
+        for (i = seriesOffset; i < seriesFilms->size; i++) {
+            table->offsets[seriesFilms->elements[i]].series = i;
+        }
+    }
+    else {
+        postings_swapRemoveAt(genreFilms, genreOffset);
+        if (genreOffset < genreFilms->size) {
+            table->offsets[genreFilms->elements[genreOffset]].genre = genreOffset;
+        }
+        postings_swapRemoveAt(seriesFilms, seriesOffset);
+        if (seriesOffset < seriesFilms->size) {
+            table->offsets[seriesFilms->elements[seriesOffset]].series = seriesOffset;
+        }
+    }
+
+    if (seriesFilms->size == 0) {
+        filmTable_removeSeriesFilms(table, entry);
+    }
+}
+
+// Release the indexes of genres and series of a table
+static void filmTable_freeIndexes(tFilmTable* table) {
+    unsigned int i;
+
+    for (i = 0; i < GENRE_QTY; i++) {
+        postings_free(&table->byGenre[i]);
+    }
+    for (i = 0; i < table->bySeries.size; i++) {
+        postings_free(&(table->bySeries.elements[i].films));
+    }
+    if (table->bySeries.elements != NULL) {
+        mem_free(table->bySeries.elements);
+        table->bySeries.elements = NULL;
+    }
+    table->bySeries.size = 0;
+    table->bySeries.capacity = 0;
+    hashIndex_free(&table->bySeries.index);
+    if (table->offsets != NULL) {
+        mem_free(table->offsets);
+        table->offsets = NULL;
+    }
+    table->offsetsCapacity = 0;
+}
 
 // Initialize the user structure
 tError film_init(tFilm* object, const char* title, const unsigned int lengthInMin, tSeries *series) {
@@ -11,14 +196,16 @@ tError film_init(tFilm* object, const char* title, const unsigned int lengthInMi
     assert(object != NULL);
     assert(series != NULL);
 
-    object->title = (char*)malloc((strlen(title) + 1) * sizeof(char));
+    // Films with the same title share the same copy of the title
+    object->title = intern_acquire(title);
 
     if (object->title == NULL) {
         return ERR_MEMORY_ERROR;
     }
 
-    strcpy(object->title, title);
-
+    object->titleHash = intern_hash(object->title);
+    object->titleLength = (unsigned short)((intern_length(object->title) > FILM_MAX_TITLE_LENGTH) 
+            ? FILM_MAX_TITLE_LENGTH : intern_length(object->title));
     object->lengthInMin = lengthInMin;
     object->series = series;
 
@@ -32,11 +219,9 @@ void film_free(tFilm* object) {
     // Verify pre conditions
     assert(object != NULL);
 
-    // All memory allocated with malloc and realloc needs to be freed 
-    // using the free command. In this case, as we use malloc to 
-    // allocate the fields, we have to free them
+    // The title is shared, so only our reference to it is released
     if (object->title != NULL) {
-        free(object->title);
+        intern_release(object->title);
         object->title = NULL;
     }
 }
@@ -48,7 +233,10 @@ bool film_equals(tFilm* film1, tFilm* film2) {
     assert(film1 != NULL);
     assert(film2 != NULL);
 
-    if (strcmp(film1->title, film2->title) != 0) {
+    // Interned titles are equal if they are the same pointer. Different 
+    // hashes or lengths tell they are different without reading them
+    if (film1->title != film2->title && (film1->titleHash != film2->titleHash
+            || film1->titleLength != film2->titleLength || strcmp(film1->title, film2->title) != 0)) {
         // Titles are different
         return false;
     }
@@ -67,9 +255,7 @@ tError film_cpy(tFilm* dst, tFilm* src) {
     film_free(dst);
 
     // Initialize the element with the new data
-    film_init(dst, src->title, src->lengthInMin, src->series);
-
-    return ERR_NOT_IMPLEMENTED;
+    return film_init(dst, src->title, src->lengthInMin, src->series);
 }
 
 
@@ -86,6 +272,7 @@ tSeries* film_getSeries(tFilm* object) {
 
 // Initializes a table of films
 void filmTable_init(tFilmTable* table) {
+    unsigned int i;
 
     // Verify pre conditions
     assert(table != NULL);
@@ -98,110 +285,310 @@ void filmTable_init(tFilmTable* table) {
     // the user of static memory, were data was allways initialized 
     // (tFilm elements[MAX_ELEMENTS])
     table->elements = NULL;
+    // No memory allocated means no capacity
+    table->capacity = 0;
+
+    // The hash index starts empty too
+    hashIndex_init(&table->index);
+
+    // By default removing keeps the order of the films
+    table->removeMode = TABLE_REMOVE_SHIFT;
+    table->removed = 0;
+
+    // No logs or recommenders keep the positions of the films yet
+    table->references = 0;
+
+    // By default the table is not shared between threads
+    table->lock = NULL;
+    table->arena = NULL;
+
+    // Indexes of genres and series start empty
+    for (i = 0; i < GENRE_QTY; i++) {
+        postings_init(&table->byGenre[i]);
+    }
+    table->bySeries.size = 0;
+    table->bySeries.capacity = 0;
+    table->bySeries.elements = NULL;
+    hashIndex_init(&table->bySeries.index);
+    table->offsets = NULL;
+    table->offsetsCapacity = 0;
 }
 
 
 // Free resources stored by an existing tFilmTable data type.
 void filmTable_free(tFilmTable* object) {
     // PR1 EX3
+    unsigned int i;
 
     // Verify pre conditions
     assert(object != NULL);
 
+    // Release the references to the titles of the films. Tombstones 
+    // of removed films are already released
+    for (i = 0; i < object->size; i++) {
+        film_free(&(object->elements[i]));
+    }
+
     // All memory allocated with malloc and realloc needs to be freed using 
     // the free command. In this case, as we use malloc/realloc to 
     // allocate the elements, and need to free them.
     if (object->elements != NULL) {
-        free(object->elements);
+        mem_free(object->elements);
         object->elements = NULL;
     }
-    // As the table is now empty, assign the size to 0.
+    // As the table is now empty, assign the size and capacity to 0.
     object->size = 0;
+    object->capacity = 0;
+    object->removed = 0;
+
+    // Release the hash index
+    hashIndex_free(&object->index);
+
+    // And the indexes of genres and series
+    filmTable_freeIndexes(object);
 
 }
 
 
-// Add a new film in the table. In case the film already exists (same title), 
-// it will return an error value ERR_DUPLICATED.
-tError filmTable_add(tFilmTable* table, tFilm* film) {
+// filmTable_add without taking the lock of the table
+static tError filmTable_addUnlocked(tFilmTable* table, tFilm* film) {
 
     // PR1 EX3
     // return ERR_NOT_IMPLEMENTED;
-    int i;
+    unsigned int hash;
+    tError err;
     // Verify pre conditions
     assert(table != NULL);
     assert(film != NULL);
 
-    for (i = 0; i<table->size; i++) {
+    // Check if the film already is on the table, using the hash index
+    hash = hash_string(film->title);
+    if (hashIndex_find(&table->index, film->title, hash, filmTable_getKey, table, NULL)) {
+        return ERR_DUPLICATED;
+    }
 
-        if (strcmp(table->elements[i].title, film->title) == 0) {
-            return ERR_DUPLICATED;
+    // The first step is to make sure there is space for the new element. 
+    // The capacity of the table grows geometrically (see filmTable_reserve), 
+    // so most of the times there is already space and no memory is allocated.
+    if (table->size == table->capacity) {
+        if (filmTable_reserve(table, table_growCapacity(table->capacity, table->size + 1)) != OK) {
+            // Error allocating or reallocating the memory
+            return ERR_MEMORY_ERROR;
         }
     }
 
-    // The first step is to allocate the required space. There are two methods 
-    // to manage the memory (malloc and realloc). Malloc allows to allocate a 
-    // new memory block, while realloc allows to modify an existing memory block.    
-    if (table->size == 0) {
-        // Empty table
+    // Increase the number of elements of the table
+    table->size = table->size + 1;
 
-        // Increase the number of elements of the table
-        table->size = 1;
+    // Once we have the block of memory, which is an array of tFilm elements, 
+    // we initialize the new element. If there is no memory for its title, 
+    // the film is taken out of the table again
+    err = film_init(&(table->elements[table->size - 1]), film->title, film->lengthInMin, film->series);
+    if (err != OK) {
+        table->size = table->size - 1;
+        return err;
+    }
 
-        // Since the table is empty, and we do not have any previous memory block, 
-        // we have to use malloc. The amount of memory we need is the number of 
-        // elements (will be 1) times the size of one element, which is computed 
-        // by sizeof(type). In this case the type is tFilm.
-        table->elements = (tFilm*)malloc(table->size * sizeof(tFilm));
+    // Add the position of the new film in the hash index
+    if (hashIndex_insert(&table->index, hash, table->size - 1) != OK) {
+        film_free(&(table->elements[table->size - 1]));
+        table->size = table->size - 1;
+        return ERR_MEMORY_ERROR;
     }
-    else {
-        // Table with elements
 
-        // Increase the number of elements of the table
-        table->size = table->size + 1;
+    // And in the indexes of genres and series
+    if (filmTable_indexFilm(table, table->size - 1) != OK) {
+        hashIndex_remove(&table->index, film->title, hash, filmTable_getKey, table);
+        film_free(&(table->elements[table->size - 1]));
+        table->size = table->size - 1;
+        return ERR_MEMORY_ERROR;
+    }
+
+    return OK;
+}
+
+// Add a new film in the table. In case the film already exists (same title), 
+// it will return an error value ERR_DUPLICATED.
+tError filmTable_add(tFilmTable* table, tFilm* film) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = filmTable_addUnlocked(table, film);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+    TRACE_END(TRACE_FILM_ADD, start);
+
+    return result;
+}
+
+
+// Add count films to the table, as filmTable_add, with one reservation for the batch
+tError filmTable_addMany(tFilmTable* table, tFilm* films, unsigned int count, tError* results) {
+    unsigned int i;
+    tError err;
+    tError first = OK;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(films != NULL || count == 0);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+
+    // Reserve memory for the whole batch, so no element is moved while adding it. 
+    // If it fails, the elements are still added one by one
+    filmTable_reserve(table, table_growCapacity(table->capacity, table->size + count));
+    hashIndex_reserve(&table->index, table->index.count + count);
+
+    for (i = 0; i < count; i++) {
+        // Duplicates in the batch are found as each element enters the index
+        err = filmTable_addUnlocked(table, &films[i]);
+        if (results != NULL) {
+            results[i] = err;
+        }
+        if (err != OK && first == OK) {
+            first = err;
+        }
+    }
+
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return first;
+}
+
+// filmTable_reserve without taking the lock of the table
+static tError filmTable_reserveUnlocked(tFilmTable* table, unsigned int n) {
+    tFilm* elements;
+
+    // Verify pre conditions
+    assert(table != NULL);
 
-        // Since the table is not empty, we already have a memory block. 
-        // We need to modify the size of this block, using the realloc 
-        // command. The amount of memory we need is the number of elements 
-        // times the size of one element, which is computed by sizeof(type). 
-        // In this case the type is tFilm. 
-        // We provide the previous block of memory.
-        table->elements = (tFilm*)realloc(table->elements, table->size * sizeof(tFilm));
+    if (n <= table->capacity) {
+        // Already enough memory
+        return OK;
     }
 
-    // Check that the memory has been allocated
-    if (table->elements == NULL) {
-        // Error allocating or reallocating the memory
+    // realloc behaves as malloc when the previous block is NULL.
+    // The amount of memory we need is the new capacity times the size of 
+    // one element, which is computed by sizeof(type). In this case the type is tFilm.
+    elements = (tFilm*)mem_realloc(MEM_FILM, table->elements, n * sizeof(tFilm));
+
+    // Check that the memory has been allocated. The previous block is 
+    // still valid if realloc fails, so the table is not modified
+    if (elements == NULL) {
         return ERR_MEMORY_ERROR;
     }
 
-    // Once we have the block of memory, which is an array of tFilm elements, 
-    // we initialize the new element
-    film_init(&(table->elements[table->size - 1]), film->title, film->lengthInMin, film->series);
+    table->elements = elements;
+    table->capacity = n;
 
     return OK;
 }
 
+// Ensure there is memory for at least n films in the table
+tError filmTable_reserve(tFilmTable* table, unsigned int n) {
+    tError result;
+    const tAllocator* scope;
 
-/* a search for an film in the table received as a parameter, by its title.
-* It will return a pointer to the tFilm type data if found, or NULL otherwise.
-*/
-tFilm* filmTable_find(tFilmTable* table, const char* title) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = filmTable_reserveUnlocked(table, n);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// filmTable_shrinkToFit without taking the lock of the table
+static tError filmTable_shrinkToFitUnlocked(tFilmTable* table) {
+    tFilm* elements;
+    tFilmOffsets* offsets;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    if (table->size == table->capacity) {
+        // Nothing to release
+        return OK;
+    }
+
+    // We cannot allocate zero bytes, so an empty table has no memory
+    if (table->size == 0) {
+        mem_free(table->elements);
+        table->elements = NULL;
+        table->capacity = 0;
+        if (table->offsets != NULL) {
+            mem_free(table->offsets);
+            table->offsets = NULL;
+        }
+        table->offsetsCapacity = 0;
+        return OK;
+    }
+
+    elements = (tFilm*)mem_realloc(MEM_FILM, table->elements, table->size * sizeof(tFilm));
+    if (elements == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    table->elements = elements;
+    table->capacity = table->size;
+
+    // The offsets of the films follow the capacity of the table
+    if (table->offsetsCapacity > table->size) {
+        offsets = (tFilmOffsets*)mem_realloc(MEM_INDEX, table->offsets, table->size * sizeof(tFilmOffsets));
+        if (offsets == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+        table->offsets = offsets;
+        table->offsetsCapacity = table->size;
+    }
+
+    return OK;
+}
+
+// Release the memory not used by the elements of the table
+tError filmTable_shrinkToFit(tFilmTable* table) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = filmTable_shrinkToFitUnlocked(table);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// filmTable_find without taking the lock of the table
+static tFilm* filmTable_findUnlocked(tFilmTable* table, const char* title) {
     // PR1 EX3
     //return NULL;
-    int i;
+    unsigned int position;
 
     // Verify pre conditions
     assert(table != NULL);
     assert(title != NULL);
 
-    // Search over the table and return once we found the element.
-    for (i = 0; i<table->size; i++) {
-        if (strcmp(table->elements[i].title, title) == 0) {
-            // We return the ADDRESS (&) of the element, 
-            // which is a pointer to the element
-            return &(table->elements[i]);
-        }
+    // Search the position of the element in the hash index.
+    if (hashIndex_find(&table->index, title, hash_string(title), filmTable_getKey, table, &position)) {
+        // We return the ADDRESS (&) of the element, 
+        // which is a pointer to the element
+        return &(table->elements[position]);
     }
 
     // The element has not been found. Return NULL (empty pointer).
@@ -209,74 +596,215 @@ tFilm* filmTable_find(tFilmTable* table, const char* title) {
 
 }
 
-/* Removes an film received as a parameter from the table, based on its title.
-* If an attempt is made to delete a device that
-* does not exist in the table, the error value ERR_NOT_FOUND will be returned.
-* Otherwise, it will return the OK value. If there is a problem managing memory,
-* this function will return an error value ERR_MEMORY_ERROR.
+/* a search for an film in the table received as a parameter, by its title.
+* It will return a pointer to the tFilm type data if found, or NULL otherwise.
 */
-tError filmTable_remove(tFilmTable* table, tFilm* film){
-    int i;
-    bool found;
+tFilm* filmTable_find(tFilmTable* table, const char* title) {
+    tFilm* result;
 
     // Verify pre conditions
     assert(table != NULL);
-    assert(film != NULL);
 
-    // To remove an element of a table, we will move all elements after this element 
-    // one position, to fill the space of the removed element.
-    found = false;
-    for (i = 0; i<table->size; i++) {
-        // If the element has been found. Displace this element to the previous element 
-        // (will never happend for the first one). We use the ADDRESS of the previous 
-        // element &(table->elements[i-1]) as destination, and ADDRESS of the current 
-        // element &(table->elements[i]) as source.
-        if (found) {
-            // Check the return code to detect memory allocation errors
-            if (film_cpy(&(table->elements[i - 1]), &(table->elements[i])) == ERR_MEMORY_ERROR) {
-                // Error allocating memory. Just stop the process and return memory error.
-                return ERR_MEMORY_ERROR;
-            }
+    TRACE_BEGIN(start);
+    rwlock_readLock(table->lock);
+    result = filmTable_findUnlocked(table, title);
+    rwlock_readUnlock(table->lock);
+    TRACE_END(TRACE_FILM_FIND, start);
+
+    return result;
+}
+
+// filmTable_compact without taking the lock of the table
+static tError filmTable_compactUnlocked(tFilmTable* table) {
+    unsigned int i, j;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // Bound logs and recommenders keep the positions of the films
+    if (table->references > 0) {
+        return ERR_INVALID;
+    }
+    if (table->removed == 0) {
+        return OK;
+    }
+
+    // Move the films to the front, keeping their order
+    for (i = 0, j = 0; i < table->size; i++) {
+        if (table->elements[i].title == NULL) {
+            continue;
         }
-        else if (strcmp(table->elements[i].title, film->title) == 0) {
-            // The current element is the element we want to remove. 
-            // Set found flag to true to start element movement.
-            found = true;
+        if (i != j) {
+            table->elements[j] = table->elements[i];
+            // Position i still holds the moved film, used to find it in the index
+            hashIndex_update(&table->index, table->elements[j].title, 
+                table->elements[j].titleHash, filmTable_getKey, table, j);
         }
+        j++;
     }
 
-    // Once removed the element, we need to modify the memory used by the table.
-    if (found) {
-        // Modify the number of elements
-        table->size = table->size - 1;
+    table->size = j;
+    table->removed = 0;
 
-        // If we are removing the last element, we will assign the pointer 
-        // to NULL, since we cannot allocate zero bytes
-        if (table->size == 0) {
-            table->elements = NULL;
-        }
-        else {
-            // Modify the used memory. As we are modifying a previously 
-            // allocated block, we need to use the realloc command.
-            table->elements = (tFilm*)realloc(table->elements, table->size * sizeof(tFilm));
-
-            // Check that the memory has been allocated
-            if (table->elements == NULL) {
-                // Error allocating or reallocating the memory
-                return ERR_MEMORY_ERROR;
-            }
-        }
+    // Index the positions again. The tombstones were already out of the 
+    // indexes, so the lists do not grow and no memory is allocated
+    for (i = 0; i < GENRE_QTY; i++) {
+        table->byGenre[i].size = 0;
     }
-    else {
+    for (i = 0; i < table->bySeries.size; i++) {
+        table->bySeries.elements[i].films.size = 0;
+    }
+    for (i = 0; i < table->size; i++) {
+        filmTable_indexFilm(table, i);
+    }
+
+    return OK;
+}
+
+// filmTable_remove without taking the lock of the table
+static tError filmTable_removeUnlocked(tFilmTable* table, tFilm* film){
+    unsigned int i;
+    unsigned int position = 0;
+    unsigned int hash;
+    tFilm* moved;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(film != NULL);
+
+    // Get the position of the element from the hash index, and remove 
+    // it from the index before moving any element.
+    hash = hash_string(film->title);
+    if (!hashIndex_find(&table->index, film->title, hash, filmTable_getKey, table, &position)) {
         // If the element was not in the table, return an error.
         return ERR_NOT_FOUND;
     }
 
+    // Bound logs and recommenders keep the positions of the films, so the 
+    // other films can not be moved
+    if (table->references > 0 && table->removeMode != TABLE_REMOVE_TOMBSTONE) {
+        return ERR_INVALID;
+    }
+    hashIndex_remove(&table->index, film->title, hash, filmTable_getKey, table);
+    filmTable_unindexFilm(table, position);
+
+    // Release the removed element. The other elements are moved as they are, 
+    // without copying their titles, so no memory is allocated
+    film_free(&(table->elements[position]));
+
+    switch (table->removeMode) {
+    case TABLE_REMOVE_SWAP:
+        // The last element fills the space of the removed element
+        table->size = table->size - 1;
+        if (position != table->size) {
+            moved = &(table->elements[position]);
+            *moved = table->elements[table->size];
+            // The old position still holds the moved film, used to find it in the index
+            hashIndex_update(&table->index, moved->title, moved->titleHash, 
+                filmTable_getKey, table, position);
+            // The moved film keeps its offsets, where its new position is stored
+            table->offsets[position] = table->offsets[table->size];
+            table->byGenre[moved->series->genre].elements[table->offsets[position].genre] = position;
+            filmTable_findSeriesFilms(table, moved->series)->films.elements[table->offsets[position].series] = position;
+        }
+        break;
+
+    case TABLE_REMOVE_TOMBSTONE:
+        // The released element (with a NULL title) stays as a tombstone
+        table->removed = table->removed + 1;
+        if (table->references == 0 && table_needsCompaction(table->size, table->removed)) {
+            filmTable_compactUnlocked(table);
+        }
+        break;
+
+    default:
+        // Move all elements after the removed one one position to the front. 
+        // The memory block is kept, to be reused by next additions (see filmTable_shrinkToFit)
+        memmove(&(table->elements[position]), &(table->elements[position + 1]), 
+            (table->size - position - 1) * sizeof(tFilm));
+        memmove(&(table->offsets[position]), &(table->offsets[position + 1]), 
+            (table->size - position - 1) * sizeof(tFilmOffsets));
+        table->size = table->size - 1;
+        hashIndex_shift(&table->index, position);
+        for (i = 0; i < GENRE_QTY; i++) {
+            postings_shift(&table->byGenre[i], position);
+        }
+        for (i = 0; i < table->bySeries.size; i++) {
+            postings_shift(&(table->bySeries.elements[i].films), position);
+        }
+        break;
+    }
+
     return OK;
 }
 
-// Returns the number of films in the tFilmTable table received as a parameter.
-unsigned int filmTable_size(tFilmTable* table){
+/* Removes an film received as a parameter from the table, based on its title.
+* If an attempt is made to delete a device that
+* does not exist in the table, the error value ERR_NOT_FOUND will be returned.
+* Otherwise, it will return the OK value. If there is a problem managing memory,
+* this function will return an error value ERR_MEMORY_ERROR.
+*/
+tError filmTable_remove(tFilmTable* table, tFilm* film){
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = filmTable_removeUnlocked(table, film);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+    TRACE_END(TRACE_FILM_REMOVE, start);
+
+    return result;
+}
+
+// filmTable_setRemoveMode without taking the lock of the table
+static void filmTable_setRemoveModeUnlocked(tFilmTable* table, tRemoveMode mode) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // Tables referenced by bound logs or recommenders keep their tombstones
+    if (mode != TABLE_REMOVE_TOMBSTONE) {
+        filmTable_compactUnlocked(table);
+    }
+    table->removeMode = mode;
+}
+
+// Select how films are removed from the table. Leaving the 
+// TABLE_REMOVE_TOMBSTONE mode compacts the table
+void filmTable_setRemoveMode(tFilmTable* table, tRemoveMode mode) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    filmTable_setRemoveModeUnlocked(table, mode);
+    rwlock_writeUnlock(table->lock);
+}
+
+// Remove the tombstones of removed films from the table. 
+// The positions of the films after them change
+tError filmTable_compact(tFilmTable* table) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = filmTable_compactUnlocked(table);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// filmTable_size without taking the lock of the table
+static unsigned int filmTable_sizeUnlocked(tFilmTable* table){
 
     // PR1 EX3
     //return 0;
@@ -285,8 +813,116 @@ unsigned int filmTable_size(tFilmTable* table){
     assert(table != NULL);
 
     // The size of the table is the number of elements. 
-    // This value is stored in the "size" field.
-    return table->size;
+    // This value is stored in the "size" field, that also counts 
+    // the tombstones of removed elements
+    return table->size - table->removed;
 
 }
 
+// Returns the number of films in the tFilmTable table received as a parameter.
+unsigned int filmTable_size(tFilmTable* table){
+    unsigned int result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_readLock(table->lock);
+    result = filmTable_sizeUnlocked(table);
+    rwlock_readUnlock(table->lock);
+
+    return result;
+}
+
+// Use a reader-writer lock to share the table between threads
+void filmTable_setLock(tFilmTable* table, struct tRWLock* lock) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    table->lock = lock;
+}
+
+// Allocate the memory of the table in an arena
+void filmTable_setArena(tFilmTable* table, struct tArena* arena) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    table->arena = arena;
+}
+
+// Count a bound log or a recommender that keeps the positions of the films of the table
+void filmTable_addReference(tFilmTable* table) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    table->references++;
+    rwlock_writeUnlock(table->lock);
+}
+
+// Stop counting a log or a recommender counted with filmTable_addReference
+void filmTable_releaseReference(tFilmTable* table) {
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(table->references > 0);
+
+    rwlock_writeLock(table->lock);
+    table->references--;
+    rwlock_writeUnlock(table->lock);
+}
+
+// filmTable_getGenreFilms without taking the lock of the table
+static tPostings* filmTable_getGenreFilmsUnlocked(tFilmTable* table, tGenre genre) {
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(genre < GENRE_QTY);
+
+    if (table->byGenre[genre].size == 0) {
+        return NULL;
+    }
+
+    return &(table->byGenre[genre]);
+}
+
+// Get the positions of the films of a genre in the table
+tPostings* filmTable_getGenreFilms(tFilmTable* table, tGenre genre) {
+    tPostings* result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_readLock(table->lock);
+    result = filmTable_getGenreFilmsUnlocked(table, genre);
+    rwlock_readUnlock(table->lock);
+
+    return result;
+}
+
+// filmTable_getSeriesFilms without taking the lock of the table
+static tPostings* filmTable_getSeriesFilmsUnlocked(tFilmTable* table, tSeries* series) {
+    tSeriesFilms* entry;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(series != NULL);
+
+    entry = filmTable_findSeriesFilms(table, series);
+    if (entry == NULL || entry->films.size == 0) {
+        return NULL;
+    }
+
+    return &(entry->films);
+}
+
+// Get the positions of the films of a series in the table
+tPostings* filmTable_getSeriesFilms(tFilmTable* table, tSeries* series) {
+    tPostings* result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_readLock(table->lock);
+    result = filmTable_getSeriesFilmsUnlocked(table, series);
+    rwlock_readUnlock(table->lock);
+
+    return result;
+}
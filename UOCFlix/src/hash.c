@@ -0,0 +1,352 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "hash.h"
+#include "mem.h"
+
+// Initial number of slots of an index. Must be a power of 2
+#define HASH_INDEX_INITIAL_CAPACITY 16
+
+// Get the hash value of a string (FNV-1a)
+unsigned int hash_string(const char* key) {
+    unsigned int hash = 2166136261u;
+
+    // Verify pre conditions
+    assert(key != NULL);
+
+    while (*key != '\0') {
+        hash ^= (unsigned char)*key;
+        hash *= 16777619u;
+        key++;
+    }
+
+    return hash;
+}
+
+// Spread the bits of a hash over 64 bits (finalizer of MurmurHash3)
+unsigned long long hash_mix64(unsigned int hash) {
+    unsigned long long value = (unsigned long long)hash + 0x9E3779B97F4A7C15ull;
+
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+
+    return value;
+}
+
+// Initialize an empty hash index
+void hashIndex_init(tHashIndex* index) {
+    // Verify pre conditions
+    assert(index != NULL);
+
+    // No memory is allocated until the first key is added
+    index->capacity = 0;
+    index->count = 0;
+    index->slots = NULL;
+}
+
+// Release the memory used by a hash index
+void hashIndex_free(tHashIndex* index) {
+    // Verify pre conditions
+    assert(index != NULL);
+
+    if (index->slots != NULL) {
+        mem_free(index->slots);
+        index->slots = NULL;
+    }
+    index->capacity = 0;
+    index->count = 0;
+}
+
+// Remove all the entries of a hash index, keeping its memory
+void hashIndex_clear(tHashIndex* index) {
+    // Verify pre conditions
+    assert(index != NULL);
+
+    if (index->slots != NULL) {
+        memset(index->slots, 0, index->capacity * sizeof(tHashSlot));
+    }
+    index->count = 0;
+}
+
+// Place a slot in the first free position of its probe sequence
+static void hashIndex_place(tHashSlot* slots, unsigned int capacity, tHashSlot slot) {
+    unsigned int mask = capacity - 1;
+    unsigned int i = slot.hash & mask;
+
+    while (slots[i].position != 0) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+}
+
+// Change the number of slots of the index, placing again all the entries
+static tError hashIndex_resize(tHashIndex* index, unsigned int capacity) {
+    unsigned int i;
+    tHashSlot* slots;
+
+    // calloc leaves all the slots with position 0 (empty)
+    slots = (tHashSlot*)mem_calloc(MEM_INDEX, capacity, sizeof(tHashSlot));
+    if (slots == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // The hash of each key is stored in its slot, so keys are not read again
+    for (i = 0; i < index->capacity; i++) {
+        if (index->slots[i].position != 0) {
+            hashIndex_place(slots, capacity, index->slots[i]);
+        }
+    }
+
+    if (index->slots != NULL) {
+        mem_free(index->slots);
+    }
+    index->slots = slots;
+    index->capacity = capacity;
+
+    return OK;
+}
+
+// Double the number of slots of the index
+static tError hashIndex_grow(tHashIndex* index) {
+    return hashIndex_resize(index, (index->capacity == 0) ? HASH_INDEX_INITIAL_CAPACITY : index->capacity * 2);
+}
+
+// Ensure the index can hold n keys without growing
+tError hashIndex_reserve(tHashIndex* index, unsigned int n) {
+    unsigned int capacity;
+
+    // Verify pre conditions
+    assert(index != NULL);
+
+    // The same load factor than hashIndex_insert, with a power of 2 of slots
+    capacity = (index->capacity == 0) ? HASH_INDEX_INITIAL_CAPACITY : index->capacity;
+    while (n * 10 > capacity * 7) {
+        capacity *= 2;
+    }
+    if (capacity == index->capacity) {
+        return OK;
+    }
+
+    return hashIndex_resize(index, capacity);
+}
+
+// Add the position of a new key in the index.
+// The key must not be already in the index
+tError hashIndex_insert(tHashIndex* index, unsigned int hash, unsigned int position) {
+    tHashSlot slot;
+
+    // Verify pre conditions
+    assert(index != NULL);
+
+    // Keep the load factor under 70% to have short probe sequences
+    if ((index->count + 1) * 10 > index->capacity * 7) {
+        if (hashIndex_grow(index) != OK) {
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    slot.hash = hash;
+    slot.position = position + 1;
+    hashIndex_place(index->slots, index->capacity, slot);
+    index->count++;
+
+    return OK;
+}
+
+// Get the slot that contains a key, or -1 if the key is not in the index
+static int hashIndex_findSlot(tHashIndex* index, const char* key, unsigned int hash,
+                    tHashKeyFn getKey, void* table) {
+    unsigned int mask;
+    unsigned int i;
+    const char* stored;
+
+    if (index->count == 0) {
+        return -1;
+    }
+
+    mask = index->capacity - 1;
+    i = hash & mask;
+
+    // Walk the probe sequence until an empty slot is found. Only compare
+    // the keys when the hashes are equal, and not even then when the key
+    // is the same interned string
+    while (index->slots[i].position != 0) {
+        if (index->slots[i].hash == hash) {
+            stored = getKey(table, index->slots[i].position - 1);
+            if (stored == key || strcmp(stored, key) == 0) {
+                return (int)i;
+            }
+        }
+        i = (i + 1) & mask;
+    }
+
+    return -1;
+}
+
+// Search a key in the index. If found, returns true and the position of
+// the element in the table is stored in position
+bool hashIndex_find(tHashIndex* index, const char* key, unsigned int hash,
+                    tHashKeyFn getKey, void* table, unsigned int* position) {
+    int slot;
+
+    // Verify pre conditions
+    assert(index != NULL);
+    assert(key != NULL);
+    assert(getKey != NULL);
+
+    slot = hashIndex_findSlot(index, key, hash, getKey, table);
+    if (slot < 0) {
+        return false;
+    }
+
+    if (position != NULL) {
+        *position = index->slots[slot].position - 1;
+    }
+
+    return true;
+}
+
+// Empty a slot of the index. Backward shift deletion: move back the 
+// entries of the same probe sequence to fill the hole, so no tombstones 
+// are needed
+static void hashIndex_removeSlot(tHashIndex* index, unsigned int slot) {
+    unsigned int mask;
+    unsigned int i, j, home;
+
+    mask = index->capacity - 1;
+    i = slot;
+    j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (index->slots[j].position == 0) {
+            break;
+        }
+        home = index->slots[j].hash & mask;
+
+        // The entry in j can fill the hole in i if its home slot
+        // is not (cyclically) between i and j
+        if ((i <= j) ? (home <= i || home > j) : (home <= i && home > j)) {
+            index->slots[i] = index->slots[j];
+            i = j;
+        }
+    }
+    index->slots[i].position = 0;
+    index->count--;
+}
+
+// Remove a key from the index. Returns false if the key is not in the index
+bool hashIndex_remove(tHashIndex* index, const char* key, unsigned int hash,
+                    tHashKeyFn getKey, void* table) {
+    int slot;
+
+    // Verify pre conditions
+    assert(index != NULL);
+    assert(key != NULL);
+    assert(getKey != NULL);
+
+    slot = hashIndex_findSlot(index, key, hash, getKey, table);
+    if (slot < 0) {
+        return false;
+    }
+    hashIndex_removeSlot(index, (unsigned int)slot);
+
+    return true;
+}
+
+// Get the slot that contains the entry of the element at a position of 
+// the table, or -1 if the position is not in the index
+static int hashIndex_findPositionSlot(tHashIndex* index, unsigned int hash, unsigned int position) {
+    unsigned int mask;
+    unsigned int i;
+
+    if (index->count == 0) {
+        return -1;
+    }
+
+    mask = index->capacity - 1;
+    i = hash & mask;
+    while (index->slots[i].position != 0) {
+        if (index->slots[i].position == position + 1) {
+            return (int)i;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return -1;
+}
+
+// Remove the entry of the element at a position of the table. The key of 
+// the element is not read, so it can be already released, and tables with
+// repeated keys remove the right entry. Returns false if the position is 
+// not in the index
+bool hashIndex_removePosition(tHashIndex* index, unsigned int hash, unsigned int position) {
+    int slot;
+
+    // Verify pre conditions
+    assert(index != NULL);
+
+    slot = hashIndex_findPositionSlot(index, hash, position);
+    if (slot < 0) {
+        return false;
+    }
+    hashIndex_removeSlot(index, (unsigned int)slot);
+
+    return true;
+}
+
+// Change the position stored for the element at a position of the table, 
+// without reading its key, as hashIndex_removePosition. 
+// Returns false if the position is not in the index
+bool hashIndex_updatePosition(tHashIndex* index, unsigned int hash, unsigned int position, unsigned int newPosition) {
+    int slot;
+
+    // Verify pre conditions
+    assert(index != NULL);
+
+    slot = hashIndex_findPositionSlot(index, hash, position);
+    if (slot < 0) {
+        return false;
+    }
+    index->slots[slot].position = newPosition + 1;
+
+    return true;
+}
+
+// Change the position stored for a key of the index. 
+// Returns false if the key is not in the index
+bool hashIndex_update(tHashIndex* index, const char* key, unsigned int hash,
+                    tHashKeyFn getKey, void* table, unsigned int position) {
+    int slot;
+
+    // Verify pre conditions
+    assert(index != NULL);
+    assert(key != NULL);
+    assert(getKey != NULL);
+
+    slot = hashIndex_findSlot(index, key, hash, getKey, table);
+    if (slot < 0) {
+        return false;
+    }
+    index->slots[slot].position = position + 1;
+
+    return true;
+}
+
+// Update positions after removing the element at a position of the table
+// and moving all the elements after it one position to the front
+void hashIndex_shift(tHashIndex* index, unsigned int position) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(index != NULL);
+
+    // Stored positions are the table position plus one
+    for (i = 0; i < index->capacity; i++) {
+        if (index->slots[i].position > position + 1) {
+            index->slots[i].position--;
+        }
+    }
+}
@@ -0,0 +1,240 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "ingest.h"
+#include "mem.h"
+
+// Read a value shared between threads
+static unsigned long long viewIngest_load(volatile unsigned long long* value) {
+    return atomic_fetchAdd64(value, 0);
+}
+
+// Check if the view at the tail of the ring has been written by its producer
+static bool viewIngest_ready(tViewIngest* ingest) {
+    tViewIngestSlot* slot = &(ingest->slots[ingest->tail & (ingest->capacity - 1)]);
+
+    return viewIngest_load(&slot->sequence) == ingest->tail + 1;
+}
+
+// Add a batch of queued views to the log. Returns the number of views of the batch
+static unsigned int viewIngest_consume(tViewIngest* ingest) {
+    tView batch[VIEWINGEST_MAX_BATCH];
+    tViewIngestSlot* slot;
+    unsigned int i, n = 0;
+    tError err;
+
+    // Copy the views and free their slots, so producers can use them while the batch is added
+    while (n < VIEWINGEST_MAX_BATCH && viewIngest_ready(ingest)) {
+        slot = &(ingest->slots[ingest->tail & (ingest->capacity - 1)]);
+        batch[n++] = slot->view;
+        atomic_fetchAdd64(&slot->sequence, ingest->capacity - 1);
+        ingest->tail++;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    // The lock is reentrant, so viewLog_add does not wait for it again
+    rwlock_writeLock(ingest->log->lock);
+    viewLog_reserve(ingest->log, ingest->log->size + n);
+    for (i = 0; i < n; i++) {
+        err = viewLog_add(ingest->log, &batch[i]);
+        if (err != OK) {
+            atomic_fetchAdd64(&ingest->failed, 1);
+            atomic_compareExchange64(&ingest->error, (unsigned long long)OK, (unsigned long long)err);
+        }
+    }
+    rwlock_writeUnlock(ingest->log->lock);
+
+    atomic_fetchAdd64(&ingest->done, n);
+    if (atomic_fetchAdd(&ingest->waiting, 0) > 0) {
+        event_signal(&ingest->progress);
+    }
+
+    return n;
+}
+
+// Entry point of the consumer thread
+static void viewIngest_run(void* context) {
+    tViewIngest* ingest = (tViewIngest*)context;
+    unsigned long long seen;
+    bool stop = false;
+
+    while (!stop) {
+        if (viewIngest_consume(ingest) > 0) {
+            continue;
+        }
+
+        // Producers signal the event if they see the consumer sleeping,
+        // so the queue is checked again after telling them
+        seen = event_count(&ingest->queued);
+        atomic_fetchAdd(&ingest->sleeping, 1);
+        if (!viewIngest_ready(ingest)) {
+            if (atomic_fetchAdd(&ingest->stopping, 0) != 0) {
+                stop = true;
+            }
+            else {
+                event_wait(&ingest->queued, seen);
+            }
+        }
+        atomic_fetchAdd(&ingest->sleeping, (unsigned int)-1);
+    }
+}
+
+// Wait until the consumer has done the views before a position
+static void viewIngest_waitDone(tViewIngest* ingest, unsigned long long position) {
+    unsigned long long seen;
+
+    while (viewIngest_load(&ingest->done) < position) {
+        seen = event_count(&ingest->progress);
+        atomic_fetchAdd(&ingest->waiting, 1);
+        if (viewIngest_load(&ingest->done) < position) {
+            event_wait(&ingest->progress, seen);
+        }
+        atomic_fetchAdd(&ingest->waiting, (unsigned int)-1);
+    }
+}
+
+// Initialize an empty queue in front of a log, and start its consumer thread
+tError viewIngest_init(tViewIngest* ingest, tViewLog* log, unsigned int capacity) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(ingest != NULL);
+    assert(log != NULL);
+
+    if (capacity == 0 || capacity > VIEWINGEST_MAX_CAPACITY) {
+        return ERR_INVALID;
+    }
+
+    // Positions are mapped to slots with a mask
+    ingest->capacity = 2;
+    while (ingest->capacity < capacity) {
+        ingest->capacity *= 2;
+    }
+    ingest->slots = (tViewIngestSlot*)mem_alloc(MEM_VIEW, ingest->capacity * sizeof(tViewIngestSlot));
+    if (ingest->slots == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < ingest->capacity; i++) {
+        ingest->slots[i].sequence = i;
+    }
+
+    ingest->log = log;
+    ingest->head = 0;
+    ingest->tail = 0;
+    ingest->done = 0;
+    ingest->failed = 0;
+    ingest->error = (unsigned long long)OK;
+    ingest->sleeping = 0;
+    ingest->waiting = 0;
+    ingest->stopping = 0;
+
+    if (event_init(&ingest->queued) != OK) {
+        mem_free(ingest->slots);
+        return ERR_MEMORY_ERROR;
+    }
+    if (event_init(&ingest->progress) != OK) {
+        event_free(&ingest->queued);
+        mem_free(ingest->slots);
+        return ERR_MEMORY_ERROR;
+    }
+    if (thread_create(&ingest->consumer, viewIngest_run, ingest) != OK) {
+        event_free(&ingest->progress);
+        event_free(&ingest->queued);
+        mem_free(ingest->slots);
+        return ERR_MEMORY_ERROR;
+    }
+
+    return OK;
+}
+
+// Add the queued views to the log, stop the consumer thread and release the memory of the queue
+void viewIngest_free(tViewIngest* ingest) {
+    // Verify pre conditions
+    assert(ingest != NULL);
+
+    // The consumer empties the queue before it ends
+    atomic_fetchAdd(&ingest->stopping, 1);
+    event_signal(&ingest->queued);
+    thread_join(&ingest->consumer);
+
+    event_free(&ingest->progress);
+    event_free(&ingest->queued);
+    mem_free(ingest->slots);
+    ingest->slots = NULL;
+    ingest->capacity = 0;
+}
+
+// Queue a view to be added to the log
+tError viewIngest_add(tViewIngest* ingest, tView* view) {
+    unsigned long long position, sequence, seen;
+    tViewIngestSlot* slot;
+
+    // Verify pre conditions
+    assert(ingest != NULL);
+    assert(view != NULL);
+
+    // Take the next position, if its slot is free
+    position = viewIngest_load(&ingest->head);
+    for (;;) {
+        slot = &(ingest->slots[position & (ingest->capacity - 1)]);
+        sequence = viewIngest_load(&slot->sequence);
+        if (sequence == position) {
+            if (atomic_compareExchange64(&ingest->head, position, position + 1)) {
+                break;
+            }
+        }
+        else if ((long long)(sequence - position) < 0) {
+            // The queue is full until the consumer reads the view of the slot
+            seen = event_count(&ingest->progress);
+            atomic_fetchAdd(&ingest->waiting, 1);
+            if (viewIngest_load(&slot->sequence) == sequence) {
+                event_wait(&ingest->progress, seen);
+            }
+            atomic_fetchAdd(&ingest->waiting, (unsigned int)-1);
+        }
+        position = viewIngest_load(&ingest->head);
+    }
+
+    // Publish the view to the consumer
+    slot->view = *view;
+    atomic_fetchAdd64(&slot->sequence, 1);
+    if (atomic_fetchAdd(&ingest->sleeping, 0) > 0) {
+        event_signal(&ingest->queued);
+    }
+
+    return OK;
+}
+
+// Wait until the views queued before the call are in the log
+tError viewIngest_flush(tViewIngest* ingest) {
+    unsigned long long error;
+
+    // Verify pre conditions
+    assert(ingest != NULL);
+
+    viewIngest_waitDone(ingest, viewIngest_load(&ingest->head));
+
+    // Take the error, unless the consumer sets another one at the same time
+    do {
+        error = viewIngest_load(&ingest->error);
+    } while (!atomic_compareExchange64(&ingest->error, error, (unsigned long long)OK));
+
+    return (tError)(long long)error;
+}
+
+// Get the number of views queued and not in the log yet
+unsigned int viewIngest_pending(tViewIngest* ingest) {
+    // Verify pre conditions
+    assert(ingest != NULL);
+
+    return (unsigned int)(viewIngest_load(&ingest->head) - viewIngest_load(&ingest->done));
+}
+
+// Get the number of views that could not be added to the log
+unsigned int viewIngest_failed(tViewIngest* ingest) {
+    // Verify pre conditions
+    assert(ingest != NULL);
+
+    return (unsigned int)viewIngest_load(&ingest->failed);
+}
@@ -0,0 +1,207 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <assert.h>
+#include "intern.h"
+#include "hash.h"
+#include "table.h"
+#include "sync.h"
+#include "mem.h"
+
+// Shared copy of a string. The characters are stored just after the
+// header, so the header can be found from the string pointer
+typedef struct {
+    unsigned int refs;
+    unsigned int hash;
+    unsigned int length;
+    unsigned int position;
+    char str[];
+} tInternEntry;
+
+// Table of the strings of the pool, with a hash index over their content
+typedef struct {
+    unsigned int size;
+    unsigned int capacity;
+    tInternEntry** elements;
+    tHashIndex index;
+} tInternPool;
+
+static tInternPool internPool = { 0, 0, NULL, { 0, 0, NULL } };
+
+// The pool is shared by all the threads. Acquiring and releasing strings 
+// change the pool, so they take the lock for writing
+static tRWLock internLock = RWLOCK_INITIALIZER;
+
+// Get the header of a string acquired from the pool
+static tInternEntry* intern_getEntry(const char* str) {
+    return (tInternEntry*)(str - offsetof(tInternEntry, str));
+}
+
+// Get the key used by the hash index of the pool
+static const char* intern_getKey(void* table, unsigned int position) {
+    return ((tInternPool*)table)->elements[position]->str;
+}
+
+// Release the memory of the pool once it has no strings
+static void intern_releasePool(void) {
+    if (internPool.elements != NULL) {
+        mem_free(internPool.elements);
+        internPool.elements = NULL;
+    }
+    internPool.size = 0;
+    internPool.capacity = 0;
+    hashIndex_free(&internPool.index);
+}
+
+// intern_acquire without taking the lock of the pool
+static const char* intern_acquireUnlocked(const char* str) {
+    unsigned int hash;
+    unsigned int position;
+    unsigned int capacity;
+    size_t length;
+    tInternEntry** elements;
+    tInternEntry* entry;
+
+    // Verify pre conditions
+    assert(str != NULL);
+
+    // The string is already in the pool, just add a reference
+    hash = hash_string(str);
+    if (hashIndex_find(&internPool.index, str, hash, intern_getKey, &internPool, &position)) {
+        entry = internPool.elements[position];
+        entry->refs++;
+        return entry->str;
+    }
+
+    // Make space for the new string
+    if (internPool.size == internPool.capacity) {
+        capacity = table_growCapacity(internPool.capacity, internPool.size + 1);
+        elements = (tInternEntry**)mem_realloc(MEM_INTERN, internPool.elements, capacity * sizeof(tInternEntry*));
+        if (elements == NULL) {
+            return NULL;
+        }
+        internPool.elements = elements;
+        internPool.capacity = capacity;
+    }
+
+    length = strlen(str);
+    entry = (tInternEntry*)mem_alloc(MEM_INTERN, sizeof(tInternEntry) + length + 1);
+    if (entry == NULL) {
+        return NULL;
+    }
+    memcpy(entry->str, str, length + 1);
+    entry->refs = 1;
+    entry->hash = hash;
+    entry->length = (unsigned int)length;
+    entry->position = internPool.size;
+
+    if (hashIndex_insert(&internPool.index, hash, internPool.size) != OK) {
+        mem_free(entry);
+        return NULL;
+    }
+    internPool.elements[internPool.size] = entry;
+    internPool.size++;
+
+    return entry->str;
+}
+
+// Get the shared copy of a string, adding a reference to it. 
+// Returns NULL if there is no memory to create the copy
+const char* intern_acquire(const char* str) {
+    const char* result;
+    const tAllocator* previous;
+
+    // Verify pre conditions
+    assert(str != NULL);
+
+    // The strings are shared by all the tables, so they are never 
+    // allocated in the arena of a table
+    previous = mem_setThreadAllocator(NULL);
+    rwlock_writeLock(&internLock);
+    result = intern_acquireUnlocked(str);
+    rwlock_writeUnlock(&internLock);
+    mem_setThreadAllocator(previous);
+
+    return result;
+}
+
+// intern_release without taking the lock of the pool
+static void intern_releaseUnlocked(const char* str) {
+    tInternEntry* entry;
+    tInternEntry* moved;
+
+    if (str == NULL) {
+        return;
+    }
+
+    entry = intern_getEntry(str);
+    assert(entry->refs > 0);
+    entry->refs--;
+    if (entry->refs > 0) {
+        return;
+    }
+
+    // Last reference, remove the string from the pool. The last string
+    // of the table takes its position, so the table has no holes
+    hashIndex_remove(&internPool.index, entry->str, entry->hash, intern_getKey, &internPool);
+    internPool.size--;
+    if (entry->position != internPool.size) {
+        moved = internPool.elements[internPool.size];
+        moved->position = entry->position;
+        internPool.elements[entry->position] = moved;
+        hashIndex_update(&internPool.index, moved->str, moved->hash, intern_getKey, &internPool, moved->position);
+    }
+    mem_free(entry);
+
+    if (internPool.size == 0) {
+        intern_releasePool();
+    }
+}
+
+// Remove a reference to a string acquired from the pool. 
+// Accepts NULL, that is ignored
+void intern_release(const char* str) {
+    if (str == NULL) {
+        return;
+    }
+
+    rwlock_writeLock(&internLock);
+    intern_releaseUnlocked(str);
+    rwlock_writeUnlock(&internLock);
+}
+
+// Get the number of references to a string acquired from the pool
+unsigned int intern_refs(const char* str) {
+    // Verify pre conditions
+    assert(str != NULL);
+
+    return intern_getEntry(str)->refs;
+}
+
+// Get the hash of a string acquired from the pool. It is set when the 
+// string is added and never changes, so the lock is not needed
+unsigned int intern_hash(const char* str) {
+    // Verify pre conditions
+    assert(str != NULL);
+
+    return intern_getEntry(str)->hash;
+}
+
+// Get the length of a string acquired from the pool
+unsigned int intern_length(const char* str) {
+    // Verify pre conditions
+    assert(str != NULL);
+
+    return intern_getEntry(str)->length;
+}
+
+// Get the number of different strings in the pool
+unsigned int intern_size(void) {
+    unsigned int size;
+
+    rwlock_readLock(&internLock);
+    size = internPool.size;
+    rwlock_readUnlock(&internLock);
+
+    return size;
+}
@@ -0,0 +1,408 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+#include "journal.h"
+#include "user.h"
+#include "film.h"
+#include "mem.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <time.h>
+#endif
+
+// Identifier at the beginning of the journal files
+#define JOURNAL_MAGIC "UOCFJRNL"
+
+// Header of a journal file
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+} tJournalHeader;
+
+// Record of a view, followed by the username and the title (without the 
+// final '\0'). The checksum covers all the previous fields and both keys
+typedef struct {
+    uint16_t userLength;
+    uint16_t filmLength;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    int16_t score;
+    uint16_t minutes;
+    uint16_t reserved;
+    uint32_t checksum;
+} tJournalRecord;
+
+// Get the current time in milliseconds, from an arbitrary origin
+static unsigned long long journal_now(void) {
+#ifdef _WIN32
+    return (unsigned long long)GetTickCount64();
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000 + (unsigned long long)now.tv_nsec / 1000000;
+#endif
+}
+
+// Write the buffered data of a file to disk
+static bool journal_flush(FILE* file) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Change the size of a file
+static bool journal_truncate(FILE* file, long size) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _chsize(_fileno(file), size) == 0;
+#else
+    return ftruncate(fileno(file), (off_t)size) == 0;
+#endif
+}
+
+// Add a block of bytes to a FNV-1a hash
+static uint32_t journal_hash(uint32_t hash, const void* block, size_t size) {
+    const unsigned char* data = (const unsigned char*)block;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+// Get the checksum (FNV-1a) of the fields and the keys of a record
+static uint32_t journal_checksum(const tJournalRecord* record, const char* username, const char* title) {
+    uint32_t hash = 2166136261u;
+
+    hash = journal_hash(hash, record, offsetof(tJournalRecord, checksum));
+    hash = journal_hash(hash, username, record->userLength);
+    return journal_hash(hash, title, record->filmLength);
+}
+
+// Read the next record of a journal and its keys, that are stored in a buffer 
+// that grows as needed. Returns ERR_NOT_FOUND at the end of the journal or 
+// at an incomplete or corrupted record
+static tError journal_read(FILE* file, tJournalRecord* record, char** buffer, size_t* capacity) {
+    size_t size;
+    char* data;
+
+    if (fread(record, sizeof(tJournalRecord), 1, file) != 1) {
+        return ERR_NOT_FOUND;
+    }
+
+    // Both keys, each one with its '\0'
+    size = (size_t)record->userLength + record->filmLength + 2;
+    if (size > *capacity) {
+        data = (char*)mem_realloc(MEM_STORAGE, *buffer, size);
+        if (data == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+        *buffer = data;
+        *capacity = size;
+    }
+    data = *buffer;
+    if (fread(data, 1, record->userLength, file) != record->userLength
+            || fread(data + record->userLength + 1, 1, record->filmLength, file) != record->filmLength) {
+        return ERR_NOT_FOUND;
+    }
+    data[record->userLength] = '\0';
+    data[record->userLength + 1 + record->filmLength] = '\0';
+
+    if (record->checksum != journal_checksum(record, data, data + record->userLength + 1)) {
+        return ERR_NOT_FOUND;
+    }
+
+    return OK;
+}
+
+// Check the header of a journal
+static bool journal_checkHeader(const tJournalHeader* header) {
+    return memcmp(header->magic, JOURNAL_MAGIC, sizeof(header->magic)) == 0
+        && header->version == JOURNAL_VERSION && header->recordSize == sizeof(tJournalRecord);
+}
+
+// Open a journal to add records at its end, creating it if it does not exist. 
+tError journal_open(tJournal* journal, const char* path, unsigned int syncRecords, unsigned int syncIntervalMs) {
+    tJournalHeader header;
+    tJournalRecord record;
+    char* buffer = NULL;
+    size_t capacity = 0;
+    tError err;
+    long size;
+
+    // Verify pre conditions
+    assert(journal != NULL);
+    assert(path != NULL);
+
+    // Open without truncating, or create the file
+    journal->file = fopen(path, "r+b");
+    if (journal->file == NULL) {
+        journal->file = fopen(path, "w+b");
+    }
+    if (journal->file == NULL) {
+        return ERR_INVALID;
+    }
+
+    if (fseek(journal->file, 0, SEEK_END) != 0 || (size = ftell(journal->file)) < 0) {
+        fclose(journal->file);
+        return ERR_INVALID;
+    }
+
+    if (size == 0) {
+        // New journal
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = JOURNAL_VERSION;
+        header.recordSize = sizeof(tJournalRecord);
+        if (fwrite(&header, sizeof(header), 1, journal->file) != 1 || !journal_flush(journal->file)) {
+            fclose(journal->file);
+            return ERR_INVALID;
+        }
+    }
+    else {
+        if (fseek(journal->file, 0, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, journal->file) != 1 
+                || !journal_checkHeader(&header)) {
+            fclose(journal->file);
+            return ERR_INVALID;
+        }
+
+        // Records have different sizes, so they are read to find the end of 
+        // the last one. A partial record after it is removed
+        size = (long)sizeof(header);
+        while ((err = journal_read(journal->file, &record, &buffer, &capacity)) == OK) {
+            size = ftell(journal->file);
+        }
+        mem_free(buffer);
+        if (err != ERR_NOT_FOUND) {
+            fclose(journal->file);
+            return err;
+        }
+        if (!journal_truncate(journal->file, size) || fseek(journal->file, size, SEEK_SET) != 0) {
+            fclose(journal->file);
+            return ERR_INVALID;
+        }
+    }
+
+    journal->syncRecords = syncRecords;
+    journal->syncIntervalMs = syncIntervalMs;
+    journal->pending = 0;
+    journal->lastSync = journal_now();
+    journal->records = 0;
+    journal->syncs = 0;
+
+    return OK;
+}
+
+// Add the record of a view of a user of a film, syncing the group if needed
+tError journal_append(tJournal* journal, tView* view, const tUser* user, const tFilm* film) {
+    tJournalRecord record;
+    size_t userLength, filmLength;
+
+    // Verify pre conditions
+    assert(journal != NULL);
+    assert(journal->file != NULL);
+    assert(view != NULL);
+    assert(user != NULL && user->username != NULL);
+    assert(film != NULL && film->title != NULL);
+
+    // The positions of the user and the film change when the tables are 
+    // saved in a snapshot, so the record keeps their keys
+    userLength = strlen(user->username);
+    filmLength = strlen(film->title);
+    if (userLength > JOURNAL_MAX_KEY_LENGTH || filmLength > JOURNAL_MAX_KEY_LENGTH) {
+        return ERR_INVALID;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.userLength = (uint16_t)userLength;
+    record.filmLength = (uint16_t)filmLength;
+    record.year = view->timestamp.year;
+    record.month = view->timestamp.month;
+    record.day = view->timestamp.day;
+    record.hour = view->timestamp.hour;
+    record.minute = view->timestamp.minute;
+    record.score = view->score;
+    record.minutes = view->minutes;
+    record.checksum = journal_checksum(&record, user->username, film->title);
+
+    // The record stays in the buffer of the file until the group is synced
+    if (fwrite(&record, sizeof(record), 1, journal->file) != 1
+            || fwrite(user->username, 1, userLength, journal->file) != userLength
+            || fwrite(film->title, 1, filmLength, journal->file) != filmLength) {
+        return ERR_INVALID;
+    }
+    journal->pending++;
+    journal->records++;
+
+    if ((journal->syncRecords > 0 && journal->pending >= journal->syncRecords)
+            || (journal->syncIntervalMs > 0 && journal_now() - journal->lastSync >= journal->syncIntervalMs)) {
+        return journal_sync(journal);
+    }
+
+    return OK;
+}
+
+// Write all the pending records to disk
+tError journal_sync(tJournal* journal) {
+    // Verify pre conditions
+    assert(journal != NULL);
+    assert(journal->file != NULL);
+
+    if (journal->pending == 0) {
+        return OK;
+    }
+    if (!journal_flush(journal->file)) {
+        return ERR_INVALID;
+    }
+
+    journal->pending = 0;
+    journal->lastSync = journal_now();
+    journal->syncs++;
+
+    return OK;
+}
+
+// Remove all the records, usually after saving a snapshot
+tError journal_reset(tJournal* journal) {
+    // Verify pre conditions
+    assert(journal != NULL);
+    assert(journal->file != NULL);
+
+    // Only the header is kept
+    if (!journal_truncate(journal->file, (long)sizeof(tJournalHeader)) 
+            || fseek(journal->file, (long)sizeof(tJournalHeader), SEEK_SET) != 0
+            || !journal_flush(journal->file)) {
+        return ERR_INVALID;
+    }
+    journal->pending = 0;
+    journal->lastSync = journal_now();
+
+    return OK;
+}
+
+// Sync the pending records and close the journal
+tError journal_close(tJournal* journal) {
+    tError err;
+
+    // Verify pre conditions
+    assert(journal != NULL);
+    assert(journal->file != NULL);
+
+    err = journal_sync(journal);
+    if (fclose(journal->file) != 0 && err == OK) {
+        err = ERR_INVALID;
+    }
+    journal->file = NULL;
+
+    return err;
+}
+
+// Add the views of a journal to a bound log. Replay stops at the first 
+// incomplete or corrupted record, as it was not completely written. 
+tError journal_replay(const char* path, tViewLog* views, unsigned int* replayed) {
+    FILE* file;
+    tJournalHeader header;
+    tJournalRecord record;
+    tJournal* journal;
+    tDateTime timestamp;
+    tView view;
+    tUser* user;
+    tFilm* film;
+    char* buffer = NULL;
+    size_t capacity = 0;
+    unsigned int count = 0;
+    tError err = OK;
+
+    // Verify pre conditions
+    assert(path != NULL);
+    assert(views != NULL);
+
+    if (replayed != NULL) {
+        *replayed = 0;
+    }
+    if (views->users == NULL) {
+        return ERR_INVALID;
+    }
+
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        return ERR_NOT_FOUND;
+    }
+    if (fread(&header, sizeof(header), 1, file) != 1 || !journal_checkHeader(&header)) {
+        fclose(file);
+        return ERR_INVALID;
+    }
+
+    // The replayed views must not be written again to the journal of the log
+    journal = views->journal;
+    views->journal = NULL;
+
+    while (err == OK) {
+        err = journal_read(file, &record, &buffer, &capacity);
+        if (err != OK) {
+            // Incomplete or corrupted records are the end of the journal
+            if (err == ERR_NOT_FOUND) {
+                err = OK;
+            }
+            break;
+        }
+
+        // Removed users and films are not found
+        user = userTable_find(views->users, buffer);
+        film = filmTable_find(views->films, buffer + record.userLength + 1);
+        if (user == NULL || film == NULL || record.month > 12 || record.day > 31 || record.hour >= 24 
+                || record.minute > 60 || record.score >= 10) {
+            err = ERR_INVALID;
+            break;
+        }
+
+        timestamp.year = record.year;
+        timestamp.month = record.month;
+        timestamp.day = record.day;
+        timestamp.hour = record.hour;
+        timestamp.minute = record.minute;
+        view_initRef(&view, &timestamp, record.score, user, film);
+        view.minutes = record.minutes;
+
+        err = viewLog_add(views, &view);
+        if (err == OK) {
+            count++;
+        }
+        else if (err == ERR_NOT_FOUND) {
+            // The user or the film was removed from the tables
+            err = ERR_INVALID;
+        }
+    }
+
+    views->journal = journal;
+    mem_free(buffer);
+    fclose(file);
+
+    if (replayed != NULL) {
+        *replayed = count;
+    }
+
+    return err;
+}
@@ -0,0 +1,449 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "loader.h"
+#include "table.h"
+#include "mem.h"
+
+// Size of the chunks read from the files
+#define LOADER_CHUNK_SIZE 65536
+
+// Maximum number of fields of a record
+#define LOADER_MAX_FIELDS 5
+
+// Function that adds the record given by its fields to a table. Returns 
+// OK if added, ERR_MEMORY_ERROR to stop the load, or any other error to skip it
+typedef tError (*tLoaderRecordFn)(char** fields, void* context);
+
+// Function that reserves memory in a table for n more records
+typedef tError (*tLoaderReserveFn)(unsigned int n, void* context);
+
+// Parse an unsigned number that fills the whole field. Returns false if it is not valid
+static bool loader_parseUnsigned(const char* field, unsigned int* value) {
+    unsigned int result = 0;
+
+    if (*field == '\0') {
+        return false;
+    }
+    while (*field >= '0' && *field <= '9') {
+        // Numbers that do not fit are not valid
+        if (result > (UINT_MAX - (unsigned int)(*field - '0')) / 10) {
+            return false;
+        }
+        result = result * 10 + (unsigned int)(*field - '0');
+        field++;
+    }
+    *value = result;
+
+    return (*field == '\0');
+}
+
+// Parse a number with an optional minus sign
+static bool loader_parseInt(const char* field, int* value) {
+    unsigned int result;
+    bool negative = (*field == '-');
+
+    if (!loader_parseUnsigned(negative ? field + 1 : field, &result) || result > INT_MAX) {
+        return false;
+    }
+    *value = negative ? -(int)result : (int)result;
+
+    return true;
+}
+
+// Parse the digits of a part of a timestamp, followed by a separator
+static bool loader_parseDigits(const char** field, int digits, char separator, unsigned int* value) {
+    unsigned int result = 0;
+
+    while (digits > 0) {
+        if (**field < '0' || **field > '9') {
+            return false;
+        }
+        result = result * 10 + (unsigned int)(**field - '0');
+        (*field)++;
+        digits--;
+    }
+    if (**field != separator) {
+        return false;
+    }
+    if (separator != '\0') {
+        (*field)++;
+    }
+    *value = result;
+
+    return true;
+}
+
+// Parse a timestamp with the format YYYY-MM-DD hh:mm
+static bool loader_parseDateTime(const char* field, tDateTime* timestamp) {
+    unsigned int year, month, day, hour, minute;
+
+    if (!loader_parseDigits(&field, 4, '-', &year) || !loader_parseDigits(&field, 2, '-', &month)
+            || !loader_parseDigits(&field, 2, ' ', &day) || !loader_parseDigits(&field, 2, ':', &hour)
+            || !loader_parseDigits(&field, 2, '\0', &minute)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59) {
+        return false;
+    }
+
+    timestamp->year = (unsigned short)year;
+    timestamp->month = (unsigned char)month;
+    timestamp->day = (unsigned char)day;
+    timestamp->hour = (unsigned char)hour;
+    timestamp->minute = (unsigned char)minute;
+
+    return true;
+}
+
+// Split a line in fields, in place. Returns the number of fields found
+static int loader_split(char* line, char delimiter, char** fields) {
+    int count = 1;
+
+    fields[0] = line;
+    while (*line != '\0') {
+        if (*line == delimiter) {
+            // Too many fields, the record is not valid
+            if (count == LOADER_MAX_FIELDS) {
+                return LOADER_MAX_FIELDS + 1;
+            }
+            *line = '\0';
+            fields[count] = line + 1;
+            count++;
+        }
+        line++;
+    }
+
+    return count;
+}
+
+// Count the lines in a block of the buffer
+static unsigned int loader_countLines(const char* data, size_t length) {
+    unsigned int lines = 0;
+    const char* end = data + length;
+
+    while ((data = memchr(data, '\n', (size_t)(end - data))) != NULL) {
+        lines++;
+        data++;
+    }
+
+    return lines;
+}
+
+// Process one line of the file
+static tError loader_processLine(char* line, char delimiter, int numFields, 
+                        tLoaderRecordFn addRecord, void* context, tLoaderStats* stats) {
+    char* fields[LOADER_MAX_FIELDS];
+    size_t length;
+    tError err;
+
+    // Remove the end of line of files written on Windows
+    length = strlen(line);
+    if (length > 0 && line[length - 1] == '\r') {
+        line[length - 1] = '\0';
+        length--;
+    }
+
+    // Empty lines and comments are not records
+    if (length == 0 || line[0] == '#') {
+        return OK;
+    }
+
+    stats->records++;
+    if (length >= LOADER_MAX_LINE || loader_split(line, delimiter, fields) != numFields) {
+        stats->skipped++;
+        return OK;
+    }
+
+    err = addRecord(fields, context);
+    if (err == ERR_MEMORY_ERROR) {
+        return err;
+    }
+    if (err == OK) {
+        stats->loaded++;
+    }
+    else {
+        stats->skipped++;
+    }
+
+    return OK;
+}
+
+// Read a file in chunks, adding each record to a table. Before processing 
+// a chunk, memory is reserved in the table for all the lines it contains. 
+// The capacity still grows geometrically, to avoid a reallocation per chunk
+static tError loader_run(FILE* file, char delimiter, int numFields, tLoaderRecordFn addRecord, 
+                        tLoaderReserveFn reserve, void* context, tLoaderStats* stats) {
+    tLoaderStats localStats;
+    char* buffer;
+    char* line;
+    char* end;
+    size_t used = 0;
+    size_t start;
+    size_t read;
+    bool skipping = false;
+    tError err = OK;
+
+    // Verify pre conditions
+    assert(file != NULL);
+    assert(delimiter != '\0' && delimiter != '\n');
+
+    if (stats == NULL) {
+        stats = &localStats;
+    }
+    memset(stats, 0, sizeof(tLoaderStats));
+
+    // One more byte to always end the buffer with '\0'
+    buffer = (char*)mem_alloc(MEM_STORAGE, LOADER_CHUNK_SIZE + 1);
+    if (buffer == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    do {
+        // Fill the buffer after the incomplete line of the previous chunk
+        read = fread(buffer + used, 1, LOADER_CHUNK_SIZE - used, file);
+        if (read > 0 && reserve != NULL) {
+            err = reserve(loader_countLines(buffer + used, read) + 1, context);
+            if (err != OK) {
+                break;
+            }
+        }
+        used += read;
+        buffer[used] = '\0';
+
+        // Process all the complete lines, and the last one at the end of the file
+        start = 0;
+        while (start < used) {
+            line = buffer + start;
+            end = memchr(line, '\n', used - start);
+            if (end == NULL) {
+                if (read > 0) {
+                    // Incomplete line, wait for the next chunk
+                    break;
+                }
+                end = buffer + used;
+            }
+            *end = '\0';
+            start = (size_t)(end - buffer) + 1;
+
+            // Discard the rest of a line that did not fit in the buffer
+            if (skipping) {
+                skipping = false;
+                continue;
+            }
+            err = loader_processLine(line, delimiter, numFields, addRecord, context, stats);
+            if (err != OK) {
+                break;
+            }
+        }
+        if (err != OK) {
+            break;
+        }
+
+        // Move the incomplete line to the beginning of the buffer
+        if (start < used) {
+            used -= start;
+            memmove(buffer, buffer + start, used);
+        }
+        else {
+            used = 0;
+        }
+
+        // Lines longer than LOADER_MAX_LINE are skipped
+        if (used >= LOADER_MAX_LINE || used == LOADER_CHUNK_SIZE) {
+            if (!skipping) {
+                stats->records++;
+                stats->skipped++;
+            }
+            skipping = true;
+            used = 0;
+        }
+    } while (read > 0);
+
+    if (err == OK && ferror(file)) {
+        err = ERR_INVALID;
+    }
+
+    mem_free(buffer);
+
+    return err;
+}
+
+// **** Users
+
+// Add a user record to the table
+static tError loader_addUser(char** fields, void* context) {
+    tUser user;
+
+    // userTable_add copies the fields, so the user can reference the buffer
+    user.username = fields[0];
+    user.name = fields[1];
+    user.mail = fields[2];
+
+    return userTable_add((tUserTable*)context, &user);
+}
+
+// Reserve memory for n more users
+static tError loader_reserveUsers(unsigned int n, void* context) {
+    tUserTable* users = (tUserTable*)context;
+
+    return userTable_reserve(users, table_growCapacity(users->capacity, users->size + n));
+}
+
+// Load users into a table. stats can be NULL
+tError loader_loadUsers(FILE* file, char delimiter, tUserTable* users, tLoaderStats* stats) {
+    // Verify pre conditions
+    assert(users != NULL);
+
+    return loader_run(file, delimiter, 3, loader_addUser, loader_reserveUsers, users, stats);
+}
+
+// **** Series
+
+// Add a series record to the table
+static tError loader_addSeries(char** fields, void* context) {
+    tSeries series;
+    unsigned int genre;
+
+    if (!loader_parseUnsigned(fields[1], &genre) || genre == GENRE_NOT_FOUND || genre >= GENRE_QTY) {
+        return ERR_INVALID;
+    }
+
+    // seriesTable_add copies the series, so it can reference the buffer
+    series.title = fields[0];
+    series.genre = (tGenre)genre;
+
+    return seriesTable_add((tSeriesTable*)context, &series);
+}
+
+// Reserve memory for n more series
+static tError loader_reserveSeries(unsigned int n, void* context) {
+    tSeriesTable* series = (tSeriesTable*)context;
+
+    return seriesTable_reserve(series, table_growCapacity(series->capacity, series->size + n));
+}
+
+// Load series into a table. stats can be NULL
+tError loader_loadSeries(FILE* file, char delimiter, tSeriesTable* series, tLoaderStats* stats) {
+    // Verify pre conditions
+    assert(series != NULL);
+
+    return loader_run(file, delimiter, 2, loader_addSeries, loader_reserveSeries, series, stats);
+}
+
+// **** Films
+
+// Tables used to load films
+typedef struct {
+    tSeriesTable* series;
+    tFilmTable* films;
+} tLoaderFilmsContext;
+
+// Add a film record to the table
+static tError loader_addFilm(char** fields, void* context) {
+    tLoaderFilmsContext* tables = (tLoaderFilmsContext*)context;
+    tFilm film;
+    unsigned int length;
+
+    if (!loader_parseUnsigned(fields[1], &length) || length > 0xFFFF) {
+        return ERR_INVALID;
+    }
+
+    film.series = seriesTable_find(tables->series, fields[2]);
+    if (film.series == NULL) {
+        return ERR_NOT_FOUND;
+    }
+
+    // filmTable_add copies the film, so it can reference the buffer
+    film.title = fields[0];
+    film.lengthInMin = (unsigned short)length;
+
+    return filmTable_add(tables->films, &film);
+}
+
+// Reserve memory for n more films
+static tError loader_reserveFilms(unsigned int n, void* context) {
+    tFilmTable* films = ((tLoaderFilmsContext*)context)->films;
+
+    return filmTable_reserve(films, table_growCapacity(films->capacity, films->size + n));
+}
+
+// Load films into a table, resolving their series by title. stats can be NULL
+tError loader_loadFilms(FILE* file, char delimiter, tSeriesTable* series, tFilmTable* films, 
+                        tLoaderStats* stats) {
+    tLoaderFilmsContext context;
+
+    // Verify pre conditions
+    assert(series != NULL);
+    assert(films != NULL);
+
+    context.series = series;
+    context.films = films;
+
+    return loader_run(file, delimiter, 3, loader_addFilm, loader_reserveFilms, &context, stats);
+}
+
+// **** Views
+
+// Tables used to load views
+typedef struct {
+    tUserTable* users;
+    tFilmTable* films;
+    tViewLog* views;
+} tLoaderViewsContext;
+
+// Add a view record to the log
+static tError loader_addView(char** fields, void* context) {
+    tLoaderViewsContext* tables = (tLoaderViewsContext*)context;
+    tView view;
+    tDateTime timestamp;
+    tUser* user;
+    tFilm* film;
+    int score;
+    unsigned int minutes;
+
+    // Scores are below 10 (see view_init) and fit in the view
+    if (!loader_parseDateTime(fields[2], &timestamp) || !loader_parseInt(fields[3], &score) 
+            || score >= 10 || score < SHRT_MIN
+            || !loader_parseUnsigned(fields[4], &minutes) || minutes > 0xFFFF) {
+        return ERR_INVALID;
+    }
+
+    user = userTable_find(tables->users, fields[0]);
+    film = filmTable_find(tables->films, fields[1]);
+    if (user == NULL || film == NULL) {
+        return ERR_NOT_FOUND;
+    }
+
+    // The log copies what it needs, so the view only references the user and the film
+    view_initRef(&view, &timestamp, (short)score, user, film);
+    view.minutes = (unsigned short)minutes;
+
+    return viewLog_add(tables->views, &view);
+}
+
+// Reserve memory for n more views
+static tError loader_reserveViews(unsigned int n, void* context) {
+    tViewLog* views = ((tLoaderViewsContext*)context)->views;
+
+    return viewLog_reserve(views, table_growCapacity(views->capacity, views->size + n));
+}
+
+// Load views into a log, resolving their users and films by username and title. 
+// Views of a bound log must reference its tables. stats can be NULL
+tError loader_loadViews(FILE* file, char delimiter, tUserTable* users, tFilmTable* films, 
+                        tViewLog* views, tLoaderStats* stats) {
+    tLoaderViewsContext context;
+
+    // Verify pre conditions
+    assert(users != NULL);
+    assert(films != NULL);
+    assert(views != NULL);
+
+    context.users = users;
+    context.films = films;
+    context.views = views;
+
+    return loader_run(file, delimiter, 5, loader_addView, loader_reserveViews, &context, stats);
+}
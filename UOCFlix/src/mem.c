@@ -0,0 +1,273 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "mem.h"
+#include "sync.h"
+
+// Size of the header stored before each block. It keeps the blocks
+// aligned as the blocks returned by malloc
+#define MEM_HEADER_SIZE 32
+
+// Header stored before each block, with what is needed to resize and release it
+typedef union {
+    struct {
+        size_t size;
+        const tAllocator* allocator;
+        unsigned int subsystem;
+        bool counted;
+    } info;
+    long double align;
+    char pad[MEM_HEADER_SIZE];
+} tMemHeader;
+
+// Counters of a subsystem, updated by several threads at the same time
+typedef struct {
+    volatile unsigned long long liveBytes;
+    volatile unsigned long long liveBlocks;
+    volatile unsigned long long highWater;
+    volatile unsigned long long allocations;
+} tMemCounters;
+
+// malloc with the signature of an allocator
+static void* mem_defaultAllocate(size_t size, void* context) {
+    return malloc(size);
+}
+
+// realloc with the signature of an allocator
+static void* mem_defaultReallocate(void* ptr, size_t size, void* context) {
+    return realloc(ptr, size);
+}
+
+// free with the signature of an allocator
+static void mem_defaultRelease(void* ptr, void* context) {
+    free(ptr);
+}
+
+// Allocator used when no other allocator is set
+static const tAllocator memDefaultAllocator = { mem_defaultAllocate, mem_defaultReallocate, mem_defaultRelease, NULL };
+
+// Storage class of the variables that are private to each thread
+#if defined(_MSC_VER)
+#define MEM_THREAD_LOCAL __declspec(thread)
+#else
+#define MEM_THREAD_LOCAL __thread
+#endif
+
+// Allocator used for the next blocks
+static const tAllocator* memAllocator = &memDefaultAllocator;
+
+// Allocator used for the next blocks of each thread, instead of memAllocator
+static MEM_THREAD_LOCAL const tAllocator* memThreadAllocator = NULL;
+
+// Counters of each subsystem. The last entry counts the whole library
+static tMemCounters memCounters[MEM_SUBSYSTEM_QTY + 1];
+
+// Names of the subsystems, in the order of tMemSubsystem
+static const char* memSubsystemNames[MEM_SUBSYSTEM_QTY] = {
+    "user", "film", "series", "view", "favorite", "index", "intern", "storage", "report", "arena", "recommend", "segment"
+};
+
+// Add a change of the memory to a set of counters
+static void memCounters_add(tMemCounters* counters, long long bytes, long long blocks, bool allocation) {
+    unsigned long long live;
+    unsigned long long highWater;
+
+    live = atomic_fetchAdd64(&counters->liveBytes, (unsigned long long)bytes) + (unsigned long long)bytes;
+    atomic_fetchAdd64(&counters->liveBlocks, (unsigned long long)blocks);
+    if (allocation) {
+        atomic_fetchAdd64(&counters->allocations, 1);
+    }
+
+    // Other threads can raise the high water mark at the same time
+    highWater = atomic_fetchAdd64(&counters->highWater, 0);
+    while (live > highWater && !atomic_compareExchange64(&counters->highWater, highWater, live)) {
+        highWater = atomic_fetchAdd64(&counters->highWater, 0);
+    }
+}
+
+// Add a change of the memory of a subsystem to its counters and to the total
+static void mem_count(unsigned int subsystem, long long bytes, long long blocks, bool allocation) {
+    memCounters_add(&memCounters[subsystem], bytes, blocks, allocation);
+    memCounters_add(&memCounters[MEM_SUBSYSTEM_QTY], bytes, blocks, allocation);
+}
+
+// Set the allocator used for the next blocks of the library
+void mem_setAllocator(const tAllocator* allocator) {
+    if (allocator == NULL) {
+        memAllocator = &memDefaultAllocator;
+    } else {
+        assert(allocator->allocate != NULL);
+        memAllocator = allocator;
+    }
+}
+
+// Set the allocator used for the next blocks of the calling thread, and get the previous one
+const tAllocator* mem_setThreadAllocator(const tAllocator* allocator) {
+    const tAllocator* previous = memThreadAllocator;
+
+    // Verify pre conditions
+    assert(allocator == NULL || allocator->allocate != NULL);
+
+    memThreadAllocator = allocator;
+    return previous;
+}
+
+// Get the allocator set for the calling thread, or NULL if it has none
+const tAllocator* mem_getThreadAllocator(void) {
+    return memThreadAllocator;
+}
+
+// Allocate a block of memory for a subsystem. Returns NULL if there is no memory
+void* mem_alloc(tMemSubsystem subsystem, size_t size) {
+    const tAllocator* allocator = (memThreadAllocator != NULL) ? memThreadAllocator : memAllocator;
+    tMemHeader* header;
+
+    // Verify pre conditions
+    assert(subsystem < MEM_SUBSYSTEM_QTY);
+
+    if (size > (size_t)-1 - sizeof(tMemHeader)) {
+        return NULL;
+    }
+    header = (tMemHeader*)allocator->allocate(sizeof(tMemHeader) + size, allocator->context);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->info.size = size;
+    header->info.allocator = allocator;
+    header->info.subsystem = subsystem;
+
+    // The blocks of a region are released with the region, that counts its own memory
+    header->info.counted = (allocator->release != NULL);
+    mem_count(subsystem, header->info.counted ? (long long)size : 0, header->info.counted ? 1 : 0, true);
+
+    return header + 1;
+}
+
+// Allocate a block for n elements of the given size, set to 0
+void* mem_calloc(tMemSubsystem subsystem, size_t n, size_t size) {
+    void* ptr;
+
+    // Check the total size does not overflow
+    if (size != 0 && n > (size_t)-1 / size) {
+        return NULL;
+    }
+    ptr = mem_alloc(subsystem, n * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, n * size);
+    }
+
+    return ptr;
+}
+
+// Change the size of a block. A NULL block allocates a new one.
+// Returns NULL if there is no memory, keeping the old block
+void* mem_realloc(tMemSubsystem subsystem, void* ptr, size_t size) {
+    tMemHeader* header;
+    tMemHeader* resized;
+    const tAllocator* allocator;
+    size_t oldSize;
+
+    if (ptr == NULL) {
+        return mem_alloc(subsystem, size);
+    }
+    if (size > (size_t)-1 - sizeof(tMemHeader)) {
+        return NULL;
+    }
+
+    // The block keeps its allocator and its subsystem
+    header = (tMemHeader*)ptr - 1;
+    allocator = header->info.allocator;
+    oldSize = header->info.size;
+    if (allocator->reallocate != NULL) {
+        resized = (tMemHeader*)allocator->reallocate(header, sizeof(tMemHeader) + size, allocator->context);
+        if (resized == NULL) {
+            return NULL;
+        }
+    } else {
+        // Copy the block to a new block of the same allocator
+        resized = (tMemHeader*)allocator->allocate(sizeof(tMemHeader) + size, allocator->context);
+        if (resized == NULL) {
+            return NULL;
+        }
+        memcpy(resized, header, sizeof(tMemHeader) + ((size < oldSize) ? size : oldSize));
+        if (allocator->release != NULL) {
+            allocator->release(header, allocator->context);
+        }
+    }
+    resized->info.size = size;
+    mem_count(resized->info.subsystem, resized->info.counted ? (long long)size - (long long)oldSize : 0, 0, true);
+
+    return resized + 1;
+}
+
+// Release a block of memory. Accepts NULL, that is ignored
+void mem_free(void* ptr) {
+    tMemHeader* header;
+
+    if (ptr == NULL) {
+        return;
+    }
+    header = (tMemHeader*)ptr - 1;
+    if (!header->info.counted) {
+        // Blocks of a region are released with the region
+        return;
+    }
+    mem_count(header->info.subsystem, -(long long)header->info.size, -1, false);
+    header->info.allocator->release(header, header->info.allocator->context);
+}
+
+// Copy a set of counters, that can be changed by other threads while it is read
+static void memCounters_get(tMemCounters* counters, tMemStats* stats) {
+    stats->liveBytes = atomic_fetchAdd64(&counters->liveBytes, 0);
+    stats->liveBlocks = atomic_fetchAdd64(&counters->liveBlocks, 0);
+    stats->highWater = atomic_fetchAdd64(&counters->highWater, 0);
+    stats->allocations = atomic_fetchAdd64(&counters->allocations, 0);
+}
+
+// Get the counters of a subsystem
+void mem_getStats(tMemSubsystem subsystem, tMemStats* stats) {
+    // Verify pre conditions
+    assert(subsystem < MEM_SUBSYSTEM_QTY);
+    assert(stats != NULL);
+
+    memCounters_get(&memCounters[subsystem], stats);
+}
+
+// Get the counters of the whole library
+void mem_getTotalStats(tMemStats* stats) {
+    // Verify pre conditions
+    assert(stats != NULL);
+
+    memCounters_get(&memCounters[MEM_SUBSYSTEM_QTY], stats);
+}
+
+// Get the name of a subsystem
+const char* mem_subsystemName(tMemSubsystem subsystem) {
+    // Verify pre conditions
+    assert(subsystem < MEM_SUBSYSTEM_QTY);
+
+    return memSubsystemNames[subsystem];
+}
+
+// Write one line with a set of counters
+static void mem_dumpStats(FILE* fout, const char* name, tMemStats* stats) {
+    fprintf(fout, "%-10s %16llu %12llu %16llu %14llu\n", name, stats->liveBytes, stats->liveBlocks,
+            stats->highWater, stats->allocations);
+}
+
+// Write the counters of all the subsystems
+void mem_dump(FILE* fout) {
+    unsigned int i;
+    tMemStats stats;
+
+    // Verify pre conditions
+    assert(fout != NULL);
+
+    fprintf(fout, "%-10s %16s %12s %16s %14s\n", "SUBSYSTEM", "LIVE BYTES", "LIVE BLOCKS", "HIGH WATER", "ALLOCATIONS");
+    for (i = 0; i < MEM_SUBSYSTEM_QTY; i++) {
+        mem_getStats((tMemSubsystem)i, &stats);
+        mem_dumpStats(fout, memSubsystemNames[i], &stats);
+    }
+    mem_getTotalStats(&stats);
+    mem_dumpStats(fout, "total", &stats);
+}
@@ -0,0 +1,618 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "recommend.h"
+#include "table.h"
+#include "sync.h"
+#include "topk.h"
+#include "mem.h"
+
+// Number of entries of the counts when the first id is added. Must be a power of 2
+#define RECOMMEND_COUNTS_INITIAL_CAPACITY 8
+
+// **** Functions related to management of tRecommendCounts objects
+
+// Get the first entry of the probe sequence of an id
+static unsigned int recommendCounts_home(unsigned int id, unsigned int capacity) {
+    // Multiplicative hashing spreads consecutive positions over the table
+    return (id * 2654435761u) & (capacity - 1);
+}
+
+// Get the entry of an id, or NULL if the id has no entry
+static tRecommendCount* recommendCounts_find(tRecommendCounts* counts, unsigned int id) {
+    unsigned int i;
+
+    if (counts->size == 0) {
+        return NULL;
+    }
+
+    // Walk the probe sequence until an empty entry is found
+    i = recommendCounts_home(id, counts->capacity);
+    while (counts->entries[i].key != 0) {
+        if (counts->entries[i].key == id + 1) {
+            return &(counts->entries[i]);
+        }
+        i = (i + 1) & (counts->capacity - 1);
+    }
+
+    return NULL;
+}
+
+// Get the count of an id, or 0 if the id has no entry
+static unsigned int recommendCounts_get(tRecommendCounts* counts, unsigned int id) {
+    tRecommendCount* entry = recommendCounts_find(counts, id);
+
+    return (entry != NULL) ? entry->count : 0;
+}
+
+// Ensure there is space for n entries without growing
+static tError recommendCounts_reserve(tRecommendCounts* counts, unsigned int n) {
+    unsigned int capacity;
+    unsigned int i, j;
+    tRecommendCount* entries;
+
+    // Keep the load factor under 70% to have short probe sequences
+    capacity = (counts->capacity == 0) ? RECOMMEND_COUNTS_INITIAL_CAPACITY : counts->capacity;
+    while (n * 10 > capacity * 7) {
+        capacity *= 2;
+    }
+    if (capacity == counts->capacity) {
+        return OK;
+    }
+
+    // calloc leaves all the entries empty
+    entries = (tRecommendCount*)mem_calloc(MEM_RECOMMEND, capacity, sizeof(tRecommendCount));
+    if (entries == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < counts->capacity; i++) {
+        if (counts->entries[i].key != 0) {
+            j = recommendCounts_home(counts->entries[i].key - 1, capacity);
+            while (entries[j].key != 0) {
+                j = (j + 1) & (capacity - 1);
+            }
+            entries[j] = counts->entries[i];
+        }
+    }
+
+    mem_free(counts->entries);
+    counts->entries = entries;
+    counts->capacity = capacity;
+
+    return OK;
+}
+
+// Ensure there is space for one more entry, unless the id already has one
+static tError recommendCounts_reserveId(tRecommendCounts* counts, unsigned int id) {
+    if (recommendCounts_find(counts, id) != NULL) {
+        return OK;
+    }
+    return recommendCounts_reserve(counts, counts->size + 1);
+}
+
+// Add 1 to the count of an id. There must be space for its entry (see recommendCounts_reserve)
+static void recommendCounts_increment(tRecommendCounts* counts, unsigned int id) {
+    tRecommendCount* entry;
+    unsigned int i;
+
+    entry = recommendCounts_find(counts, id);
+    if (entry != NULL) {
+        entry->count++;
+        return;
+    }
+
+    assert((counts->size + 1) * 10 <= counts->capacity * 7);
+    i = recommendCounts_home(id, counts->capacity);
+    while (counts->entries[i].key != 0) {
+        i = (i + 1) & (counts->capacity - 1);
+    }
+    counts->entries[i].key = id + 1;
+    counts->entries[i].count = 1;
+    counts->size++;
+}
+
+// Remove 1 from the count of an id, that must be over 0. The entry is kept
+static void recommendCounts_decrement(tRecommendCounts* counts, unsigned int id) {
+    tRecommendCount* entry = recommendCounts_find(counts, id);
+
+    assert(entry != NULL && entry->count > 0);
+    entry->count--;
+}
+
+// Release the memory used by the counts
+static void recommendCounts_free(tRecommendCounts* counts) {
+    mem_free(counts->entries);
+    counts->entries = NULL;
+    counts->size = 0;
+    counts->capacity = 0;
+}
+
+// **** Functions related to management of tRecommender objects
+
+// Get the key used by the hash index of the series of a recommender
+static const char* recommender_getSeriesKey(void* table, unsigned int position) {
+    return ((tRecommender*)table)->series[position].series->title;
+}
+
+// Initialize an empty recommender bound to a table of users and a table of films
+void recommender_init(tRecommender* recommender, tUserTable* users, tFilmTable* films) {
+    // Verify pre conditions
+    assert(recommender != NULL);
+    assert(users != NULL);
+    assert(films != NULL);
+
+    // The counts are kept by the positions of the users and the films, so 
+    // the tables must not move them while the recommender is bound
+    userTable_addReference(users);
+    filmTable_addReference(films);
+    recommender->users = users;
+    recommender->films = films;
+
+    // No memory is allocated until the first view or favorite is added
+    recommender->userCount = 0;
+    recommender->userCounts = NULL;
+    recommender->filmCount = 0;
+    recommender->filmCounts = NULL;
+    recommender->seriesSize = 0;
+    recommender->seriesCapacity = 0;
+    recommender->series = NULL;
+    hashIndex_init(&recommender->seriesIndex);
+
+    // By default the recommender is not shared between threads
+    recommender->lock = NULL;
+}
+
+// Release the memory used by a recommender
+void recommender_free(tRecommender* recommender) {
+    unsigned int i, j;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+
+    for (i = 0; i < recommender->userCount; i++) {
+        for (j = 0; j < RECOMMEND_SOURCE_QTY; j++) {
+            recommendCounts_free(&(recommender->userCounts[i].films[j]));
+        }
+        recommendCounts_free(&(recommender->userCounts[i].series));
+    }
+    for (i = 0; i < recommender->filmCount; i++) {
+        for (j = 0; j < RECOMMEND_SOURCE_QTY; j++) {
+            recommendCounts_free(&(recommender->filmCounts[i].pairs[j]));
+        }
+    }
+    for (i = 0; i < recommender->seriesSize; i++) {
+        recommendCounts_free(&(recommender->series[i].pairs));
+    }
+    mem_free(recommender->userCounts);
+    mem_free(recommender->filmCounts);
+    mem_free(recommender->series);
+    hashIndex_free(&recommender->seriesIndex);
+
+    recommender->userCount = 0;
+    recommender->userCounts = NULL;
+    recommender->filmCount = 0;
+    recommender->filmCounts = NULL;
+    recommender->seriesSize = 0;
+    recommender->seriesCapacity = 0;
+    recommender->series = NULL;
+
+    // The tables can move their elements again
+    if (recommender->users != NULL) {
+        userTable_releaseReference(recommender->users);
+        filmTable_releaseReference(recommender->films);
+        recommender->users = NULL;
+        recommender->films = NULL;
+    }
+}
+
+// Ensure there are counts for the user and the film at the given positions
+static tError recommender_reserveIds(tRecommender* recommender, unsigned int userId, unsigned int filmId) {
+    unsigned int capacity;
+    tRecommendUser* userCounts;
+    tRecommendFilm* filmCounts;
+
+    // The arrays grow geometrically, and the new counts start empty
+    // (all the fields to 0)
+    if (userId >= recommender->userCount) {
+        capacity = table_growCapacity(recommender->userCount, userId + 1);
+        userCounts = (tRecommendUser*)mem_realloc(MEM_RECOMMEND, recommender->userCounts, capacity * sizeof(tRecommendUser));
+        if (userCounts == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+        memset(&userCounts[recommender->userCount], 0, (capacity - recommender->userCount) * sizeof(tRecommendUser));
+        recommender->userCounts = userCounts;
+        recommender->userCount = capacity;
+    }
+    if (filmId >= recommender->filmCount) {
+        capacity = table_growCapacity(recommender->filmCount, filmId + 1);
+        filmCounts = (tRecommendFilm*)mem_realloc(MEM_RECOMMEND, recommender->filmCounts, capacity * sizeof(tRecommendFilm));
+        if (filmCounts == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+        memset(&filmCounts[recommender->filmCount], 0, (capacity - recommender->filmCount) * sizeof(tRecommendFilm));
+        recommender->filmCounts = filmCounts;
+        recommender->filmCount = capacity;
+    }
+
+    return OK;
+}
+
+// Get the position of a series in the recommender, adding it if needed.
+// Returns false if there is no memory to add it
+static bool recommender_getSeriesId(tRecommender* recommender, tSeries* series, unsigned int* seriesId) {
+    unsigned int hash;
+    unsigned int capacity;
+    tRecommendSeries* elements;
+
+    hash = hash_string(series->title);
+    if (hashIndex_find(&recommender->seriesIndex, series->title, hash, recommender_getSeriesKey, recommender, seriesId)) {
+        return true;
+    }
+
+    if (recommender->seriesSize == recommender->seriesCapacity) {
+        capacity = table_growCapacity(recommender->seriesCapacity, recommender->seriesSize + 1);
+        elements = (tRecommendSeries*)mem_realloc(MEM_RECOMMEND, recommender->series, capacity * sizeof(tRecommendSeries));
+        if (elements == NULL) {
+            return false;
+        }
+        recommender->series = elements;
+        recommender->seriesCapacity = capacity;
+    }
+    if (hashIndex_insert(&recommender->seriesIndex, hash, recommender->seriesSize) != OK) {
+        return false;
+    }
+
+    elements = &(recommender->series[recommender->seriesSize]);
+    elements->series = series;
+    elements->users = 0;
+    memset(&elements->pairs, 0, sizeof(tRecommendCounts));
+    *seriesId = recommender->seriesSize;
+    recommender->seriesSize++;
+
+    return true;
+}
+
+// Get the pairs of an id of a source
+typedef tRecommendCounts* (*tRecommendPairsFn)(tRecommender* recommender, tRecommendSource source, unsigned int id);
+
+// Get the pairs of a film
+static tRecommendCounts* recommender_filmPairs(tRecommender* recommender, tRecommendSource source, unsigned int id) {
+    return &(recommender->filmCounts[id].pairs[source]);
+}
+
+// Get the pairs of a series, that only counts views
+static tRecommendCounts* recommender_seriesPairs(tRecommender* recommender, tRecommendSource source, unsigned int id) {
+    return &(recommender->series[id].pairs);
+}
+
+// Ensure there is space to count that a user added an id to its counts, 
+// pairing it with the other ids of the user if it is the first time
+static tError recommender_reserveAdd(tRecommender* recommender, tRecommendSource source, tRecommendCounts* userIds, 
+                                     unsigned int id, tRecommendPairsFn getPairs) {
+    unsigned int i;
+    tRecommendCounts* pairs;
+
+    if (recommendCounts_get(userIds, id) > 0) {
+        return OK;
+    }
+    if (recommendCounts_reserveId(userIds, id) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // The id is paired with each id of the user, and each of them with the id
+    pairs = getPairs(recommender, source, id);
+    if (recommendCounts_reserve(pairs, pairs->size + userIds->size) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < userIds->capacity; i++) {
+        if (userIds->entries[i].count > 0 && userIds->entries[i].key != id + 1) {
+            if (recommendCounts_reserveId(getPairs(recommender, source, userIds->entries[i].key - 1), id) != OK) {
+                return ERR_MEMORY_ERROR;
+            }
+        }
+    }
+
+    return OK;
+}
+
+// Count that a user added an id, once recommender_reserveAdd made space for it. 
+// users is the number of users of the id
+static void recommender_applyAdd(tRecommender* recommender, tRecommendSource source, tRecommendCounts* userIds, 
+                                 unsigned int id, tRecommendPairsFn getPairs, unsigned int* users) {
+    unsigned int i, other;
+
+    if (recommendCounts_get(userIds, id) == 0) {
+        for (i = 0; i < userIds->capacity; i++) {
+            if (userIds->entries[i].count > 0 && userIds->entries[i].key != id + 1) {
+                other = userIds->entries[i].key - 1;
+                recommendCounts_increment(getPairs(recommender, source, id), other);
+                recommendCounts_increment(getPairs(recommender, source, other), id);
+            }
+        }
+        (*users)++;
+    }
+    recommendCounts_increment(userIds, id);
+}
+
+// Count that a user removed an id, that it added before. 
+// The pairs of the id are removed with the last time it was added
+static void recommender_applyRemove(tRecommender* recommender, tRecommendSource source, tRecommendCounts* userIds, 
+                                    unsigned int id, tRecommendPairsFn getPairs, unsigned int* users) {
+    unsigned int i, other;
+
+    recommendCounts_decrement(userIds, id);
+    if (recommendCounts_get(userIds, id) == 0) {
+        for (i = 0; i < userIds->capacity; i++) {
+            if (userIds->entries[i].count > 0) {
+                other = userIds->entries[i].key - 1;
+                recommendCounts_decrement(getPairs(recommender, source, id), other);
+                recommendCounts_decrement(getPairs(recommender, source, other), id);
+            }
+        }
+        (*users)--;
+    }
+}
+
+// Count that a user added a film from a source. Nothing is counted if there is no memory
+static tError recommender_addUnlocked(tRecommender* recommender, tRecommendSource source, 
+                                      unsigned int userId, unsigned int filmId) {
+    tRecommendUser* user;
+    tRecommendFilm* film;
+    unsigned int seriesId = 0;
+
+    // Verify pre conditions
+    assert(userId < recommender->users->size);
+    assert(filmId < recommender->films->size);
+
+    // Make space for all the counts before changing any of them
+    if (recommender_reserveIds(recommender, userId, filmId) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+    user = &(recommender->userCounts[userId]);
+    if (recommender_reserveAdd(recommender, source, &user->films[source], filmId, recommender_filmPairs) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+    if (source == RECOMMEND_VIEWS) {
+        if (!recommender_getSeriesId(recommender, recommender->films->elements[filmId].series, &seriesId)
+                || recommender_reserveAdd(recommender, source, &user->series, seriesId, recommender_seriesPairs) != OK) {
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    film = &(recommender->filmCounts[filmId]);
+    recommender_applyAdd(recommender, source, &user->films[source], filmId, recommender_filmPairs, &film->users[source]);
+    if (source == RECOMMEND_VIEWS) {
+        recommender_applyAdd(recommender, source, &user->series, seriesId, recommender_seriesPairs, 
+                             &(recommender->series[seriesId].users));
+    }
+
+    return OK;
+}
+
+// Count that a user removed a film from a source. It does not allocate memory
+static tError recommender_removeUnlocked(tRecommender* recommender, tRecommendSource source, 
+                                         unsigned int userId, unsigned int filmId) {
+    tRecommendUser* user;
+    unsigned int seriesId;
+
+    if (userId >= recommender->userCount || filmId >= recommender->filmCount
+            || recommendCounts_get(&(recommender->userCounts[userId].films[source]), filmId) == 0) {
+        return ERR_NOT_FOUND;
+    }
+
+    user = &(recommender->userCounts[userId]);
+    recommender_applyRemove(recommender, source, &user->films[source], filmId, recommender_filmPairs, 
+                            &(recommender->filmCounts[filmId].users[source]));
+
+    // The series was added with the view, so it has an entry
+    if (source == RECOMMEND_VIEWS) {
+        if (hashIndex_find(&recommender->seriesIndex, recommender->films->elements[filmId].series->title, 
+                hash_string(recommender->films->elements[filmId].series->title), recommender_getSeriesKey, 
+                recommender, &seriesId)) {
+            recommender_applyRemove(recommender, source, &user->series, seriesId, recommender_seriesPairs, 
+                                    &(recommender->series[seriesId].users));
+        }
+    }
+
+    return OK;
+}
+
+// Count a view of a user of a film, given by their positions in the tables
+tError recommender_addView(tRecommender* recommender, unsigned int userId, unsigned int filmId) {
+    tError result;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+
+    rwlock_writeLock(recommender->lock);
+    result = recommender_addUnlocked(recommender, RECOMMEND_VIEWS, userId, filmId);
+    rwlock_writeUnlock(recommender->lock);
+
+    return result;
+}
+
+// Remove a view counted by recommender_addView
+tError recommender_removeView(tRecommender* recommender, unsigned int userId, unsigned int filmId) {
+    tError result;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+
+    rwlock_writeLock(recommender->lock);
+    result = recommender_removeUnlocked(recommender, RECOMMEND_VIEWS, userId, filmId);
+    rwlock_writeUnlock(recommender->lock);
+
+    return result;
+}
+
+// Count a favorite of a user, given by the positions of the user and the film in the tables
+tError recommender_addFavorite(tRecommender* recommender, unsigned int userId, unsigned int filmId) {
+    tError result;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+
+    rwlock_writeLock(recommender->lock);
+    result = recommender_addUnlocked(recommender, RECOMMEND_FAVORITES, userId, filmId);
+    rwlock_writeUnlock(recommender->lock);
+
+    return result;
+}
+
+// Remove a favorite counted by recommender_addFavorite
+tError recommender_removeFavorite(tRecommender* recommender, unsigned int userId, unsigned int filmId) {
+    tError result;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+
+    rwlock_writeLock(recommender->lock);
+    result = recommender_removeUnlocked(recommender, RECOMMEND_FAVORITES, userId, filmId);
+    rwlock_writeUnlock(recommender->lock);
+
+    return result;
+}
+
+// Get the position of a film of the table of films of a recommender
+static unsigned int recommender_getFilmId(tRecommender* recommender, tFilm* film) {
+    // Verify pre conditions
+    assert(film >= recommender->films->elements && film < recommender->films->elements + recommender->films->size);
+
+    return (unsigned int)(film - recommender->films->elements);
+}
+
+// Get the number of users that added both films
+unsigned int recommender_getPairCount(tRecommender* recommender, tRecommendSource source, tFilm* film1, tFilm* film2) {
+    unsigned int id1, id2;
+    unsigned int result = 0;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+    assert(source < RECOMMEND_SOURCE_QTY);
+
+    id1 = recommender_getFilmId(recommender, film1);
+    id2 = recommender_getFilmId(recommender, film2);
+
+    rwlock_readLock(recommender->lock);
+    if (id1 < recommender->filmCount) {
+        result = recommendCounts_get(&(recommender->filmCounts[id1].pairs[source]), id2);
+    }
+    rwlock_readUnlock(recommender->lock);
+
+    return result;
+}
+
+// Get the number of users that added a film
+unsigned int recommender_getUserCount(tRecommender* recommender, tRecommendSource source, tFilm* film) {
+    unsigned int id;
+    unsigned int result = 0;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+    assert(source < RECOMMEND_SOURCE_QTY);
+
+    id = recommender_getFilmId(recommender, film);
+
+    rwlock_readLock(recommender->lock);
+    if (id < recommender->filmCount) {
+        result = recommender->filmCounts[id].users[source];
+    }
+    rwlock_readUnlock(recommender->lock);
+
+    return result;
+}
+
+// Select the k ids with the highest counts of a set of pairs. Ties go to the lowest id
+static tError recommender_selectPairs(tRecommendCounts* pairs, unsigned int k, tTopK* top) {
+    unsigned int i;
+
+    if (topK_init(top, k) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < pairs->capacity; i++) {
+        if (pairs->entries[i].count > 0) {
+            topK_add(top, pairs->entries[i].count, pairs->entries[i].key - 1, pairs->entries[i].key - 1);
+        }
+    }
+    topK_sort(top);
+
+    return OK;
+}
+
+// Get the k films most added by the users that added a film
+tError recommender_getFilms(tRecommender* recommender, tRecommendSource source, tFilm* film, unsigned int k,
+                            tFilm** films, unsigned int* counts, unsigned int* count) {
+    unsigned int i, id;
+    tTopK top;
+    tRecommendCounts empty = { 0, 0, NULL };
+    tError err;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+    assert(source < RECOMMEND_SOURCE_QTY);
+    assert(films != NULL || k == 0);
+    assert(count != NULL);
+
+    *count = 0;
+    id = recommender_getFilmId(recommender, film);
+
+    rwlock_readLock(recommender->lock);
+    err = recommender_selectPairs((id < recommender->filmCount) ? &(recommender->filmCounts[id].pairs[source]) : &empty, 
+                                  k, &top);
+    if (err == OK) {
+        for (i = 0; i < top.size; i++) {
+            films[i] = &(recommender->films->elements[top.entries[i].id]);
+            if (counts != NULL) {
+                counts[i] = (unsigned int)top.entries[i].score;
+            }
+        }
+        *count = top.size;
+        topK_free(&top);
+    }
+    rwlock_readUnlock(recommender->lock);
+
+    return err;
+}
+
+// Get the k series most watched by the users that watched a series
+tError recommender_getSeries(tRecommender* recommender, tSeries* series, unsigned int k,
+                             tSeries** result, unsigned int* counts, unsigned int* count) {
+    unsigned int i, id;
+    tTopK top;
+    tError err = OK;
+
+    // Verify pre conditions
+    assert(recommender != NULL);
+    assert(series != NULL);
+    assert(result != NULL || k == 0);
+    assert(count != NULL);
+
+    *count = 0;
+
+    rwlock_readLock(recommender->lock);
+    if (hashIndex_find(&recommender->seriesIndex, series->title, hash_string(series->title), 
+            recommender_getSeriesKey, recommender, &id)) {
+        err = recommender_selectPairs(&(recommender->series[id].pairs), k, &top);
+        if (err == OK) {
+            for (i = 0; i < top.size; i++) {
+                result[i] = recommender->series[top.entries[i].id].series;
+                if (counts != NULL) {
+                    counts[i] = (unsigned int)top.entries[i].score;
+                }
+            }
+            *count = top.size;
+            topK_free(&top);
+        }
+    }
+    rwlock_readUnlock(recommender->lock);
+
+    return err;
+}
+
+// Use a reader-writer lock to share the recommender between threads
+void recommender_setLock(tRecommender* recommender, struct tRWLock* lock) {
+    // Verify pre conditions
+    assert(recommender != NULL);
+
+    recommender->lock = lock;
+}
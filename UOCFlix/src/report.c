@@ -0,0 +1,356 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "report.h"
+#include "sync.h"
+#include "topk.h"
+#include "mem.h"
+#include "segment.h"
+
+// Counters of the range of views of a worker
+typedef struct {
+    tViewLog* log;
+    // Sealed segments and views not sealed of the range
+    unsigned int firstSegment;
+    unsigned int lastSegment;
+    unsigned int first;
+    unsigned int last;
+    unsigned int genreViews[GENRE_QTY];
+    tFilmStats* filmStats;
+    // Views of each genre of each user, GENRE_QTY counters per user
+    unsigned int* userGenres;
+    // Best score of each user and position of the film of its view (or -1)
+    short* bestScore;
+    int* bestView;
+} tReportPart;
+
+// Release the counters of a worker
+static void reportPart_free(tReportPart* part) {
+    mem_free(part->filmStats);
+    mem_free(part->userGenres);
+    mem_free(part->bestScore);
+    mem_free(part->bestView);
+}
+
+// Allocate the counters of a worker
+static tError reportPart_init(tReportPart* part, tViewLog* log, unsigned int firstSegment, unsigned int lastSegment, 
+                              unsigned int first, unsigned int last) {
+    unsigned int i;
+    unsigned int users = log->users->size;
+
+    part->log = log;
+    part->firstSegment = firstSegment;
+    part->lastSegment = lastSegment;
+    part->first = first;
+    part->last = last;
+    memset(part->genreViews, 0, sizeof(part->genreViews));
+
+    // calloc leaves all the counters to 0. One extra element avoids 
+    // allocating 0 bytes on empty tables
+    part->filmStats = (tFilmStats*)mem_calloc(MEM_REPORT, log->films->size + 1, sizeof(tFilmStats));
+    part->userGenres = (unsigned int*)mem_calloc(MEM_REPORT, (users + 1) * GENRE_QTY, sizeof(unsigned int));
+    part->bestScore = (short*)mem_calloc(MEM_REPORT, users + 1, sizeof(short));
+    part->bestView = (int*)mem_alloc(MEM_REPORT, (users + 1) * sizeof(int));
+    if (part->filmStats == NULL || part->userGenres == NULL || part->bestScore == NULL || part->bestView == NULL) {
+        reportPart_free(part);
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < users; i++) {
+        part->bestView[i] = -1;
+    }
+
+    return OK;
+}
+
+// Add a view to the counters of a worker
+static void reportPart_count(tReportPart* part, unsigned int userId, unsigned int filmId, unsigned int genre, 
+                             short score, unsigned short minutes) {
+    tFilmStats* stats;
+
+    part->genreViews[genre]++;
+    part->userGenres[userId * GENRE_QTY + genre]++;
+
+    stats = &(part->filmStats[filmId]);
+    stats->views++;
+    stats->scoreSum += score;
+    stats->minutes += minutes;
+
+    // Keep the first view with the highest (positive) score
+    if (score > part->bestScore[userId]) {
+        part->bestScore[userId] = score;
+        part->bestView[userId] = (int)filmId;
+    }
+}
+
+// Add a sealed view to the counters of a worker
+static void reportPart_countSealed(const tViewRecord* record, void* context) {
+    reportPart_count((tReportPart*)context, record->userId, record->filmId, record->genre, record->score, record->minutes);
+}
+
+// Aggregate the range of views of a worker. Sealed views are the first ones
+static void reportPart_run(void* context) {
+    tReportPart* part = (tReportPart*)context;
+    tViewLog* log = part->log;
+    tView* view;
+    unsigned int i, genre;
+
+    for (i = part->firstSegment; i < part->lastSegment; i++) {
+        viewSegment_visit(&(log->segments[i]), VIEWSEGMENT_ALL_USERS, 0, 0xFFFFFFFFu, reportPart_countSealed, part);
+    }
+
+    for (i = part->first; i < part->last; i++) {
+        view = &(log->elements[i]);
+        if (log->columns != NULL) {
+            genre = log->columns->genre[i];
+        }
+        else {
+            genre = (unsigned int)series_getGenre(film_getSeries(&(log->films->elements[view->filmId])));
+        }
+        reportPart_count(part, view->userId, view->filmId, genre, view->score, view->minutes);
+    }
+}
+
+// Add the counters of a worker to the counters of the first worker. 
+// Ranges are merged in order, so ties keep the view of the first range
+static void reportPart_merge(tReportPart* dst, tReportPart* src, unsigned int films, unsigned int users) {
+    unsigned int i;
+
+    for (i = 0; i < GENRE_QTY; i++) {
+        dst->genreViews[i] += src->genreViews[i];
+    }
+    for (i = 0; i < films; i++) {
+        dst->filmStats[i].views += src->filmStats[i].views;
+        dst->filmStats[i].scoreSum += src->filmStats[i].scoreSum;
+        dst->filmStats[i].minutes += src->filmStats[i].minutes;
+    }
+    for (i = 0; i < users * GENRE_QTY; i++) {
+        dst->userGenres[i] += src->userGenres[i];
+    }
+    for (i = 0; i < users; i++) {
+        if (src->bestScore[i] > dst->bestScore[i]) {
+            dst->bestScore[i] = src->bestScore[i];
+            dst->bestView[i] = src->bestView[i];
+        }
+    }
+}
+
+// Build the report of a bound log using a number of worker threads
+tError logReport_build(tLogReport* report, tViewLog* log, unsigned int threads) {
+    tReportPart parts[REPORT_MAX_THREADS];
+    tThread workers[REPORT_MAX_THREADS];
+    unsigned int i, j, started, max;
+    unsigned int users, films;
+    unsigned int segment, total, sealed, first, last;
+    tError err = OK;
+
+    // Verify pre conditions
+    assert(report != NULL);
+    assert(log != NULL);
+
+    memset(report, 0, sizeof(tLogReport));
+    if (log->users == NULL || threads == 0 || threads > REPORT_MAX_THREADS) {
+        return ERR_INVALID;
+    }
+    report->users = log->users;
+    report->films = log->films;
+    users = log->users->size;
+    films = log->films->size;
+
+    // Small logs are not worth the cost of starting threads
+    sealed = log->sealedSize;
+    total = sealed + log->size;
+    if (threads > 1 && total < threads * 1024) {
+        threads = 1;
+    }
+
+    // Contiguous ranges of the same size, with the sealed views first. 
+    // A segment is not split, and goes to the range where it starts
+    segment = 0;
+    for (i = 0; i < threads; i++) {
+        first = (unsigned int)((unsigned long long)total * i / threads);
+        last = (unsigned int)((unsigned long long)total * (i + 1) / threads);
+        j = segment;
+        while (segment < log->segmentCount && log->segments[segment].first < last) {
+            segment++;
+        }
+        err = reportPart_init(&parts[i], log, j, segment, (first > sealed) ? first - sealed : 0, 
+                    (last > sealed) ? last - sealed : 0);
+        if (err != OK) {
+            for (j = 0; j < i; j++) {
+                reportPart_free(&parts[j]);
+            }
+            return err;
+        }
+    }
+
+    // The first range is aggregated by the calling thread. If a worker can 
+    // not be started, its range is aggregated by the calling thread too
+    started = 0;
+    for (i = 1; i < threads; i++) {
+        if (thread_create(&workers[i], reportPart_run, &parts[i]) != OK) {
+            break;
+        }
+        started++;
+    }
+    reportPart_run(&parts[0]);
+    for (i = started + 1; i < threads; i++) {
+        reportPart_run(&parts[i]);
+    }
+    for (i = 1; i <= started; i++) {
+        thread_join(&workers[i]);
+    }
+
+    for (i = 1; i < threads; i++) {
+        reportPart_merge(&parts[0], &parts[i], films, users);
+        reportPart_free(&parts[i]);
+    }
+
+    // The report takes the counters of the first worker
+    memcpy(report->genreViews, parts[0].genreViews, sizeof(report->genreViews));
+    report->filmCount = films;
+    report->filmStats = parts[0].filmStats;
+    report->userCount = users;
+    report->favFilm = parts[0].bestView;
+    mem_free(parts[0].bestScore);
+
+    // Favorite genre of each user. In case of a tie, the first genre
+    report->favGenre = (tGenre*)mem_alloc(MEM_REPORT, (users + 1) * sizeof(tGenre));
+    if (report->favGenre == NULL) {
+        mem_free(parts[0].userGenres);
+        logReport_free(report);
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < users; i++) {
+        report->favGenre[i] = GENRE_NOT_FOUND;
+        max = 0;
+        for (j = 0; j < GENRE_QTY; j++) {
+            if (parts[0].userGenres[i * GENRE_QTY + j] > max) {
+                max = parts[0].userGenres[i * GENRE_QTY + j];
+                report->favGenre[i] = (tGenre)j;
+            }
+        }
+    }
+    mem_free(parts[0].userGenres);
+
+    return OK;
+}
+
+// Release the memory used by a report
+void logReport_free(tLogReport* report) {
+    // Verify pre conditions
+    assert(report != NULL);
+
+    mem_free(report->filmStats);
+    mem_free(report->favGenre);
+    mem_free(report->favFilm);
+    memset(report, 0, sizeof(tLogReport));
+}
+
+// Get the genre with the most views
+tGenre logReport_getTopGenre(tLogReport* report) {
+    unsigned int i;
+    unsigned int max = 0;
+    tGenre genre = GENRE_NOT_FOUND;
+
+    // Verify pre conditions
+    assert(report != NULL);
+
+    for (i = 0; i < GENRE_QTY; i++) {
+        if (report->genreViews[i] > max) {
+            max = report->genreViews[i];
+            genre = (tGenre)i;
+        }
+    }
+
+    return genre;
+}
+
+// Get the k films with the most views
+tError logReport_getTopFilms(tLogReport* report, unsigned int k, tFilm** films, unsigned int* count) {
+    unsigned int i;
+    tTopK top;
+
+    // Verify pre conditions
+    assert(report != NULL);
+    assert(films != NULL || k == 0);
+    assert(count != NULL);
+
+    *count = 0;
+    if (topK_init(&top, k) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    for (i = 0; i < report->filmCount; i++) {
+        if (report->filmStats[i].views > 0) {
+            topK_add(&top, report->filmStats[i].views, i, i);
+        }
+    }
+
+    topK_sort(&top);
+    for (i = 0; i < top.size; i++) {
+        films[i] = &(report->films->elements[top.entries[i].id]);
+    }
+    *count = top.size;
+    topK_free(&top);
+
+    return OK;
+}
+
+// Get the average score of the views of a film, or 0 if it has no views
+float logReport_getAverageScore(tLogReport* report, tFilm* film) {
+    tFilmStats* stats;
+
+    // Verify pre conditions
+    assert(report != NULL);
+    assert(film >= report->films->elements && film < report->films->elements + report->filmCount);
+
+    stats = &(report->filmStats[film - report->films->elements]);
+    if (stats->views == 0) {
+        return 0.0f;
+    }
+
+    return (float)stats->scoreSum / (float)stats->views;
+}
+
+// Get the total minutes watched of the films of a series
+unsigned long long logReport_getSeriesMinutes(tLogReport* report, tSeries* series) {
+    unsigned int i;
+    unsigned long long minutes = 0;
+
+    // Verify pre conditions
+    assert(report != NULL);
+    assert(series != NULL);
+
+    for (i = 0; i < report->filmCount; i++) {
+        if (report->films->elements[i].series == series) {
+            minutes += report->filmStats[i].minutes;
+        }
+    }
+
+    return minutes;
+}
+
+// Get the favorite genre of a user
+tGenre logReport_getFavGenre(tLogReport* report, tUser* user) {
+    // Verify pre conditions
+    assert(report != NULL);
+    assert(user >= report->users->elements && user < report->users->elements + report->userCount);
+
+    return report->favGenre[user - report->users->elements];
+}
+
+// Get the favorite film of a user
+tFilm* logReport_getFavFilm(tLogReport* report, tUser* user) {
+    int film;
+
+    // Verify pre conditions
+    assert(report != NULL);
+    assert(user >= report->users->elements && user < report->users->elements + report->userCount);
+
+    film = report->favFilm[user - report->users->elements];
+    if (film < 0) {
+        return NULL;
+    }
+
+    return &(report->films->elements[film]);
+}
@@ -0,0 +1,309 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "segment.h"
+#include "mem.h"
+
+// Maximum bytes of the varints of a view: a timestamp difference of 33
+// bits, two codes of 32 bits and the minutes
+#define VIEWSEGMENT_MAX_VIEW_BYTES 18
+
+// Bytes after the scores, so a score is always read with 3 bytes
+#define VIEWSEGMENT_SCORE_PADDING 2
+
+// Compare two positions, to sort them
+static int viewSegment_cmp(const void* a, const void* b) {
+    unsigned int value1 = *(const unsigned int*)a;
+    unsigned int value2 = *(const unsigned int*)b;
+
+    return (value1 > value2) - (value1 < value2);
+}
+
+// Find the code of a position in a sorted dictionary
+static bool viewSegment_findCode(const unsigned int* dictionary, unsigned int size, unsigned int value,
+                                 unsigned int* code) {
+    unsigned int low = 0, high = size, middle;
+
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (dictionary[middle] < value) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    if (low < size && dictionary[low] == value) {
+        *code = low;
+        return true;
+    }
+
+    return false;
+}
+
+// Build the sorted dictionary of the distinct values of an array. The array is sorted in place
+static unsigned int* viewSegment_buildDictionary(unsigned int* values, unsigned int count, unsigned int* size) {
+    unsigned int i, n = 0;
+    unsigned int* dictionary;
+
+    qsort(values, count, sizeof(unsigned int), viewSegment_cmp);
+    for (i = 0; i < count; i++) {
+        if (n == 0 || values[n - 1] != values[i]) {
+            values[n++] = values[i];
+        }
+    }
+
+    dictionary = (unsigned int*)mem_alloc(MEM_SEGMENT, n * sizeof(unsigned int));
+    if (dictionary != NULL) {
+        memcpy(dictionary, values, n * sizeof(unsigned int));
+        *size = n;
+    }
+
+    return dictionary;
+}
+
+// Write a varint, 7 bits per byte from the lowest ones. Returns the number of bytes written
+static unsigned int viewSegment_writeVarint(unsigned char* data, unsigned long long value) {
+    unsigned int n = 0;
+
+    while (value >= 0x80) {
+        data[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    data[n++] = (unsigned char)value;
+
+    return n;
+}
+
+// Read a varint, moving the offset after it
+static unsigned long long viewSegment_readVarint(const unsigned char* data, unsigned int* offset) {
+    unsigned long long value = 0;
+    unsigned int shift = 0;
+    unsigned char byte;
+
+    do {
+        byte = data[(*offset)++];
+        value |= (unsigned long long)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return value;
+}
+
+// Write the bits of a value at a bit position of a zeroed array
+static void viewSegment_writeBits(unsigned char* bits, unsigned long long position, unsigned int count,
+                                  unsigned int value) {
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        if (value & (1u << i)) {
+            bits[(position + i) >> 3] |= (unsigned char)(1u << ((position + i) & 7));
+        }
+    }
+}
+
+// Read count bits (16 at most) at a bit position of an array
+static unsigned int viewSegment_readBits(const unsigned char* bits, unsigned long long position, unsigned int count) {
+    const unsigned char* byte = &bits[position >> 3];
+    unsigned int window;
+
+    window = (unsigned int)byte[0] | ((unsigned int)byte[1] << 8) | ((unsigned int)byte[2] << 16);
+    return (window >> (position & 7)) & ((1u << count) - 1);
+}
+
+// Encode the first count views of a bound log in a segment
+tError viewSegment_build(tViewSegment* segment, tViewLog* log, unsigned int count, unsigned int first) {
+    unsigned int i, code = 0, bits, range;
+    unsigned int* values;
+    unsigned char* data;
+    tView* view;
+    tPackedDateTime timestamp, previous;
+    short maxScore;
+    long long delta;
+    void* ptr;
+
+    // Verify pre conditions
+    assert(segment != NULL);
+    assert(log != NULL);
+    assert(log->users != NULL);
+    assert(count > 0 && count <= log->size);
+
+    memset(segment, 0, sizeof(tViewSegment));
+    segment->first = first;
+    segment->count = count;
+
+    // Range of the timestamps and the scores
+    segment->minTimestamp = dateTime_pack(&(log->elements[0].timestamp));
+    segment->maxTimestamp = segment->minTimestamp;
+    segment->minScore = log->elements[0].score;
+    maxScore = segment->minScore;
+    for (i = 1; i < count; i++) {
+        view = &(log->elements[i]);
+        timestamp = dateTime_pack(&view->timestamp);
+        if (timestamp < segment->minTimestamp) {
+            segment->minTimestamp = timestamp;
+        }
+        if (timestamp > segment->maxTimestamp) {
+            segment->maxTimestamp = timestamp;
+        }
+        if (view->score < segment->minScore) {
+            segment->minScore = view->score;
+        }
+        if (view->score > maxScore) {
+            maxScore = view->score;
+        }
+    }
+
+    // Dictionaries of the users and the films
+    values = (unsigned int*)mem_alloc(MEM_SEGMENT, count * sizeof(unsigned int));
+    if (values == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < count; i++) {
+        values[i] = log->elements[i].userId;
+    }
+    segment->users = viewSegment_buildDictionary(values, count, &segment->userCount);
+    for (i = 0; i < count; i++) {
+        values[i] = log->elements[i].filmId;
+    }
+    segment->films = viewSegment_buildDictionary(values, count, &segment->filmCount);
+    mem_free(values);
+    if (segment->users == NULL || segment->films == NULL) {
+        viewSegment_free(segment);
+        return ERR_MEMORY_ERROR;
+    }
+    segment->genres = (unsigned char*)mem_alloc(MEM_SEGMENT, segment->filmCount);
+    if (segment->genres == NULL) {
+        viewSegment_free(segment);
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < segment->filmCount; i++) {
+        segment->genres[i] = (unsigned char)series_getGenre(film_getSeries(&(log->films->elements[segment->films[i]])));
+    }
+
+    // Bits of the scores. A segment with a single score needs none
+    range = (unsigned int)(maxScore - segment->minScore);
+    bits = 0;
+    while ((range >> bits) != 0) {
+        bits++;
+    }
+    segment->scoreBits = bits;
+    if (bits > 0) {
+        segment->scores = (unsigned char*)mem_calloc(MEM_SEGMENT,
+                    ((unsigned long long)count * bits + 7) / 8 + VIEWSEGMENT_SCORE_PADDING, 1);
+        if (segment->scores == NULL) {
+            viewSegment_free(segment);
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    // Varints of the views, in a block for the worst case that is shrunk at the end
+    data = (unsigned char*)mem_alloc(MEM_SEGMENT, (size_t)count * VIEWSEGMENT_MAX_VIEW_BYTES);
+    if (data == NULL) {
+        viewSegment_free(segment);
+        return ERR_MEMORY_ERROR;
+    }
+    segment->data = data;
+    previous = segment->minTimestamp;
+    for (i = 0; i < count; i++) {
+        view = &(log->elements[i]);
+        timestamp = dateTime_pack(&view->timestamp);
+
+        // Views are usually in order, so the difference is small. Zigzag
+        // encoding keeps small the differences of views out of order too
+        delta = (long long)timestamp - (long long)previous;
+        segment->dataSize += viewSegment_writeVarint(&data[segment->dataSize],
+                    ((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63));
+        previous = timestamp;
+
+        viewSegment_findCode(segment->users, segment->userCount, view->userId, &code);
+        segment->dataSize += viewSegment_writeVarint(&data[segment->dataSize], code);
+        viewSegment_findCode(segment->films, segment->filmCount, view->filmId, &code);
+        segment->dataSize += viewSegment_writeVarint(&data[segment->dataSize], code);
+        segment->dataSize += viewSegment_writeVarint(&data[segment->dataSize], view->minutes);
+
+        if (bits > 0) {
+            viewSegment_writeBits(segment->scores, (unsigned long long)i * bits, bits,
+                                  (unsigned int)(view->score - segment->minScore));
+        }
+    }
+
+    // If the block can not be shrunk, the segment keeps the bigger one
+    ptr = mem_realloc(MEM_SEGMENT, segment->data, segment->dataSize);
+    if (ptr != NULL) {
+        segment->data = (unsigned char*)ptr;
+    }
+
+    return OK;
+}
+
+// Release the memory used by a segment
+void viewSegment_free(tViewSegment* segment) {
+    // Verify pre conditions
+    assert(segment != NULL);
+
+    mem_free(segment->users);
+    mem_free(segment->films);
+    mem_free(segment->genres);
+    mem_free(segment->scores);
+    mem_free(segment->data);
+    memset(segment, 0, sizeof(tViewSegment));
+}
+
+// Call a function for each view of a user with a timestamp in the range [from, to)
+void viewSegment_visit(const tViewSegment* segment, unsigned int userId, tPackedDateTime from,
+                       tPackedDateTime to, tViewRecordFn fn, void* context) {
+    unsigned int i, userCode = 0, user, film, minutes;
+    unsigned int offset = 0;
+    unsigned long long zigzag;
+    tPackedDateTime timestamp;
+    tViewRecord record;
+
+    // Verify pre conditions
+    assert(segment != NULL);
+    assert(fn != NULL);
+
+    if (from >= to || segment->maxTimestamp < from || segment->minTimestamp >= to) {
+        return;
+    }
+    if (userId != VIEWSEGMENT_ALL_USERS
+            && !viewSegment_findCode(segment->users, segment->userCount, userId, &userCode)) {
+        return;
+    }
+
+    // The views are decoded in order, but only the selected ones are passed to the function
+    timestamp = segment->minTimestamp;
+    for (i = 0; i < segment->count; i++) {
+        zigzag = viewSegment_readVarint(segment->data, &offset);
+        timestamp = (tPackedDateTime)((long long)timestamp + (long long)((zigzag >> 1) ^ (0 - (zigzag & 1))));
+        user = (unsigned int)viewSegment_readVarint(segment->data, &offset);
+        film = (unsigned int)viewSegment_readVarint(segment->data, &offset);
+        minutes = (unsigned int)viewSegment_readVarint(segment->data, &offset);
+
+        if ((userId != VIEWSEGMENT_ALL_USERS && user != userCode) || timestamp < from || timestamp >= to) {
+            continue;
+        }
+        record.position = segment->first + i;
+        record.userId = segment->users[user];
+        record.filmId = segment->films[film];
+        record.genre = segment->genres[film];
+        record.timestamp = timestamp;
+        record.minutes = (unsigned short)minutes;
+        record.score = segment->minScore;
+        if (segment->scoreBits > 0) {
+            record.score += (short)viewSegment_readBits(segment->scores, (unsigned long long)i * segment->scoreBits,
+                                                         segment->scoreBits);
+        }
+        fn(&record, context);
+    }
+}
+
+// Get the bytes of memory used by a segment
+size_t viewSegment_bytes(const tViewSegment* segment) {
+    // Verify pre conditions
+    assert(segment != NULL);
+
+    return sizeof(tViewSegment) + (segment->userCount + segment->filmCount) * sizeof(unsigned int)
+            + segment->filmCount + segment->dataSize
+            + ((segment->scoreBits > 0) ? ((size_t)segment->count * segment->scoreBits + 7) / 8 + VIEWSEGMENT_SCORE_PADDING : 0);
+}
@@ -2,6 +2,14 @@
 #include <string.h>
 #include <assert.h>
 #include "series.h"
+#include "intern.h"
+#include "table.h"
+#include "mem.h"
+
+// Get the key used by the hash index of a table of series
+static const char* seriesTable_getKey(void* table, unsigned int position) {
+    return ((tSeriesTable*)table)->elements[position]->title;
+}
 
 // Initialize a series object
 tError series_init(tSeries* object, const char* title, tGenre genre) {
@@ -9,14 +17,13 @@ tError series_init(tSeries* object, const char* title, tGenre genre) {
     assert(object != NULL);
     assert(title != NULL);
 
-    object->title = (char*)malloc((strlen(title) + 1) * sizeof(char));
+    // Series with the same title share the same copy of the title
+    object->title = intern_acquire(title);
 
     if (object->title == NULL) {
         return ERR_MEMORY_ERROR;
     }
 
-    strcpy(object->title, title);
-
     object->genre = genre;
 
     return  OK;
@@ -27,11 +34,9 @@ void series_free(tSeries* object) {
     // Verify pre conditions
     assert(object != NULL);
 
-    // All memory allocated with malloc and realloc needs to be freed 
-    // using the free command. In this case, as we use malloc to allocate 
-    // the fields, we have to free them
+    // The title is shared, so only our reference to it is released
     if (object->title != NULL) {
-        free(object->title);
+        intern_release(object->title);
         object->title = NULL;
     }
 }
@@ -58,13 +63,18 @@ tError series_mdfyTitle(tSeries* object, const char* newTitle) {
     assert(newTitle != NULL);
     assert(object->title != NULL);
 
-    object->title = (char *)realloc(object->title, (strlen(newTitle) + 1) * sizeof(char));
-    if (object->title == NULL) {
-        // Error reallocating the memory
+    const char* title;
+
+    // Interned strings are immutable, take a reference to the new title
+    // before releasing the old one (newTitle could be the old title)
+    title = intern_acquire(newTitle);
+    if (title == NULL) {
+        // Error allocating the memory
         return ERR_MEMORY_ERROR;
     }
 
-    strcpy(object->title, newTitle);
+    intern_release(object->title);
+    object->title = title;
 
     return OK;
 }
@@ -75,7 +85,8 @@ bool series_equals(tSeries* serie1, tSeries* serie2) {
     assert(serie1 != NULL);
     assert(serie2 != NULL);
 
-    if (strcmp(serie1->title, serie2->title) != 0) {
+    // Interned titles are equal if they are the same pointer
+    if (serie1->title != serie2->title && strcmp(serie1->title, serie2->title) != 0) {
         // Titles are different
         return false;
     }
@@ -109,3 +120,138 @@ tError series_cpy(tSeries* dest, tSeries* src){
     return OK;
 }
 
+
+// **** Functions related to management of tSeriesTable objects
+
+// Initialize a table of series
+void seriesTable_init(tSeriesTable* table) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    table->size = 0;
+    table->capacity = 0;
+    table->elements = NULL;
+    hashIndex_init(&table->index);
+}
+
+// Release the memory used by a table of series, including its series
+void seriesTable_free(tSeriesTable* table) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // The table owns the memory of each series
+    for (i = 0; i < table->size; i++) {
+        series_free(table->elements[i]);
+        mem_free(table->elements[i]);
+    }
+
+    if (table->elements != NULL) {
+        mem_free(table->elements);
+        table->elements = NULL;
+    }
+    table->size = 0;
+    table->capacity = 0;
+
+    hashIndex_free(&table->index);
+}
+
+// Add a copy of a series to the table. In case a series with 
+// the same title already exists, it will return ERR_DUPLICATED
+tError seriesTable_add(tSeriesTable* table, tSeries* series) {
+    unsigned int hash;
+    tSeries* element;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(series != NULL);
+
+    hash = hash_string(series->title);
+    if (hashIndex_find(&table->index, series->title, hash, seriesTable_getKey, table, NULL)) {
+        return ERR_DUPLICATED;
+    }
+
+    if (table->size == table->capacity) {
+        if (seriesTable_reserve(table, table_growCapacity(table->capacity, table->size + 1)) != OK) {
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    element = (tSeries*)mem_alloc(MEM_SERIES, sizeof(tSeries));
+    if (element == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+    if (series_init(element, series->title, series->genre) != OK) {
+        mem_free(element);
+        return ERR_MEMORY_ERROR;
+    }
+
+    if (hashIndex_insert(&table->index, hash, table->size) != OK) {
+        series_free(element);
+        mem_free(element);
+        return ERR_MEMORY_ERROR;
+    }
+    table->elements[table->size] = element;
+    table->size = table->size + 1;
+
+    return OK;
+}
+
+// Ensure there is memory for at least n series in the table
+tError seriesTable_reserve(tSeriesTable* table, unsigned int n) {
+    tSeries** elements;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    if (n <= table->capacity) {
+        // Already enough memory
+        return OK;
+    }
+
+    // Only the array of pointers moves, the series stay in their place
+    elements = (tSeries**)mem_realloc(MEM_SERIES, table->elements, n * sizeof(tSeries*));
+    if (elements == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    table->elements = elements;
+    table->capacity = n;
+
+    return OK;
+}
+
+// Get the series with a title, or NULL if it is not in the table
+tSeries* seriesTable_find(tSeriesTable* table, const char* title) {
+    unsigned int position;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(title != NULL);
+
+    if (hashIndex_find(&table->index, title, hash_string(title), seriesTable_getKey, table, &position)) {
+        return table->elements[position];
+    }
+
+    return NULL;
+}
+
+// Get the position in the table of the series with a title. 
+// Returns false if it is not in the table
+bool seriesTable_findPosition(tSeriesTable* table, const char* title, unsigned int* position) {
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(title != NULL);
+    assert(position != NULL);
+
+    return hashIndex_find(&table->index, title, hash_string(title), seriesTable_getKey, table, position);
+}
+
+// Get the number of series in the table
+unsigned int seriesTable_size(tSeriesTable* table) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    return table->size;
+}
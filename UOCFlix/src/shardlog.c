@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "shardlog.h"
+#include "hash.h"
+#include "mem.h"
+
+// Get the shard that stores the views of a user
+static tViewShard* shardedViewLog_getShard(tShardedViewLog* log, tUser* user) {
+    return &(log->shards[hash_string(user->username) % log->count]);
+}
+
+// Initialize an empty sharded log with a number of shards, bound to the tables of users and films
+tError shardedViewLog_init(tShardedViewLog* log, unsigned int shards, tUserTable* users, tFilmTable* films) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(log != NULL);
+    assert(users != NULL);
+    assert(films != NULL);
+
+    log->count = 0;
+    log->shards = NULL;
+    log->users = users;
+    log->films = films;
+    log->next = 0;
+
+    if (shards == 0 || shards > SHARDLOG_MAX_SHARDS) {
+        return ERR_INVALID;
+    }
+
+    log->shards = (tViewShard*)mem_alloc(MEM_VIEW, shards * sizeof(tViewShard));
+    if (log->shards == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // count is increased with each shard ready, so a failure only releases them
+    for (i = 0; i < shards; i++) {
+        if (rwlock_init(&(log->shards[i].lock)) != OK) {
+            shardedViewLog_free(log);
+            return ERR_MEMORY_ERROR;
+        }
+        viewLog_init(&(log->shards[i].views));
+        viewLog_bind(&(log->shards[i].views), users, films);
+        viewLog_setLock(&(log->shards[i].views), &(log->shards[i].lock));
+        postings_init(&(log->shards[i].sequence));
+        log->count++;
+    }
+
+    return OK;
+}
+
+// Release the memory used by a sharded log
+void shardedViewLog_free(tShardedViewLog* log) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(log != NULL);
+
+    for (i = 0; i < log->count; i++) {
+        viewLog_free(&(log->shards[i].views));
+        postings_free(&(log->shards[i].sequence));
+        rwlock_free(&(log->shards[i].lock));
+    }
+    if (log->shards != NULL) {
+        mem_free(log->shards);
+        log->shards = NULL;
+    }
+    log->count = 0;
+    log->next = 0;
+}
+
+// Add a view to the shard of its user
+tError shardedViewLog_add(tShardedViewLog* log, tView* view) {
+    tViewShard* shard;
+    tError err;
+
+    // Verify pre conditions
+    assert(log != NULL);
+    assert(view != NULL);
+    assert(view->user != NULL);
+
+    shard = shardedViewLog_getShard(log, view->user);
+
+    // The number of the sequence is taken in the exclusive section of the 
+    // shard, so the sequence of each shard is increasing. A failed add 
+    // leaves a gap in the sequence, that does not change the order
+    rwlock_writeLock(&shard->lock);
+    err = postings_add(&shard->sequence, atomic_fetchAdd(&log->next, 1));
+    if (err == OK) {
+        err = viewLog_add(&shard->views, view);
+        if (err != OK) {
+            shard->sequence.size--;
+        }
+    }
+    rwlock_writeUnlock(&shard->lock);
+
+    return err;
+}
+
+// Get the number of views of the log
+unsigned int shardedViewLog_size(tShardedViewLog* log) {
+    unsigned int i;
+    unsigned int size = 0;
+
+    // Verify pre conditions
+    assert(log != NULL);
+
+    for (i = 0; i < log->count; i++) {
+        rwlock_readLock(&(log->shards[i].lock));
+        size += log->shards[i].views.size;
+        rwlock_readUnlock(&(log->shards[i].lock));
+    }
+
+    return size;
+}
+
+// Keep the index of views per user in each shard
+tError shardedViewLog_enableUserIndex(tShardedViewLog* log) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(log != NULL);
+
+    for (i = 0; i < log->count; i++) {
+        if (viewLog_enableUserIndex(&(log->shards[i].views)) != OK) {
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    return OK;
+}
+
+// Same as viewLog_getFavFilm, over the views of all the shards
+tFilm* shardedViewLog_getFavFilm(tShardedViewLog* log, tUser* user) {
+    // Verify pre conditions
+    assert(log != NULL);
+    assert(user != NULL);
+
+    // Only the shard of the user has views of the user, in the order of the sequence
+    return viewLog_getFavFilm(&(shardedViewLog_getShard(log, user)->views), user);
+}
+
+// Same as viewLog_getFavGenre, over the views of all the shards
+tGenre shardedViewLog_getFavGenre(tShardedViewLog* log, tUser* user) {
+    // Verify pre conditions
+    assert(log != NULL);
+    assert(user != NULL);
+
+    return viewLog_getFavGenre(&(shardedViewLog_getShard(log, user)->views), user);
+}
+
+// Add all the views of the sharded log to an empty tViewLog bound to the 
+// same tables, merging the shards in the order the views were added
+tError shardedViewLog_merge(tShardedViewLog* log, tViewLog* views) {
+    unsigned int i, best;
+    unsigned int* next;
+    tViewShard* shard;
+    tView view;
+    tError err = OK;
+
+    // Verify pre conditions
+    assert(log != NULL);
+    assert(views != NULL);
+
+    if (views->size != 0 || views->sealedSize != 0 || views->users != log->users || views->films != log->films) {
+        return ERR_INVALID;
+    }
+
+    // Position of the next view to merge from each shard
+    next = (unsigned int*)mem_calloc(MEM_VIEW, log->count, sizeof(unsigned int));
+    if (next == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    err = viewLog_reserve(views, shardedViewLog_size(log));
+
+    // Take the view with the lowest number of the sequence of all 
+    // the shards. The number of shards is small, so a linear search 
+    // is faster than keeping a heap
+    while (err == OK) {
+        best = log->count;
+        for (i = 0; i < log->count; i++) {
+            shard = &(log->shards[i]);
+            if (next[i] < shard->sequence.size && (best == log->count 
+                    || shard->sequence.elements[next[i]] < log->shards[best].sequence.elements[next[best]])) {
+                best = i;
+            }
+        }
+        if (best == log->count) {
+            break;
+        }
+
+        shard = &(log->shards[best]);
+        view = shard->views.elements[next[best]];
+        view.user = &(log->users->elements[view.userId]);
+        view.film = &(log->films->elements[view.filmId]);
+        err = viewLog_add(views, &view);
+        next[best]++;
+    }
+
+    mem_free(next);
+
+    return err;
+}
@@ -0,0 +1,611 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "snapshot.h"
+#include "favorite.h"
+#include "table.h"
+#include "mem.h"
+
+#ifdef _WIN32
+#define SNAPSHOT_NO_MMAP
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Identifier at the beginning of the snapshot files
+#define SNAPSHOT_MAGIC "UOCFSNAP"
+
+// Value used to detect files written with another byte order
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+// Header of a snapshot. Offsets are from the beginning of the file
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t seriesCount;
+    uint32_t filmsCount;
+    uint32_t usersCount;
+    uint32_t favoritesCount;
+    uint32_t viewsCount;
+    uint32_t stringsSize;
+    uint32_t seriesOffset;
+    uint32_t filmsOffset;
+    uint32_t usersOffset;
+    uint32_t favoritesOffset;
+    uint32_t viewsOffset;
+    uint32_t stringsOffset;
+} tSnapshotHeader;
+
+// Series record
+typedef struct {
+    uint32_t title;
+    uint32_t genre;
+} tSnapshotSeries;
+
+// Film record. The series is the position in the array of series
+typedef struct {
+    uint32_t title;
+    uint32_t series;
+    uint32_t lengthInMin;
+} tSnapshotFilm;
+
+// User record. The favorites of the user are favoritesCount consecutive 
+// elements of the array of favorites, from the top of the stack to the bottom
+typedef struct {
+    uint32_t username;
+    uint32_t name;
+    uint32_t mail;
+    uint32_t firstFavorite;
+    uint32_t favoritesCount;
+} tSnapshotUser;
+
+// View record. The user and the film are positions in their arrays
+typedef struct {
+    uint32_t user;
+    uint32_t film;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    int16_t score;
+    uint16_t minutes;
+    uint16_t reserved;
+} tSnapshotView;
+
+// Block of strings built while writing the records
+typedef struct {
+    uint32_t size;
+    uint32_t capacity;
+    char* data;
+} tSnapshotStrings;
+
+// Add a string to the block and get its offset. Returns false if there is no memory
+static bool snapshotStrings_add(tSnapshotStrings* strings, const char* str, uint32_t* offset) {
+    uint32_t length = (uint32_t)strlen(str) + 1;
+    uint32_t capacity;
+    char* data;
+
+    if (strings->size + length > strings->capacity) {
+        capacity = table_growCapacity(strings->capacity, strings->size + length);
+        data = (char*)mem_realloc(MEM_STORAGE, strings->data, capacity);
+        if (data == NULL) {
+            return false;
+        }
+        strings->data = data;
+        strings->capacity = capacity;
+    }
+
+    memcpy(strings->data + strings->size, str, length);
+    *offset = strings->size;
+    strings->size += length;
+
+    return true;
+}
+
+// Get the position of the series of a film in the table of series
+static bool snapshot_findSeries(tSeriesTable* series, tSeries* object, uint32_t* position) {
+    unsigned int found;
+
+    if (!seriesTable_findPosition(series, object->title, &found) 
+            || series->elements[found]->genre != object->genre) {
+        return false;
+    }
+    *position = found;
+
+    return true;
+}
+
+// Get the position a user of the table will have in the snapshot, 
+// skipping the tombstones of removed users
+static bool snapshot_findUser(tUserTable* users, uint32_t* positions, const char* username, uint32_t* position) {
+    tUser* user = userTable_find(users, username);
+
+    if (user == NULL) {
+        return false;
+    }
+    *position = positions[user - users->elements];
+
+    return true;
+}
+
+// Get the position a film of the table will have in the snapshot, 
+// skipping the tombstones of removed films
+static bool snapshot_findFilm(tFilmTable* films, uint32_t* positions, const char* title, uint32_t* position) {
+    tFilm* film = filmTable_find(films, title);
+
+    if (film == NULL) {
+        return false;
+    }
+    *position = positions[film - films->elements];
+
+    return true;
+}
+
+// Write the records of the dataset after the header. Records are written as 
+// they are produced, strings are kept in memory and written at the end
+static tError snapshot_write(FILE* file, tSnapshotHeader* header, tSeriesTable* series, tFilmTable* films, 
+                     tUserTable* users, tViewLog* views, uint32_t* userPositions, uint32_t* filmPositions, 
+                     tSnapshotStrings* strings) {
+    unsigned int i;
+    uint32_t offset;
+    tSnapshotSeries seriesRecord;
+    tSnapshotFilm filmRecord;
+    tSnapshotUser userRecord;
+    tSnapshotView viewRecord;
+    uint32_t favorite;
+    tFavoriteStackIterator it;
+    const tFavorite* current;
+    tUser* user;
+    tFilm* film;
+    tView* view;
+    bool ok = true;
+
+    offset = sizeof(tSnapshotHeader);
+
+    // Series
+    header->seriesOffset = offset;
+    for (i = 0; i < series->size && ok; i++) {
+        seriesRecord.genre = (uint32_t)series->elements[i]->genre;
+        ok = snapshotStrings_add(strings, series->elements[i]->title, &seriesRecord.title)
+            && fwrite(&seriesRecord, sizeof(seriesRecord), 1, file) == 1;
+    }
+    header->seriesCount = series->size;
+    offset += header->seriesCount * sizeof(tSnapshotSeries);
+
+    // Films, skipping tombstones
+    header->filmsOffset = offset;
+    header->filmsCount = 0;
+    for (i = 0; i < films->size && ok; i++) {
+        film = &(films->elements[i]);
+        if (film->title == NULL) {
+            continue;
+        }
+        if (!snapshot_findSeries(series, film->series, &filmRecord.series)) {
+            return ERR_NOT_FOUND;
+        }
+        filmRecord.lengthInMin = film->lengthInMin;
+        ok = snapshotStrings_add(strings, film->title, &filmRecord.title)
+            && fwrite(&filmRecord, sizeof(filmRecord), 1, file) == 1;
+        filmPositions[i] = header->filmsCount;
+        header->filmsCount++;
+    }
+    offset += header->filmsCount * sizeof(tSnapshotFilm);
+
+    // Users, skipping tombstones. Positions are needed before writing the favorites
+    header->usersOffset = offset;
+    header->usersCount = 0;
+    header->favoritesCount = 0;
+    for (i = 0; i < users->size && ok; i++) {
+        user = &(users->elements[i]);
+        if (user->username == NULL) {
+            continue;
+        }
+        userRecord.firstFavorite = header->favoritesCount;
+        userRecord.favoritesCount = user->favorites.count;
+        ok = snapshotStrings_add(strings, user->username, &userRecord.username)
+            && snapshotStrings_add(strings, user->name, &userRecord.name)
+            && snapshotStrings_add(strings, user->mail, &userRecord.mail)
+            && fwrite(&userRecord, sizeof(userRecord), 1, file) == 1;
+        userPositions[i] = header->usersCount;
+        header->usersCount++;
+        header->favoritesCount += user->favorites.count;
+    }
+    offset += header->usersCount * sizeof(tSnapshotUser);
+
+    // Favorites of each user, from the top of the stack
+    header->favoritesOffset = offset;
+    for (i = 0; i < users->size && ok; i++) {
+        if (users->elements[i].username == NULL) {
+            continue;
+        }
+        favoriteStackIterator_init(&it, &(users->elements[i].favorites));
+        while (favoriteStackIterator_hasNext(&it) && ok) {
+            current = favoriteStackIterator_next(&it);
+            if (!snapshot_findFilm(films, filmPositions, current->film.title, &favorite)) {
+                return ERR_NOT_FOUND;
+            }
+            ok = fwrite(&favorite, sizeof(favorite), 1, file) == 1;
+        }
+    }
+    offset += header->favoritesCount * sizeof(uint32_t);
+
+    // Views
+    header->viewsOffset = offset;
+    memset(&viewRecord, 0, sizeof(viewRecord));
+    for (i = 0; i < views->size && ok; i++) {
+        view = &(views->elements[i]);
+        if (views->users != NULL) {
+            // Bound log, the views know the positions in the tables
+            if (users->elements[view->userId].username == NULL || films->elements[view->filmId].title == NULL) {
+                return ERR_NOT_FOUND;
+            }
+            viewRecord.user = userPositions[view->userId];
+            viewRecord.film = filmPositions[view->filmId];
+        }
+        else if (!snapshot_findUser(users, userPositions, view->user->username, &viewRecord.user)
+                || !snapshot_findFilm(films, filmPositions, view->film->title, &viewRecord.film)) {
+            return ERR_NOT_FOUND;
+        }
+        viewRecord.year = view->timestamp.year;
+        viewRecord.month = view->timestamp.month;
+        viewRecord.day = view->timestamp.day;
+        viewRecord.hour = view->timestamp.hour;
+        viewRecord.minute = view->timestamp.minute;
+        viewRecord.score = view->score;
+        viewRecord.minutes = view->minutes;
+        ok = fwrite(&viewRecord, sizeof(viewRecord), 1, file) == 1;
+    }
+    header->viewsCount = views->size;
+    offset += header->viewsCount * sizeof(tSnapshotView);
+
+    // Strings at the end, so records did not need to wait for them
+    header->stringsOffset = offset;
+    header->stringsSize = strings->size;
+    if (ok && strings->size > 0) {
+        ok = fwrite(strings->data, 1, strings->size, file) == strings->size;
+    }
+
+    // Header with the final counts and offsets
+    if (ok) {
+        ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(header, sizeof(tSnapshotHeader), 1, file) == 1;
+    }
+
+    return ok ? OK : ERR_INVALID;
+}
+
+// Write a snapshot of the dataset to a file, in one pass over the tables. 
+tError snapshot_save(const char* path, tSeriesTable* series, tFilmTable* films, 
+                     tUserTable* users, tViewLog* views) {
+    FILE* file;
+    tSnapshotHeader header;
+    tSnapshotStrings strings;
+    uint32_t* userPositions;
+    uint32_t* filmPositions;
+    tError err;
+
+    // Verify pre conditions
+    assert(path != NULL);
+    assert(series != NULL);
+    assert(films != NULL);
+    assert(users != NULL);
+    assert(views != NULL);
+
+    // A bound log must be bound to the tables being saved. Snapshots 
+    // store views as records, so sealed views are not supported
+    if (views->users != NULL && (views->users != users || views->films != films)) {
+        return ERR_INVALID;
+    }
+    if (views->sealedSize > 0) {
+        return ERR_INVALID;
+    }
+
+    // Positions of the elements of the tables in the snapshot, without tombstones
+    userPositions = (uint32_t*)mem_alloc(MEM_STORAGE, (users->size + 1) * sizeof(uint32_t));
+    filmPositions = (uint32_t*)mem_alloc(MEM_STORAGE, (films->size + 1) * sizeof(uint32_t));
+    if (userPositions == NULL || filmPositions == NULL) {
+        mem_free(userPositions);
+        mem_free(filmPositions);
+        return ERR_MEMORY_ERROR;
+    }
+
+    file = fopen(path, "wb");
+    if (file == NULL) {
+        err = ERR_INVALID;
+    }
+    else {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.byteOrder = SNAPSHOT_BYTE_ORDER;
+
+        strings.size = 0;
+        strings.capacity = 0;
+        strings.data = NULL;
+
+        // Space for the header, that is written at the end
+        if (fwrite(&header, sizeof(header), 1, file) != 1) {
+            err = ERR_INVALID;
+        }
+        else {
+            err = snapshot_write(file, &header, series, films, users, views, 
+                    userPositions, filmPositions, &strings);
+        }
+        mem_free(strings.data);
+
+        if (fclose(file) != 0 && err == OK) {
+            err = ERR_INVALID;
+        }
+        if (err != OK) {
+            remove(path);
+        }
+    }
+
+    mem_free(userPositions);
+    mem_free(filmPositions);
+
+    return err;
+}
+
+// **** Load
+
+// Snapshot file loaded in memory
+typedef struct {
+    const char* data;
+    size_t size;
+    bool mapped;
+} tSnapshotFile;
+
+// Map a file in memory, or read it in one block if mmap is not available
+static tError snapshotFile_open(tSnapshotFile* file, const char* path) {
+#ifdef SNAPSHOT_NO_MMAP
+    FILE* f;
+    long size;
+    char* data;
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        return ERR_NOT_FOUND;
+    }
+    if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return ERR_INVALID;
+    }
+    data = (char*)mem_alloc(MEM_STORAGE, size > 0 ? (size_t)size : 1);
+    if (data == NULL) {
+        fclose(f);
+        return ERR_MEMORY_ERROR;
+    }
+    if (fread(data, 1, (size_t)size, f) != (size_t)size) {
+        mem_free(data);
+        fclose(f);
+        return ERR_INVALID;
+    }
+    fclose(f);
+
+    file->data = data;
+    file->size = (size_t)size;
+    file->mapped = false;
+#else
+    int fd;
+    struct stat info;
+    void* data;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return ERR_NOT_FOUND;
+    }
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(tSnapshotHeader)) {
+        close(fd);
+        return ERR_INVALID;
+    }
+    data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return ERR_INVALID;
+    }
+
+    // The file is read once from the beginning to the end
+    madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+    file->data = (const char*)data;
+    file->size = (size_t)info.st_size;
+    file->mapped = true;
+#endif
+
+    return OK;
+}
+
+// Release a file loaded with snapshotFile_open
+static void snapshotFile_close(tSnapshotFile* file) {
+#ifdef SNAPSHOT_NO_MMAP
+    mem_free((void*)file->data);
+#else
+    munmap((void*)file->data, file->size);
+#endif
+    file->data = NULL;
+    file->size = 0;
+}
+
+// Check that an array of count records of a given size is inside the file
+static bool snapshot_checkArray(tSnapshotFile* file, uint32_t offset, uint32_t count, size_t size) {
+    return offset % sizeof(uint32_t) == 0 && offset <= file->size 
+        && (uint64_t)count * size <= file->size - offset;
+}
+
+// Check the header of a snapshot
+static bool snapshot_checkHeader(tSnapshotFile* file, const tSnapshotHeader* header) {
+    if (file->size < sizeof(tSnapshotHeader) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0
+            || header->version != SNAPSHOT_VERSION || header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+        return false;
+    }
+
+    // Strings are checked to end with '\0', so any offset inside the block is a valid string
+    if (header->stringsOffset > file->size || header->stringsSize > file->size - header->stringsOffset
+            || (header->stringsSize > 0 && file->data[header->stringsOffset + header->stringsSize - 1] != '\0')) {
+        return false;
+    }
+
+    return snapshot_checkArray(file, header->seriesOffset, header->seriesCount, sizeof(tSnapshotSeries))
+        && snapshot_checkArray(file, header->filmsOffset, header->filmsCount, sizeof(tSnapshotFilm))
+        && snapshot_checkArray(file, header->usersOffset, header->usersCount, sizeof(tSnapshotUser))
+        && snapshot_checkArray(file, header->favoritesOffset, header->favoritesCount, sizeof(uint32_t))
+        && snapshot_checkArray(file, header->viewsOffset, header->viewsCount, sizeof(tSnapshotView));
+}
+
+// Fill the tables with the records of a checked snapshot
+static tError snapshot_read(tSnapshotFile* file, const tSnapshotHeader* header, tSeriesTable* series, 
+                     tFilmTable* films, tUserTable* users, tViewLog* views) {
+    const tSnapshotSeries* seriesRecords = (const tSnapshotSeries*)(file->data + header->seriesOffset);
+    const tSnapshotFilm* filmRecords = (const tSnapshotFilm*)(file->data + header->filmsOffset);
+    const tSnapshotUser* userRecords = (const tSnapshotUser*)(file->data + header->usersOffset);
+    const uint32_t* favoriteRecords = (const uint32_t*)(file->data + header->favoritesOffset);
+    const tSnapshotView* viewRecords = (const tSnapshotView*)(file->data + header->viewsOffset);
+    const char* strings = file->data + header->stringsOffset;
+    unsigned int i, j;
+    tSeries seriesObject;
+    tFilm film;
+    tUser user;
+    tView view;
+    tDateTime timestamp;
+    tError err;
+
+    // All the memory of the tables is reserved at once
+    if (seriesTable_reserve(series, header->seriesCount) != OK || filmTable_reserve(films, header->filmsCount) != OK
+            || userTable_reserve(users, header->usersCount) != OK || viewLog_reserve(views, header->viewsCount) != OK
+            || favoriteNodePool_reserve(header->favoritesCount) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // The temporary objects reference the strings of the file, as the tables copy them
+    for (i = 0; i < header->seriesCount; i++) {
+        if (seriesRecords[i].title >= header->stringsSize || seriesRecords[i].genre == GENRE_NOT_FOUND 
+                || seriesRecords[i].genre >= GENRE_QTY) {
+            return ERR_INVALID;
+        }
+        seriesObject.title = strings + seriesRecords[i].title;
+        seriesObject.genre = (tGenre)seriesRecords[i].genre;
+        err = seriesTable_add(series, &seriesObject);
+        if (err != OK) {
+            return (err == ERR_DUPLICATED) ? ERR_INVALID : err;
+        }
+    }
+
+    for (i = 0; i < header->filmsCount; i++) {
+        if (filmRecords[i].title >= header->stringsSize || filmRecords[i].series >= header->seriesCount
+                || filmRecords[i].lengthInMin > 0xFFFF) {
+            return ERR_INVALID;
+        }
+        film.title = strings + filmRecords[i].title;
+        film.lengthInMin = (unsigned short)filmRecords[i].lengthInMin;
+        film.series = series->elements[filmRecords[i].series];
+        err = filmTable_add(films, &film);
+        if (err != OK) {
+            return (err == ERR_DUPLICATED) ? ERR_INVALID : err;
+        }
+    }
+
+    for (i = 0; i < header->usersCount; i++) {
+        if (userRecords[i].username >= header->stringsSize || userRecords[i].name >= header->stringsSize
+                || userRecords[i].mail >= header->stringsSize || userRecords[i].firstFavorite > header->favoritesCount
+                || userRecords[i].favoritesCount > header->favoritesCount - userRecords[i].firstFavorite) {
+            return ERR_INVALID;
+        }
+        user.username = strings + userRecords[i].username;
+        user.name = (char*)(strings + userRecords[i].name);
+        user.mail = (char*)(strings + userRecords[i].mail);
+        err = userTable_add(users, &user);
+        if (err != OK) {
+            return (err == ERR_DUPLICATED) ? ERR_INVALID : err;
+        }
+
+        // Push the favorites from the bottom of the stack to the top
+        for (j = userRecords[i].favoritesCount; j > 0; j--) {
+            if (favoriteRecords[userRecords[i].firstFavorite + j - 1] >= header->filmsCount) {
+                return ERR_INVALID;
+            }
+            err = user_addFavorite(&(users->elements[i]), films->elements[favoriteRecords[userRecords[i].firstFavorite + j - 1]]);
+            if (err != OK) {
+                return err;
+            }
+        }
+    }
+
+    if (viewLog_bind(views, users, films) != OK) {
+        return ERR_INVALID;
+    }
+    for (i = 0; i < header->viewsCount; i++) {
+        if (viewRecords[i].user >= header->usersCount || viewRecords[i].film >= header->filmsCount
+                || viewRecords[i].month > 12 || viewRecords[i].day > 31 || viewRecords[i].hour >= 24
+                || viewRecords[i].minute > 60 || viewRecords[i].score >= 10) {
+            return ERR_INVALID;
+        }
+        timestamp.year = viewRecords[i].year;
+        timestamp.month = viewRecords[i].month;
+        timestamp.day = viewRecords[i].day;
+        timestamp.hour = viewRecords[i].hour;
+        timestamp.minute = viewRecords[i].minute;
+        view_initRef(&view, &timestamp, viewRecords[i].score, 
+            &(users->elements[viewRecords[i].user]), &(films->elements[viewRecords[i].film]));
+        view.minutes = viewRecords[i].minutes;
+        err = viewLog_add(views, &view);
+        if (err != OK) {
+            return err;
+        }
+    }
+
+    return OK;
+}
+
+// Load a snapshot into empty tables, which are initialized by this function. 
+tError snapshot_load(const char* path, tSeriesTable* series, tFilmTable* films, 
+                     tUserTable* users, tViewLog* views) {
+    tSnapshotFile file;
+    tSnapshotHeader header;
+    tError err;
+
+    // Verify pre conditions
+    assert(path != NULL);
+    assert(series != NULL);
+    assert(films != NULL);
+    assert(users != NULL);
+    assert(views != NULL);
+
+    seriesTable_init(series);
+    filmTable_init(films);
+    userTable_init(users);
+    viewLog_init(views);
+
+    err = snapshotFile_open(&file, path);
+    if (err != OK) {
+        return err;
+    }
+
+    // Copy the header, the file could be too short to contain it
+    memset(&header, 0, sizeof(header));
+    memcpy(&header, file.data, file.size < sizeof(header) ? file.size : sizeof(header));
+
+    if (!snapshot_checkHeader(&file, &header)) {
+        err = ERR_INVALID;
+    }
+    else {
+        err = snapshot_read(&file, &header, series, films, users, views);
+    }
+    snapshotFile_close(&file);
+
+    // Leave the tables empty on error
+    if (err != OK) {
+        viewLog_free(views);
+        userTable_free(users);
+        filmTable_free(films);
+        seriesTable_free(series);
+    }
+
+    return err;
+}
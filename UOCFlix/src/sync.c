@@ -0,0 +1,338 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "sync.h"
+
+#ifdef _WIN32
+#include <process.h>
+#endif
+
+// Storage class of the variables that are private to each thread
+#if defined(_MSC_VER)
+#define SYNC_THREAD_LOCAL __declspec(thread)
+#else
+#define SYNC_THREAD_LOCAL __thread
+#endif
+
+// Lock held by the calling thread. The system locks are not reentrant, so 
+// each thread keeps the locks it holds and how many times it has taken them
+typedef struct {
+    tRWLock* lock;
+    unsigned int depth;
+    bool write;
+} tHeldLock;
+
+static SYNC_THREAD_LOCAL tHeldLock heldLocks[SYNC_MAX_HELD_LOCKS];
+static SYNC_THREAD_LOCAL unsigned int heldCount = 0;
+
+// Get the entry of a lock held by the calling thread, or NULL
+static tHeldLock* rwlock_findHeld(tRWLock* lock) {
+    unsigned int i;
+
+    for (i = 0; i < heldCount; i++) {
+        if (heldLocks[i].lock == lock) {
+            return &heldLocks[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Take a lock, or increase its depth if the thread already holds it
+static void rwlock_acquire(tRWLock* lock, bool write) {
+    tHeldLock* held;
+
+    held = rwlock_findHeld(lock);
+    if (held != NULL) {
+        // Upgrading a read lock would deadlock with the other readers
+        assert(held->write || !write);
+        held->depth++;
+        return;
+    }
+
+    assert(heldCount < SYNC_MAX_HELD_LOCKS);
+#ifdef _WIN32
+    if (write) {
+        AcquireSRWLockExclusive(&lock->handle);
+    }
+    else {
+        AcquireSRWLockShared(&lock->handle);
+    }
+#else
+    if (write) {
+        pthread_rwlock_wrlock(&lock->handle);
+    }
+    else {
+        pthread_rwlock_rdlock(&lock->handle);
+    }
+#endif
+    heldLocks[heldCount].lock = lock;
+    heldLocks[heldCount].depth = 1;
+    heldLocks[heldCount].write = write;
+    heldCount++;
+}
+
+// Decrease the depth of a lock held by the thread, releasing it when it gets to 0
+static void rwlock_release(tRWLock* lock) {
+    tHeldLock* held;
+
+    held = rwlock_findHeld(lock);
+    assert(held != NULL);
+
+    held->depth--;
+    if (held->depth > 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    if (held->write) {
+        ReleaseSRWLockExclusive(&lock->handle);
+    }
+    else {
+        ReleaseSRWLockShared(&lock->handle);
+    }
+#else
+    pthread_rwlock_unlock(&lock->handle);
+#endif
+
+    // The last entry fills the hole
+    heldCount--;
+    *held = heldLocks[heldCount];
+}
+
+// Initialize a reader-writer lock
+tError rwlock_init(tRWLock* lock) {
+    // Verify pre conditions
+    assert(lock != NULL);
+
+#ifdef _WIN32
+    InitializeSRWLock(&lock->handle);
+#else
+    if (pthread_rwlock_init(&lock->handle, NULL) != 0) {
+        return ERR_MEMORY_ERROR;
+    }
+#endif
+
+    return OK;
+}
+
+// Release a reader-writer lock, that must not be held by any thread
+void rwlock_free(tRWLock* lock) {
+    // Verify pre conditions
+    assert(lock != NULL);
+    assert(rwlock_findHeld(lock) == NULL);
+
+#ifndef _WIN32
+    pthread_rwlock_destroy(&lock->handle);
+#endif
+}
+
+// Take a lock for reading. A NULL lock does nothing
+void rwlock_readLock(tRWLock* lock) {
+    if (lock != NULL) {
+        rwlock_acquire(lock, false);
+    }
+}
+
+// Release a lock taken for reading. A NULL lock does nothing
+void rwlock_readUnlock(tRWLock* lock) {
+    if (lock != NULL) {
+        rwlock_release(lock);
+    }
+}
+
+// Take a lock for writing. A NULL lock does nothing
+void rwlock_writeLock(tRWLock* lock) {
+    if (lock != NULL) {
+        rwlock_acquire(lock, true);
+    }
+}
+
+// Release a lock taken for writing. A NULL lock does nothing
+void rwlock_writeUnlock(tRWLock* lock) {
+    if (lock != NULL) {
+        rwlock_release(lock);
+    }
+}
+
+// Add delta to a value shared between threads, as a single atomic operation
+unsigned int atomic_fetchAdd(volatile unsigned int* value, unsigned int delta) {
+    // Verify pre conditions
+    assert(value != NULL);
+
+#if defined(_MSC_VER)
+    return (unsigned int)InterlockedExchangeAdd((volatile LONG*)value, (LONG)delta);
+#else
+    return __atomic_fetch_add(value, delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Add delta to a 64 bits value shared between threads, as a single atomic operation
+unsigned long long atomic_fetchAdd64(volatile unsigned long long* value, unsigned long long delta) {
+    // Verify pre conditions
+    assert(value != NULL);
+
+#if defined(_MSC_VER)
+    return (unsigned long long)InterlockedExchangeAdd64((volatile LONGLONG*)value, (LONGLONG)delta);
+#else
+    return __atomic_fetch_add(value, delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Set a 64 bits value shared between threads to desired if it is still equal to expected
+bool atomic_compareExchange64(volatile unsigned long long* value, unsigned long long expected, unsigned long long desired) {
+    // Verify pre conditions
+    assert(value != NULL);
+
+#if defined(_MSC_VER)
+    return (unsigned long long)InterlockedCompareExchange64((volatile LONGLONG*)value, 
+                (LONGLONG)desired, (LONGLONG)expected) == expected;
+#else
+    return __atomic_compare_exchange_n(value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Initialize an event, that has not been signaled
+tError event_init(tEvent* event) {
+    // Verify pre conditions
+    assert(event != NULL);
+
+    event->count = 0;
+#ifdef _WIN32
+    InitializeCriticalSection(&event->mutex);
+    InitializeConditionVariable(&event->cond);
+#else
+    if (pthread_mutex_init(&event->mutex, NULL) != 0) {
+        return ERR_MEMORY_ERROR;
+    }
+    if (pthread_cond_init(&event->cond, NULL) != 0) {
+        pthread_mutex_destroy(&event->mutex);
+        return ERR_MEMORY_ERROR;
+    }
+#endif
+
+    return OK;
+}
+
+// Release an event, that must not have waiting threads
+void event_free(tEvent* event) {
+    // Verify pre conditions
+    assert(event != NULL);
+
+#ifdef _WIN32
+    DeleteCriticalSection(&event->mutex);
+#else
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->mutex);
+#endif
+}
+
+// Get the number of times an event has been signaled
+unsigned long long event_count(tEvent* event) {
+    unsigned long long count;
+
+    // Verify pre conditions
+    assert(event != NULL);
+
+#ifdef _WIN32
+    EnterCriticalSection(&event->mutex);
+    count = event->count;
+    LeaveCriticalSection(&event->mutex);
+#else
+    pthread_mutex_lock(&event->mutex);
+    count = event->count;
+    pthread_mutex_unlock(&event->mutex);
+#endif
+
+    return count;
+}
+
+// Signal an event, waking all the threads waiting for it
+void event_signal(tEvent* event) {
+    // Verify pre conditions
+    assert(event != NULL);
+
+#ifdef _WIN32
+    EnterCriticalSection(&event->mutex);
+    event->count++;
+    LeaveCriticalSection(&event->mutex);
+    WakeAllConditionVariable(&event->cond);
+#else
+    pthread_mutex_lock(&event->mutex);
+    event->count++;
+    pthread_cond_broadcast(&event->cond);
+    pthread_mutex_unlock(&event->mutex);
+#endif
+}
+
+// Wait until an event has been signaled more than count times
+void event_wait(tEvent* event, unsigned long long count) {
+    // Verify pre conditions
+    assert(event != NULL);
+
+    // Waits can end without a signal, so the count is checked again
+#ifdef _WIN32
+    EnterCriticalSection(&event->mutex);
+    while (event->count <= count) {
+        SleepConditionVariableCS(&event->cond, &event->mutex, INFINITE);
+    }
+    LeaveCriticalSection(&event->mutex);
+#else
+    pthread_mutex_lock(&event->mutex);
+    while (event->count <= count) {
+        pthread_cond_wait(&event->cond, &event->mutex);
+    }
+    pthread_mutex_unlock(&event->mutex);
+#endif
+}
+
+// Entry point of the threads, with the signature of each platform
+#ifdef _WIN32
+static unsigned __stdcall thread_main(void* arg) {
+    tThread* thread = (tThread*)arg;
+
+    thread->fn(thread->context);
+    return 0;
+}
+#else
+static void* thread_main(void* arg) {
+    tThread* thread = (tThread*)arg;
+
+    thread->fn(thread->context);
+    return NULL;
+}
+#endif
+
+// Start a thread that runs fn(context)
+tError thread_create(tThread* thread, tThreadFn fn, void* context) {
+    // Verify pre conditions
+    assert(thread != NULL);
+    assert(fn != NULL);
+
+    thread->fn = fn;
+    thread->context = context;
+#ifdef _WIN32
+    thread->handle = (HANDLE)_beginthreadex(NULL, 0, thread_main, thread, 0, NULL);
+    if (thread->handle == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+#else
+    if (pthread_create(&thread->handle, NULL, thread_main, thread) != 0) {
+        return ERR_MEMORY_ERROR;
+    }
+#endif
+
+    return OK;
+}
+
+// Wait for the end of a thread
+void thread_join(tThread* thread) {
+    // Verify pre conditions
+    assert(thread != NULL);
+
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+}
@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "table.h"
+#include "mem.h"
+
+// Get the capacity a table must grow to in order to hold at least n elements.
+// The capacity is doubled each time, so appending elements is amortized O(1)
+unsigned int table_growCapacity(unsigned int capacity, unsigned int n) {
+    unsigned int newCapacity;
+
+    newCapacity = (capacity == 0) ? TABLE_INITIAL_CAPACITY : capacity;
+
+    while (newCapacity < n) {
+        // Avoid overflow for huge tables, just use the requested size
+        if (newCapacity > UINT_MAX / 2) {
+            return n;
+        }
+        newCapacity = newCapacity * 2;
+    }
+
+    return newCapacity;
+}
+
+// Check if a table with size positions, with removed of them being 
+// tombstones, must be compacted
+bool table_needsCompaction(unsigned int size, unsigned int removed) {
+    // Compacting after removing half of the table keeps the cost 
+    // of compaction amortized O(1) per removal
+    return removed > 0 && removed >= size - removed;
+}
+
+// Initialize an empty list of positions
+void postings_init(tPostings* postings) {
+    // Verify pre conditions
+    assert(postings != NULL);
+
+    postings->size = 0;
+    postings->capacity = 0;
+    postings->elements = NULL;
+}
+
+// Release the memory used by a list of positions
+void postings_free(tPostings* postings) {
+    // Verify pre conditions
+    assert(postings != NULL);
+
+    if (postings->elements != NULL) {
+        mem_free(postings->elements);
+        postings->elements = NULL;
+    }
+    postings->size = 0;
+    postings->capacity = 0;
+}
+
+// Add a position at the end of the list
+tError postings_add(tPostings* postings, unsigned int position) {
+    unsigned int capacity;
+    unsigned int* elements;
+
+    // Verify pre conditions
+    assert(postings != NULL);
+
+    if (postings->size == postings->capacity) {
+        capacity = table_growCapacity(postings->capacity, postings->size + 1);
+        elements = (unsigned int*)mem_realloc(MEM_INDEX, postings->elements, capacity * sizeof(unsigned int));
+        if (elements == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+        postings->elements = elements;
+        postings->capacity = capacity;
+    }
+
+    postings->elements[postings->size] = position;
+    postings->size++;
+
+    return OK;
+}
+
+// Remove the position stored at an offset of the list, keeping the order of the others
+void postings_removeAt(tPostings* postings, unsigned int offset) {
+    // Verify pre conditions
+    assert(postings != NULL);
+    assert(offset < postings->size);
+
+    memmove(&postings->elements[offset], &postings->elements[offset + 1], 
+        (postings->size - offset - 1) * sizeof(unsigned int));
+    postings->size--;
+}
+
+// Remove the position stored at an offset of the list, moving the last 
+// position of the list to that offset
+void postings_swapRemoveAt(tPostings* postings, unsigned int offset) {
+    // Verify pre conditions
+    assert(postings != NULL);
+    assert(offset < postings->size);
+
+    postings->size--;
+    postings->elements[offset] = postings->elements[postings->size];
+}
+
+// Update the positions of the list after removing the element at a position of the table
+void postings_shift(tPostings* postings, unsigned int position) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(postings != NULL);
+
+    for (i = 0; i < postings->size; i++) {
+        if (postings->elements[i] > position) {
+            postings->elements[i]--;
+        }
+    }
+}
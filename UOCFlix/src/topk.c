@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "topk.h"
+#include "mem.h"
+
+// Check if an entry of a ranking goes after another one
+static bool rankEntry_isWorse(const tRankEntry* a, const tRankEntry* b) {
+    if (a->score != b->score) {
+        return a->score < b->score;
+    }
+    return a->order > b->order;
+}
+
+// Move down an entry of the heap until its children are not worse than it
+static void topK_siftDown(tRankEntry* entries, unsigned int size, unsigned int i) {
+    unsigned int child;
+    tRankEntry entry = entries[i];
+
+    while ((child = 2 * i + 1) < size) {
+        // Take the worst of the two children
+        if (child + 1 < size && rankEntry_isWorse(&entries[child + 1], &entries[child])) {
+            child++;
+        }
+        if (!rankEntry_isWorse(&entries[child], &entry)) {
+            break;
+        }
+        entries[i] = entries[child];
+        i = child;
+    }
+    entries[i] = entry;
+}
+
+// Move up an entry of the heap until its parent is not better than it
+static void topK_siftUp(tRankEntry* entries, unsigned int i) {
+    unsigned int parent;
+    tRankEntry entry = entries[i];
+
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (!rankEntry_isWorse(&entry, &entries[parent])) {
+            break;
+        }
+        entries[i] = entries[parent];
+        i = parent;
+    }
+    entries[i] = entry;
+}
+
+// Initialize an empty selection of the k best elements
+tError topK_init(tTopK* top, unsigned int k) {
+    // Verify pre conditions
+    assert(top != NULL);
+
+    top->k = k;
+    top->size = 0;
+    top->entries = NULL;
+    if (k > 0) {
+        top->entries = (tRankEntry*)mem_alloc(MEM_REPORT, k * sizeof(tRankEntry));
+        if (top->entries == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    return OK;
+}
+
+// Release the memory used by a selection
+void topK_free(tTopK* top) {
+    // Verify pre conditions
+    assert(top != NULL);
+
+    if (top->entries != NULL) {
+        mem_free(top->entries);
+        top->entries = NULL;
+    }
+    top->size = 0;
+    top->k = 0;
+}
+
+// Add an element to the selection
+void topK_add(tTopK* top, long long score, unsigned int order, unsigned int id) {
+    tRankEntry entry;
+
+    // Verify pre conditions
+    assert(top != NULL);
+
+    entry.score = score;
+    entry.order = order;
+    entry.id = id;
+
+    if (top->size < top->k) {
+        top->entries[top->size] = entry;
+        topK_siftUp(top->entries, top->size);
+        top->size++;
+    }
+    else if (top->k > 0 && rankEntry_isWorse(&top->entries[0], &entry)) {
+        // Replace the worst selected entry
+        top->entries[0] = entry;
+        topK_siftDown(top->entries, top->size, 0);
+    }
+}
+
+// Add an element to the selection, or replace the entry with the same id if the new one is better
+void topK_update(tTopK* top, long long score, unsigned int order, unsigned int id) {
+    unsigned int i;
+    tRankEntry entry;
+
+    // Verify pre conditions
+    assert(top != NULL);
+
+    for (i = 0; i < top->size; i++) {
+        if (top->entries[i].id == id) {
+            entry.score = score;
+            entry.order = order;
+            entry.id = id;
+            // A better entry can only move down in a min-heap
+            if (rankEntry_isWorse(&top->entries[i], &entry)) {
+                top->entries[i] = entry;
+                topK_siftDown(top->entries, top->size, i);
+            }
+            return;
+        }
+    }
+
+    // An entry that was discarded is worse than all the selected ones, 
+    // so if the id comes back it is selected again only if it is better
+    topK_add(top, score, order, id);
+}
+
+// Sort the selected entries from the best to the worst
+void topK_sort(tTopK* top) {
+    unsigned int size;
+    tRankEntry worst;
+
+    // Verify pre conditions
+    assert(top != NULL);
+
+    // Heap sort: the worst entry goes to the end each time
+    for (size = top->size; size > 1; size--) {
+        worst = top->entries[0];
+        top->entries[0] = top->entries[size - 1];
+        top->entries[size - 1] = worst;
+        topK_siftDown(top->entries, size - 1, 0);
+    }
+}
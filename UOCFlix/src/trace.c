@@ -0,0 +1,259 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+#include "trace.h"
+#include "sync.h"
+
+// Storage class of the variables that are private to each thread
+#if defined(_MSC_VER)
+#define TRACE_THREAD_LOCAL __declspec(thread)
+#else
+#define TRACE_THREAD_LOCAL __thread
+#endif
+
+// Number of buckets for each power of 2
+#define TRACE_SUB_BUCKETS (1u << TRACE_SUB_BITS)
+
+// Records of a thread not merged yet. The counters are smaller than the
+// shared ones, as they are merged before they can overflow
+typedef struct {
+    unsigned int buckets[TRACE_POINT_QTY][TRACE_BUCKETS];
+    unsigned long long totalNs[TRACE_POINT_QTY];
+    unsigned long long maxNs[TRACE_POINT_QTY];
+    unsigned int count[TRACE_POINT_QTY];
+    unsigned int pending;
+} tTraceLocal;
+
+static TRACE_THREAD_LOCAL tTraceLocal traceLocal;
+
+// Histograms with the records merged by all the threads
+static tTraceHistogram traceHistograms[TRACE_POINT_QTY];
+
+// Lock of the shared histograms
+static tRWLock traceLock = RWLOCK_INITIALIZER;
+
+// Function called with each record
+static tTraceFn traceCallback = NULL;
+static void* traceContext = NULL;
+
+// Names of the entry points, in the order of tTracePoint
+static const char* tracePointNames[TRACE_POINT_QTY] = {
+    "userTable_find", "userTable_add", "userTable_remove",
+    "filmTable_find", "filmTable_add", "filmTable_remove",
+    "viewLog_add", "viewLog_getFavFilm", "viewLog_getFavGenre",
+    "viewLog_getFavFilmInRange", "viewLog_getFavGenreInRange",
+    "user_getFavoriteGenre", "user_getFavsLengthInMin", "user_getFavsCntPerSeries"
+};
+
+// Get the time of a monotonic clock, in nanoseconds
+unsigned long long trace_now(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (unsigned long long)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+// Get the position of the highest bit set of a value, that must not be 0
+static unsigned int trace_highestBit(unsigned long long value) {
+#if defined(__GNUC__)
+    return 63 - (unsigned int)__builtin_clzll(value);
+#else
+    unsigned int bit = 0;
+
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Get the bucket of a value
+unsigned int traceHistogram_bucket(unsigned long long value) {
+    unsigned int bit;
+
+    // Small values have a bucket each
+    if (value < TRACE_SUB_BUCKETS) {
+        return (unsigned int)value;
+    }
+
+    // Bigger values are grouped by their highest bit, and inside it,
+    // by the TRACE_SUB_BITS bits that follow it
+    bit = trace_highestBit(value);
+    return ((bit - TRACE_SUB_BITS + 1) << TRACE_SUB_BITS)
+            + (unsigned int)((value >> (bit - TRACE_SUB_BITS)) & (TRACE_SUB_BUCKETS - 1));
+}
+
+// Get the lowest value of a bucket
+unsigned long long traceHistogram_bucketLow(unsigned int bucket) {
+    unsigned int bit;
+
+    // Verify pre conditions
+    assert(bucket < TRACE_BUCKETS);
+
+    if (bucket < TRACE_SUB_BUCKETS) {
+        return bucket;
+    }
+    bit = (bucket >> TRACE_SUB_BITS) + TRACE_SUB_BITS - 1;
+    return (unsigned long long)(TRACE_SUB_BUCKETS + (bucket & (TRACE_SUB_BUCKETS - 1))) << (bit - TRACE_SUB_BITS);
+}
+
+// Get the value under which are the given fraction (0 to 1) of the records
+unsigned long long traceHistogram_percentile(const tTraceHistogram* histogram, double fraction) {
+    unsigned long long target, seen, high;
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(histogram != NULL);
+    assert(fraction >= 0.0 && fraction <= 1.0);
+
+    if (histogram->count == 0) {
+        return 0;
+    }
+
+    // Rank of the record, starting at 1
+    target = (unsigned long long)(fraction * (double)histogram->count);
+    if ((double)target < fraction * (double)histogram->count) {
+        target++;
+    }
+    if (target == 0) {
+        target = 1;
+    }
+
+    seen = 0;
+    for (i = 0; i < TRACE_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= target) {
+            high = (i + 1 < TRACE_BUCKETS) ? traceHistogram_bucketLow(i + 1) - 1 : histogram->maxNs;
+            return (high < histogram->maxNs) ? high : histogram->maxNs;
+        }
+    }
+
+    return histogram->maxNs;
+}
+
+// Merge the records of the calling thread in the shared histograms
+void trace_flush(void) {
+    unsigned int i, j;
+    tTraceHistogram* histogram;
+
+    if (traceLocal.pending == 0) {
+        return;
+    }
+
+    rwlock_writeLock(&traceLock);
+    for (i = 0; i < TRACE_POINT_QTY; i++) {
+        // Only the entry points called since the last merge
+        if (traceLocal.count[i] == 0) {
+            continue;
+        }
+        histogram = &traceHistograms[i];
+        for (j = 0; j < TRACE_BUCKETS; j++) {
+            histogram->buckets[j] += traceLocal.buckets[i][j];
+        }
+        histogram->count += traceLocal.count[i];
+        histogram->totalNs += traceLocal.totalNs[i];
+        if (traceLocal.maxNs[i] > histogram->maxNs) {
+            histogram->maxNs = traceLocal.maxNs[i];
+        }
+
+        memset(traceLocal.buckets[i], 0, sizeof(traceLocal.buckets[i]));
+        traceLocal.count[i] = 0;
+        traceLocal.totalNs[i] = 0;
+        traceLocal.maxNs[i] = 0;
+    }
+    rwlock_writeUnlock(&traceLock);
+
+    traceLocal.pending = 0;
+}
+
+// Record the latency of a call to an entry point
+void trace_record(tTracePoint point, unsigned long long ns) {
+    tTraceFn fn = traceCallback;
+
+    // Verify pre conditions
+    assert(point < TRACE_POINT_QTY);
+
+    // Only the thread is changed, the shared histograms are updated periodically
+    traceLocal.buckets[point][traceHistogram_bucket(ns)]++;
+    traceLocal.count[point]++;
+    traceLocal.totalNs[point] += ns;
+    if (ns > traceLocal.maxNs[point]) {
+        traceLocal.maxNs[point] = ns;
+    }
+    traceLocal.pending++;
+    if (traceLocal.pending >= TRACE_MERGE_INTERVAL) {
+        trace_flush();
+    }
+
+    if (fn != NULL) {
+        fn(point, ns, traceContext);
+    }
+}
+
+// Set the function called with each record, or NULL to call none
+void trace_setCallback(tTraceFn fn, void* context) {
+    traceContext = context;
+    traceCallback = fn;
+}
+
+// Get the histogram of an entry point, with the records merged until now
+void trace_getHistogram(tTracePoint point, tTraceHistogram* histogram) {
+    // Verify pre conditions
+    assert(point < TRACE_POINT_QTY);
+    assert(histogram != NULL);
+
+    // The records of the calling thread are included
+    trace_flush();
+
+    rwlock_readLock(&traceLock);
+    *histogram = traceHistograms[point];
+    rwlock_readUnlock(&traceLock);
+}
+
+// Remove all the records of the shared histograms and of the calling thread
+void trace_reset(void) {
+    memset(&traceLocal, 0, sizeof(traceLocal));
+
+    rwlock_writeLock(&traceLock);
+    memset(traceHistograms, 0, sizeof(traceHistograms));
+    rwlock_writeUnlock(&traceLock);
+}
+
+// Get the name of an entry point
+const char* trace_pointName(tTracePoint point) {
+    // Verify pre conditions
+    assert(point < TRACE_POINT_QTY);
+
+    return tracePointNames[point];
+}
+
+// Write count, mean, percentiles and maximum of each entry point with records
+void trace_dump(FILE* fout) {
+    unsigned int i;
+    tTraceHistogram histogram;
+
+    // Verify pre conditions
+    assert(fout != NULL);
+
+    fprintf(fout, "%-28s %12s %10s %10s %10s %10s %12s\n", "ENTRY POINT", "CALLS", "MEAN NS", "P50 NS", "P90 NS", "P99 NS", "MAX NS");
+    for (i = 0; i < TRACE_POINT_QTY; i++) {
+        trace_getHistogram((tTracePoint)i, &histogram);
+        if (histogram.count == 0) {
+            continue;
+        }
+        fprintf(fout, "%-28s %12llu %10llu %10llu %10llu %10llu %12llu\n", tracePointNames[i], histogram.count,
+                histogram.totalNs / histogram.count, traceHistogram_percentile(&histogram, 0.5),
+                traceHistogram_percentile(&histogram, 0.9), traceHistogram_percentile(&histogram, 0.99), histogram.maxNs);
+    }
+}
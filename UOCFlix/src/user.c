@@ -2,9 +2,141 @@
 #include <string.h>
 #include <assert.h>
 #include <limits.h>
+#include <stdint.h>
 #include <ctype.h>
 #include "user.h"
 #include "favorite.h"
+#include "hash.h"
+#include "table.h"
+#include "intern.h"
+#include "sync.h"
+#include "topk.h"
+#include "mem.h"
+#include "trace.h"
+#include "arena.h"
+#include "recommend.h"
+
+// Vector instructions used to normalize the names, when the compiler has them
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USER_NAME_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USER_NAME_NEON
+#endif
+
+// Get the key used by the hash index of a table of users
+static const char* userTable_getKey(void* table, unsigned int position) {
+    return ((tUserTable*)table)->elements[position].username;
+}
+
+// Get the key used by the hash index of a table of counts per series
+static const char* seriesCountTable_getKey(void* table, unsigned int position) {
+    return ((tSeriesCountTable*)table)->elements[position].series->title;
+}
+
+// Initialize the aggregates of the favorites of a user
+static void user_initFavsAggregates(tUser* object) {
+    int i;
+
+    for (i = 0; i < GENRE_QTY; i++) {
+        object->favsPerGenre[i] = 0;
+    }
+    object->favsLengthInMin = 0;
+
+    object->favsPerSeries.size = 0;
+    object->favsPerSeries.capacity = 0;
+    object->favsPerSeries.elements = NULL;
+    hashIndex_init(&object->favsPerSeries.index);
+}
+
+// Release the memory used by the aggregates of the favorites of a user
+static void user_freeFavsAggregates(tUser* object) {
+    if (object->favsPerSeries.elements != NULL) {
+        mem_free(object->favsPerSeries.elements);
+    }
+    hashIndex_free(&object->favsPerSeries.index);
+    user_initFavsAggregates(object);
+}
+
+// Get the count of favorites of a series, or NULL if the series has no entry yet
+static tSeriesCount* user_findSeriesCount(tUser* object, tSeries* series) {
+    unsigned int position;
+    unsigned int i;
+    tSeriesCount* entry;
+
+    if (!hashIndex_find(&object->favsPerSeries.index, series->title, hash_string(series->title), 
+            seriesCountTable_getKey, &object->favsPerSeries, &position)) {
+        return NULL;
+    }
+
+    // Series are equal if they have the same title and genre
+    entry = &(object->favsPerSeries.elements[position]);
+    if (entry->series == series || series_equals(entry->series, series)) {
+        return entry;
+    }
+
+    // Same title but other genre. Not expected in a catalog, but also supported
+    for (i = 0; i < object->favsPerSeries.size; i++) {
+        entry = &(object->favsPerSeries.elements[i]);
+        if (series_equals(entry->series, series)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+// Update the aggregates of the favorites of a user when a film is added 
+// to the favorites (delta 1) or removed from them (delta -1)
+static tError user_updateFavsAggregates(tUser* object, tFilm* film, int delta) {
+    tSeriesCountTable* table = &object->favsPerSeries;
+    tSeriesCount* entry;
+    tSeriesCount* elements;
+    unsigned int capacity;
+    unsigned int position;
+
+    entry = user_findSeriesCount(object, film->series);
+
+    // First favorite of this series, add a new entry
+    if (entry == NULL) {
+        assert(delta > 0);
+        if (table->size == table->capacity) {
+            capacity = table_growCapacity(table->capacity, table->size + 1);
+            elements = (tSeriesCount*)mem_realloc(MEM_USER, table->elements, capacity * sizeof(tSeriesCount));
+            if (elements == NULL) {
+                return ERR_MEMORY_ERROR;
+            }
+            table->elements = elements;
+            table->capacity = capacity;
+        }
+        if (hashIndex_insert(&table->index, hash_string(film->series->title), table->size) != OK) {
+            return ERR_MEMORY_ERROR;
+        }
+        entry = &(table->elements[table->size]);
+        entry->series = film->series;
+        entry->count = 0;
+        table->size++;
+    }
+
+    entry->count += delta;
+    object->favsPerGenre[film->series->genre] += delta;
+    object->favsLengthInMin += delta * (int)film->lengthInMin;
+
+    // Last favorite of this series, remove its entry. Entries borrow the 
+    // series of the film, which can be released once no favorite is left. 
+    // Entries after it move one position to the front, so they are kept in 
+    // the order their series were first added (see user_getTopSeries)
+    if (entry->count == 0) {
+        position = (unsigned int)(entry - table->elements);
+        hashIndex_removePosition(&table->index, hash_string(film->series->title), position);
+        hashIndex_shift(&table->index, position);
+        memmove(entry, entry + 1, (table->size - position - 1) * sizeof(tSeriesCount));
+        table->size--;
+    }
+
+    return OK;
+}
 
 // Initialize the user structure
 tError user_init(tUser* object, const char* username, const char* name, const char* mail) {
@@ -18,27 +150,38 @@ tError user_init(tUser* object, const char* username, const char* name, const ch
     // Allocate the memory for all the fields, using the length of the provided 
     // text plus 1 space for the "end of string" char '\0'. 
     // To allocate memory we use the malloc command.
-    object->username = (char*)malloc((strlen(username) + 1) * sizeof(char));
-    object->name = (char*)malloc((strlen(name) + 1) * sizeof(char));
-    object->mail = (char*)malloc((strlen(mail) + 1) * sizeof(char));
+    // The username is shared with other copies of the user
+    object->username = intern_acquire(username);
+    object->usernameHash = (object->username != NULL) ? intern_hash(object->username) : 0;
+    object->usernameLength = (object->username != NULL) ? intern_length(object->username) : 0;
+    object->name = (char*)mem_alloc(MEM_USER, (strlen(name) + 1) * sizeof(char));
+    object->mail = (char*)mem_alloc(MEM_USER, (strlen(mail) + 1) * sizeof(char));
+
+    // PR2 EX1 
+    favoriteStack_create(&object->favorites);
+
+    // No favorites yet
+    user_initFavsAggregates(object);
 
     // Check that memory has been allocated for all fields. 
     // Pointer must be different from NULL.
     if (object->username == NULL || object->name == NULL || object->mail == NULL) {
         // Some of the fields have a NULL value, what means that we found 
-        // some problem allocating the memory
+        // some problem allocating the memory. Release the other fields
+        intern_release(object->username);
+        mem_free(object->name);
+        mem_free(object->mail);
+        object->username = NULL;
+        object->name = NULL;
+        object->mail = NULL;
         return ERR_MEMORY_ERROR;
     }
 
     // Once the memory is allocated, copy the data. As the fields are strings, 
     // we need to use the string copy function strcpy. 
-    strcpy(object->username, username);
     strcpy(object->name, name);
     strcpy(object->mail, mail);
     
-    // PR2 EX1 
-    favoriteStack_create(&object->favorites);
-    
     return OK;
 }
 
@@ -51,22 +194,25 @@ void user_free(tUser* object) {
     // All memory allocated with malloc and realloc needs to be freed using the free command. 
     // In this case, as we use malloc to allocate the fields, we have to free them
     if (object->username != NULL) {
-        free(object->username);
+        intern_release(object->username);
         object->username = NULL;
     }
 
     if (object->name != NULL) {
-        free(object->name);
+        mem_free(object->name);
         object->name = NULL;
     }
 
     if (object->mail != NULL) {
-        free(object->mail);
+        mem_free(object->mail);
         object->mail = NULL;
     }
 
     // PR2 EX2 - Release favorites stack
     favoriteStack_free(&object->favorites);
+
+    // Release the aggregates of the favorites
+    user_freeFavsAggregates(object);
     
 }
 
@@ -81,7 +227,10 @@ bool user_equals(tUser* user1, tUser* user2) {
     // Strings are pointers to a table of chars, therefore, cannot be compared  as  
     // " user1->username == user2->username ". We need to use a string comparison function    
 
-    if (strcmp(user1->username, user2->username) != 0) {
+    // Interned usernames are equal if they are the same pointer. Different 
+    // hashes or lengths tell they are different without reading them
+    if (user1->username != user2->username && (user1->usernameHash != user2->usernameHash
+            || user1->usernameLength != user2->usernameLength || strcmp(user1->username, user2->username) != 0)) {
         // Usernames are different
         return false;
     }
@@ -108,20 +257,42 @@ bool userTable_equals(tUserTable* userTable1, tUserTable* userTable2) {
     assert(userTable2 != NULL);
 
     int i;
-    if (userTable1->size != userTable2->size) {
-        return false;
+    bool equals = true;
+    tRWLock* first;
+    tRWLock* second;
+
+    // Both tables are read, so hold both locks. They are taken in the order 
+    // of their addresses, so two threads comparing the same tables in 
+    // opposite orders do not wait for each other. Locks are reentrant, so 
+    // userTable_size and userTable_find do not wait for them again
+    first = ((uintptr_t)userTable1->lock < (uintptr_t)userTable2->lock) ? userTable1->lock : userTable2->lock;
+    second = (first == userTable1->lock) ? userTable2->lock : userTable1->lock;
+    rwlock_readLock(first);
+    rwlock_readLock(second);
+
+    // Tables with different fingerprints have different users, so the 
+    // users are only searched when the fingerprints are equal
+    if (userTable_size(userTable1) != userTable_size(userTable2) 
+            || userTable1->fingerprint != userTable2->fingerprint) {
+        equals = false;
     }
 
-    for (i = 0; i< userTable1->size; i++)
+    for (i = 0; equals && i< userTable2->size; i++)
     {
+        // Skip the tombstones of removed users
+        if (userTable2->elements[i].username == NULL) {
+            continue;
+        }
         // Uses "find" because the order of users could be different
         if (!userTable_find(userTable1, userTable2->elements[i].username)) {
             // Usernames are different
-            return false;
+            equals = false;
         }
     }
+    rwlock_readUnlock(second);
+    rwlock_readUnlock(first);
 
-    return true;
+    return equals;
 }
 
 // Copy the data of a user to another user
@@ -135,9 +306,7 @@ tError user_cpy(tUser* dst, tUser* src) {
     user_free(dst);
 
     // Initialize the element with the new data
-    user_init(dst, src->username, src->name, src->mail);
-
-    return OK;
+    return user_init(dst, src->username, src->name, src->mail);
 }
 
 // Initialize the table of users
@@ -153,248 +322,828 @@ void userTable_init(tUserTable* table) {
     // This is the main difference with respect to the user of static memory, 
     // where data was always initialized (tUser elements[MAX_ELEMENTS])
     table->elements = NULL;
+    // No memory allocated means no capacity
+    table->capacity = 0;
+
+    // The hash index starts empty too
+    hashIndex_init(&table->index);
+
+    // By default removing keeps the order of the users
+    table->removeMode = TABLE_REMOVE_SHIFT;
+    table->removed = 0;
+    table->fingerprint = 0;
+
+    // No logs or recommenders keep the positions of the users yet
+    table->references = 0;
+
+    // By default the table is not shared between threads
+    table->lock = NULL;
+    table->arena = NULL;
+    table->recommender = NULL;
 }
 
 // Remove the memory used by userTable structure
 void userTable_free(tUserTable* table) {
+    unsigned int i;
+
     // Verify pre conditions
     assert(table != NULL);
 
+    // Release the fields of the users. Tombstones of removed users 
+    // are already released, and user_free does nothing for them
+    for (i = 0; i < table->size; i++) {
+        user_free(&(table->elements[i]));
+    }
+
     // All memory allocated with malloc and realloc 
     // needs to be freed using the free command. 
     // In this case, as we use malloc/realloc to 
     // allocate the elements, and need to free them.
     if (table->elements != NULL) {
-        free(table->elements);
+        mem_free(table->elements);
         table->elements = NULL;
     }
-    // As the table is now empty, assign the size to 0.
+    // As the table is now empty, assign the size and capacity to 0.
     table->size = 0;
+    table->capacity = 0;
+    table->removed = 0;
+    table->fingerprint = 0;
+
+    // Release the hash index
+    hashIndex_free(&table->index);
 }
 
-// Add a new user to the table
-tError userTable_add(tUserTable* table, tUser* user) {
+// userTable_add without taking the lock of the table
+static tError userTable_addUnlocked(tUserTable* table, tUser* user) {
+    unsigned int hash;
+    tError err;
+
     // Verify pre conditions
     assert(table != NULL);
     assert(user != NULL);
 
-    // Check if users already is on the table
-    if (userTable_find(table, user->username))
+    // Check if users already is on the table, using the hash index
+    hash = hash_string(user->username);
+    if (hashIndex_find(&table->index, user->username, hash, userTable_getKey, table, NULL))
         return ERR_DUPLICATED;
 
-    // The first step is to allocate the required space. 
-    // There are two methods to manage the 
-    // memory (malloc and realloc). Malloc allows 
-    // to allocate a new memory block, while realloc 
-    // allows to modify an existing memory block.    
-    if (table->size == 0) {
-        // Empty table
+    // The first step is to make sure there is space for the new element. 
+    // The capacity of the table grows geometrically (see userTable_reserve), 
+    // so most of the times there is already space and no memory is allocated.
+    if (table->size == table->capacity) {
+        if (userTable_reserve(table, table_growCapacity(table->capacity, table->size + 1)) != OK) {
+            // Error allocating or reallocating the memory
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    // Increase the number of elements of the table
+    table->size = table->size + 1;
+
+    // Once we have the block of memory, which is an array of tUser elements, 
+    // we initialize the new element (which is the last one). The last element 
+    // is " table->elements[table->size - 1] " (we start counting at 0). 
+    // If there is no memory, the user is taken out of the table again
+    err = user_init(&(table->elements[table->size - 1]), user->username, user->name, user->mail);
+    if (err != OK) {
+        table->size = table->size - 1;
+        return err;
+    }
+
+    // Add the position of the new user in the hash index
+    if (hashIndex_insert(&table->index, hash, table->size - 1) != OK) {
+        user_free(&(table->elements[table->size - 1]));
+        table->size = table->size - 1;
+        return ERR_MEMORY_ERROR;
+    }
+    table->fingerprint += hash_mix64(hash);
+
+    return OK;
+}
+
+// Add a new user to the table
+tError userTable_add(tUserTable* table, tUser* user) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = userTable_addUnlocked(table, user);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+    TRACE_END(TRACE_USER_ADD, start);
+
+    return result;
+}
 
-        // Increase the number of elements of the table
-        table->size = 1;
+// Add count users to the table, as userTable_add, with one reservation for the batch
+tError userTable_addMany(tUserTable* table, tUser* users, unsigned int count, tError* results) {
+    unsigned int i;
+    tError err;
+    tError first = OK;
+    const tAllocator* scope;
 
-        // Since the table is empty, and we do not have any previous memory block, 
-        // we have to use malloc. The amount of memory we need is the number of 
-        // elements (will be 1) times the size of one element, which is computed 
-        // by sizeof(type). In this case the type is tUser.
-        table->elements = (tUser*)malloc(table->size * sizeof(tUser));
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(users != NULL || count == 0);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+
+    // Reserve memory for the whole batch, so no element is moved while adding it. 
+    // If it fails, the elements are still added one by one
+    userTable_reserve(table, table_growCapacity(table->capacity, table->size + count));
+    hashIndex_reserve(&table->index, table->index.count + count);
+
+    for (i = 0; i < count; i++) {
+        // Duplicates in the batch are found as each element enters the index
+        err = userTable_addUnlocked(table, &users[i]);
+        if (results != NULL) {
+            results[i] = err;
+        }
+        if (err != OK && first == OK) {
+            first = err;
+        }
     }
-    else {
-        // table with elements
 
-        // Increase the number of elements of the table
-        table->size = table->size + 1;
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return first;
+}
+
+// userTable_reserve without taking the lock of the table
+static tError userTable_reserveUnlocked(tUserTable* table, unsigned int n) {
+    tUser* elements;
+
+    // Verify pre conditions
+    assert(table != NULL);
 
-        // Since the table is not empty, we already have a memory block. 
-        // We need to modify the size of this block, using the realloc command. 
-        // The amount of memory we need is the number of elements times 
-        // the size of one element, which is computed by sizeof(type). 
-        // In this case the type is tUser. We provide the previous block of memory.
-        table->elements = (tUser*)realloc(table->elements, table->size * sizeof(tUser));
+    if (n <= table->capacity) {
+        // Already enough memory
+        return OK;
     }
 
-    // Check that the memory has been allocated
-    if (table->elements == NULL) {
-        // Error allocating or reallocating the memory
+    // realloc behaves as malloc when the previous block is NULL.
+    // The amount of memory we need is the new capacity times the size of 
+    // one element, which is computed by sizeof(type). In this case the type is tUser.
+    elements = (tUser*)mem_realloc(MEM_USER, table->elements, n * sizeof(tUser));
+
+    // Check that the memory has been allocated. The previous block is 
+    // still valid if realloc fails, so the table is not modified
+    if (elements == NULL) {
         return ERR_MEMORY_ERROR;
     }
 
-    // Once we have the block of memory, which is an array of tUser elements, 
-    // we initialize the new element (which is the last one). The last element 
-    // is " table->elements[table->size - 1] " (we start counting at 0)
-    user_init(&(table->elements[table->size - 1]), user->username, user->name, user->mail);
+    table->elements = elements;
+    table->capacity = n;
 
     return OK;
 }
 
-// Remove a user from the table
-tError userTable_remove(tUserTable* table, tUser* user) {
-    int i;
-    bool found;
+// Ensure there is memory for at least n users in the table
+tError userTable_reserve(tUserTable* table, unsigned int n) {
+    tError result;
+    const tAllocator* scope;
 
     // Verify pre conditions
     assert(table != NULL);
-    assert(user != NULL);
 
-    // To remove an element of a table, we will move all elements after this element 
-    // one position, to fill the space of the removed element.
-    found = false;
-    for (i = 0; i<table->size; i++) {
-        // If the element has been found. Displace this element to the previous element 
-        // (will never happend for the first one). We use the ADDRESS of the previous 
-        // element &(table->elements[i-1]) as destination, and ADDRESS of the current 
-        // element &(table->elements[i]) as source.
-        if (found) {
-            // Check the return code to detect memory allocation errors
-            if (user_cpy(&(table->elements[i - 1]), &(table->elements[i])) == ERR_MEMORY_ERROR) {
-                // Error allocating memory. Just stop the process and return memory error.
-                return ERR_MEMORY_ERROR;
-            }
-        }
-        else if (strcmp(table->elements[i].username, user->username) == 0) {
-            // The current element is the element we want to remove. 
-            // Set found flag to true to start element movement.
-            found = true;
-        }
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = userTable_reserveUnlocked(table, n);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// userTable_shrinkToFit without taking the lock of the table
+static tError userTable_shrinkToFitUnlocked(tUserTable* table) {
+    tUser* elements;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    if (table->size == table->capacity) {
+        // Nothing to release
+        return OK;
     }
 
-    // Once removed the element, we need to modify the memory used by the table.
-    if (found) {
-        // Modify the number of elements
-        table->size = table->size - 1;
+    // We cannot allocate zero bytes, so an empty table has no memory
+    if (table->size == 0) {
+        mem_free(table->elements);
+        table->elements = NULL;
+        table->capacity = 0;
+        return OK;
+    }
+
+    elements = (tUser*)mem_realloc(MEM_USER, table->elements, table->size * sizeof(tUser));
+    if (elements == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    table->elements = elements;
+    table->capacity = table->size;
+
+    return OK;
+}
+
+// Release the memory not used by the elements of the table
+tError userTable_shrinkToFit(tUserTable* table) {
+    tError result;
+    const tAllocator* scope;
 
-        // If we are removing the last element, we will assign the pointer 
-        // to NULL, since we cannot allocate zero bytes
-        if (table->size == 0) {
-            table->elements = NULL;
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = userTable_shrinkToFitUnlocked(table);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// userTable_compact without taking the lock of the table
+static tError userTable_compactUnlocked(tUserTable* table) {
+    unsigned int i, j;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // Bound logs and recommenders keep the positions of the users
+    if (table->references > 0) {
+        return ERR_INVALID;
+    }
+    if (table->removed == 0) {
+        return OK;
+    }
+
+    // Move the users to the front, keeping their order
+    for (i = 0, j = 0; i < table->size; i++) {
+        if (table->elements[i].username == NULL) {
+            continue;
         }
-        else {
-            // Modify the used memory. As we are modifying a previously 
-            // allocated block, we need to use the realloc command.
-            table->elements = (tUser*)realloc(table->elements, table->size * sizeof(tUser));
-
-            // Check that the memory has been allocated
-            if (table->elements == NULL) {
-                // Error allocating or reallocating the memory
-                return ERR_MEMORY_ERROR;
-            }
+        if (i != j) {
+            table->elements[j] = table->elements[i];
+            // Position i still holds the moved user, used to find it in the index
+            hashIndex_update(&table->index, table->elements[j].username, 
+                table->elements[j].usernameHash, userTable_getKey, table, j);
         }
+        j++;
     }
-    else {
+
+    table->size = j;
+    table->removed = 0;
+
+    return OK;
+}
+
+// userTable_remove without taking the lock of the table
+static tError userTable_removeUnlocked(tUserTable* table, tUser* user) {
+    unsigned int position = 0;
+    unsigned int hash;
+    tUser* moved;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(user != NULL);
+
+    // Get the position of the element from the hash index, and remove 
+    // it from the index before moving any element.
+    hash = hash_string(user->username);
+    if (!hashIndex_find(&table->index, user->username, hash, userTable_getKey, table, &position)) {
         // If the element was not in the table, return an error.
         return ERR_NOT_FOUND;
     }
 
+    // Bound logs and recommenders keep the positions of the users, so the 
+    // other users can not be moved
+    if (table->references > 0 && table->removeMode != TABLE_REMOVE_TOMBSTONE) {
+        return ERR_INVALID;
+    }
+    hashIndex_remove(&table->index, user->username, hash, userTable_getKey, table);
+    table->fingerprint -= hash_mix64(hash);
+
+    // Release the removed element. The other elements are moved as they are, 
+    // without copying their strings, so no memory is allocated
+    user_free(&(table->elements[position]));
+
+    switch (table->removeMode) {
+    case TABLE_REMOVE_SWAP:
+        // The last element fills the space of the removed element
+        table->size = table->size - 1;
+        if (position != table->size) {
+            moved = &(table->elements[position]);
+            *moved = table->elements[table->size];
+            // The old position still holds the moved user, used to find it in the index
+            hashIndex_update(&table->index, moved->username, moved->usernameHash, 
+                userTable_getKey, table, position);
+        }
+        break;
+
+    case TABLE_REMOVE_TOMBSTONE:
+        // The released element (with a NULL username) stays as a tombstone
+        table->removed = table->removed + 1;
+        if (table->references == 0 && table_needsCompaction(table->size, table->removed)) {
+            userTable_compactUnlocked(table);
+        }
+        break;
+
+    default:
+        // Move all elements after the removed one one position to the front. 
+        // The memory block is kept, to be reused by next additions (see userTable_shrinkToFit)
+        memmove(&(table->elements[position]), &(table->elements[position + 1]), 
+            (table->size - position - 1) * sizeof(tUser));
+        table->size = table->size - 1;
+        hashIndex_shift(&table->index, position);
+        break;
+    }
+
     return OK;
 }
 
-// Get user by username
-tUser* userTable_find(tUserTable* table, const char* username) {
-    int i;
+// Remove a user from the table
+tError userTable_remove(tUserTable* table, tUser* user) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = userTable_removeUnlocked(table, user);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+    TRACE_END(TRACE_USER_REMOVE, start);
+
+    return result;
+}
+
+// userTable_setRemoveMode without taking the lock of the table
+static void userTable_setRemoveModeUnlocked(tUserTable* table, tRemoveMode mode) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // Tables referenced by bound logs or recommenders keep their tombstones
+    if (mode != TABLE_REMOVE_TOMBSTONE) {
+        userTable_compactUnlocked(table);
+    }
+    table->removeMode = mode;
+}
+
+// Select how users are removed from the table. Leaving the 
+// TABLE_REMOVE_TOMBSTONE mode compacts the table
+void userTable_setRemoveMode(tUserTable* table, tRemoveMode mode) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    userTable_setRemoveModeUnlocked(table, mode);
+    rwlock_writeUnlock(table->lock);
+}
+
+// Remove the tombstones of removed users from the table. 
+// The positions of the users after them change
+tError userTable_compact(tUserTable* table) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = userTable_compactUnlocked(table);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// userTable_find without taking the lock of the table
+static tUser* userTable_findUnlocked(tUserTable* table, const char* username) {
+    unsigned int position;
 
     // Verify pre conditions
     assert(table != NULL);
     assert(username != NULL);
 
-    // Search over the table and return once we found the element.
-    for (i = 0; i<table->size; i++) {
-        if (strcmp(table->elements[i].username, username) == 0) {
-            // We return the ADDRESS (&) of the element, which is a pointer to the element
-            return &(table->elements[i]);
-        }
+    // Search the position of the element in the hash index.
+    if (hashIndex_find(&table->index, username, hash_string(username), userTable_getKey, table, &position)) {
+        // We return the ADDRESS (&) of the element, which is a pointer to the element
+        return &(table->elements[position]);
     }
 
     // The element has not been found. Return NULL (empty pointer).
     return NULL;
 }
 
+// Get user by username
+tUser* userTable_find(tUserTable* table, const char* username) {
+    tUser* result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_readLock(table->lock);
+    result = userTable_findUnlocked(table, username);
+    rwlock_readUnlock(table->lock);
+    TRACE_END(TRACE_USER_FIND, start);
+
+    return result;
+}
+
+// userTable_size without taking the lock of the table
+static unsigned int userTable_sizeUnlocked(tUserTable* table) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // The size of the table is the number of elements. This value is stored in the "size" field, 
+    // that also counts the tombstones of removed elements
+    return table->size - table->removed;
+}
+
 // Get the size of a the table
 unsigned int userTable_size(tUserTable* table) {
+    unsigned int result;
+
     // Verify pre conditions
     assert(table != NULL);
 
-    // The size of the table is the number of elements. This value is stored in the "size" field.
-    return table->size;
+    rwlock_readLock(table->lock);
+    result = userTable_sizeUnlocked(table);
+    rwlock_readUnlock(table->lock);
+
+    return result;
 }
 
-/* Remove the spaces at the beginning and end of the name (or name and surname).
-* Ensure that the first character of each name / surname has its first letter in uppercase,
-* and the rest of the characters in lower case.
-*/
+// Use a reader-writer lock to share the table between threads
+void userTable_setLock(tUserTable* table, struct tRWLock* lock) {
+    // Verify pre conditions
+    assert(table != NULL);
 
-tError user_trimCapitalizeName(tUser* object) {
+    table->lock = lock;
+}
+
+// Allocate the memory of the table in an arena
+void userTable_setArena(tUserTable* table, struct tArena* arena) {
     // Verify pre conditions
-    assert(object != NULL);
+    assert(table != NULL);
 
-    assert(object->name != NULL);
+    table->arena = arena;
+}
 
-    unsigned int nameStart = 0;
-    unsigned int nameEnd = UINT_MAX;
-    char *trimmedName = NULL;
-    unsigned int i = 0;
-    unsigned int j = 0;
-    bool startOfWord = true;
+// Count a bound log or a recommender that keeps the positions of the users of the table
+void userTable_addReference(tUserTable* table) {
+    // Verify pre conditions
+    assert(table != NULL);
 
-    // First trim spaces at left and right
+    rwlock_writeLock(table->lock);
+    table->references++;
+    rwlock_writeUnlock(table->lock);
+}
 
-    // find position of first non-space character
-    while (isblank(object->name[nameStart])) {
-        nameStart++;
-    }
+// Stop counting a log or a recommender counted with userTable_addReference
+void userTable_releaseReference(tUserTable* table) {
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(table->references > 0);
 
-    nameEnd = strlen(object->name) - 1; // point to last char in string
+    rwlock_writeLock(table->lock);
+    table->references--;
+    rwlock_writeUnlock(table->lock);
+}
 
+// Add or remove a favorite of the user at a position of the table in a recommender. 
+// Films that are not in the table of films of the recommender are not counted
+static tError userTable_recommendFavorite(tRecommender* recommender, unsigned int userId, const tFilm* film, 
+                                          bool add) {
+    tFilm* element;
 
-    // find position of last non-space character
-    while (isblank(object->name[nameEnd])) {
-        nameEnd--;
+    element = filmTable_find(recommender->films, film->title);
+    if (element == NULL) {
+        return OK;
     }
+    if (add) {
+        return recommender_addFavorite(recommender, userId, (unsigned int)(element - recommender->films->elements));
+    }
+    return recommender_removeFavorite(recommender, userId, (unsigned int)(element - recommender->films->elements));
+}
 
-    // malloc a new string to contain chars from 'nameStart' to 'nameEnd'
-    trimmedName = (char*)malloc(((nameEnd - nameStart + 1) + 1) * sizeof(char));
-
-    // Check that memory has been allocated for it
-    if (trimmedName == NULL) {
-        // Memory could not be allocated
-        return ERR_MEMORY_ERROR;
+// Add or remove the first n favorites of the users of the table in a recommender, 
+// from the first user to the last. Returns the number of favorites processed
+static unsigned int userTable_recommendFavorites(tUserTable* table, tRecommender* recommender, 
+                                                 unsigned int n, bool add) {
+    unsigned int i;
+    unsigned int done = 0;
+    tFavoriteStackIterator it;
+    const tFavorite* favorite;
+
+    for (i = 0; i < table->size && done < n; i++) {
+        // Skip the tombstones of removed users
+        if (table->elements[i].username == NULL) {
+            continue;
+        }
+        favoriteStackIterator_init(&it, &table->elements[i].favorites);
+        while (done < n && favoriteStackIterator_hasNext(&it)) {
+            favorite = favoriteStackIterator_next(&it);
+            if (userTable_recommendFavorite(recommender, i, &favorite->film, add) != OK) {
+                return done;
+            }
+            done++;
+        }
     }
 
-    // Move name object->name into trimmedName, 
-    // now leave out starting and ending spaces
+    return done;
+}
+
+// userTable_attachRecommender without taking the lock of the table
+static tError userTable_attachRecommenderUnlocked(tUserTable* table, tRecommender* recommender) {
+    unsigned int total = 0;
+    unsigned int i;
 
-    // 'i' is position in original string
-    // 'j' is position in output string
-    for (i = nameStart, j = 0; i <= nameEnd; i++, j++) {
-        trimmedName[j] = object->name[i];
+    // Verify pre conditions
+    assert(table != NULL);
+
+    if (recommender != NULL && recommender->users != table) {
+        return ERR_INVALID;
     }
 
-    trimmedName[j] = '\0';  // Add '\0' termination of string in last j-pos
+    // Count the favorites the users already have. If there is no memory, 
+    // the favorites counted so far are removed again
+    if (recommender != NULL) {
+        for (i = 0; i < table->size; i++) {
+            total += table->elements[i].favorites.count;
+        }
+        i = userTable_recommendFavorites(table, recommender, total, true);
+        if (i < total) {
+            userTable_recommendFavorites(table, recommender, i, false);
+            return ERR_MEMORY_ERROR;
+        }
+    }
+    table->recommender = recommender;
 
-    // free old object->name, replace by new string
-    free(object->name);
+    return OK;
+}
+
+// Count the favorites of the users of the table in a recommender bound to it. 
+// A NULL recommender stops counting them. The recommender is not owned by the table
+tError userTable_attachRecommender(tUserTable* table, struct tRecommender* recommender) {
+    tError result;
+
+    // Verify pre conditions
+    assert(table != NULL);
 
-    object->name = trimmedName;
+    rwlock_writeLock(table->lock);
+    result = userTable_attachRecommenderUnlocked(table, recommender);
+    rwlock_writeUnlock(table->lock);
 
-    // Now capitalize each word
-    startOfWord = true;
+    return result;
+}
+
+// Add a favorite to the user with a given username, holding the lock of the table for writing
+tError userTable_addFavorite(tUserTable* table, const char* username, tFilm film) {
+    tUser* user;
+    tError err = ERR_NOT_FOUND;
+    const tAllocator* scope;
 
-    for (i = 0; i < strlen(object->name); i++) {
-        if (isblank(object->name[i])) {
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(username != NULL);
 
-            startOfWord = true; // Mark beginning of word upon blank space
+    // The favorites of the user are changed in the exclusive section, 
+    // so readers holding the lock do not see a half updated user
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    user = userTable_find(table, username);
+    if (user != NULL) {
+        err = user_addFavorite(user, film);
+    }
 
+    // Count the favorite in the recommender. If there is no memory, the 
+    // favorite is removed from the user again
+    if (err == OK && table->recommender != NULL) {
+        err = userTable_recommendFavorite(table->recommender, (unsigned int)(user - table->elements), 
+                                          &user->favorites.first->e.film, true);
+        if (err != OK) {
+            user_popFavorite(user);
         }
-        else {
+    }
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return err;
+}
+
+// Check if a character separates the words of a name
+static bool user_isNameBlank(char c) {
+    return isblank((unsigned char)c) != 0;
+}
+
+// Capitalize the characters of a name between two positions, one by one.
+// startOfWord tells if the character at position start begins a word.
+// Returns the position after the last non blank character, or start if all are blank
+static unsigned int user_capitalizeScalar(char* name, unsigned int start, unsigned int end, bool startOfWord) {
+    unsigned int i;
+    unsigned int last = start;
+
+    for (i = start; i < end; i++) {
+        if (user_isNameBlank(name[i])) {
+            // Mark beginning of word upon blank space
+            startOfWord = true;
+        } else {
             // Not a blank word, ensure proper case
-            if (startOfWord) {
-                object->name[i] = toupper(object->name[i]);
-                startOfWord = false;    // next char won't be start of word
-            }
-            else {
-                object->name[i] = tolower(object->name[i]);
+            name[i] = (char)(startOfWord ? toupper((unsigned char)name[i]) : tolower((unsigned char)name[i]));
+            startOfWord = false;
+            last = i + 1;
+        }
+    }
+
+    return last;
+}
+
+#if defined(USER_NAME_SSE2)
+// Get the position of the highest bit set of a value, that must not be 0
+static unsigned int user_highestBit(unsigned int value) {
+#if defined(__GNUC__)
+    return 31 - (unsigned int)__builtin_clz(value);
+#else
+    unsigned int bit = 0;
+
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Capitalize the characters of a name between two positions, 16 at a time.
+// The character before start must be part of the name. Blocks with non ASCII
+// characters are left to the scalar version, that follows the locale. 
+// Returns the first position not processed, and the position after the last 
+// non blank character in last
+static unsigned int user_capitalizeSimd(char* name, unsigned int start, unsigned int end, unsigned int* last) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lowerA = _mm_set1_epi8('a' - 1);
+    const __m128i lowerZ = _mm_set1_epi8('z' + 1);
+    const __m128i upperA = _mm_set1_epi8('A' - 1);
+    const __m128i upperZ = _mm_set1_epi8('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    __m128i chars, previous, blank, previousBlank, wordStart, lower, upper, flip;
+    unsigned int i, nonBlank;
+
+    for (i = start; i + 16 <= end; i += 16) {
+        chars = _mm_loadu_si128((const __m128i*)(name + i));
+        if (_mm_movemask_epi8(chars) != 0) {
+            break;
+        }
+        previous = _mm_loadu_si128((const __m128i*)(name + i - 1));
+
+        // A word starts at each non blank character after a blank one
+        blank = _mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmpeq_epi8(chars, tab));
+        previousBlank = _mm_or_si128(_mm_cmpeq_epi8(previous, space), _mm_cmpeq_epi8(previous, tab));
+        wordStart = _mm_andnot_si128(blank, previousBlank);
+
+        // Lower case letters starting a word and upper case letters inside 
+        // a word change their case, flipping the bit 0x20
+        lower = _mm_and_si128(_mm_cmpgt_epi8(chars, lowerA), _mm_cmplt_epi8(chars, lowerZ));
+        upper = _mm_and_si128(_mm_cmpgt_epi8(chars, upperA), _mm_cmplt_epi8(chars, upperZ));
+        flip = _mm_or_si128(_mm_and_si128(wordStart, lower), _mm_andnot_si128(wordStart, upper));
+        _mm_storeu_si128((__m128i*)(name + i), _mm_xor_si128(chars, _mm_and_si128(flip, caseBit)));
+
+        nonBlank = (unsigned int)(~_mm_movemask_epi8(blank) & 0xFFFF);
+        if (nonBlank != 0) {
+            *last = i + user_highestBit(nonBlank) + 1;
+        }
+    }
+
+    return i;
+}
+#elif defined(USER_NAME_NEON)
+// Capitalize the characters of a name between two positions, 16 at a time.
+// The character before start must be part of the name. Blocks with non ASCII
+// characters are left to the scalar version, that follows the locale. 
+// Returns the first position not processed, and the position after the last 
+// non blank character in last
+static unsigned int user_capitalizeSimd(char* name, unsigned int start, unsigned int end, unsigned int* last) {
+    const uint8x16_t space = vdupq_n_u8(' ');
+    const uint8x16_t tab = vdupq_n_u8('\t');
+    const uint8x16_t caseBit = vdupq_n_u8(0x20);
+    uint8x16_t chars, previous, blank, previousBlank, wordStart, lower, upper, flip;
+    unsigned int i, j;
+
+    for (i = start; i + 16 <= end; i += 16) {
+        chars = vld1q_u8((const uint8_t*)(name + i));
+        if (vmaxvq_u8(chars) >= 0x80) {
+            break;
+        }
+        previous = vld1q_u8((const uint8_t*)(name + i - 1));
+
+        // A word starts at each non blank character after a blank one
+        blank = vorrq_u8(vceqq_u8(chars, space), vceqq_u8(chars, tab));
+        previousBlank = vorrq_u8(vceqq_u8(previous, space), vceqq_u8(previous, tab));
+        wordStart = vbicq_u8(previousBlank, blank);
+
+        // Lower case letters starting a word and upper case letters inside 
+        // a word change their case, flipping the bit 0x20
+        lower = vandq_u8(vcgeq_u8(chars, vdupq_n_u8('a')), vcleq_u8(chars, vdupq_n_u8('z')));
+        upper = vandq_u8(vcgeq_u8(chars, vdupq_n_u8('A')), vcleq_u8(chars, vdupq_n_u8('Z')));
+        flip = vorrq_u8(vandq_u8(wordStart, lower), vbicq_u8(upper, wordStart));
+        vst1q_u8((uint8_t*)(name + i), veorq_u8(chars, vandq_u8(flip, caseBit)));
+
+        // There is no mask of bits, so the last non blank is searched only in blocks that have one
+        if (vminvq_u8(blank) == 0) {
+            for (j = 16; j > 0 && user_isNameBlank(name[i + j - 1]); j--) {
             }
+            *last = i + j;
+        }
+    }
+
+    return i;
+}
+#endif
+
+// Remove the blanks at the beginning and end of a name, and capitalize its 
+// words, in place. The characters are read once, 16 at a time when possible
+static void user_normalizeName(char* name) {
+    unsigned int start = 0;
+    unsigned int end;
+    unsigned int last;
+    unsigned int i;
+
+    // Find position of first non-space character
+    while (user_isNameBlank(name[start])) {
+        start++;
+    }
+    end = start + (unsigned int)strlen(name + start);
+    if (start == end) {
+        // The name was empty or only had blanks
+        name[0] = '\0';
+        return;
+    }
+
+    // The first character starts a word and is not blank
+    name[start] = (char)toupper((unsigned char)name[start]);
+    last = start + 1;
+    i = start + 1;
+
+#if defined(USER_NAME_SSE2) || defined(USER_NAME_NEON)
+    // Each block reads the character before it, that is already part of the name
+    i = user_capitalizeSimd(name, i, end, &last);
+#endif
+
+    // Rest of the characters, that do not fill a block or are not ASCII
+    if (i < end) {
+        i = user_capitalizeScalar(name, i, end, user_isNameBlank(name[i - 1]));
+        if (i > last) {
+            last = i;
+        }
+    }
+
+    // Move the name to the beginning, leaving out starting and ending spaces
+    if (start > 0) {
+        memmove(name, name + start, last - start);
+    }
+    name[last - start] = '\0';
+}
+
+/* Remove the spaces at the beginning and end of the name (or name and surname).
+* Ensure that the first character of each name / surname has its first letter in uppercase,
+* and the rest of the characters in lower case.
+* The name is changed in place, so no memory is allocated
+*/
+
+tError user_trimCapitalizeName(tUser* object) {
+    // Verify pre conditions
+    assert(object != NULL);
+    assert(object->name != NULL);
+
+    user_normalizeName(object->name);
+
+    return OK;
+}
 
-        } // end of if(isblank(object->n..
+// Normalize the names of an array of users, as user_trimCapitalizeName
+tError user_trimCapitalizeNames(tUser* objects, unsigned int count) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(objects != NULL || count == 0);
+
+    for (i = 0; i < count; i++) {
+        assert(objects[i].name != NULL);
+        user_normalizeName(objects[i].name);
     }
 
     return OK;
@@ -407,27 +1156,22 @@ tGenre user_getFavoriteGenre(tUser *object) {
     // PR2 EX3
     assert(object != NULL);
     
-    int i, maxOcurrences;
-    tFavoriteStack tmpFavoriteStack;
-    int genreOcurrences[] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-    tGenre tmpGenre = GENRE_NOT_FOUND;
-    
-    favoriteStack_duplicate(&tmpFavoriteStack, object->favorites);
-    
-    while(!favoriteStack_empty(tmpFavoriteStack)){
-        tmpGenre = tmpFavoriteStack.first->e.film.series->genre;
-        genreOcurrences[tmpGenre]++;
-        favoriteStack_pop(&tmpFavoriteStack);
-    }
-    
-    for (i = 0; i<8; i++) {
-        if (genreOcurrences[i] > maxOcurrences) {
-            tmpGenre = i;
-            maxOcurrences = genreOcurrences[i];
+    int i;
+    unsigned int maxOcurrences = 0;
+    tGenre favGenre = GENRE_NOT_FOUND;
+    TRACE_BEGIN(start);
+
+    // The number of favorites per genre is kept by user_addFavorite, 
+    // in case of a tie the first genre wins
+    for (i = 0; i < GENRE_QTY; i++) {
+        if (object->favsPerGenre[i] > maxOcurrences) {
+            favGenre = (tGenre)i;
+            maxOcurrences = object->favsPerGenre[i];
         }
     }
 
-    return tmpGenre;   
+    TRACE_END(TRACE_USER_GET_FAVORITE_GENRE, start);
+    return favGenre;   
 }
 
 
@@ -437,16 +1181,77 @@ tError user_addFavorite(tUser *object, tFilm film) {
     // Verify pre conditions
     assert(object!=NULL);
     
-    tFavorite *tmp;
-    tmp = (tFavorite *)malloc(sizeof(tFavorite));
-    
-    if (tmp == NULL) {
+    tError err;
+    tFavorite favorite;
+
+    // The stack makes its own copy of the favorite
+    favorite.film = film;
+    err = favoriteStack_push(&object->favorites, favorite);
+    if (err != OK) {
+        return err;
+    }
+
+    // Keep the aggregates up to date with the copy stored in the stack
+    err = user_updateFavsAggregates(object, &object->favorites.first->e.film, 1);
+    if (err != OK) {
+        favoriteStack_pop(&object->favorites);
+        return err;
+    }
+
+    return OK;
+}
+
+// Removes the last favorite added to the stack of favorites of the user
+// If the user has no favorites, will return ERR_INVALID
+tError user_popFavorite(tUser *object) {
+    // Verify pre conditions
+    assert(object != NULL);
+
+    if (favoriteStack_empty(object->favorites)) {
+        return ERR_INVALID;
+    }
+
+    // Decrementing never needs memory
+    user_updateFavsAggregates(object, &object->favorites.first->e.film, -1);
+
+    return favoriteStack_pop(&object->favorites);
+}
+
+// Get the k series with the most favorite films of a user
+tError user_getTopSeries(tUser* object, unsigned int k, tSeries** series, unsigned int* counts, unsigned int* count) {
+    unsigned int i;
+    tSeriesCount* entry;
+    tTopK top;
+
+    // Verify pre conditions
+    assert(object != NULL);
+    assert(series != NULL || k == 0);
+    assert(count != NULL);
+
+    *count = 0;
+    if (topK_init(&top, k) != OK) {
         return ERR_MEMORY_ERROR;
-    } else {
-        tmp->film = film;
-        favoriteStack_push(&object->favorites, *tmp);
     }
 
+    // The counts are kept per series (see user_addFavorite), so the 
+    // favorites stack is not visited. Entries are in the order their 
+    // series were first added, and series with no favorites have no entry
+    for (i = 0; i < object->favsPerSeries.size; i++) {
+        entry = &(object->favsPerSeries.elements[i]);
+        topK_add(&top, entry->count, i, i);
+    }
+
+    topK_sort(&top);
+    for (i = 0; i < top.size; i++) {
+        entry = &(object->favsPerSeries.elements[top.entries[i].id]);
+        series[i] = entry->series;
+        if (counts != NULL) {
+            counts[i] = entry->count;
+        }
+    }
+    *count = top.size;
+    topK_free(&top);
+
     return OK;
 }
 
@@ -456,8 +1261,14 @@ unsigned user_getFavsCntPerSeries(tUser *user, tSeries *series) {
     // PR2 EX3
     assert(user != NULL);
     assert(series != NULL);
+
+    tSeriesCount* entry;
+    TRACE_BEGIN(start);
+
+    entry = user_findSeriesCount(user, series);
     
-    return favoriteStack_getFavsCntPerSeriesRecursive(&user->favorites, series);
+    TRACE_END(TRACE_USER_GET_FAVS_PER_SERIES, start);
+    return (entry == NULL) ? 0 : entry->count;
 }
 
 
@@ -467,5 +1278,11 @@ unsigned user_getFavsLengthInMin(tUser *user) {
     // PR2 EX3
     assert(user != NULL);
 
-    return favoriteStack_getFavsLengthInMinRecursive(&user->favorites);
+    unsigned result;
+    TRACE_BEGIN(start);
+
+    result = user->favsLengthInMin;
+    TRACE_END(TRACE_USER_GET_FAVS_LENGTH, start);
+
+    return result;
 }
@@ -1,11 +1,21 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include "error.h"
 #include "user.h"
 #include "film.h"
 #include "view.h"
+#include "table.h"
+#include "journal.h"
+#include "recommend.h"
+#include "segment.h"
+#include "sync.h"
+#include "topk.h"
+#include "mem.h"
+#include "trace.h"
+#include "arena.h"
 
 // **** Functions related to management of tView objects
 
@@ -23,132 +33,1366 @@ tError view_init(tView* object, tDateTime *timestamp, short score, tUser *user,
 
     object->timestamp = *timestamp;
     object->score = score;
+    object->minutes = 0;
+    object->userId = 0;
+    object->filmId = 0;
     
-    object->user = (tUser *)malloc(sizeof(tUser));
+    object->user = (tUser *)mem_alloc(MEM_VIEW, sizeof(tUser));
+    object->film = (tFilm *)mem_alloc(MEM_VIEW, sizeof(tFilm));
+    if (object->user == NULL || object->film == NULL) {
+        mem_free(object->user);
+        mem_free(object->film);
+        object->user = NULL;
+        object->film = NULL;
+        return ERR_MEMORY_ERROR;
+    }
+
     errUser = user_init(object->user, user->username, user->name, user->mail);
-    
-    object->film = (tFilm *)malloc(sizeof(tFilm));
     errFilm = film_init(object->film, film->title, film->lengthInMin, film->series);
     
-    if (errUser != OK)
-        return errUser;    
-    else if (errFilm != OK)
-        return errFilm;
-    else
-        return OK;
+    if (errUser != OK || errFilm != OK) {
+        // Release what could be copied
+        view_free(object);
+        return (errUser != OK) ? errUser : errFilm;
+    }
+    return OK;
+}
+
+// Initialize a tView object that references the user and the film, without 
+// copying them. As it owns no memory, it must not be released with view_free
+void view_initRef(tView* object, tDateTime *timestamp, short score, tUser *user, tFilm *film) {
+    assert(object != NULL);
+    assert(user != NULL);
+    assert(film != NULL);
+    assert(score < 10);
+    assert(timestamp->day <= 31);
+    assert(timestamp->month <= 12);
+    assert(timestamp->hour < 24);
+    assert(timestamp->minute <= 60);
+
+    object->timestamp = *timestamp;
+    object->score = score;
+    object->minutes = 0;
+    object->userId = 0;
+    object->filmId = 0;
+
+    // Just keep the pointers, no memory is allocated
+    object->user = user;
+    object->film = film;
 }
 
 // Free the resources stored by an existing tView object
 void view_free(tView* object) {
     // PR1 EX4    
+    // The copies of the user and the film own their strings too
     if (object->user != NULL) {
-        free(object->user);
+        user_free(object->user);
+        mem_free(object->user);
         object->user = NULL;
     }
     
     if (object->film != NULL) {
-        free(object->film);
+        film_free(object->film);
+        mem_free(object->film);
         object->film = NULL;
     }
 }
 
 // **** Functions related to management of tViewLog objects
 
-// Add a new visualization in the table, received as a parameter.
-tError viewLog_add(tViewLog* table, tView* view) {
-    // PR1 EX4
-    //return ERR_NOT_IMPLEMENTED;
+// Get the position of a user in the table of users of a bound log
+static bool viewLog_getUserId(tViewLog* table, tUser* user, unsigned int* id) {
+    tUser* found;
+
+    // If the user is an element of the table, its position is given by its address
+    if (user >= table->users->elements && user < table->users->elements + table->users->size) {
+        *id = (unsigned int)(user - table->users->elements);
+        return true;
+    }
+
+    // Otherwise, search it by username
+    found = userTable_find(table->users, user->username);
+    if (found == NULL) {
+        return false;
+    }
+    *id = (unsigned int)(found - table->users->elements);
+
+    return true;
+}
+
+// Get the position of a film in the table of films of a bound log
+static bool viewLog_getFilmId(tViewLog* table, tFilm* film, unsigned int* id) {
+    tFilm* found;
+
+    // If the film is an element of the table, its position is given by its address
+    if (film >= table->films->elements && film < table->films->elements + table->films->size) {
+        *id = (unsigned int)(film - table->films->elements);
+        return true;
+    }
+
+    // Otherwise, search it by title
+    found = filmTable_find(table->films, film->title);
+    if (found == NULL) {
+        return false;
+    }
+    *id = (unsigned int)(found - table->films->elements);
+
+    return true;
+}
+
+// Release the arrays of the columns of a log
+static void viewColumns_free(tViewColumns* columns) {
+    mem_free(columns->userId);
+    mem_free(columns->filmId);
+    mem_free(columns->genre);
+    mem_free(columns->score);
+    mem_free(columns->timestamp);
+    mem_free(columns->minutes);
+    memset(columns, 0, sizeof(tViewColumns));
+}
+
+// Resize all the arrays of the columns to a given capacity
+static tError viewColumns_resize(tViewColumns* columns, unsigned int capacity) {
+    void* ptr;
+
+    // Each array is updated as soon as it is reallocated, so if one of them 
+    // fails the others remain valid. The capacity is only updated at the end
+    ptr = mem_realloc(MEM_VIEW, columns->userId, capacity * sizeof(unsigned int));
+    if (ptr == NULL) return ERR_MEMORY_ERROR;
+    columns->userId = (unsigned int*)ptr;
+
+    ptr = mem_realloc(MEM_VIEW, columns->filmId, capacity * sizeof(unsigned int));
+    if (ptr == NULL) return ERR_MEMORY_ERROR;
+    columns->filmId = (unsigned int*)ptr;
+
+    ptr = mem_realloc(MEM_VIEW, columns->genre, capacity * sizeof(unsigned char));
+    if (ptr == NULL) return ERR_MEMORY_ERROR;
+    columns->genre = (unsigned char*)ptr;
+
+    ptr = mem_realloc(MEM_VIEW, columns->score, capacity * sizeof(short));
+    if (ptr == NULL) return ERR_MEMORY_ERROR;
+    columns->score = (short*)ptr;
+
+    ptr = mem_realloc(MEM_VIEW, columns->timestamp, capacity * sizeof(tPackedDateTime));
+    if (ptr == NULL) return ERR_MEMORY_ERROR;
+    columns->timestamp = (tPackedDateTime*)ptr;
+
+    ptr = mem_realloc(MEM_VIEW, columns->minutes, capacity * sizeof(unsigned short));
+    if (ptr == NULL) return ERR_MEMORY_ERROR;
+    columns->minutes = (unsigned short*)ptr;
+
+    columns->capacity = capacity;
+
+    return OK;
+}
+
+// Copy the view at a given position of a bound log to its columns
+static void viewColumns_set(tViewLog* table, unsigned int position) {
+    tViewColumns* columns = table->columns;
+    tView* view = &(table->elements[position]);
+
+    columns->userId[position] = view->userId;
+    columns->filmId[position] = view->filmId;
+    columns->genre[position] = (unsigned char)series_getGenre(film_getSeries(&(table->films->elements[view->filmId])));
+    columns->score[position] = view->score;
+    columns->timestamp[position] = dateTime_pack(&view->timestamp);
+    columns->minutes[position] = view->minutes;
+}
+
+// Remove the first n views of the columns, moving the next count views to the front
+static void viewColumns_removeFirst(tViewColumns* columns, unsigned int n, unsigned int count) {
+    memmove(columns->userId, columns->userId + n, count * sizeof(unsigned int));
+    memmove(columns->filmId, columns->filmId + n, count * sizeof(unsigned int));
+    memmove(columns->genre, columns->genre + n, count * sizeof(unsigned char));
+    memmove(columns->score, columns->score + n, count * sizeof(short));
+    memmove(columns->timestamp, columns->timestamp + n, count * sizeof(tPackedDateTime));
+    memmove(columns->minutes, columns->minutes + n, count * sizeof(unsigned short));
+}
+
+// Resize the entries of a time index to a given capacity
+static tError viewTimeIndex_resize(tViewTimeIndex* byTime, unsigned int capacity) {
+    tViewTimeEntry* entries;
+
+    entries = (tViewTimeEntry*)mem_realloc(MEM_VIEW, byTime->entries, capacity * sizeof(tViewTimeEntry));
+    if (entries == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+    byTime->entries = entries;
+    byTime->capacity = capacity;
+
+    return OK;
+}
+
+// Check if the view at a given position of the log was made by a user. 
+// On bound logs, userId is the position of the user in the table of users
+static bool viewLog_isViewOf(tViewLog* table, unsigned int position, tUser* user, unsigned int userId) {
+    if (table->users != NULL) {
+        return table->elements[position].userId == userId;
+    }
+    return user_equals(table->elements[position].user, user);
+}
+
+// viewLog_bind without taking the lock of the table
+static tError viewLog_bindUnlocked(tViewLog* table, tUserTable* users, tFilmTable* films) {
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(users != NULL);
+    assert(films != NULL);
+
+    // Views already in the log have their own copies of users and films
+    if (table->size > 0) {
+        return ERR_INVALID;
+    }
+
+    // The views keep the positions of the users and the films, so the 
+    // tables must not move them while the log is bound
+    if (table->users != NULL) {
+        userTable_releaseReference(table->users);
+        filmTable_releaseReference(table->films);
+    }
+    userTable_addReference(users);
+    filmTable_addReference(films);
+    table->users = users;
+    table->films = films;
+
+    return OK;
+}
+
+// Bind an empty log to the tables that own the users and the films. 
+tError viewLog_bind(tViewLog* table, tUserTable* users, tFilmTable* films) {
+    tError result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    result = viewLog_bindUnlocked(table, users, films);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_getUser without taking the lock of the table
+static tUser* viewLog_getUserUnlocked(tViewLog* table, unsigned int position) {
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(position < table->size);
+
+    if (table->users != NULL) {
+        return &(table->users->elements[table->elements[position].userId]);
+    }
+    return table->elements[position].user;
+}
+
+// Get the user of the view at a given position of the log
+tUser* viewLog_getUser(tViewLog* table, unsigned int position) {
+    tUser* result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_readLock(table->lock);
+    result = viewLog_getUserUnlocked(table, position);
+    rwlock_readUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_getFilm without taking the lock of the table
+static tFilm* viewLog_getFilmUnlocked(tViewLog* table, unsigned int position) {
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(position < table->size);
+
+    if (table->films != NULL) {
+        return &(table->films->elements[table->elements[position].filmId]);
+    }
+    return table->elements[position].film;
+}
+
+// Get the film of the view at a given position of the log
+tFilm* viewLog_getFilm(tViewLog* table, unsigned int position) {
+    tFilm* result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_readLock(table->lock);
+    result = viewLog_getFilmUnlocked(table, position);
+    rwlock_readUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_enableColumns without taking the lock of the table
+static tError viewLog_enableColumnsUnlocked(tViewLog* table) {
+    unsigned int i;
+    tViewColumns* columns;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // Columns store the positions of users and films
+    if (table->users == NULL) {
+        return ERR_INVALID;
+    }
+
+    if (table->columns != NULL) {
+        // Already enabled
+        return OK;
+    }
+
+    // calloc leaves all the arrays to NULL
+    columns = (tViewColumns*)mem_calloc(MEM_VIEW, 1, sizeof(tViewColumns));
+    if (columns == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // Columns have the same capacity than the log
+    if (table->capacity > 0 && viewColumns_resize(columns, table->capacity) != OK) {
+        viewColumns_free(columns);
+        mem_free(columns);
+        return ERR_MEMORY_ERROR;
+    }
+    table->columns = columns;
+
+    // Copy the views already in the log
+    for (i = 0; i < table->size; i++) {
+        viewColumns_set(table, i);
+    }
+
+    return OK;
+}
+
+// Keep a columnar copy of the views of a bound log
+tError viewLog_enableColumns(tViewLog* table) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = viewLog_enableColumnsUnlocked(table);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// Add the view at a given position of a bound log to the index of its user
+static tError viewLog_indexUser(tViewLog* table, unsigned int position) {
+    unsigned int i;
+    unsigned int count;
+    unsigned int userId = table->elements[position].userId;
+    tPostings* byUser;
+
+    // Make room for new users, with the same geometric growth used by the tables
+    if (userId >= table->byUserCount) {
+        count = table_growCapacity(table->byUserCount, userId + 1);
+        byUser = (tPostings*)mem_realloc(MEM_VIEW, table->byUser, count * sizeof(tPostings));
+        if (byUser == NULL) {
+            return ERR_MEMORY_ERROR;
+        }
+        for (i = table->byUserCount; i < count; i++) {
+            postings_init(&byUser[i]);
+        }
+        table->byUser = byUser;
+        table->byUserCount = count;
+    }
+
+    return postings_add(&(table->byUser[userId]), position);
+}
+
+// Release the index of views per user
+static void viewLog_freeUserIndex(tViewLog* table) {
+    unsigned int i;
+
+    for (i = 0; i < table->byUserCount; i++) {
+        postings_free(&(table->byUser[i]));
+    }
+    mem_free(table->byUser);
+    table->byUser = NULL;
+    table->byUserCount = 0;
+}
+
+// viewLog_enableUserIndex without taking the lock of the table
+static tError viewLog_enableUserIndexUnlocked(tViewLog* table) {
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // The index is addressed by the position of the users
+    if (table->users == NULL) {
+        return ERR_INVALID;
+    }
+
+    if (table->byUser != NULL) {
+        // Already enabled
+        return OK;
+    }
+
+    // Start with one (empty) list per user of the table
+    table->byUserCount = table->users->size > 0 ? table->users->size : 1;
+    table->byUser = (tPostings*)mem_alloc(MEM_VIEW, table->byUserCount * sizeof(tPostings));
+    if (table->byUser == NULL) {
+        table->byUserCount = 0;
+        return ERR_MEMORY_ERROR;
+    }
+    for (i = 0; i < table->byUserCount; i++) {
+        postings_init(&(table->byUser[i]));
+    }
+
+    // Index the views already in the log
+    for (i = 0; i < table->size; i++) {
+        if (viewLog_indexUser(table, i) != OK) {
+            viewLog_freeUserIndex(table);
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    return OK;
+}
+
+// Keep an index with the positions of the views of each user of a bound log
+tError viewLog_enableUserIndex(tViewLog* table) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = viewLog_enableUserIndexUnlocked(table);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_getUserViews without taking the lock of the table
+static tPostings* viewLog_getUserViewsUnlocked(tViewLog* table, tUser* user) {
+    unsigned int userId;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(user != NULL);
+    assert(table->byUser != NULL);
+
+    if (!viewLog_getUserId(table, user, &userId) || userId >= table->byUserCount 
+            || table->byUser[userId].size == 0) {
+        return NULL;
+    }
+
+    return &(table->byUser[userId]);
+}
+
+// Get the positions of the views of a user, in the order they were added
+tPostings* viewLog_getUserViews(tViewLog* table, tUser* user) {
+    tPostings* result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_readLock(table->lock);
+    result = viewLog_getUserViewsUnlocked(table, user);
+    rwlock_readUnlock(table->lock);
+
+    return result;
+}
+
+// Get the first entry of the time index with a timestamp not lower than a given one
+static unsigned int viewTimeIndex_lowerBound(const tViewTimeEntry* entries, unsigned int count, tPackedDateTime timestamp) {
+    unsigned int low = 0, high = count, middle;
+
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (entries[middle].timestamp < timestamp) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// Get the first entry of the time index with a timestamp greater than a given one
+static unsigned int viewTimeIndex_upperBound(const tViewTimeEntry* entries, unsigned int count, tPackedDateTime timestamp) {
+    unsigned int low = 0, high = count, middle;
+
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (entries[middle].timestamp <= timestamp) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// Get the packed timestamp of the view at a given position of the log
+static tPackedDateTime viewLog_getTimestamp(tViewLog* table, unsigned int position) {
+    if (table->columns != NULL) {
+        return table->columns->timestamp[position];
+    }
+    return dateTime_pack(&(table->elements[position].timestamp));
+}
+
+// Add the last view of the log to the time index. The index has the same 
+// capacity than the log, so no memory is allocated
+static void viewLog_indexTime(tViewLog* table) {
+    unsigned int count = table->size - 1;
+    unsigned int i;
+    tViewTimeEntry* entries = table->byTime->entries;
+    tViewTimeEntry entry;
+
+    entry.timestamp = viewLog_getTimestamp(table, count);
+    entry.position = count;
+
+    // Views usually arrive in order, and then the entry goes at the end. 
+    // Otherwise it goes after all the views with the same timestamp
+    i = count;
+    if (count > 0 && entries[count - 1].timestamp > entry.timestamp) {
+        i = viewTimeIndex_upperBound(entries, count, entry.timestamp);
+        memmove(&entries[i + 1], &entries[i], (count - i) * sizeof(tViewTimeEntry));
+    }
+    entries[i] = entry;
+}
+
+// Remove the last view of the log from the time index. It is the last entry with its timestamp
+static void viewLog_unindexTime(tViewLog* table) {
+    unsigned int count = table->size;
+    unsigned int i;
+    tViewTimeEntry* entries = table->byTime->entries;
+
+    i = viewTimeIndex_upperBound(entries, count, viewLog_getTimestamp(table, count - 1)) - 1;
+    assert(entries[i].position == count - 1);
+    memmove(&entries[i], &entries[i + 1], (count - i - 1) * sizeof(tViewTimeEntry));
+}
+
+// Compare two entries of the time index by timestamp and then by position
+static int viewTimeEntry_cmp(const void* a, const void* b) {
+    const tViewTimeEntry* entry1 = (const tViewTimeEntry*)a;
+    const tViewTimeEntry* entry2 = (const tViewTimeEntry*)b;
+
+    if (entry1->timestamp != entry2->timestamp) {
+        return entry1->timestamp < entry2->timestamp ? -1 : 1;
+    }
+    if (entry1->position != entry2->position) {
+        return entry1->position < entry2->position ? -1 : 1;
+    }
+    return 0;
+}
+
+// Release the time index of a log
+static void viewLog_freeTimeIndex(tViewLog* table) {
+    mem_free(table->byTime->entries);
+    mem_free(table->byTime);
+    table->byTime = NULL;
+}
+
+// viewLog_enableTimeIndex without taking the lock of the table
+static tError viewLog_enableTimeIndexUnlocked(tViewLog* table) {
+    unsigned int i;
+    tViewTimeIndex* byTime;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    if (table->byTime != NULL) {
+        // Already enabled
+        return OK;
+    }
+
+    byTime = (tViewTimeIndex*)mem_alloc(MEM_VIEW, sizeof(tViewTimeIndex));
+    if (byTime == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // The index has the same capacity than the log
+    byTime->capacity = table->capacity;
+    byTime->entries = NULL;
+    if (table->capacity > 0) {
+        byTime->entries = (tViewTimeEntry*)mem_alloc(MEM_VIEW, table->capacity * sizeof(tViewTimeEntry));
+        if (byTime->entries == NULL) {
+            mem_free(byTime);
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    // Sort the views already in the log. Using the position as second key 
+    // keeps the order in which views with the same timestamp were added
+    for (i = 0; i < table->size; i++) {
+        byTime->entries[i].timestamp = viewLog_getTimestamp(table, i);
+        byTime->entries[i].position = i;
+    }
+    if (table->size > 1) {
+        qsort(byTime->entries, table->size, sizeof(tViewTimeEntry), viewTimeEntry_cmp);
+    }
+    table->byTime = byTime;
+
+    return OK;
+}
+
+// Keep an index with the views of the log sorted by their timestamp
+tError viewLog_enableTimeIndex(tViewLog* table) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = viewLog_enableTimeIndexUnlocked(table);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_findRange without taking the lock of the table
+static tError viewLog_findRangeUnlocked(tViewLog* table, tPackedDateTime from, tPackedDateTime to, 
+                        const tViewTimeEntry** first, unsigned int* count) {
+    unsigned int start, end;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(first != NULL);
+    assert(count != NULL);
+
+    if (table->byTime == NULL) {
+        return ERR_INVALID;
+    }
+
+    // Two binary searches give the limits of the range
+    start = viewTimeIndex_lowerBound(table->byTime->entries, table->size, from);
+    end = (to > from) ? viewTimeIndex_lowerBound(table->byTime->entries, table->size, to) : start;
+    *first = (table->byTime->entries != NULL) ? &(table->byTime->entries[start]) : NULL;
+    *count = end - start;
+
+    return OK;
+}
+
+// Get the views with a timestamp in the range [from, to), sorted by timestamp
+tError viewLog_findRange(tViewLog* table, tPackedDateTime from, tPackedDateTime to, 
+                        const tViewTimeEntry** first, unsigned int* count) {
+    tError result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_readLock(table->lock);
+    result = viewLog_findRangeUnlocked(table, from, to, first, count);
+    rwlock_readUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_add without taking the lock of the table
+static tError viewLog_addUnlocked(tViewLog* table, tView* view) {
+    // PR1 EX4
+    //return ERR_NOT_IMPLEMENTED;
+    unsigned int userId = 0;
+    unsigned int filmId = 0;
+    tView* element;
+    tError err;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(view != NULL);
+
+    // On a bound log, the user and the film must be in the tables of the log
+    if (table->users != NULL) {
+        if (!viewLog_getUserId(table, view->user, &userId) 
+                || !viewLog_getFilmId(table, view->film, &filmId)) {
+            return ERR_NOT_FOUND;
+        }
+    }
+
+    // The first step is to make sure there is space for the new element. 
+    // The capacity of the table grows geometrically (see viewLog_reserve), 
+    // so most of the times there is already space and no memory is allocated.
+    if (table->size == table->capacity) {
+        if (viewLog_reserve(table, table_growCapacity(table->capacity, table->size + 1)) != OK) {
+            // Error allocating or reallocating the memory
+            return ERR_MEMORY_ERROR;
+        }
+    }
+
+    // Increase the number of elements of the table
+    table->size = table->size + 1;
+
+    // Once we have the block of memory, which is an array 
+    // of tView elements, we initialize the new element
+    element = &(table->elements[table->size - 1]);
+
+    if (table->users != NULL) {
+        // Bound log. Only store the positions of the user and the film, 
+        // so no memory is allocated
+        element->user = NULL;
+        element->film = NULL;
+        element->userId = userId;
+        element->filmId = filmId;
+        element->timestamp = view->timestamp;
+        element->score = view->score;
+    }
+    else {
+        // If the user or the film can not be copied, the view is taken out of the log again
+        err = view_init(element, &view->timestamp, view->score, view->user, view->film);
+        if (err != OK) {
+            table->size = table->size - 1;
+            return err;
+        }
+    }
+    element->minutes = view->minutes;
+
+    // Keep the columns up to date
+    if (table->columns != NULL) {
+        viewColumns_set(table, table->size - 1);
+    }
+
+    // Keep the time index up to date
+    if (table->byTime != NULL) {
+        viewLog_indexTime(table);
+    }
+
+    // Keep the index of views per user up to date. If it fails, the view 
+    // is taken out of the log again (as bound views have no memory to release)
+    if (table->byUser != NULL && viewLog_indexUser(table, table->size - 1) != OK) {
+        if (table->byTime != NULL) {
+            viewLog_unindexTime(table);
+        }
+        table->size = table->size - 1;
+        return ERR_MEMORY_ERROR;
+    }
+
+    // Count the view in the recommender. If there is no memory, nothing is 
+    // counted, and the view is taken out of the log and the indexes
+    if (table->recommender != NULL && recommender_addView(table->recommender, element->userId, element->filmId) != OK) {
+        if (table->byUser != NULL) {
+            table->byUser[element->userId].size--;
+        }
+        if (table->byTime != NULL) {
+            viewLog_unindexTime(table);
+        }
+        table->size = table->size - 1;
+        return ERR_MEMORY_ERROR;
+    }
+
+    // Write the view to the journal. If it fails, the view is taken out of 
+    // the log, the indexes (where it is the last view of its user) and the recommender
+    if (table->journal != NULL && journal_append(table->journal, element, &(table->users->elements[element->userId]), 
+                                                  &(table->films->elements[element->filmId])) != OK) {
+        if (table->recommender != NULL) {
+            recommender_removeView(table->recommender, element->userId, element->filmId);
+        }
+        if (table->byUser != NULL) {
+            table->byUser[element->userId].size--;
+        }
+        if (table->byTime != NULL) {
+            viewLog_unindexTime(table);
+        }
+        table->size = table->size - 1;
+        return ERR_INVALID;
+    }
+
+    return OK;
+}
+
+// Add a new visualization in the table, received as a parameter.
+tError viewLog_add(tViewLog* table, tView* view) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = viewLog_addUnlocked(table, view);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+    TRACE_END(TRACE_VIEW_ADD, start);
+
+    return result;
+}
+
+// Add count views to the table, as viewLog_add, with one reservation for the batch
+tError viewLog_addMany(tViewLog* table, tView* views, unsigned int count, tError* results) {
+    unsigned int i;
+    tError err;
+    tError first = OK;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(views != NULL || count == 0);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+
+    // Reserve memory for the whole batch, so no element is moved while adding it. 
+    // If it fails, the elements are still added one by one
+    viewLog_reserve(table, table_growCapacity(table->capacity, table->size + count));
+
+    for (i = 0; i < count; i++) {
+        // Duplicates in the batch are found as each element enters the index
+        err = viewLog_addUnlocked(table, &views[i]);
+        if (results != NULL) {
+            results[i] = err;
+        }
+        if (err != OK && first == OK) {
+            first = err;
+        }
+    }
+
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return first;
+}
+
+// Initializes a visualization table.
+void viewLog_init(tViewLog* table) {
+    // PR1 EX4
+    // Verify pre conditions
+    assert(table != NULL);
+
+
+    // The initialization of a table is to set it to the empty state. 
+    // That is, with 0 elements. 
+    table->size = 0;
+
+    // Using dynamic memory, the pointer to the elements must be set 
+    // to NULL (no memory allocated). This is the main difference with 
+    // respect to the user of static memory, were data was always 
+    // initialized (tView elements[MAX_ELEMENTS])
+    table->elements = NULL;
+    // No memory allocated means no capacity
+    table->capacity = 0;
+
+    // By default views store their own copies of users and films
+    table->users = NULL;
+    table->films = NULL;
+    table->columns = NULL;
+    table->byUser = NULL;
+    table->byUserCount = 0;
+    table->byTime = NULL;
+    table->journal = NULL;
+    table->recommender = NULL;
+    table->segmentCount = 0;
+    table->segments = NULL;
+    table->sealedSize = 0;
+    table->lock = NULL;
+    table->arena = NULL;
+}
+
+// Release memory stored by an existing tViewLog object
+void viewLog_free(tViewLog* table) {
+    // PR1 EX4    
+    unsigned int i;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // Views of a log that is not bound own their copies of the user and the film
+    if (table->users == NULL) {
+        for (i = 0; i < table->size; i++) {
+            view_free(&(table->elements[i]));
+        }
+    }
+
+    // All memory allocated with malloc and realloc needs to be freed 
+    // using the free command. In this case, as we use malloc/realloc 
+    // to allocate the elements, and need to free them.
+    if (table->elements != NULL) {
+        mem_free(table->elements);
+        table->elements = NULL;
+    }
+
+    // Release the columns
+    if (table->columns != NULL) {
+        viewColumns_free(table->columns);
+        mem_free(table->columns);
+        table->columns = NULL;
+    }
+
+    // Release the index of views per user
+    if (table->byUser != NULL) {
+        viewLog_freeUserIndex(table);
+    }
+
+    // Release the time index
+    if (table->byTime != NULL) {
+        viewLog_freeTimeIndex(table);
+    }
+
+    // Release the sealed views
+    for (i = 0; i < table->segmentCount; i++) {
+        viewSegment_free(&(table->segments[i]));
+    }
+    mem_free(table->segments);
+    table->segments = NULL;
+    table->segmentCount = 0;
+    table->sealedSize = 0;
+
+    // The journal and the recommender are not owned by the log
+    table->journal = NULL;
+    table->recommender = NULL;
+
+    // The tables can move their elements again
+    if (table->users != NULL) {
+        userTable_releaseReference(table->users);
+        filmTable_releaseReference(table->films);
+        table->users = NULL;
+        table->films = NULL;
+    }
+
+    // As the table is now empty, assign the size and capacity to 0.
+    table->size = 0;
+    table->capacity = 0;
+}
+
+// viewLog_attachJournal without taking the lock of the table
+static tError viewLog_attachJournalUnlocked(tViewLog* table, struct tJournal* journal) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // Records store the keys of the users and the films of the tables
+    if (table->users == NULL) {
+        return ERR_INVALID;
+    }
+    table->journal = journal;
+
+    return OK;
+}
+
+// Write each view added to a bound log to a journal, that must be open. 
+// A NULL journal stops writing them. The journal is not owned by the log. 
+tError viewLog_attachJournal(tViewLog* table, struct tJournal* journal) {
+    tError result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    result = viewLog_attachJournalUnlocked(table, journal);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_attachRecommender without taking the lock of the table
+static tError viewLog_attachRecommenderUnlocked(tViewLog* table, struct tRecommender* recommender) {
+    unsigned int i, j;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // The recommender counts the positions of the users and the films in the tables
+    if (table->users == NULL || (recommender != NULL 
+            && (recommender->users != table->users || recommender->films != table->films))) {
+        return ERR_INVALID;
+    }
+
+    // Count the views already in the log. If there is no memory, the 
+    // views counted so far are removed again
+    for (i = 0; recommender != NULL && i < table->size; i++) {
+        if (recommender_addView(recommender, table->elements[i].userId, table->elements[i].filmId) != OK) {
+            for (j = 0; j < i; j++) {
+                recommender_removeView(recommender, table->elements[j].userId, table->elements[j].filmId);
+            }
+            return ERR_MEMORY_ERROR;
+        }
+    }
+    table->recommender = recommender;
+
+    return OK;
+}
+
+// Count the views of a bound log in a recommender bound to the same tables. 
+// A NULL recommender stops counting them. The recommender is not owned by the log
+tError viewLog_attachRecommender(tViewLog* table, struct tRecommender* recommender) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = viewLog_attachRecommenderUnlocked(table, recommender);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_reserve without taking the lock of the table
+static tError viewLog_reserveUnlocked(tViewLog* table, unsigned int n) {
+    tView* elements;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    if (n <= table->capacity) {
+        // Already enough memory
+        return OK;
+    }
+
+    // realloc behaves as malloc when the previous block is NULL.
+    // The amount of memory we need is the new capacity times the size of 
+    // one element, which is computed by sizeof(type). In this case the type is tView.
+    elements = (tView*)mem_realloc(MEM_VIEW, table->elements, n * sizeof(tView));
+
+    // Check that the memory has been allocated. The previous block is 
+    // still valid if realloc fails, so the table is not modified
+    if (elements == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    table->elements = elements;
+
+    // Columns always have the same capacity than the log
+    if (table->columns != NULL && viewColumns_resize(table->columns, n) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // And so does the time index
+    if (table->byTime != NULL && viewTimeIndex_resize(table->byTime, n) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    table->capacity = n;
+
+    return OK;
+}
+
+// Use a reader-writer lock to share the log between threads
+void viewLog_setLock(tViewLog* table, struct tRWLock* lock) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    table->lock = lock;
+}
+
+// Allocate the memory of the table in an arena
+void viewLog_setArena(tViewLog* table, struct tArena* arena) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    table->arena = arena;
+}
+
+// Ensure there is memory for at least n views in the table
+tError viewLog_reserve(tViewLog* table, unsigned int n) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = viewLog_reserveUnlocked(table, n);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// viewLog_seal without taking the lock of the table
+static tError viewLog_sealUnlocked(tViewLog* table, tPackedDateTime before) {
+    unsigned int i, j, n = 0;
+    tViewSegment* segments;
+    tPostings* views;
+    tViewTimeEntry* entries;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    // Segments store the positions of the users and the films in the tables
+    if (table->users == NULL) {
+        return ERR_INVALID;
+    }
+
+    while (n < table->size && viewLog_getTimestamp(table, n) < before) {
+        n++;
+    }
+    if (n == 0) {
+        return OK;
+    }
+
+    // Nothing changes until the segment is built
+    segments = (tViewSegment*)mem_realloc(MEM_SEGMENT, table->segments, (table->segmentCount + 1) * sizeof(tViewSegment));
+    if (segments == NULL) {
+        return ERR_MEMORY_ERROR;
+    }
+    table->segments = segments;
+    if (viewSegment_build(&segments[table->segmentCount], table, n, table->sealedSize) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+    table->segmentCount++;
+    table->sealedSize += n;
+
+    // The views not sealed move to the front, and so do their positions in the 
+    // indexes. Bound views have no memory to release, and no memory is allocated
+    memmove(table->elements, table->elements + n, (table->size - n) * sizeof(tView));
+    if (table->columns != NULL) {
+        viewColumns_removeFirst(table->columns, n, table->size - n);
+    }
+    for (i = 0; table->byUser != NULL && i < table->byUserCount; i++) {
+        views = &(table->byUser[i]);
+        for (j = 0; j < views->size && views->elements[j] < n; j++);
+        memmove(views->elements, views->elements + j, (views->size - j) * sizeof(unsigned int));
+        views->size -= j;
+        for (j = 0; j < views->size; j++) {
+            views->elements[j] -= n;
+        }
+    }
+    if (table->byTime != NULL) {
+        entries = table->byTime->entries;
+        j = 0;
+        for (i = 0; i < table->size; i++) {
+            if (entries[i].position >= n) {
+                entries[j] = entries[i];
+                entries[j].position -= n;
+                j++;
+            }
+        }
+    }
+    table->size -= n;
+
+    return OK;
+}
+
+// Move the oldest views of a bound log to a new compressed segment
+tError viewLog_seal(tViewLog* table, tPackedDateTime before) {
+    tError result;
+    const tAllocator* scope;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = viewLog_sealUnlocked(table, before);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
+
+    return result;
+}
+
+// Call a function for each sealed view of a user with a timestamp in the range [from, to)
+static void viewLog_visitSealed(tViewLog* table, unsigned int userId, tPackedDateTime from, tPackedDateTime to, 
+                                tViewRecordFn fn, void* context) {
+    unsigned int i;
+
+    for (i = 0; i < table->segmentCount; i++) {
+        viewSegment_visit(&(table->segments[i]), userId, from, to, fn, context);
+    }
+}
+
+// Favorite film of a user in the sealed views
+typedef struct {
+    short score;
+    int filmId;
+} tViewSealedFav;
+
+// Keep the first sealed view with the highest score
+static void viewLog_sealedFavFilm(const tViewRecord* record, void* context) {
+    tViewSealedFav* fav = (tViewSealedFav*)context;
+
+    if (record->score > fav->score) {
+        fav->score = record->score;
+        fav->filmId = (int)record->filmId;
+    }
+}
+
+// Count the sealed views of each genre
+static void viewLog_sealedCountGenre(const tViewRecord* record, void* context) {
+    ((unsigned int*)context)[record->genre]++;
+}
+
+// viewLog_shrinkToFit without taking the lock of the table
+static tError viewLog_shrinkToFitUnlocked(tViewLog* table) {
+    tView* elements;
+
     // Verify pre conditions
     assert(table != NULL);
-    assert(view != NULL);
 
-    // The first step is to allocate the required space. There are two methods 
-    // to manage the memory (malloc and realloc). Malloc allows to allocate a new 
-    // memory block, while realloc allows to modify an existing memory block.    
+    if (table->size == table->capacity) {
+        // Nothing to release
+        return OK;
+    }
+
+    // We cannot allocate zero bytes, so an empty table has no memory
     if (table->size == 0) {
-        // Empty table
+        mem_free(table->elements);
+        table->elements = NULL;
+        table->capacity = 0;
 
-        // Increase the number of elements of the table
-        table->size = 1;
+        // Empty columns and time index have no memory either
+        if (table->columns != NULL) {
+            viewColumns_free(table->columns);
+        }
+        if (table->byTime != NULL) {
+            mem_free(table->byTime->entries);
+            table->byTime->entries = NULL;
+            table->byTime->capacity = 0;
+        }
+        return OK;
+    }
 
-        // Since the table is empty, and we do not have any previous memory 
-        // block, we have to use malloc. The amount of memory we need is the 
-        // number of elements (will be 1) times the size of one element, which 
-        // is computed by sizeof(type). In this case the type is tView.
-        table->elements = (tView*)malloc(table->size * sizeof(tView));
+    elements = (tView*)mem_realloc(MEM_VIEW, table->elements, table->size * sizeof(tView));
+    if (elements == NULL) {
+        return ERR_MEMORY_ERROR;
     }
-    else {
-        // Table with elements
 
-        // Increase the number of elements of the table
-        table->size = table->size + 1;
+    table->elements = elements;
 
-        // Since the table is not empty, we already have a memory block. 
-        // We need to modify the size of this block, using the realloc command. 
-        // The amount of memory we need is the number of elements times 
-        // the size of one element, which is computed by sizeof(type). 
-        // In this case the type is tView. We provide the previous block of memory.
-        table->elements = (tView*)realloc(table->elements, table->size * sizeof(tView));
+    if (table->columns != NULL && viewColumns_resize(table->columns, table->size) != OK) {
+        return ERR_MEMORY_ERROR;
     }
 
-    // Check that the memory has been allocated
-    if (table->elements == NULL) {
-        // Error allocating or reallocating the memory
+    if (table->byTime != NULL && viewTimeIndex_resize(table->byTime, table->size) != OK) {
         return ERR_MEMORY_ERROR;
     }
 
-    // Once we have the block of memory, which is an array 
-    // of tView elements, we initialize the new element
-
-    view_init(&(table->elements[table->size - 1]), &view->timestamp, view->score, view->user, view->film);
+    table->capacity = table->size;
 
     return OK;
 }
 
-// Initializes a visualization table.
-void viewLog_init(tViewLog* table) {
-    // PR1 EX4
+// Release the memory not used by the elements of the table
+tError viewLog_shrinkToFit(tViewLog* table) {
+    tError result;
+    const tAllocator* scope;
+
     // Verify pre conditions
     assert(table != NULL);
 
+    rwlock_writeLock(table->lock);
+    scope = arena_enter(table->arena);
+    result = viewLog_shrinkToFitUnlocked(table);
+    arena_leave(scope);
+    rwlock_writeUnlock(table->lock);
 
-    // The initialization of a table is to set it to the empty state. 
-    // That is, with 0 elements. 
-    table->size = 0;
+    return result;
+}
 
-    // Using dynamic memory, the pointer to the elements must be set 
-    // to NULL (no memory allocated). This is the main difference with 
-    // respect to the user of static memory, were data was always 
-    // initialized (tView elements[MAX_ELEMENTS])
-    table->elements = NULL;
+// Get the film with the highest score viewed by a user, scanning the columns. 
+// Only views with a score higher than the given one are the favorite
+static tFilm* viewColumns_getFavFilm(tViewLog* table, unsigned int userId, short score) {
+    unsigned int i;
+    unsigned int size = table->size;
+    const unsigned int* users = table->columns->userId;
+    const short* scores = table->columns->score;
+    int favPosition = -1;
+
+    // Keep the first view with the highest score, as the row scan does
+    for (i = 0; i < size; i++) {
+        if (users[i] == userId && scores[i] > score) {
+            score = scores[i];
+            favPosition = (int)i;
+        }
+    }
+
+    if (favPosition < 0)
+        return NULL;
+
+    return &(table->films->elements[table->columns->filmId[favPosition]]);
 }
 
-// Release memory stored by an existing tViewLog object
-void viewLog_free(tViewLog* table) {
-    // PR1 EX4    
+// Get the genre most viewed by a user, scanning the columns. 
+// The views of each genre are added to the given ones
+static tGenre viewColumns_getFavGenre(tViewLog* table, unsigned int userId, unsigned int* visualizations) {
+    unsigned int i;
+    unsigned int size = table->size;
+    const unsigned int* users = table->columns->userId;
+    const unsigned char* genres = table->columns->genre;
+    unsigned int maxVisualization = 0;
+    tGenre genre = GENRE_NOT_FOUND;
 
-    // Verify pre conditions
-    assert(table != NULL);
+    // Branchless count, so the compiler can vectorize the loop
+    for (i = 0; i < size; i++) {
+        visualizations[genres[i]] += (users[i] == userId);
+    }
 
-    // All memory allocated with malloc and realloc needs to be freed 
-    // using the free command. In this case, as we use malloc/realloc 
-    // to allocate the elements, and need to free them.
-    if (table->elements != NULL) {
-        free(table->elements);
-        table->elements = NULL;
+    for (i = 0; i < GENRE_QTY; i++) {
+        if (visualizations[i] > maxVisualization) {
+            genre = (tGenre)i;
+            maxVisualization = visualizations[i];
+        }
     }
 
+    return genre;
+}
 
-    // As the table is now empty, assign the size to 0.
-    table->size = 0;
+// Get the film with the highest score viewed by a user, using the index of views per user. 
+// Only views with a score higher than the given one are the favorite
+static tFilm* viewLog_getFavFilmIndexed(tViewLog* table, unsigned int userId, short score) {
+    unsigned int i;
+    unsigned int position;
+    tPostings* views;
+    tFilm* favFilm = NULL;
+
+    if (userId >= table->byUserCount)
+        return NULL;
+
+    // Positions are in the order of the log, so ties keep the first view
+    views = &(table->byUser[userId]);
+    for (i = 0; i < views->size; i++) {
+        position = views->elements[i];
+        if (table->elements[position].score > score) {
+            score = table->elements[position].score;
+            favFilm = viewLog_getFilm(table, position);
+        }
+    }
+
+    return favFilm;
 }
 
-// Given a username and a table of type tViewLog, it performs a search 
-// of the episode with the highest score (not negative) displayed by the 
-// user, offering us a pointer to it. In case of a tie, offer among the 
-// winning genres the episode that is first on the list. 
-// If the user can't be found in the list, return NULL.
-tFilm *viewLog_getFavFilm(tViewLog* table, tUser* user) {
+// Get the genre most viewed by a user, using the index of views per user. 
+// The views of each genre are added to the given ones
+static tGenre viewLog_getFavGenreIndexed(tViewLog* table, unsigned int userId, unsigned int* visualizations) {
+    unsigned int i;
+    tPostings* views;
+    unsigned int maxVisualization = 0;
+    tGenre genre = GENRE_NOT_FOUND;
+
+    views = (userId < table->byUserCount) ? &(table->byUser[userId]) : NULL;
+    for (i = 0; views != NULL && i < views->size; i++) {
+        if (table->columns != NULL) {
+            visualizations[table->columns->genre[views->elements[i]]]++;
+        }
+        else {
+            visualizations[series_getGenre(film_getSeries(viewLog_getFilm(table, views->elements[i])))]++;
+        }
+    }
+
+    for (i = 0; i < GENRE_QTY; i++) {
+        if (visualizations[i] > maxVisualization) {
+            genre = (tGenre)i;
+            maxVisualization = visualizations[i];
+        }
+    }
+
+    return genre;
+}
+
+// viewLog_getFavFilm without taking the lock of the table
+static tFilm *viewLog_getFavFilmUnlocked(tViewLog* table, tUser* user) {
     // PR1 EX4
 
     // Verify pre conditions
@@ -157,47 +1401,105 @@ tFilm *viewLog_getFavFilm(tViewLog* table, tUser* user) {
 
 
     int i;
+    unsigned int userId = 0;
     tFilm *favFilm = NULL;
     short score = 0;
+    tViewSealedFav sealed;
+
+    if (table->size == 0 && table->sealedSize == 0)
+        return NULL;
 
-    if (table->size == 0)
+    // On bound logs, compare the position of the users instead of their data
+    if (table->users != NULL && !viewLog_getUserId(table, user, &userId))
         return NULL;
 
-    for (i = 0; i<table->size; i++){
+    // Sealed views are the first ones, so the other views must have a higher score
+    sealed.score = 0;
+    sealed.filmId = -1;
+    viewLog_visitSealed(table, userId, 0, 0xFFFFFFFFu, viewLog_sealedFavFilm, &sealed);
+    score = sealed.score;
+
+    if (table->byUser != NULL) {
+        // With the index of views per user, only visit the views of the user
+        favFilm = viewLog_getFavFilmIndexed(table, userId, score);
+    }
+    else if (table->columns != NULL) {
+        // With columns, scan only the user and score of each view
+        favFilm = viewColumns_getFavFilm(table, userId, score);
+    }
+    else {
+        for (i = 0; i<table->size; i++){
 
-        if (user_equals(table->elements[i].user, user)) {
+            if (viewLog_isViewOf(table, i, user, userId)) {
 
-            if (score < table->elements[i].score) {
-                favFilm = table->elements[i].film;
-                score = table->elements[i].score;
+                if (score < table->elements[i].score) {
+                    favFilm = viewLog_getFilm(table, i);
+                    score = table->elements[i].score;
+                }
             }
         }
     }
 
+    if (favFilm == NULL && sealed.filmId >= 0)
+        favFilm = &(table->films->elements[sealed.filmId]);
+
     return favFilm;
 }
 
+// Given a username and a table of type tViewLog, it performs a search 
+// of the episode with the highest score (not negative) displayed by the 
+// user, offering us a pointer to it. In case of a tie, offer among the 
+// winning genres the episode that is first on the list. 
+// If the user can't be found in the list, return NULL.
+tFilm *viewLog_getFavFilm(tViewLog* table, tUser* user) {
+    tFilm* result;
 
-// Given a username and a table of type tViewLog, it returns the 
-// genre for which a user has made more visualizations. In case of a tie, 
-// offer the first one on the list. In case the user does not have 
-// visualizations, return ERR_NOT_FOUND.
-tGenre viewLog_getFavGenre(tViewLog* table, tUser* user) {
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_readLock(table->lock);
+    result = viewLog_getFavFilmUnlocked(table, user);
+    rwlock_readUnlock(table->lock);
+    TRACE_END(TRACE_VIEW_GET_FAV_FILM, start);
+
+    return result;
+}
+
+
+// viewLog_getFavGenre without taking the lock of the table
+static tGenre viewLog_getFavGenreUnlocked(tViewLog* table, tUser* user) {
     // PR1 EX4
 
     // Verify pre conditions
     assert(table != NULL);
     assert(user != NULL);
     int i;
-    int visualizations[] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-    int maxVisualization = 0;
+    unsigned int userId = 0;
+    unsigned int visualizations[] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    unsigned int maxVisualization = 0;
     tFilm *film;
     tSeries *series;
     tGenre genre = 0;
 
+    // On bound logs, compare the position of the users instead of their data
+    if (table->users != NULL && !viewLog_getUserId(table, user, &userId))
+        return GENRE_NOT_FOUND;
+
+    // The sealed views are counted with the others
+    viewLog_visitSealed(table, userId, 0, 0xFFFFFFFFu, viewLog_sealedCountGenre, visualizations);
+
+    // With the index of views per user, only visit the views of the user
+    if (table->byUser != NULL)
+        return viewLog_getFavGenreIndexed(table, userId, visualizations);
+
+    // With columns, scan only the user and genre of each view
+    if (table->columns != NULL)
+        return viewColumns_getFavGenre(table, userId, visualizations);
+
     for (i = 0; i<table->size; i++) {
-        if (user_equals(table->elements[i].user, user)) {
-            film = table->elements[i].film;
+        if (viewLog_isViewOf(table, i, user, userId)) {
+            film = viewLog_getFilm(table, i);
             series = film_getSeries(film);
             genre = series_getGenre(series);
             visualizations[genre]++;
@@ -215,24 +1517,359 @@ tGenre viewLog_getFavGenre(tViewLog* table, tUser* user) {
 
 }
 
-// helper func to get tDateTime for a given timestamp in year, month...
-tDateTime* setDateTime(unsigned char day, unsigned char month, unsigned short year,
-    unsigned char hour, unsigned char minute) {
+// Given a username and a table of type tViewLog, it returns the 
+// genre for which a user has made more visualizations. In case of a tie, 
+// offer the first one on the list. In case the user does not have 
+// visualizations, return ERR_NOT_FOUND.
+tGenre viewLog_getFavGenre(tViewLog* table, tUser* user) {
+    tGenre result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_readLock(table->lock);
+    result = viewLog_getFavGenreUnlocked(table, user);
+    rwlock_readUnlock(table->lock);
+    TRACE_END(TRACE_VIEW_GET_FAV_GENRE, start);
+
+    return result;
+}
+
+// Function called for each view of a user in a range of time
+typedef void (*tViewRangeFn)(tViewLog* table, unsigned int position, void* context);
+
+// Call a function for each view of a user with a timestamp in the range [from, to), 
+// using the smallest set of views given by the available indexes. 
+// On bound logs, userId is the position of the user in the table of users
+static void viewLog_visitRange(tViewLog* table, tUser* user, unsigned int userId, 
+                        tPackedDateTime from, tPackedDateTime to, tViewRangeFn fn, void* context) {
+    unsigned int i;
+    unsigned int count = 0;
+    const tViewTimeEntry* entries = NULL;
+    tPostings* views = NULL;
+    tPackedDateTime timestamp;
+
+    if (table->byTime != NULL) {
+        viewLog_findRange(table, from, to, &entries, &count);
+    }
+    if (table->byUser != NULL) {
+        views = (userId < table->byUserCount) ? &(table->byUser[userId]) : NULL;
+        if (views == NULL || views->size == 0) {
+            return;
+        }
+    }
+
+    // Visit the views in the range of time, unless the user has fewer views
+    if (entries != NULL && (views == NULL || count <= views->size)) {
+        for (i = 0; i < count; i++) {
+            if (viewLog_isViewOf(table, entries[i].position, user, userId)) {
+                fn(table, entries[i].position, context);
+            }
+        }
+        return;
+    }
+
+    // An empty range
+    if (table->byTime != NULL && count == 0) {
+        return;
+    }
+
+    // Visit the views of the user
+    if (views != NULL) {
+        for (i = 0; i < views->size; i++) {
+            timestamp = viewLog_getTimestamp(table, views->elements[i]);
+            if (timestamp >= from && timestamp < to) {
+                fn(table, views->elements[i], context);
+            }
+        }
+        return;
+    }
+
+    // Visit all the views
+    for (i = 0; i < table->size; i++) {
+        if (viewLog_isViewOf(table, i, user, userId)) {
+            timestamp = viewLog_getTimestamp(table, i);
+            if (timestamp >= from && timestamp < to) {
+                fn(table, i, context);
+            }
+        }
+    }
+}
+
+// Favorite film of a user in a range of time
+typedef struct {
+    short score;
+    int position;
+} tViewFavFilm;
+
+// Keep the view with the highest score. Views of the time index are not in 
+// the order of the log, so ties keep the view with the lowest position
+static void viewLog_rangeFavFilm(tViewLog* table, unsigned int position, void* context) {
+    tViewFavFilm* fav = (tViewFavFilm*)context;
+    short score = table->elements[position].score;
+
+    if (score > fav->score || (score == fav->score && fav->position >= 0 && (int)position < fav->position)) {
+        fav->score = score;
+        fav->position = (int)position;
+    }
+}
+
+// Count the views of each genre
+static void viewLog_rangeCountGenre(tViewLog* table, unsigned int position, void* context) {
+    unsigned int* visualizations = (unsigned int*)context;
+
+    if (table->columns != NULL) {
+        visualizations[table->columns->genre[position]]++;
+    }
+    else {
+        visualizations[series_getGenre(film_getSeries(viewLog_getFilm(table, position)))]++;
+    }
+}
+
+// viewLog_getFavFilmInRange without taking the lock of the table
+static tFilm* viewLog_getFavFilmInRangeUnlocked(tViewLog* table, tUser* user, tPackedDateTime from, tPackedDateTime to) {
+    unsigned int userId = 0;
+    tViewFavFilm fav;
+    tViewSealedFav sealed;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(user != NULL);
+
+    if ((table->size == 0 && table->sealedSize == 0) || from >= to)
+        return NULL;
+
+    // On bound logs, compare the position of the users instead of their data
+    if (table->users != NULL && !viewLog_getUserId(table, user, &userId))
+        return NULL;
+
+    // Only views with a positive score can be the favorite, and 
+    // the views not sealed must have a higher score than the sealed ones
+    sealed.score = 0;
+    sealed.filmId = -1;
+    viewLog_visitSealed(table, userId, from, to, viewLog_sealedFavFilm, &sealed);
+    fav.score = sealed.score;
+    fav.position = -1;
+    viewLog_visitRange(table, user, userId, from, to, viewLog_rangeFavFilm, &fav);
+
+    if (fav.position < 0)
+        return (sealed.filmId >= 0) ? &(table->films->elements[sealed.filmId]) : NULL;
+
+    return viewLog_getFilm(table, (unsigned int)fav.position);
+}
+
+// Same as viewLog_getFavFilm, but only for the views with a timestamp 
+// in the range [from, to)
+tFilm* viewLog_getFavFilmInRange(tViewLog* table, tUser* user, tPackedDateTime from, tPackedDateTime to) {
+    tFilm* result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_readLock(table->lock);
+    result = viewLog_getFavFilmInRangeUnlocked(table, user, from, to);
+    rwlock_readUnlock(table->lock);
+    TRACE_END(TRACE_VIEW_GET_FAV_FILM_IN_RANGE, start);
+
+    return result;
+}
+
+// viewLog_getFavGenreInRange without taking the lock of the table
+static tGenre viewLog_getFavGenreInRangeUnlocked(tViewLog* table, tUser* user, tPackedDateTime from, tPackedDateTime to) {
+    unsigned int i;
+    unsigned int userId = 0;
+    unsigned int visualizations[GENRE_QTY] = { 0 };
+    unsigned int maxVisualization = 0;
+    tGenre genre = GENRE_NOT_FOUND;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(user != NULL);
+
+    if ((table->size == 0 && table->sealedSize == 0) || from >= to)
+        return GENRE_NOT_FOUND;
+
+    // On bound logs, compare the position of the users instead of their data
+    if (table->users != NULL && !viewLog_getUserId(table, user, &userId))
+        return GENRE_NOT_FOUND;
+
+    viewLog_visitSealed(table, userId, from, to, viewLog_sealedCountGenre, visualizations);
+    viewLog_visitRange(table, user, userId, from, to, viewLog_rangeCountGenre, visualizations);
+
+    // In case of a tie, keep the first genre
+    for (i = 0; i < GENRE_QTY; i++) {
+        if (visualizations[i] > maxVisualization) {
+            genre = (tGenre)i;
+            maxVisualization = visualizations[i];
+        }
+    }
+
+    return genre;
+}
+
+// Same as viewLog_getFavGenre, but only for the views with a timestamp 
+// in the range [from, to)
+tGenre viewLog_getFavGenreInRange(tViewLog* table, tUser* user, tPackedDateTime from, tPackedDateTime to) {
+    tGenre result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    TRACE_BEGIN(start);
+    rwlock_readLock(table->lock);
+    result = viewLog_getFavGenreInRangeUnlocked(table, user, from, to);
+    rwlock_readUnlock(table->lock);
+    TRACE_END(TRACE_VIEW_GET_FAV_GENRE_IN_RANGE, start);
+
+    return result;
+}
+
+// Select the best view of each film. The views not sealed go after the sealed ones
+static void viewLog_rangeTopFilms(tViewLog* table, unsigned int position, void* context) {
+    tView* view = &(table->elements[position]);
+
+    if (view->score > 0) {
+        topK_update((tTopK*)context, view->score, table->sealedSize + position, view->filmId);
+    }
+}
+
+// Select the best sealed view of each film
+static void viewLog_sealedTopFilms(const tViewRecord* record, void* context) {
+    if (record->score > 0) {
+        topK_update((tTopK*)context, record->score, record->position, record->filmId);
+    }
+}
+
+// viewLog_getTopFilms without taking the lock of the table
+static tError viewLog_getTopFilmsUnlocked(tViewLog* table, tUser* user, unsigned int k, tFilm** films, unsigned int* count) {
+    unsigned int i;
+    unsigned int userId;
+    tTopK top;
+
+    // Verify pre conditions
+    assert(table != NULL);
+    assert(user != NULL);
+    assert(films != NULL || k == 0);
+    assert(count != NULL);
+
+    *count = 0;
+    if (table->users == NULL) {
+        return ERR_INVALID;
+    }
+    if (!viewLog_getUserId(table, user, &userId) || k == 0) {
+        return OK;
+    }
+
+    if (topK_init(&top, k) != OK) {
+        return ERR_MEMORY_ERROR;
+    }
+
+    // The views are ranked by score and then by position, with one entry per film
+    viewLog_visitSealed(table, userId, 0, 0xFFFFFFFFu, viewLog_sealedTopFilms, &top);
+    viewLog_visitRange(table, user, userId, 0, 0xFFFFFFFFu, viewLog_rangeTopFilms, &top);
+    topK_sort(&top);
+    for (i = 0; i < top.size; i++) {
+        films[i] = &(table->films->elements[top.entries[i].id]);
+    }
+    *count = top.size;
+    topK_free(&top);
+
+    return OK;
+}
+
+// Get the k films with the highest (positive) score viewed by a user of a bound log
+tError viewLog_getTopFilms(tViewLog* table, tUser* user, unsigned int k, tFilm** films, unsigned int* count) {
+    tError result;
+
+    // Verify pre conditions
+    assert(table != NULL);
+
+    rwlock_readLock(table->lock);
+    result = viewLog_getTopFilmsUnlocked(table, user, k, films, count);
+    rwlock_readUnlock(table->lock);
+
+    return result;
+}
+
+// Pack a tDateTime into minutes since 1970-01-01 00:00
+tPackedDateTime dateTime_pack(tDateTime* timestamp) {
+    int year, era, days;
+    unsigned int month, yearOfEra, dayOfYear, dayOfEra;
+
+    // Verify pre conditions
+    assert(timestamp != NULL);
+    assert(timestamp->year >= 1970);
+
+    // Count the days since the epoch with a proleptic Gregorian calendar, 
+    // using years that start in March so leap days are at the end of the year
+    month = timestamp->month;
+    year = timestamp->year - (month <= 2 ? 1 : 0);
+    era = year / 400;
+    yearOfEra = (unsigned int)(year - era * 400);
+    dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + timestamp->day - 1;
+    dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    days = era * 146097 + (int)dayOfEra - 719468;
+
+    return ((tPackedDateTime)days * 24 + timestamp->hour) * 60 + timestamp->minute;
+}
+
+// Get the tDateTime of a packed timestamp
+tDateTime dateTime_unpack(tPackedDateTime packed) {
+    tDateTime timestamp;
+    unsigned int days, era, dayOfEra, yearOfEra, dayOfYear, monthIndex, year;
+
+    timestamp.minute = packed % 60;
+    timestamp.hour = (packed / 60) % 24;
+
+    // Inverse of the computation done in dateTime_pack
+    days = packed / (24 * 60) + 719468;
+    era = days / 146097;
+    dayOfEra = days - era * 146097;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    year = yearOfEra + era * 400;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    monthIndex = (5 * dayOfYear + 2) / 153;
+    timestamp.day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    timestamp.month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    timestamp.year = year + (timestamp.month <= 2 ? 1 : 0);
+
+    return timestamp;
+}
+
+// Get the tDateTime for a given day, month, year, hour and minute
+tDateTime dateTime_make(unsigned char day, unsigned char month, unsigned short year, 
+                        unsigned char hour, unsigned char minute) {
+    tDateTime timestamp;
 
     assert(month <= 12);
     assert(day <= 31);      // just to keep it simple
     assert(hour < 24);
     assert(minute < 60);
 
+    timestamp.year = year;
+    timestamp.month = month;
+    timestamp.day = day;
+
+    timestamp.hour = hour;
+    timestamp.minute = minute;
+
+    return timestamp;
+}
+
+// helper func to get tDateTime for a given timestamp in year, month...
+// The result is allocated with malloc. Prefer dateTime_make, that does not allocate memory
+tDateTime* setDateTime(unsigned char day, unsigned char month, unsigned short year,
+    unsigned char hour, unsigned char minute) {
+
     tDateTime *timestamp;
     timestamp = (tDateTime*)malloc(sizeof(tDateTime));
+    if (timestamp == NULL) {
+        return NULL;
+    }
 
-    timestamp->year = year;
-    timestamp->month = month;
-    timestamp->day = day;
-
-    timestamp->hour = hour;
-    timestamp->minute = minute;
+    *timestamp = dateTime_make(day, month, year, hour, minute);
 
     return timestamp;
-}
\ No newline at end of file
+}
@@ -62,7 +62,7 @@ AS       := E:/MinGW/bin/as.exe
 ## User defined environment variables
 ##
 CodeLiteDir:=E:\Program Files\CodeLite
-Objects0=$(IntermediateDirectory)/test_src_test_pr1.c$(ObjectSuffix) $(IntermediateDirectory)/src_main.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_suit.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_utils.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr2.c$(ObjectSuffix) 
+Objects0=$(IntermediateDirectory)/test_src_test_pr1.c$(ObjectSuffix) $(IntermediateDirectory)/src_main.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_suit.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_utils.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr2.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_perf.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_bench.c$(ObjectSuffix) 
 
 
 
@@ -134,6 +134,22 @@ $(IntermediateDirectory)/test_src_test_pr2.c$(PreprocessSuffix): test/src/test_p
 	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/test_src_test_pr2.c$(PreprocessSuffix) test/src/test_pr2.c
 
 
+$(IntermediateDirectory)/test_src_test_perf.c$(ObjectSuffix): test/src/test_perf.c $(IntermediateDirectory)/test_src_test_perf.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlixMain/test/src/test_perf.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/test_src_test_perf.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/test_src_test_perf.c$(DependSuffix): test/src/test_perf.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/test_src_test_perf.c$(ObjectSuffix) -MF$(IntermediateDirectory)/test_src_test_perf.c$(DependSuffix) -MM test/src/test_perf.c
+
+$(IntermediateDirectory)/test_src_test_perf.c$(PreprocessSuffix): test/src/test_perf.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/test_src_test_perf.c$(PreprocessSuffix) test/src/test_perf.c
+
+$(IntermediateDirectory)/test_src_bench.c$(ObjectSuffix): test/src/bench.c $(IntermediateDirectory)/test_src_bench.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "E:/c-projects/pr2/UOCFlixMain/test/src/bench.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/test_src_bench.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/test_src_bench.c$(DependSuffix): test/src/bench.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/test_src_bench.c$(ObjectSuffix) -MF$(IntermediateDirectory)/test_src_bench.c$(DependSuffix) -MM test/src/bench.c
+
+$(IntermediateDirectory)/test_src_bench.c$(PreprocessSuffix): test/src/bench.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/test_src_bench.c$(PreprocessSuffix) test/src/bench.c
+
 -include $(IntermediateDirectory)/*$(DependSuffix)
 ##
 ## Clean
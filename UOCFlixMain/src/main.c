@@ -3,6 +3,9 @@
 #include <string.h>
 #include <assert.h>
 #include "test_suit.h"
+#include "bench.h"
+#include "mem.h"
+#include "trace.h"
 
 void waitKey() {
     printf("Press enter to end...");
@@ -13,12 +16,15 @@ void help(const char* name) {
     printf("%s\t =>\t Run all tests and show results on screen\n", name);
     printf("%s -h\t =>\t Show this help\n", name);
     printf("%s -e [<file_path>]\t =>\t Run all tests and save results on file (default test_result.json)\n", name);
+    printf("%s -b [<file_path> [<max_elements>]]\t =>\t Run the benchmarks, show results on screen and save them on file (default bench_result.json, %d elements)\n", name, BENCH_DEFAULT_ELEMENTS);
 }
 
 int main(int argc, char **argv)
 {
     char output_filename[512];
     tTestSuite test_suite;
+    tBenchSuite bench_suite;
+    unsigned int max_elements;
     FILE* fout = NULL;
     
     if(argc == 1) {
@@ -45,6 +51,29 @@ int main(int argc, char **argv)
             assert(fout != NULL);
             testSuite_export(&test_suite, fout);
             fclose(fout);
+        } else if(strcmp(argv[1], "-b") == 0) {
+            // Run benchmarks and export the results in JSON format
+            if(argc > 2) {
+                // Output file is provided
+                strncpy(output_filename, argv[2], 512);
+            } else {
+                // Use default filename
+                strncpy(output_filename, "bench_result.json", 512);
+            }
+            max_elements = BENCH_DEFAULT_ELEMENTS;
+            if(argc > 3) {
+                // Size of the biggest dataset is provided
+                max_elements = (unsigned int)strtoul(argv[3], NULL, 10);
+            }
+            run_bench(&bench_suite, max_elements);
+            benchSuite_print(&bench_suite);
+            mem_dump(stdout);
+            trace_dump(stdout);
+            fout = fopen(output_filename, "w");
+            assert(fout != NULL);
+            benchSuite_export(&bench_suite, fout);
+            fclose(fout);
+            benchSuite_free(&bench_suite);
         } else {
             // Invalid parameters
             printf("Invalid parameters\n");
@@ -0,0 +1,57 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+#include <stdio.h>
+
+// Number of elements of the smallest dataset of the benchmarks
+#define BENCH_MIN_ELEMENTS 1000
+
+// Maximum number of elements of the biggest dataset of the benchmarks
+#define BENCH_MAX_ELEMENTS 10000000
+
+// Default number of elements of the biggest dataset of the benchmarks
+#define BENCH_DEFAULT_ELEMENTS 100000
+
+// Result of the benchmark of an operation for a dataset size
+typedef struct {
+    // Code of the benchmarked operation
+    char* code;
+    // Number of elements of the dataset
+    unsigned int elements;
+    // Number of timed operations
+    unsigned int ops;
+    // Average time of an operation, in nanoseconds
+    double nsPerOp;
+    // Average number of memory allocations of an operation, or a negative value if not available
+    double allocsPerOp;
+    // Peak resident memory of the process after the benchmark, in KB
+    long peakRss;
+} tBenchResult;
+
+// Results of a run of the benchmarks
+typedef struct {
+    // Number of results
+    int numResults;
+    // Array of results
+    tBenchResult* results;
+} tBenchSuite;
+
+// Initialize a benchmark suite
+void benchSuite_init(tBenchSuite* object);
+
+// Remove a benchmark suite
+void benchSuite_free(tBenchSuite* object);
+
+// Add a result to a benchmark suite
+void benchSuite_addResult(tBenchSuite* object, const char* code, unsigned int elements, unsigned int ops,
+                        double nsPerOp, double allocsPerOp, long peakRss);
+
+// Print benchmark suite
+void benchSuite_print(tBenchSuite* object);
+
+// Export a benchmark suite
+void benchSuite_export(tBenchSuite* object, FILE* fout);
+
+// Run all benchmarks, with datasets from BENCH_MIN_ELEMENTS to maxElements elements
+void run_bench(tBenchSuite* bench_suite, unsigned int maxElements);
+
+#endif // __BENCH_H__
@@ -0,0 +1,97 @@
+#ifndef __TEST_PERF_H__
+#define __TEST_PERF_H__
+
+#include <stdbool.h>
+#include "utils.h"
+
+// Run all tests for the performance extensions of the library
+bool run_perf(tTestSuite* test_suite);
+
+// Run tests for the hash index of the table of users
+bool run_perf_userIndex(tTestSection* test_section);
+
+// Run tests for the capacity management of the tables
+bool run_perf_capacity(tTestSection* test_section);
+
+// Run tests for view logs bound to the tables of users and films
+bool run_perf_boundViewLog(tTestSection* test_section);
+
+// Run tests for the columnar copy of the view log
+bool run_perf_viewColumns(tTestSection* test_section);
+
+// Run tests for the index of views per user
+bool run_perf_userViewIndex(tTestSection* test_section);
+
+// Run tests for the aggregates of the favorites of a user
+bool run_perf_favoriteAggregates(tTestSection* test_section);
+
+// Run tests for the iteration over stacks of favorites
+bool run_perf_favoriteIterator(tTestSection* test_section);
+
+// Run tests for the pool of nodes of the stacks of favorites
+bool run_perf_favoritePool(tTestSection* test_section);
+
+// Run tests for the pool of interned strings
+bool run_perf_intern(tTestSection* test_section);
+
+// Run tests for the modes to remove elements from the tables
+bool run_perf_removeModes(tTestSection* test_section);
+
+// Run tests for the bulk loader of delimited files
+bool run_perf_loader(tTestSection* test_section);
+
+// Run tests for the binary snapshots of the dataset
+bool run_perf_snapshot(tTestSection* test_section);
+
+// Run tests for the journal of views
+bool run_perf_journal(tTestSection* test_section);
+
+// Run tests for the time index of the views
+bool run_perf_timeIndex(tTestSection* test_section);
+
+// Run tests for the tables shared between threads
+bool run_perf_concurrent(tTestSection* test_section);
+
+// Run tests for the sharded log of views
+bool run_perf_sharded(tTestSection* test_section);
+
+// Run tests for the parallel reports of a log
+bool run_perf_report(tTestSection* test_section);
+
+// Run tests for the top-K queries
+bool run_perf_topK(tTestSection* test_section);
+
+// Run tests for the indexes of genres and series of the films
+bool run_perf_filmIndexes(tTestSection* test_section);
+
+// Run tests for the batch additions
+bool run_perf_addMany(tTestSection* test_section);
+
+// Run tests for the accounting of the memory of the library
+bool run_perf_memory(tTestSection* test_section);
+
+// Run tests for the latency histograms of the entry points
+bool run_perf_trace(tTestSection* test_section);
+
+// Run tests for the arenas of the tables
+bool run_perf_arena(tTestSection* test_section);
+
+// Run tests for the cached hash and length of the keys of users and films
+bool run_perf_keys(tTestSection* test_section);
+
+// Run tests for the normalization of the names of the users
+bool run_perf_names(tTestSection* test_section);
+
+// Run tests for the fingerprints of the stacks of favorites and the tables of users
+bool run_perf_fingerprints(tTestSection* test_section);
+
+// Run tests for the recommender of films and series
+bool run_perf_recommend(tTestSection* test_section);
+
+// Run tests for the queue of views in front of a log
+bool run_perf_ingest(tTestSection* test_section);
+
+// Run tests for the compressed segments of sealed views
+bool run_perf_segments(tTestSection* test_section);
+
+#endif // __TEST_PERF_H__
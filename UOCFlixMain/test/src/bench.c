@@ -0,0 +1,595 @@
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(_WIN32)
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#include "bench.h"
+#include "user.h"
+#include "film.h"
+#include "series.h"
+#include "view.h"
+#include "mem.h"
+#include "recommend.h"
+#include "ingest.h"
+
+// Maximum number of timed removals for a dataset, as removing from the
+// middle of a table in the default mode is linear on its size
+#define BENCH_REMOVE_OPS 1000
+
+// Number of timed queries that scan the whole log or stack for a dataset
+#define BENCH_QUERY_OPS 100
+
+// Number of series of the catalogs used in the benchmarks, one per genre
+#define BENCH_SERIES (GENRE_QTY - 1)
+
+// Number of views of the queue of the benchmark of viewIngest_add
+#define BENCH_INGEST_CAPACITY 4096
+
+// Measure of an operation in progress
+typedef struct {
+    // Start time, in nanoseconds
+    unsigned long long start;
+    // Number of allocations done before the start, or a negative value if not available
+    long long allocations;
+} tBenchTimer;
+
+// Get the time of a monotonic clock, in nanoseconds
+static unsigned long long bench_now(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (unsigned long long)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+// Get the peak resident memory of the process, in KB
+static long bench_peakRss(void) {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return (long)(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // Reported in bytes instead of KB
+    return (long)(usage.ru_maxrss / 1024);
+#else
+    return (long)usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Get the number of memory allocations done by the library, or a negative
+// value if they are not counted
+static long long bench_allocations(void) {
+    tMemStats stats;
+
+    mem_getTotalStats(&stats);
+    return (long long)stats.allocations;
+}
+
+// Get the next value of a pseudo random sequence, to have repeatable data
+static unsigned int bench_random(unsigned int* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 16) & 0x7fff;
+}
+
+// Get a pseudo random position, also for tables bigger than the range of bench_random
+static unsigned int bench_position(unsigned int* seed, unsigned int size) {
+    return ((bench_random(seed) << 15) | bench_random(seed)) % size;
+}
+
+// Start the measure of an operation
+static void bench_start(tBenchTimer* timer) {
+    timer->allocations = bench_allocations();
+    timer->start = bench_now();
+}
+
+// Finish the measure of an operation repeated ops times, and add its result to the suite
+static void bench_stop(tBenchSuite* suite, tBenchTimer* timer, const char* code, unsigned int elements, unsigned int ops) {
+    unsigned long long elapsed;
+    long long allocations;
+    double allocsPerOp = -1.0;
+
+    elapsed = bench_now() - timer->start;
+    allocations = bench_allocations();
+    if (ops == 0) {
+        ops = 1;
+    }
+    if (timer->allocations >= 0 && allocations >= 0) {
+        allocsPerOp = (double)(allocations - timer->allocations) / ops;
+    }
+
+    benchSuite_addResult(suite, code, elements, ops, (double)elapsed / ops, allocsPerOp, bench_peakRss());
+}
+
+// Initialize the series used by the films of the benchmarks
+static void bench_initSeries(tSeries* series) {
+    int i;
+    char name[32];
+
+    for (i = 0; i < BENCH_SERIES; i++) {
+        sprintf(name, "series%d", i);
+        series_init(&series[i], name, (tGenre)(i + 1));
+    }
+}
+
+// Release the series used by the films of the benchmarks
+static void bench_freeSeries(tSeries* series) {
+    int i;
+
+    for (i = 0; i < BENCH_SERIES; i++) {
+        series_free(&series[i]);
+    }
+}
+
+// Benchmark the table of users with a dataset of n users
+static void bench_userTable(tBenchSuite* suite, unsigned int n) {
+    unsigned int i, ops;
+    unsigned int seed = n;
+    char name[32];
+    tUser* users;
+    tUserTable table;
+    tBenchTimer timer;
+
+    // The users are created before the timers start, so only the table is measured
+    users = (tUser*)malloc(n * sizeof(tUser));
+    assert(users != NULL);
+    for (i = 0; i < n; i++) {
+        sprintf(name, "user%u", i);
+        user_init(&users[i], name, "name", "mail@uoc.edu");
+    }
+    userTable_init(&table);
+
+    bench_start(&timer);
+    for (i = 0; i < n; i++) {
+        userTable_add(&table, &users[i]);
+    }
+    bench_stop(suite, &timer, "userTable_add", n, n);
+
+    bench_start(&timer);
+    for (i = 0; i < n; i++) {
+        userTable_find(&table, users[bench_position(&seed, n)].username);
+    }
+    bench_stop(suite, &timer, "userTable_find", n, n);
+
+    // Remove users scattered over the whole table
+    ops = (n < BENCH_REMOVE_OPS) ? n : BENCH_REMOVE_OPS;
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        userTable_remove(&table, &users[i * (n / ops)]);
+    }
+    bench_stop(suite, &timer, "userTable_remove", n, ops);
+
+    userTable_free(&table);
+    for (i = 0; i < n; i++) {
+        user_free(&users[i]);
+    }
+    free(users);
+}
+
+// Benchmark the normalization of the names of n users, as done by an import
+static void bench_userNames(tBenchSuite* suite, unsigned int n) {
+    unsigned int i;
+    char name[32];
+    tUser* users;
+    tBenchTimer timer;
+
+    users = (tUser*)malloc(n * sizeof(tUser));
+    assert(users != NULL);
+    for (i = 0; i < n; i++) {
+        sprintf(name, "user%u", i);
+        user_init(&users[i], name, "   joAN pere GAbriel de la MUNTANYA   ", "mail@uoc.edu");
+    }
+
+    bench_start(&timer);
+    user_trimCapitalizeNames(users, n);
+    bench_stop(suite, &timer, "user_trimCapitalizeNames", n, n);
+
+    for (i = 0; i < n; i++) {
+        user_free(&users[i]);
+    }
+    free(users);
+}
+
+// Benchmark the table of films with a dataset of n films
+static void bench_filmTable(tBenchSuite* suite, unsigned int n) {
+    unsigned int i, ops;
+    unsigned int seed = n;
+    char name[32];
+    tSeries series[BENCH_SERIES];
+    tFilm* films;
+    tFilmTable table;
+    tBenchTimer timer;
+
+    // The films are created before the timers start, so only the table is measured
+    bench_initSeries(series);
+    films = (tFilm*)malloc(n * sizeof(tFilm));
+    assert(films != NULL);
+    for (i = 0; i < n; i++) {
+        sprintf(name, "film%u", i);
+        film_init(&films[i], name, 30 + i % 60, &series[i % BENCH_SERIES]);
+    }
+    filmTable_init(&table);
+
+    bench_start(&timer);
+    for (i = 0; i < n; i++) {
+        filmTable_add(&table, &films[i]);
+    }
+    bench_stop(suite, &timer, "filmTable_add", n, n);
+
+    bench_start(&timer);
+    for (i = 0; i < n; i++) {
+        filmTable_find(&table, films[bench_position(&seed, n)].title);
+    }
+    bench_stop(suite, &timer, "filmTable_find", n, n);
+
+    // Remove films scattered over the whole table
+    ops = (n < BENCH_REMOVE_OPS) ? n : BENCH_REMOVE_OPS;
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        filmTable_remove(&table, &films[i * (n / ops)]);
+    }
+    bench_stop(suite, &timer, "filmTable_remove", n, ops);
+
+    // The same films in the other modes, which take them out of the lists 
+    // of genres and series in constant time
+    for (i = 0; i < ops; i++) {
+        filmTable_add(&table, &films[i * (n / ops)]);
+    }
+    filmTable_setRemoveMode(&table, TABLE_REMOVE_SWAP);
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        filmTable_remove(&table, &films[i * (n / ops)]);
+    }
+    bench_stop(suite, &timer, "filmTable_removeSwap", n, ops);
+
+    for (i = 0; i < ops; i++) {
+        filmTable_add(&table, &films[i * (n / ops)]);
+    }
+    filmTable_setRemoveMode(&table, TABLE_REMOVE_TOMBSTONE);
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        filmTable_remove(&table, &films[i * (n / ops)]);
+    }
+    bench_stop(suite, &timer, "filmTable_removeTombstone", n, ops);
+
+    filmTable_free(&table);
+    for (i = 0; i < n; i++) {
+        film_free(&films[i]);
+    }
+    free(films);
+    bench_freeSeries(series);
+}
+
+// Time the queries of the favorites of the users of a log, adding the results with a suffix
+static void bench_viewLogQueries(tBenchSuite* suite, tViewLog* log, tUserTable* users, unsigned int n, const char* suffix) {
+    unsigned int i, ops;
+    unsigned int seed = n;
+    char code[64];
+    tBenchTimer timer;
+
+    ops = (users->size < BENCH_QUERY_OPS) ? users->size : BENCH_QUERY_OPS;
+
+    sprintf(code, "viewLog_getFavFilm%s", suffix);
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        viewLog_getFavFilm(log, &users->elements[bench_position(&seed, users->size)]);
+    }
+    bench_stop(suite, &timer, code, n, ops);
+
+    sprintf(code, "viewLog_getFavGenre%s", suffix);
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        viewLog_getFavGenre(log, &users->elements[bench_position(&seed, users->size)]);
+    }
+    bench_stop(suite, &timer, code, n, ops);
+}
+
+// Benchmark a log of n views, bound to catalogs of n/10 users and films
+static void bench_viewLog(tBenchSuite* suite, unsigned int n) {
+    unsigned int i, count;
+    unsigned int seed = n;
+    unsigned int catalog = (n < 10) ? 1 : n / 10;
+    char name[32];
+    tSeries series[BENCH_SERIES];
+    tUserTable users;
+    tFilmTable films;
+    tViewLog log, queued;
+    tViewIngest ingest;
+    tUser user;
+    tFilm film;
+    tView view;
+    tDateTime dt;
+    tRecommender recommender;
+    tFilm* top[10];
+    tBenchTimer timer;
+
+    bench_initSeries(series);
+    userTable_init(&users);
+    filmTable_init(&films);
+    userTable_reserve(&users, catalog);
+    filmTable_reserve(&films, catalog);
+    for (i = 0; i < catalog; i++) {
+        sprintf(name, "user%u", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_add(&users, &user);
+        user_free(&user);
+        sprintf(name, "film%u", i);
+        film_init(&film, name, 30 + i % 60, &series[i % BENCH_SERIES]);
+        filmTable_add(&films, &film);
+        film_free(&film);
+    }
+    viewLog_init(&log);
+    viewLog_bind(&log, &users, &films);
+
+    // One view per minute, in chronological order
+    bench_start(&timer);
+    for (i = 0; i < n; i++) {
+        dt = dateTime_make(1 + (i / DATETIME_MINUTES_PER_DAY) % 28, 1 + (i / (DATETIME_MINUTES_PER_DAY * 28)) % 12,
+                    2019 + i / (DATETIME_MINUTES_PER_DAY * 28 * 12), (i / 60) % 24, i % 60);
+        view_initRef(&view, &dt, bench_random(&seed) % 10 - 1, &users.elements[bench_position(&seed, catalog)],
+                    &films.elements[bench_position(&seed, catalog)]);
+        viewLog_add(&log, &view);
+    }
+    bench_stop(suite, &timer, "viewLog_add", n, n);
+
+    bench_viewLogQueries(suite, &log, &users, n, "");
+
+    bench_start(&timer);
+    viewLog_enableUserIndex(&log);
+    bench_stop(suite, &timer, "viewLog_enableUserIndex", n, 1);
+
+    bench_viewLogQueries(suite, &log, &users, n, "/indexed");
+
+    // Recommendations from the films watched by the same users
+    recommender_init(&recommender, &users, &films);
+    bench_start(&timer);
+    viewLog_attachRecommender(&log, &recommender);
+    bench_stop(suite, &timer, "viewLog_attachRecommender", n, 1);
+
+    bench_start(&timer);
+    for (i = 0; i < BENCH_QUERY_OPS; i++) {
+        recommender_getFilms(&recommender, RECOMMEND_VIEWS, &films.elements[bench_position(&seed, catalog)], 10, 
+                             top, NULL, &count);
+    }
+    bench_stop(suite, &timer, "recommender_getFilms", n, BENCH_QUERY_OPS);
+
+    viewLog_attachRecommender(&log, NULL);
+    recommender_free(&recommender);
+
+    // The same views through a queue, that adds them to another log
+    viewLog_init(&queued);
+    viewLog_bind(&queued, &users, &films);
+    if (viewIngest_init(&ingest, &queued, BENCH_INGEST_CAPACITY) == OK) {
+        bench_start(&timer);
+        for (i = 0; i < n; i++) {
+            view = log.elements[i];
+            view.user = viewLog_getUser(&log, i);
+            view.film = viewLog_getFilm(&log, i);
+            viewIngest_add(&ingest, &view);
+        }
+        bench_stop(suite, &timer, "viewIngest_add", n, n);
+
+        bench_start(&timer);
+        viewIngest_flush(&ingest);
+        bench_stop(suite, &timer, "viewIngest_flush", n, 1);
+        viewIngest_free(&ingest);
+    }
+    viewLog_free(&queued);
+
+    // The older half of the views in compressed segments
+    if (n > 1) {
+        bench_start(&timer);
+        viewLog_seal(&log, dateTime_pack(&log.elements[n / 2].timestamp));
+        viewLog_shrinkToFit(&log);
+        bench_stop(suite, &timer, "viewLog_seal", n, 1);
+
+        bench_viewLogQueries(suite, &log, &users, n, "/sealed");
+    }
+
+    viewLog_free(&log);
+    filmTable_free(&films);
+    userTable_free(&users);
+    bench_freeSeries(series);
+}
+
+// Benchmark the favorites of a user with n favorites
+static void bench_favorites(tBenchSuite* suite, unsigned int n) {
+    unsigned int i, ops;
+    unsigned int catalog = (n < BENCH_MIN_ELEMENTS) ? n : BENCH_MIN_ELEMENTS;
+    char name[32];
+    tSeries series[BENCH_SERIES];
+    tFilm* films;
+    tUser user;
+    tBenchTimer timer;
+
+    // The favorites repeat the films of a small catalog
+    bench_initSeries(series);
+    films = (tFilm*)malloc(catalog * sizeof(tFilm));
+    assert(films != NULL);
+    for (i = 0; i < catalog; i++) {
+        sprintf(name, "film%u", i);
+        film_init(&films[i], name, 30 + i % 60, &series[i % BENCH_SERIES]);
+    }
+    user_init(&user, "user", "name", "mail@uoc.edu");
+
+    bench_start(&timer);
+    for (i = 0; i < n; i++) {
+        user_addFavorite(&user, films[i % catalog]);
+    }
+    bench_stop(suite, &timer, "user_addFavorite", n, n);
+
+    ops = BENCH_QUERY_OPS;
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        user_getFavoriteGenre(&user);
+    }
+    bench_stop(suite, &timer, "user_getFavoriteGenre", n, ops);
+
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        user_getFavsLengthInMin(&user);
+    }
+    bench_stop(suite, &timer, "user_getFavsLengthInMin", n, ops);
+
+    bench_start(&timer);
+    for (i = 0; i < ops; i++) {
+        user_getFavsCntPerSeries(&user, &series[i % BENCH_SERIES]);
+    }
+    bench_stop(suite, &timer, "user_getFavsCntPerSeries", n, ops);
+
+    bench_start(&timer);
+    for (i = 0; i < n; i++) {
+        user_popFavorite(&user);
+    }
+    bench_stop(suite, &timer, "user_popFavorite", n, n);
+
+    user_free(&user);
+    for (i = 0; i < catalog; i++) {
+        film_free(&films[i]);
+    }
+    free(films);
+    bench_freeSeries(series);
+}
+
+// Run all benchmarks, with datasets from BENCH_MIN_ELEMENTS to maxElements elements
+void run_bench(tBenchSuite* bench_suite, unsigned int maxElements) {
+    unsigned int n;
+
+    assert(bench_suite != NULL);
+
+    benchSuite_init(bench_suite);
+
+    if (maxElements > BENCH_MAX_ELEMENTS) {
+        maxElements = BENCH_MAX_ELEMENTS;
+    }
+
+    // Each dataset is 10 times bigger than the previous one, so the growth
+    // of the time per operation shows the complexity of the operation
+    for (n = BENCH_MIN_ELEMENTS; n <= maxElements; n *= 10) {
+        bench_userTable(bench_suite, n);
+        bench_userNames(bench_suite, n);
+        bench_filmTable(bench_suite, n);
+        bench_viewLog(bench_suite, n);
+        bench_favorites(bench_suite, n);
+    }
+}
+
+// Initialize a benchmark suite
+void benchSuite_init(tBenchSuite* object) {
+    assert(object != NULL);
+    object->numResults = 0;
+    object->results = NULL;
+}
+
+// Remove a benchmark suite
+void benchSuite_free(tBenchSuite* object) {
+    int i;
+    assert(object != NULL);
+
+    if (object->results != NULL) {
+        for (i = 0; i < object->numResults; i++) {
+            free(object->results[i].code);
+        }
+        free(object->results);
+    }
+    object->numResults = 0;
+    object->results = NULL;
+}
+
+// Add a result to a benchmark suite
+void benchSuite_addResult(tBenchSuite* object, const char* code, unsigned int elements, unsigned int ops,
+                        double nsPerOp, double allocsPerOp, long peakRss) {
+    tBenchResult* result;
+    assert(object != NULL);
+    assert(code != NULL);
+
+    object->numResults++;
+    if (object->results == NULL) {
+        object->results = (tBenchResult*)malloc(object->numResults * sizeof(tBenchResult));
+    } else {
+        object->results = (tBenchResult*)realloc(object->results, object->numResults * sizeof(tBenchResult));
+    }
+    assert(object->results != NULL);
+
+    result = &(object->results[object->numResults - 1]);
+    result->code = (char*)malloc((strlen(code) + 1) * sizeof(char));
+    assert(result->code != NULL);
+    strcpy(result->code, code);
+    result->elements = elements;
+    result->ops = ops;
+    result->nsPerOp = nsPerOp;
+    result->allocsPerOp = allocsPerOp;
+    result->peakRss = peakRss;
+}
+
+// Print benchmark suite
+void benchSuite_print(tBenchSuite* object) {
+    int i;
+    tBenchResult* result;
+    assert(object != NULL);
+
+    printf("=========================================================================================\n");
+    printf("\tBENCHMARKS\n");
+    printf("=========================================================================================\n");
+    printf("%-32s %10s %10s %14s %12s %12s\n", "OPERATION", "ELEMENTS", "OPS", "NS/OP", "ALLOCS/OP", "PEAK RSS KB");
+    for (i = 0; i < object->numResults; i++) {
+        result = &(object->results[i]);
+        if (result->allocsPerOp < 0) {
+            printf("%-32s %10u %10u %14.1f %12s %12ld\n", result->code, result->elements, result->ops,
+                    result->nsPerOp, "-", result->peakRss);
+        } else {
+            printf("%-32s %10u %10u %14.1f %12.2f %12ld\n", result->code, result->elements, result->ops,
+                    result->nsPerOp, result->allocsPerOp, result->peakRss);
+        }
+    }
+    printf("=========================================================================================\n");
+}
+
+// Export a benchmark suite
+void benchSuite_export(tBenchSuite* object, FILE* fout) {
+    int i;
+    tBenchResult* result;
+    assert(object != NULL);
+    assert(fout != NULL);
+
+    fprintf(fout, "{ \"total\": %d, \"benchmarks\": [", object->numResults);
+    for (i = 0; i < object->numResults; i++) {
+        result = &(object->results[i]);
+        if (i > 0) {
+            fprintf(fout, ", ");
+        }
+        fprintf(fout, "{ \"code\": \"%s\", \"elements\": %u, \"ops\": %u, \"ns_per_op\": %.1f, ",
+                result->code, result->elements, result->ops, result->nsPerOp);
+        if (result->allocsPerOp < 0) {
+            fprintf(fout, "\"allocs_per_op\": null, ");
+        } else {
+            fprintf(fout, "\"allocs_per_op\": %.2f, ", result->allocsPerOp);
+        }
+        fprintf(fout, "\"peak_rss_kb\": %ld}", result->peakRss);
+    }
+    fprintf(fout, "]}");
+}
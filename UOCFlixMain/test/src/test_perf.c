@@ -0,0 +1,5691 @@
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "test_perf.h"
+#include "user.h"
+#include "film.h"
+#include "series.h"
+#include "view.h"
+#include "favorite.h"
+#include "intern.h"
+#include "loader.h"
+#include "snapshot.h"
+#include "journal.h"
+#include "sync.h"
+#include "shardlog.h"
+#include "report.h"
+#include "topk.h"
+#include "mem.h"
+#include "trace.h"
+#include "arena.h"
+#include "hash.h"
+#include "recommend.h"
+#include "ingest.h"
+#include "segment.h"
+
+// Number of elements used to fill the tables in these tests
+#define PERF_TEST_ELEMENTS 1000
+
+// Number of series of the catalogs used in these tests, one per genre
+#define PERF_TEST_SERIES (GENRE_QTY - 1)
+
+// Get the next value of a pseudo random sequence, to have repeatable data
+static unsigned int perf_random(unsigned int* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 16) & 0x7fff;
+}
+
+// Create a catalog of series, films and users to be used in the tests
+static void perf_initCatalog(tSeries* series, tFilmTable* films, tUserTable* users, int numFilms, int numUsers) {
+    int i;
+    char name[32];
+    tFilm film;
+    tUser user;
+
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        sprintf(name, "series%d", i);
+        series_init(&series[i], name, (tGenre)(i + 1));
+    }
+
+    filmTable_init(films);
+    for (i = 0; i < numFilms; i++) {
+        sprintf(name, "film%d", i);
+        film_init(&film, name, 30 + i % 60, &series[i % PERF_TEST_SERIES]);
+        filmTable_add(films, &film);
+        film_free(&film);
+    }
+
+    userTable_init(users);
+    for (i = 0; i < numUsers; i++) {
+        sprintf(name, "user%d", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_add(users, &user);
+        user_free(&user);
+    }
+}
+
+// Release a catalog created with perf_initCatalog
+static void perf_freeCatalog(tSeries* series, tFilmTable* films, tUserTable* users) {
+    int i;
+
+    filmTable_free(films);
+    userTable_free(users);
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        series_free(&series[i]);
+    }
+}
+
+// Add pseudo random views of the catalog to a log, in chronological order
+static void perf_addViews(tViewLog* viewLog, tFilmTable* films, tUserTable* users, int numViews, unsigned int seed) {
+    int i;
+    short score;
+    tView view;
+    tDateTime dt;
+    tUser* user;
+
+    dt.year = 2019;
+    dt.month = 10;
+    dt.day = 1;
+    dt.hour = 0;
+    dt.minute = 0;
+
+    for (i = 0; i < numViews; i++) {
+        dt.hour = (i / 60) % 24;
+        dt.minute = i % 60;
+        dt.day = 1 + (i / (60 * 24)) % 28;
+        score = perf_random(&seed) % 10 - 1;
+        // Skip the tombstones of removed users
+        do {
+            user = &users->elements[perf_random(&seed) % users->size];
+        } while (user->username == NULL);
+        view_initRef(&view, &dt, score, user, &films->elements[perf_random(&seed) % films->size]);
+        view.minutes = 1 + perf_random(&seed) % 60;
+        viewLog_add(viewLog, &view);
+    }
+}
+
+// Add views with random timestamps in October 2019 to several logs
+static void perf_addRandomViews(tViewLog** logs, int numLogs, tFilmTable* films, tUserTable* users, int numViews, unsigned int seed) {
+    int i, j;
+    tView view;
+    tDateTime dt;
+
+    for (i = 0; i < numViews; i++) {
+        dt = dateTime_make(1 + perf_random(&seed) % 28, 10, 2019, perf_random(&seed) % 24, perf_random(&seed) % 60);
+        view_initRef(&view, &dt, perf_random(&seed) % 10 - 1, &users->elements[perf_random(&seed) % users->size], 
+                    &films->elements[perf_random(&seed) % films->size]);
+        for (j = 0; j < numLogs; j++) {
+            viewLog_add(logs[j], &view);
+        }
+    }
+}
+
+// Stop a favoriteStack_foreach after the number of visits given as context
+static bool perf_visitFavorites(const tFavorite* favorite, void* context) {
+    int* pending = (int*)context;
+
+    (*pending)--;
+    return (*pending > 0);
+}
+
+// Remove from the tables of a catalog the users and films with an odd number, 
+// in a scattered order, and check the tables. Returns false if any check fails.
+// The number of elements must not be a multiple of 37
+static bool perf_removeOdd(tFilmTable* films, tUserTable* users, int numFilms, int numUsers) {
+    int i, k;
+    char name[32];
+    const char* names[PERF_TEST_ELEMENTS];
+    tUser* user;
+    tUser missing;
+    tFilm* film;
+    bool ok = true;
+
+    // Keep the strings of the users, to check they are not copied
+    for (i = 0; i < numUsers; i++) {
+        sprintf(name, "user%d", i);
+        names[i] = userTable_find(users, name)->username;
+    }
+
+    for (k = 0; k < numUsers; k++) {
+        i = (k * 37) % numUsers;
+        sprintf(name, "user%d", i);
+        user = userTable_find(users, name);
+        if (i % 2 == 1 && (user == NULL || userTable_remove(users, user) != OK)) {
+            ok = false;
+        }
+    }
+    for (k = 0; k < numFilms; k++) {
+        i = (k * 37) % numFilms;
+        sprintf(name, "film%d", i);
+        film = filmTable_find(films, name);
+        if (i % 2 == 1 && (film == NULL || filmTable_remove(films, film) != OK)) {
+            ok = false;
+        }
+    }
+
+    if (userTable_size(users) != (numUsers + 1) / 2 || filmTable_size(films) != (numFilms + 1) / 2) {
+        ok = false;
+    }
+    for (i = 0; i < numUsers; i++) {
+        sprintf(name, "user%d", i);
+        user = userTable_find(users, name);
+        if ((i % 2 == 1 && user != NULL) || (i % 2 == 0 && (user == NULL || user->username != names[i]))) {
+            ok = false;
+        }
+    }
+    for (i = 0; i < numFilms; i++) {
+        sprintf(name, "film%d", i);
+        film = filmTable_find(films, name);
+        if ((i % 2 == 1 && film != NULL) || (i % 2 == 0 && (film == NULL || strcmp(film->title, name) != 0))) {
+            ok = false;
+        }
+    }
+
+    // Removing again fails
+    user_init(&missing, "user1", "name", "mail@uoc.edu");
+    if (userTable_remove(users, &missing) != ERR_NOT_FOUND) {
+        ok = false;
+    }
+    user_free(&missing);
+
+    return ok;
+}
+
+// Check that two bound logs have the same views
+static bool perf_equalViews(tViewLog* log1, tViewLog* log2) {
+    int i;
+    tView* view1;
+    tView* view2;
+
+    if (log1->size != log2->size) {
+        return false;
+    }
+    for (i = 0; i < log1->size; i++) {
+        view1 = &log1->elements[i];
+        view2 = &log2->elements[i];
+        if (!user_equals(viewLog_getUser(log1, i), viewLog_getUser(log2, i))
+                || !film_equals(viewLog_getFilm(log1, i), viewLog_getFilm(log2, i))
+                || view1->score != view2->score || view1->minutes != view2->minutes
+                || memcmp(&view1->timestamp, &view2->timestamp, sizeof(tDateTime)) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Number of reader threads and of operations of each thread in the concurrency tests
+#define PERF_TEST_READERS 4
+#define PERF_TEST_OPERATIONS 2000
+
+// Catalog shared by the threads of the concurrency tests
+typedef struct {
+    tRWLock* lock;
+    tSeries* series;
+    tFilmTable* films;
+    tUserTable* users;
+    tViewLog* views;
+    unsigned int numFilms;
+    unsigned int numUsers;
+    unsigned int seed;
+    // Number of failed checks of the thread
+    unsigned int errors;
+} tPerfShared;
+
+// Tables with their own locks, compared by the threads of the concurrency tests
+typedef struct {
+    tUserTable* users1;
+    tUserTable* users2;
+    // Compare the tables, or take their locks for writing
+    bool writer;
+    // Number of failed checks of the thread
+    unsigned int errors;
+} tPerfCompare;
+
+// Compare two tables with the same users, or take their locks for writing one after the other
+static void perf_compareThread(void* context) {
+    tPerfCompare* compare = (tPerfCompare*)context;
+    int i;
+
+    for (i = 0; i < PERF_TEST_OPERATIONS / 4; i++) {
+        if (compare->writer) {
+            rwlock_writeLock(compare->users1->lock);
+            rwlock_writeUnlock(compare->users1->lock);
+            rwlock_writeLock(compare->users2->lock);
+            rwlock_writeUnlock(compare->users2->lock);
+        }
+        else if (!userTable_equals(compare->users1, compare->users2)) {
+            compare->errors++;
+        }
+    }
+}
+
+// Look up the initial users and films of the catalog, and their favorites
+static void perf_readerThread(void* context) {
+    tPerfShared* shared = (tPerfShared*)context;
+    char name[32];
+    tUser* user;
+    tFilm* film;
+    int i;
+
+    for (i = 0; i < PERF_TEST_OPERATIONS; i++) {
+        // Hold the lock to use the elements found
+        rwlock_readLock(shared->lock);
+        sprintf(name, "user%u", perf_random(&shared->seed) % shared->numUsers);
+        user = userTable_find(shared->users, name);
+        if (user == NULL || strcmp(user->username, name) != 0) {
+            shared->errors++;
+        }
+        else {
+            film = viewLog_getFavFilm(shared->views, user);
+            if (film != NULL && film->title == NULL) {
+                shared->errors++;
+            }
+            viewLog_getFavGenre(shared->views, user);
+        }
+        rwlock_readUnlock(shared->lock);
+
+        // Lookups without holding the lock
+        sprintf(name, "film%u", perf_random(&shared->seed) % shared->numFilms);
+        if (filmTable_find(shared->films, name) == NULL || userTable_size(shared->users) < shared->numUsers) {
+            shared->errors++;
+        }
+    }
+}
+
+// Add new users, films and views to the catalog, and favorites to the initial users
+static void perf_writerThread(void* context) {
+    tPerfShared* shared = (tPerfShared*)context;
+    char name[32];
+    tUser user;
+    tFilm film;
+    tView view;
+    tDateTime dt;
+    int i;
+
+    dt = dateTime_make(1, 11, 2019, 0, 0);
+    for (i = 0; i < PERF_TEST_OPERATIONS; i++) {
+        sprintf(name, "newUser%d", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        sprintf(name, "newFilm%d", i);
+        film_init(&film, name, 60, &shared->series[0]);
+        if (userTable_add(shared->users, &user) != OK || filmTable_add(shared->films, &film) != OK) {
+            shared->errors++;
+        }
+
+        // The view references the elements of the tables, that must not move meanwhile
+        rwlock_writeLock(shared->lock);
+        view_initRef(&view, &dt, 5, userTable_find(shared->users, user.username), filmTable_find(shared->films, film.title));
+        if (viewLog_add(shared->views, &view) != OK) {
+            shared->errors++;
+        }
+        rwlock_writeUnlock(shared->lock);
+
+        sprintf(name, "user%u", perf_random(&shared->seed) % shared->numUsers);
+        if (userTable_addFavorite(shared->users, name, film) != OK) {
+            shared->errors++;
+        }
+        user_free(&user);
+        film_free(&film);
+    }
+
+    // Nodes of the favorites are released by the main thread, but the free 
+    // nodes of the pool of this thread must be released before it ends
+    favoriteNodePool_release();
+}
+
+// Number of threads that add views to a sharded log
+#define PERF_TEST_PRODUCERS 8
+
+// Views added by a thread to a sharded log: the views of a log with a 
+// position equal to first modulo PERF_TEST_PRODUCERS
+typedef struct {
+    tShardedViewLog* sharded;
+    tViewIngest* ingest;
+    tViewLog* views;
+    unsigned int first;
+    unsigned int errors;
+} tPerfProducer;
+
+// Add the views of the slice of a producer to the sharded log
+static void perf_producerThread(void* context) {
+    tPerfProducer* producer = (tPerfProducer*)context;
+    unsigned int i;
+    tView view;
+
+    for (i = producer->first; i < producer->views->size; i += PERF_TEST_PRODUCERS) {
+        view = producer->views->elements[i];
+        view.user = viewLog_getUser(producer->views, i);
+        view.film = viewLog_getFilm(producer->views, i);
+        if (shardedViewLog_add(producer->sharded, &view) != OK) {
+            producer->errors++;
+        }
+    }
+}
+
+// Queue the views of a producer in a queue of views
+static void perf_ingestThread(void* context) {
+    tPerfProducer* producer = (tPerfProducer*)context;
+    unsigned int i;
+    tView view;
+
+    for (i = producer->first; i < producer->views->size; i += PERF_TEST_PRODUCERS) {
+        view = producer->views->elements[i];
+        view.user = viewLog_getUser(producer->views, i);
+        view.film = viewLog_getFilm(producer->views, i);
+        if (viewIngest_add(producer->ingest, &view) != OK) {
+            producer->errors++;
+        }
+    }
+}
+
+// Sort entries of a ranking from the best to the worst
+static int perf_rankCmp(const void* a, const void* b) {
+    const tRankEntry* entry1 = (const tRankEntry*)a;
+    const tRankEntry* entry2 = (const tRankEntry*)b;
+
+    if (entry1->score != entry2->score) {
+        return entry1->score > entry2->score ? -1 : 1;
+    }
+    if (entry1->order != entry2->order) {
+        return entry1->order < entry2->order ? -1 : 1;
+    }
+    return 0;
+}
+
+// Check that a selection has the first k entries of a sorted ranking
+static bool perf_checkTopK(tTopK* top, tRankEntry* sorted, unsigned int size, unsigned int k) {
+    unsigned int i;
+
+    topK_sort(top);
+    if (top->size != (size < k ? size : k)) {
+        return false;
+    }
+    for (i = 0; i < top->size; i++) {
+        if (top->entries[i].score != sorted[i].score || top->entries[i].order != sorted[i].order 
+                || top->entries[i].id != sorted[i].id) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Check that a list of positions has exactly the films of a table that match a genre 
+// (if series is NULL) or a series. Returns false if any check fails
+static bool perf_checkFilmList(tFilmTable* films, tPostings* list, tGenre genre, tSeries* series) {
+    unsigned int i;
+    unsigned int expected = 0;
+    tFilm* film;
+
+    for (i = 0; i < films->size; i++) {
+        film = &films->elements[i];
+        if (film->title != NULL && (series != NULL ? series_equals(film->series, series) : film->series->genre == genre)) {
+            expected++;
+        }
+    }
+    if (expected == 0 || list == NULL) {
+        return expected == 0 && list == NULL;
+    }
+    if (list->size != expected) {
+        return false;
+    }
+
+    // All the positions are different films of the list
+    for (i = 0; i < list->size; i++) {
+        if (list->elements[i] >= films->size) {
+            return false;
+        }
+        film = &films->elements[list->elements[i]];
+        if (film->title == NULL || (series != NULL ? !series_equals(film->series, series) : film->series->genre != genre)
+                || (i > 0 && list->elements[i] == list->elements[i - 1])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Check the lists of all the genres and series of a table of films
+static bool perf_checkFilmIndexes(tFilmTable* films, tSeries* series) {
+    unsigned int i;
+    bool ok = true;
+
+    for (i = 0; i < GENRE_QTY; i++) {
+        ok = perf_checkFilmList(films, filmTable_getGenreFilms(films, (tGenre)i), (tGenre)i, NULL) && ok;
+    }
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        ok = perf_checkFilmList(films, filmTable_getSeriesFilms(films, &series[i]), GENRE_NOT_FOUND, &series[i]) && ok;
+    }
+
+    return ok;
+}
+
+// Allocator that counts its calls and can fail after a number of allocations
+typedef struct {
+    unsigned int allocations;
+    unsigned int releases;
+    // Number of allocations that can be done before failing, or -1 to never fail
+    int remaining;
+} tPerfAllocator;
+
+// Blocks can be released after the allocator is changed, so it is kept for all the tests
+static tPerfAllocator perfAllocator;
+
+// Allocate a block with a tPerfAllocator
+static void* perf_allocate(size_t size, void* context) {
+    tPerfAllocator* allocator = (tPerfAllocator*)context;
+
+    if (allocator->remaining == 0) {
+        return NULL;
+    }
+    if (allocator->remaining > 0) {
+        allocator->remaining--;
+    }
+    allocator->allocations++;
+    return malloc(size);
+}
+
+// Resize a block with a tPerfAllocator
+static void* perf_reallocate(void* ptr, size_t size, void* context) {
+    tPerfAllocator* allocator = (tPerfAllocator*)context;
+
+    if (allocator->remaining == 0) {
+        return NULL;
+    }
+    if (allocator->remaining > 0) {
+        allocator->remaining--;
+    }
+    allocator->allocations++;
+    return realloc(ptr, size);
+}
+
+// Release a block with a tPerfAllocator
+static void perf_release(void* ptr, void* context) {
+    ((tPerfAllocator*)context)->releases++;
+    free(ptr);
+}
+
+// Functions of perfAllocator
+static const tAllocator perfAllocatorFns = { perf_allocate, perf_reallocate, perf_release, &perfAllocator };
+
+// Check the live memory of the elements of the catalog is the same than in a previous state
+static bool perf_sameLiveMemory(tMemStats* before) {
+    tMemStats stats;
+    int i;
+    tMemSubsystem subsystems[] = { MEM_USER, MEM_FILM, MEM_SERIES, MEM_VIEW };
+
+    // The pools of strings and nodes can keep the memory of their arrays, 
+    // so only the number of blocks of the whole library is compared
+    mem_getTotalStats(&stats);
+    if (stats.liveBlocks != before[MEM_SUBSYSTEM_QTY].liveBlocks) {
+        return false;
+    }
+    for (i = 0; i < 4; i++) {
+        mem_getStats(subsystems[i], &stats);
+        if (stats.liveBytes != before[subsystems[i]].liveBytes || stats.liveBlocks != before[subsystems[i]].liveBlocks) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Get the counters of all the subsystems, with the total as the last element
+static void perf_getMemStats(tMemStats* stats) {
+    int i;
+
+    for (i = 0; i < MEM_SUBSYSTEM_QTY; i++) {
+        mem_getStats((tMemSubsystem)i, &stats[i]);
+    }
+    mem_getTotalStats(&stats[MEM_SUBSYSTEM_QTY]);
+}
+
+// Number of records of each thread of the tests of the histograms
+#define PERF_TRACE_RECORDS 3000
+
+// Record latencies from a thread, merging the last ones before ending
+static void perf_traceThread(void* context) {
+    unsigned int i;
+
+    for (i = 1; i <= PERF_TRACE_RECORDS; i++) {
+        trace_record(TRACE_FILM_ADD, i);
+    }
+    trace_flush();
+}
+
+// Count the calls of a trace callback
+static void perf_traceCallback(tTracePoint point, unsigned long long ns, void* context) {
+    ((unsigned int*)context)[point]++;
+}
+
+// Run all tests for the performance extensions of the library
+bool run_perf(tTestSuite* test_suite) {
+    bool ok = true;
+    tTestSection* section = NULL;
+
+    assert(test_suite != NULL);
+
+    testSuite_addSection(test_suite, "PERF", "Tests for performance extensions");
+
+    section = testSuite_getSection(test_suite, "PERF");
+    assert(section != NULL);
+
+    ok = run_perf_userIndex(section) && ok;
+    ok = run_perf_capacity(section) && ok;
+    ok = run_perf_boundViewLog(section) && ok;
+    ok = run_perf_viewColumns(section) && ok;
+    ok = run_perf_userViewIndex(section) && ok;
+    ok = run_perf_favoriteAggregates(section) && ok;
+    ok = run_perf_favoriteIterator(section) && ok;
+    ok = run_perf_favoritePool(section) && ok;
+    ok = run_perf_intern(section) && ok;
+    ok = run_perf_removeModes(section) && ok;
+    ok = run_perf_loader(section) && ok;
+    ok = run_perf_snapshot(section) && ok;
+    ok = run_perf_journal(section) && ok;
+    ok = run_perf_timeIndex(section) && ok;
+    ok = run_perf_concurrent(section) && ok;
+    ok = run_perf_sharded(section) && ok;
+    ok = run_perf_report(section) && ok;
+    ok = run_perf_topK(section) && ok;
+    ok = run_perf_filmIndexes(section) && ok;
+    ok = run_perf_addMany(section) && ok;
+    ok = run_perf_memory(section) && ok;
+    ok = run_perf_trace(section) && ok;
+    ok = run_perf_arena(section) && ok;
+    ok = run_perf_keys(section) && ok;
+    ok = run_perf_names(section) && ok;
+    ok = run_perf_fingerprints(section) && ok;
+    ok = run_perf_recommend(section) && ok;
+    ok = run_perf_ingest(section) && ok;
+    ok = run_perf_segments(section) && ok;
+
+    return ok;
+}
+
+// Run tests for the hash index of the table of users
+bool run_perf_userIndex(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i;
+    char username[32];
+    tError err;
+    tUser user;
+    tUser* userAux;
+    tUserTable users, usersReversed;
+
+    userTable_init(&users);
+    userTable_init(&usersReversed);
+
+    // TEST 1: Add and find many users
+    failed = false;
+    start_test(test_section, "PERF_USER_1", "Add and find many users");
+
+    for (i = 0; i < PERF_TEST_ELEMENTS && !failed; i++) {
+        sprintf(username, "user%d", i);
+        user_init(&user, username, "name", "mail@uoc.edu");
+        if (userTable_add(&users, &user) != OK) {
+            failed = true;
+        }
+        user_free(&user);
+    }
+
+    for (i = 0; i < PERF_TEST_ELEMENTS && !failed; i++) {
+        sprintf(username, "user%d", i);
+        userAux = userTable_find(&users, username);
+        if (userAux == NULL || strcmp(userAux->username, username) != 0) {
+            failed = true;
+        }
+    }
+
+    if (userTable_size(&users) != PERF_TEST_ELEMENTS || userTable_find(&users, "nobody") != NULL) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_USER_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_USER_1", true);
+    }
+
+    // TEST 2: Duplicated users are detected
+    failed = false;
+    start_test(test_section, "PERF_USER_2", "Detect duplicated users");
+
+    user_init(&user, "user500", "other name", "other@uoc.edu");
+    err = userTable_add(&users, &user);
+    user_free(&user);
+
+    if (err != ERR_DUPLICATED || userTable_size(&users) != PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_USER_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_USER_2", true);
+    }
+
+    // TEST 3: Remove users keeps the index consistent
+    failed = false;
+    start_test(test_section, "PERF_USER_3", "Remove users and find the remaining ones");
+
+    for (i = 0; i < PERF_TEST_ELEMENTS && !failed; i += 3) {
+        sprintf(username, "user%d", i);
+        user_init(&user, username, "name", "mail@uoc.edu");
+        if (userTable_remove(&users, &user) != OK) {
+            failed = true;
+        }
+        user_free(&user);
+    }
+
+    for (i = 0; i < PERF_TEST_ELEMENTS && !failed; i++) {
+        sprintf(username, "user%d", i);
+        userAux = userTable_find(&users, username);
+        if ((i % 3 == 0) != (userAux == NULL)) {
+            failed = true;
+        }
+        else if (userAux != NULL && strcmp(userAux->username, username) != 0) {
+            failed = true;
+        }
+    }
+
+    user_init(&user, "user0", "name", "mail@uoc.edu");
+    if (userTable_remove(&users, &user) != ERR_NOT_FOUND) {
+        failed = true;
+    }
+    user_free(&user);
+
+    if (failed) {
+        end_test(test_section, "PERF_USER_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_USER_3", true);
+    }
+
+    // TEST 4: Compare tables with users in different order
+    failed = false;
+    start_test(test_section, "PERF_USER_4", "Compare tables with users in different order");
+
+    for (i = PERF_TEST_ELEMENTS - 1; i >= 0; i--) {
+        if (i % 3 != 0) {
+            sprintf(username, "user%d", i);
+            user_init(&user, username, "name", "mail@uoc.edu");
+            userTable_add(&usersReversed, &user);
+            user_free(&user);
+        }
+    }
+
+    if (!userTable_equals(&users, &usersReversed)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_USER_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_USER_4", true);
+    }
+
+    userTable_free(&users);
+    userTable_free(&usersReversed);
+
+    return passed;
+}
+
+// Run tests for the capacity management of the tables
+bool run_perf_capacity(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i;
+    char name[32];
+    tUser user;
+    tUserTable users;
+    tSeries series;
+    tFilm film;
+    tFilmTable films;
+    tView view;
+    tViewLog viewLog;
+    tDateTime* dt;
+    tUser* usersBlock;
+
+    userTable_init(&users);
+    filmTable_init(&films);
+    viewLog_init(&viewLog);
+    series_init(&series, "Series", DRAMA);
+
+    // TEST 1: Reserve memory in advance
+    failed = false;
+    start_test(test_section, "PERF_CAPACITY_1", "Reserve memory for the tables");
+
+    if (userTable_reserve(&users, PERF_TEST_ELEMENTS) != OK || users.capacity != PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    if (filmTable_reserve(&films, PERF_TEST_ELEMENTS) != OK || films.capacity != PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    if (viewLog_reserve(&viewLog, PERF_TEST_ELEMENTS) != OK || viewLog.capacity != PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    if (userTable_size(&users) != 0 || filmTable_size(&films) != 0 || viewLog.size != 0) {
+        failed = true;
+    }
+
+    // Adding the reserved elements must not move the memory block
+    usersBlock = users.elements;
+    for (i = 0; i < PERF_TEST_ELEMENTS && !failed; i++) {
+        sprintf(name, "user%d", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_add(&users, &user);
+        user_free(&user);
+    }
+    if (users.elements != usersBlock || users.capacity != PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_CAPACITY_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_CAPACITY_1", true);
+    }
+
+    // TEST 2: Capacity grows geometrically
+    failed = false;
+    start_test(test_section, "PERF_CAPACITY_2", "Capacity grows geometrically");
+
+    dt = setDateTime(1, 10, 2019, 22, 30);
+    for (i = 0; i < PERF_TEST_ELEMENTS + 1; i++) {
+        sprintf(name, "film%d", i);
+        film_init(&film, name, 60, &series);
+        filmTable_add(&films, &film);
+        film_free(&film);
+
+        view_init(&view, dt, 5, &users.elements[0], &films.elements[0]);
+        viewLog_add(&viewLog, &view);
+        view_free(&view);
+    }
+    free(dt);
+
+    if (filmTable_size(&films) != PERF_TEST_ELEMENTS + 1 || films.capacity != 2 * PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    if (viewLog.size != PERF_TEST_ELEMENTS + 1 || viewLog.capacity != 2 * PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_CAPACITY_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_CAPACITY_2", true);
+    }
+
+    // TEST 3: Shrink the tables to their size
+    failed = false;
+    start_test(test_section, "PERF_CAPACITY_3", "Shrink the tables to their size");
+
+    for (i = 0; i < PERF_TEST_ELEMENTS / 2; i++) {
+        sprintf(name, "user%d", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_remove(&users, &user);
+        user_free(&user);
+    }
+
+    if (users.capacity != PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    if (userTable_shrinkToFit(&users) != OK || users.capacity != PERF_TEST_ELEMENTS / 2) {
+        failed = true;
+    }
+    if (filmTable_shrinkToFit(&films) != OK || films.capacity != PERF_TEST_ELEMENTS + 1) {
+        failed = true;
+    }
+    if (viewLog_shrinkToFit(&viewLog) != OK || viewLog.capacity != PERF_TEST_ELEMENTS + 1) {
+        failed = true;
+    }
+    if (userTable_find(&users, "user999") == NULL || filmTable_find(&films, "film1000") == NULL) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_CAPACITY_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_CAPACITY_3", true);
+    }
+
+    viewLog_free(&viewLog);
+    filmTable_free(&films);
+    userTable_free(&users);
+    series_free(&series);
+
+    return passed;
+}
+
+// Run tests for view logs bound to the tables of users and films
+bool run_perf_boundViewLog(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tError err;
+    tUser user;
+    tUser *alice, *bob;
+    tUserTable users;
+    tSeries series[2];
+    tFilm film;
+    tFilm *films[3];
+    tFilmTable filmTable;
+    tView view;
+    tViewLog viewLog, unboundLog;
+    tDateTime* dt;
+
+    userTable_init(&users);
+    filmTable_init(&filmTable);
+    viewLog_init(&viewLog);
+    viewLog_init(&unboundLog);
+
+    user_init(&user, "alice", "Alice", "alice@uoc.edu");
+    userTable_add(&users, &user);
+    user_free(&user);
+    user_init(&user, "bob", "Bob", "bob@uoc.edu");
+    userTable_add(&users, &user);
+    user_free(&user);
+
+    series_init(&series[0], "Stranger Things", SCIENCE_FICTION);
+    series_init(&series[1], "Breaking Bad", DRAMA);
+    film_init(&film, "The Vanishing of Will Byers", 49, &series[0]);
+    filmTable_add(&filmTable, &film);
+    film_free(&film);
+    film_init(&film, "Pilot", 58, &series[1]);
+    filmTable_add(&filmTable, &film);
+    film_free(&film);
+    film_init(&film, "Cat's in the Bag...", 48, &series[1]);
+    filmTable_add(&filmTable, &film);
+    film_free(&film);
+
+    alice = userTable_find(&users, "alice");
+    bob = userTable_find(&users, "bob");
+    films[0] = filmTable_find(&filmTable, "The Vanishing of Will Byers");
+    films[1] = filmTable_find(&filmTable, "Pilot");
+    films[2] = filmTable_find(&filmTable, "Cat's in the Bag...");
+
+    // TEST 1: Add views to a bound log
+    failed = false;
+    start_test(test_section, "PERF_BOUND_1", "Add views to a bound log");
+
+    if (viewLog_bind(&viewLog, &users, &filmTable) != OK) {
+        failed = true;
+    }
+
+    dt = setDateTime(1, 10, 2019, 22, 30);
+    view_initRef(&view, dt, 4, alice, films[0]);
+    if (viewLog_add(&viewLog, &view) != OK) {
+        failed = true;
+    }
+    view_initRef(&view, dt, 3, bob, films[1]);
+    viewLog_add(&viewLog, &view);
+    view_initRef(&view, dt, 5, bob, films[2]);
+    viewLog_add(&viewLog, &view);
+
+    // A user given by value is found by username
+    user_init(&user, "alice", "Alice", "alice@uoc.edu");
+    view_initRef(&view, dt, 2, &user, films[1]);
+    viewLog_add(&viewLog, &view);
+    user_free(&user);
+
+    if (viewLog.size != 4) {
+        failed = true;
+    }
+    else if (viewLog.elements[0].user != NULL || viewLog.elements[0].film != NULL) {
+        failed = true;
+    }
+    else if (viewLog_getUser(&viewLog, 2) != bob || viewLog_getFilm(&viewLog, 2) != films[2]) {
+        failed = true;
+    }
+    else if (viewLog_getUser(&viewLog, 3) != alice || viewLog_getFilm(&viewLog, 3) != films[1]) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_BOUND_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_BOUND_1", true);
+    }
+
+    // TEST 2: Views of unknown users are rejected
+    failed = false;
+    start_test(test_section, "PERF_BOUND_2", "Reject views of unknown users");
+
+    user_init(&user, "sam", "Sam", "sam@uoc.edu");
+    view_initRef(&view, dt, 2, &user, films[1]);
+    err = viewLog_add(&viewLog, &view);
+
+    if (err != ERR_NOT_FOUND || viewLog.size != 4) {
+        failed = true;
+    }
+    if (viewLog_getFavFilm(&viewLog, &user) != NULL || viewLog_getFavGenre(&viewLog, &user) != GENRE_NOT_FOUND) {
+        failed = true;
+    }
+    user_free(&user);
+
+    // Only empty logs can be bound
+    view_init(&view, dt, 2, alice, films[1]);
+    viewLog_add(&unboundLog, &view);
+    view_free(&view);
+    if (viewLog_bind(&unboundLog, &users, &filmTable) != ERR_INVALID) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_BOUND_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_BOUND_2", true);
+    }
+
+    // TEST 3: Queries over a bound log
+    failed = false;
+    start_test(test_section, "PERF_BOUND_3", "Favorite film and genre in a bound log");
+
+    if (viewLog_getFavFilm(&viewLog, alice) != films[0] || viewLog_getFavFilm(&viewLog, bob) != films[2]) {
+        failed = true;
+    }
+    if (viewLog_getFavGenre(&viewLog, alice) != SCIENCE_FICTION || viewLog_getFavGenre(&viewLog, bob) != DRAMA) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_BOUND_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_BOUND_3", true);
+    }
+
+    free(dt);
+    viewLog_free(&viewLog);
+    viewLog_free(&unboundLog);
+    filmTable_free(&filmTable);
+    userTable_free(&users);
+    series_free(&series[0]);
+    series_free(&series[1]);
+
+    return passed;
+}
+
+// Run tests for the columnar copy of the view log
+bool run_perf_viewColumns(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tViewLog rowLog, columnLog, unboundLog;
+    tDateTime dt;
+
+    perf_initCatalog(series, &films, &users, 40, 30);
+    viewLog_init(&rowLog);
+    viewLog_init(&columnLog);
+    viewLog_init(&unboundLog);
+    viewLog_bind(&rowLog, &users, &films);
+    viewLog_bind(&columnLog, &users, &films);
+
+    // TEST 1: Pack and unpack timestamps
+    failed = false;
+    start_test(test_section, "PERF_COLUMNS_1", "Pack and unpack timestamps");
+
+    dt.year = 2019;
+    dt.month = 9;
+    dt.day = 30;
+    dt.hour = 22;
+    dt.minute = 24;
+    if (dateTime_pack(&dt) != 26164704) {
+        failed = true;
+    }
+    dt.year = 2000;
+    dt.month = 2;
+    dt.day = 29;
+    dt.hour = 23;
+    dt.minute = 59;
+    if (dateTime_pack(&dt) != 15864479) {
+        failed = true;
+    }
+    dt = dateTime_unpack(15864479 + 1);
+    if (dt.year != 2000 || dt.month != 3 || dt.day != 1 || dt.hour != 0 || dt.minute != 0) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_COLUMNS_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_COLUMNS_1", true);
+    }
+
+    // TEST 2: Enable columns on an existing log
+    failed = false;
+    start_test(test_section, "PERF_COLUMNS_2", "Enable columns on a bound log");
+
+    perf_addViews(&rowLog, &films, &users, 500, 1);
+    perf_addViews(&columnLog, &films, &users, 500, 1);
+
+    if (viewLog_enableColumns(&unboundLog) != ERR_INVALID) {
+        failed = true;
+    }
+    if (viewLog_enableColumns(&columnLog) != OK || columnLog.columns == NULL) {
+        failed = true;
+    }
+    else {
+        for (i = 0; i < columnLog.size && !failed; i++) {
+            if (columnLog.columns->userId[i] != columnLog.elements[i].userId
+                    || columnLog.columns->score[i] != columnLog.elements[i].score
+                    || columnLog.columns->minutes[i] != columnLog.elements[i].minutes
+                    || columnLog.columns->timestamp[i] != dateTime_pack(&columnLog.elements[i].timestamp)
+                    || columnLog.columns->genre[i] != viewLog_getFilm(&columnLog, i)->series->genre) {
+                failed = true;
+            }
+        }
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_COLUMNS_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_COLUMNS_2", true);
+    }
+
+    // TEST 3: Queries on columns give the same results than on rows
+    failed = false;
+    start_test(test_section, "PERF_COLUMNS_3", "Queries on columns match queries on rows");
+
+    // Add more views once the columns are enabled
+    perf_addViews(&rowLog, &films, &users, 500, 2);
+    perf_addViews(&columnLog, &films, &users, 500, 2);
+
+    for (i = 0; i < users.size && !failed; i++) {
+        if (viewLog_getFavFilm(&rowLog, &users.elements[i]) != viewLog_getFavFilm(&columnLog, &users.elements[i])) {
+            failed = true;
+        }
+        if (viewLog_getFavGenre(&rowLog, &users.elements[i]) != viewLog_getFavGenre(&columnLog, &users.elements[i])) {
+            failed = true;
+        }
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_COLUMNS_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_COLUMNS_3", true);
+    }
+
+    viewLog_free(&rowLog);
+    viewLog_free(&columnLog);
+    viewLog_free(&unboundLog);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the index of views per user
+bool run_perf_userViewIndex(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i, j, count;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tUser user;
+    tViewLog rowLog, indexedLog;
+    tPostings* views;
+
+    perf_initCatalog(series, &films, &users, 40, 30);
+    viewLog_init(&rowLog);
+    viewLog_init(&indexedLog);
+    viewLog_bind(&rowLog, &users, &films);
+    viewLog_bind(&indexedLog, &users, &films);
+
+    // TEST 1: Index the views of each user
+    failed = false;
+    start_test(test_section, "PERF_USERVIEWS_1", "Index the views of each user");
+
+    perf_addViews(&rowLog, &films, &users, 400, 3);
+    perf_addViews(&indexedLog, &films, &users, 400, 3);
+    if (viewLog_enableUserIndex(&indexedLog) != OK) {
+        failed = true;
+    }
+    perf_addViews(&rowLog, &films, &users, 400, 4);
+    perf_addViews(&indexedLog, &films, &users, 400, 4);
+
+    // A new user, added to the table after the index was created
+    user_init(&user, "newcomer", "name", "mail@uoc.edu");
+    userTable_add(&users, &user);
+    user_free(&user);
+    if (viewLog_getUserViews(&indexedLog, userTable_find(&users, "newcomer")) != NULL) {
+        failed = true;
+    }
+    perf_addViews(&rowLog, &films, &users, 200, 5);
+    perf_addViews(&indexedLog, &films, &users, 200, 5);
+
+    for (i = 0; i < users.size && !failed; i++) {
+        views = viewLog_getUserViews(&indexedLog, &users.elements[i]);
+        count = 0;
+        for (j = 0; j < indexedLog.size; j++) {
+            if (indexedLog.elements[j].userId == i) {
+                if (views == NULL || count >= views->size || views->elements[count] != j) {
+                    failed = true;
+                }
+                count++;
+            }
+        }
+        if ((views == NULL && count != 0) || (views != NULL && views->size != count)) {
+            failed = true;
+        }
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_USERVIEWS_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_USERVIEWS_1", true);
+    }
+
+    // TEST 2: Queries with the index give the same results than without it
+    failed = false;
+    start_test(test_section, "PERF_USERVIEWS_2", "Queries with the user index match full scans");
+
+    for (i = 0; i < users.size && !failed; i++) {
+        if (viewLog_getFavFilm(&rowLog, &users.elements[i]) != viewLog_getFavFilm(&indexedLog, &users.elements[i])) {
+            failed = true;
+        }
+        if (viewLog_getFavGenre(&rowLog, &users.elements[i]) != viewLog_getFavGenre(&indexedLog, &users.elements[i])) {
+            failed = true;
+        }
+    }
+
+    // Same results when the columns are enabled too
+    viewLog_enableColumns(&indexedLog);
+    for (i = 0; i < users.size && !failed; i++) {
+        if (viewLog_getFavGenre(&rowLog, &users.elements[i]) != viewLog_getFavGenre(&indexedLog, &users.elements[i])) {
+            failed = true;
+        }
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_USERVIEWS_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_USERVIEWS_2", true);
+    }
+
+    viewLog_free(&rowLog);
+    viewLog_free(&indexedLog);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the aggregates of the favorites of a user
+bool run_perf_favoriteAggregates(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i, k;
+    unsigned int length, count[PERF_TEST_SERIES];
+    unsigned int seed = 11;
+    tSeries series[PERF_TEST_SERIES];
+    tSeries other;
+    tSeries* released;
+    tSeries* top[2];
+    tFilmTable films;
+    tUserTable users;
+    tUser user;
+    tFilm* film;
+    tFilm releasedFilm;
+
+    perf_initCatalog(series, &films, &users, 50, 1);
+    user_init(&user, "fan", "name", "mail@uoc.edu");
+    series_init(&other, "series0", CRIME);
+
+    // TEST 1: Aggregates are updated when favorites are added
+    failed = false;
+    start_test(test_section, "PERF_FAVAGGS_1", "Aggregates follow added favorites");
+
+    if (user_getFavoriteGenre(&user) != GENRE_NOT_FOUND || user_getFavsLengthInMin(&user) != 0
+            || user_getFavsCntPerSeries(&user, &series[0]) != 0) {
+        failed = true;
+    }
+
+    length = 0;
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        // Favor the films of the first series
+        k = (i % 3 == 0) ? 0 : perf_random(&seed) % films.size;
+        film = &films.elements[k];
+        if (user_addFavorite(&user, *film) != OK) {
+            failed = true;
+        }
+        length += film->lengthInMin;
+        count[k % PERF_TEST_SERIES]++;
+    }
+
+    if (user_getFavsLengthInMin(&user) != length || user_getFavoriteGenre(&user) != series[0].genre) {
+        failed = true;
+    }
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        if (user_getFavsCntPerSeries(&user, &series[i]) != count[i]) {
+            failed = true;
+        }
+    }
+
+    // Same title but other genre is another series
+    if (user_getFavsCntPerSeries(&user, &other) != 0) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FAVAGGS_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FAVAGGS_1", true);
+    }
+
+    // TEST 2: Aggregates are updated when favorites are removed
+    failed = false;
+    start_test(test_section, "PERF_FAVAGGS_2", "Aggregates follow removed favorites");
+
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        film = &user.favorites.first->e.film;
+        length -= film->lengthInMin;
+        for (k = 0; k < PERF_TEST_SERIES; k++) {
+            if (film->series == &series[k]) {
+                count[k]--;
+            }
+        }
+        if (user_popFavorite(&user) != OK) {
+            failed = true;
+        }
+        if (i % 100 == 0) {
+            if (user_getFavsLengthInMin(&user) != length) {
+                failed = true;
+            }
+            for (k = 0; k < PERF_TEST_SERIES; k++) {
+                if (user_getFavsCntPerSeries(&user, &series[k]) != count[k]) {
+                    failed = true;
+                }
+            }
+        }
+    }
+
+    if (user_getFavoriteGenre(&user) != GENRE_NOT_FOUND || user_getFavsLengthInMin(&user) != 0
+            || user_getFavsCntPerSeries(&user, &series[0]) != 0) {
+        failed = true;
+    }
+    if (user_popFavorite(&user) != ERR_INVALID) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FAVAGGS_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FAVAGGS_2", true);
+    }
+
+    // TEST 3: Series released after their last favorite is removed are not read
+    failed = false;
+    start_test(test_section, "PERF_FAVAGGS_3", "Remove the counts of series with no favorites");
+
+    released = (tSeries*)malloc(sizeof(tSeries));
+    if (released == NULL || series_init(released, "Released series", MISTERY) != OK) {
+        failed = true;
+    }
+    else {
+        film_init(&releasedFilm, "Released film", 90, released);
+        if (user_addFavorite(&user, releasedFilm) != OK || user_addFavorite(&user, films.elements[0]) != OK) {
+            failed = true;
+        }
+        film_free(&releasedFilm);
+
+        // Pop both, the count of the released series must go with its last favorite
+        user_popFavorite(&user);
+        user_popFavorite(&user);
+        if (user.favsPerSeries.size != 0) {
+            failed = true;
+        }
+        series_free(released);
+        free(released);
+
+        // A new series with the same title gets its own count
+        series_free(&other);
+        series_init(&other, "Released series", MISTERY);
+        film_init(&releasedFilm, "Released film", 90, &other);
+        if (user_addFavorite(&user, releasedFilm) != OK || user_addFavorite(&user, films.elements[0]) != OK
+                || user_addFavorite(&user, releasedFilm) != OK) {
+            failed = true;
+        }
+        film_free(&releasedFilm);
+        if (user_getFavsCntPerSeries(&user, &other) != 2 || user_getFavsCntPerSeries(&user, &series[0]) != 1) {
+            failed = true;
+        }
+        if (user_getTopSeries(&user, 2, top, count, &length) != OK || length != 2
+                || top[0] != &other || count[0] != 2 || top[1] != &series[0] || count[1] != 1) {
+            failed = true;
+        }
+
+        // Removing an entry keeps the others in order and indexed
+        user_popFavorite(&user);
+        user_popFavorite(&user);
+        if (user_getFavsCntPerSeries(&user, &other) != 1 || user_getFavsCntPerSeries(&user, &series[0]) != 0
+                || user.favsPerSeries.size != 1) {
+            failed = true;
+        }
+        user_popFavorite(&user);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FAVAGGS_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FAVAGGS_3", true);
+    }
+
+    series_free(&other);
+    user_free(&user);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the iteration over stacks of favorites
+bool run_perf_favoriteIterator(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i, pending;
+    unsigned int length, count;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tFavoriteStack stack1, stack2;
+    tFavoriteStackIterator it;
+    tFavorite favorite;
+    const tFavorite* current;
+
+    // Big stacks, that can not be walked with one recursive call per element
+    perf_initCatalog(series, &films, &users, 50, 1);
+    favoriteStack_create(&stack1);
+    favoriteStack_create(&stack2);
+    length = 0;
+    count = 0;
+    for (i = 0; i < PERF_TEST_ELEMENTS * 50; i++) {
+        favorite.film = films.elements[i % films.size];
+        favoriteStack_push(&stack1, favorite);
+        favoriteStack_push(&stack2, favorite);
+        length += favorite.film.lengthInMin;
+        if (favorite.film.series == &series[0]) {
+            count++;
+        }
+    }
+
+    // TEST 1: Iterate a stack without modifying it
+    failed = false;
+    start_test(test_section, "PERF_FAVITER_1", "Iterate a stack in place");
+
+    favoriteStackIterator_init(&it, &stack1);
+    i = PERF_TEST_ELEMENTS * 50;
+    while (favoriteStackIterator_hasNext(&it) && !failed) {
+        i--;
+        current = favoriteStackIterator_next(&it);
+        if (current->film.series != films.elements[i % films.size].series
+                || strcmp(current->film.title, films.elements[i % films.size].title) != 0) {
+            failed = true;
+        }
+    }
+    if (i != 0 || stack1.first == NULL) {
+        failed = true;
+    }
+
+    // The iteration stops when the callback returns false
+    pending = 10;
+    if (favoriteStack_foreach(&stack1, perf_visitFavorites, &pending) || pending != 0) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FAVITER_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FAVITER_1", true);
+    }
+
+    // TEST 2: Aggregates and compare on big stacks
+    failed = false;
+    start_test(test_section, "PERF_FAVITER_2", "Aggregates and compare on big stacks");
+
+    if (favoriteStack_getFavsLengthInMinRecursive(&stack1) != length
+            || favoriteStack_getFavsCntPerSeriesRecursive(&stack1, &series[0]) != count) {
+        failed = true;
+    }
+    if (!favoriteStack_compare(stack1, stack2)) {
+        failed = true;
+    }
+
+    // Stacks with different length or different top are not equal
+    favoriteStack_pop(&stack2);
+    if (favoriteStack_compare(stack1, stack2) || favoriteStack_compare(stack2, stack1)) {
+        failed = true;
+    }
+    favorite.film = films.elements[0];
+    favoriteStack_push(&stack2, favorite);
+    if (favoriteStack_compare(stack1, stack2)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FAVITER_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FAVITER_2", true);
+    }
+
+    favoriteStack_free(&stack1);
+    favoriteStack_free(&stack2);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the pool of nodes of the stacks of favorites
+bool run_perf_favoritePool(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i;
+    unsigned int available;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tFavoriteStack stack1, stack2;
+    tFavorite favorite;
+    tUser user;
+
+    perf_initCatalog(series, &films, &users, 50, 1);
+    favoriteStack_create(&stack1);
+    favoriteStack_create(&stack2);
+
+    // TEST 1: Popped nodes are reused by the next pushes
+    failed = false;
+    start_test(test_section, "PERF_FAVPOOL_1", "Reuse the nodes of popped favorites");
+
+    favoriteNodePool_release();
+    if (favoriteNodePool_available() != 0 || favoriteNodePool_reserve(10) != OK
+            || favoriteNodePool_available() != 10) {
+        failed = true;
+    }
+
+    // Churn of a user adding and removing favorites
+    user_init(&user, "churn", "name", "mail@uoc.edu");
+    for (i = 0; i < PERF_TEST_ELEMENTS && !failed; i++) {
+        user_addFavorite(&user, films.elements[i % films.size]);
+        user_addFavorite(&user, films.elements[(i + 1) % films.size]);
+        user_popFavorite(&user);
+        user_popFavorite(&user);
+        if (favoriteNodePool_available() != 10) {
+            failed = true;
+        }
+    }
+    user_free(&user);
+
+    if (failed) {
+        end_test(test_section, "PERF_FAVPOOL_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FAVPOOL_1", true);
+    }
+
+    // TEST 2: Free stacks return all their nodes to the pool
+    failed = false;
+    start_test(test_section, "PERF_FAVPOOL_2", "Return whole stacks to the pool");
+
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        favorite.film = films.elements[i % films.size];
+        favoriteStack_push(&stack1, favorite);
+    }
+    if (stack1.count != PERF_TEST_ELEMENTS || favoriteNodePool_available() != 0) {
+        failed = true;
+    }
+
+    favoriteStack_duplicate(&stack2, stack1);
+    favoriteStack_free(&stack1);
+    available = favoriteNodePool_available();
+    if (available != PERF_TEST_ELEMENTS || stack1.first != NULL || stack1.last != NULL || stack1.count != 0) {
+        failed = true;
+    }
+
+    // Reused nodes keep their new films
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        favorite.film = films.elements[i % films.size];
+        favoriteStack_push(&stack1, favorite);
+    }
+    if (!favoriteStack_compare(stack1, stack2) || favoriteNodePool_available() != 0) {
+        failed = true;
+    }
+
+    favoriteStack_free(&stack1);
+    favoriteStack_free(&stack2);
+    if (favoriteNodePool_available() != 2 * PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    favoriteNodePool_release();
+    if (favoriteNodePool_available() != 0) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FAVPOOL_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FAVPOOL_2", true);
+    }
+
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the pool of interned strings
+bool run_perf_intern(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    unsigned int size;
+    tSeries series1, series2;
+    tFilm film1, film2;
+    tUser user1, user2;
+    tFavoriteStack stack;
+    tFavorite favorite;
+    const char* title;
+
+    // TEST 1: Equal strings share the same copy
+    failed = false;
+    start_test(test_section, "PERF_INTERN_1", "Share equal strings");
+
+    size = intern_size();
+    series_init(&series1, "Interned series", DRAMA);
+    series_init(&series2, "Interned series", DRAMA);
+    film_init(&film1, "Interned film", 50, &series1);
+    film_init(&film2, "Interned film", 50, &series2);
+    user_init(&user1, "interned", "Name", "mail@uoc.edu");
+    user_init(&user2, "interned", "Other name", "other@uoc.edu");
+
+    if (intern_size() != size + 3 || series1.title != series2.title || film1.title != film2.title 
+            || user1.username != user2.username || intern_refs(film1.title) != 2) {
+        failed = true;
+    }
+    if (!series_equals(&series1, &series2) || !film_equals(&film1, &film2) || user_equals(&user1, &user2)) {
+        failed = true;
+    }
+
+    // Favorites hold references to the same title
+    favoriteStack_create(&stack);
+    favorite.film = film1;
+    favoriteStack_push(&stack, favorite);
+    favoriteStack_push(&stack, favorite);
+    if (stack.first->e.film.title != film1.title || intern_refs(film1.title) != 4) {
+        failed = true;
+    }
+    favoriteStack_free(&stack);
+    favoriteNodePool_release();
+    if (intern_refs(film1.title) != 2) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_INTERN_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_INTERN_1", true);
+    }
+
+    // TEST 2: Strings are released with their last reference
+    failed = false;
+    start_test(test_section, "PERF_INTERN_2", "Release strings with their last reference");
+
+    title = series1.title;
+    if (series_mdfyTitle(&series1, "Renamed series") != OK || strcmp(series1.title, "Renamed series") != 0
+            || intern_refs(title) != 1 || intern_size() != size + 4) {
+        failed = true;
+    }
+    if (series_equals(&series1, &series2)) {
+        failed = true;
+    }
+
+    // Renaming to the same title keeps the string
+    if (series_mdfyTitle(&series1, series1.title) != OK || strcmp(series1.title, "Renamed series") != 0
+            || intern_refs(series1.title) != 1) {
+        failed = true;
+    }
+
+    film_free(&film1);
+    film_free(&film2);
+    user_free(&user1);
+    user_free(&user2);
+    series_free(&series1);
+    series_free(&series2);
+    if (intern_size() != size) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_INTERN_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_INTERN_2", true);
+    }
+
+    return passed;
+}
+
+// Run tests for the modes to remove elements from the tables
+bool run_perf_removeModes(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i, j;
+    char name[32];
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users, reference;
+    tUser user;
+    tViewLog views;
+    tRecommender recommender;
+    const char* names[200];
+    int mode;
+    unsigned int position, last, size;
+    tPostings* list;
+
+    // TEST 1: Remove elements keeping the order
+    failed = false;
+    start_test(test_section, "PERF_REMOVE_1", "Remove elements shifting the next ones");
+
+    perf_initCatalog(series, &films, &users, 101, PERF_TEST_ELEMENTS);
+    if (!perf_removeOdd(&films, &users, 101, PERF_TEST_ELEMENTS)) {
+        failed = true;
+    }
+    // The order is kept
+    for (i = 0; i < users.size; i++) {
+        sprintf(name, "user%d", 2 * i);
+        if (strcmp(users.elements[i].username, name) != 0 || userTable_find(&users, name) != &users.elements[i]) {
+            failed = true;
+        }
+    }
+    for (i = 0; i < films.size; i++) {
+        sprintf(name, "film%d", 2 * i);
+        if (strcmp(films.elements[i].title, name) != 0 || filmTable_find(&films, name) != &films.elements[i]) {
+            failed = true;
+        }
+    }
+    perf_freeCatalog(series, &films, &users);
+
+    if (failed) {
+        end_test(test_section, "PERF_REMOVE_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_REMOVE_1", true);
+    }
+
+    // TEST 2: Remove elements swapping them with the last one
+    failed = false;
+    start_test(test_section, "PERF_REMOVE_2", "Remove elements swapping with the last one");
+
+    perf_initCatalog(series, &films, &users, 101, PERF_TEST_ELEMENTS);
+    userTable_setRemoveMode(&users, TABLE_REMOVE_SWAP);
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_SWAP);
+    if (!perf_removeOdd(&films, &users, 101, PERF_TEST_ELEMENTS)) {
+        failed = true;
+    }
+    if (users.size != PERF_TEST_ELEMENTS / 2 || films.size != 51) {
+        failed = true;
+    }
+    for (i = 0; i < users.size; i++) {
+        if (&users.elements[i] != userTable_find(&users, users.elements[i].username)) {
+            failed = true;
+        }
+    }
+    for (i = 0; i < films.size; i++) {
+        if (&films.elements[i] != filmTable_find(&films, films.elements[i].title)) {
+            failed = true;
+        }
+    }
+
+    // Same users than a table where they were never added
+    userTable_init(&reference);
+    for (i = PERF_TEST_ELEMENTS - 2; i >= 0; i -= 2) {
+        sprintf(name, "user%d", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_add(&reference, &user);
+        user_free(&user);
+    }
+    if (!userTable_equals(&users, &reference)) {
+        failed = true;
+    }
+    perf_freeCatalog(series, &films, &users);
+
+    if (failed) {
+        end_test(test_section, "PERF_REMOVE_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_REMOVE_2", true);
+    }
+
+    // TEST 3: Remove elements leaving tombstones
+    failed = false;
+    start_test(test_section, "PERF_REMOVE_3", "Remove elements leaving tombstones");
+
+    perf_initCatalog(series, &films, &users, 101, PERF_TEST_ELEMENTS);
+    userTable_setRemoveMode(&users, TABLE_REMOVE_TOMBSTONE);
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_TOMBSTONE);
+
+    // Positions do not change until the table is compacted
+    for (i = 0; i < PERF_TEST_ELEMENTS / 4; i++) {
+        userTable_remove(&users, &users.elements[i]);
+    }
+    if (users.size != PERF_TEST_ELEMENTS || users.removed != PERF_TEST_ELEMENTS / 4 
+            || userTable_size(&users) != PERF_TEST_ELEMENTS - PERF_TEST_ELEMENTS / 4
+            || users.elements[0].username != NULL || strcmp(users.elements[PERF_TEST_ELEMENTS - 1].username, "user999") != 0) {
+        failed = true;
+    }
+    if (userTable_find(&users, "user0") != NULL || userTable_find(&users, "user250") != &users.elements[250]) {
+        failed = true;
+    }
+    if (!userTable_equals(&users, &users)) {
+        failed = true;
+    }
+
+    // Removing more than half of the table compacts it
+    for (i = PERF_TEST_ELEMENTS / 4; i < PERF_TEST_ELEMENTS / 2; i++) {
+        userTable_remove(&users, &users.elements[i]);
+    }
+    if (users.size != PERF_TEST_ELEMENTS / 2 || users.removed != 0
+            || strcmp(users.elements[0].username, "user500") != 0) {
+        failed = true;
+    }
+    for (i = 0; i < users.size; i++) {
+        if (&users.elements[i] != userTable_find(&users, users.elements[i].username)) {
+            failed = true;
+        }
+    }
+
+    // Leaving the mode compacts the table
+    filmTable_remove(&films, &films.elements[10]);
+    filmTable_remove(&films, &films.elements[20]);
+    if (films.size != 101 || films.removed != 2) {
+        failed = true;
+    }
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_SHIFT);
+    if (films.size != 99 || films.removed != 0 || filmTable_find(&films, "film21") != &films.elements[19]) {
+        failed = true;
+    }
+    for (j = 0; j < films.size; j++) {
+        if (&films.elements[j] != filmTable_find(&films, films.elements[j].title)) {
+            failed = true;
+        }
+    }
+
+    perf_freeCatalog(series, &films, &users);
+
+    // Same results than other modes, compacting the table during the removals
+    perf_initCatalog(series, &films, &users, 101, PERF_TEST_ELEMENTS);
+    userTable_setRemoveMode(&users, TABLE_REMOVE_TOMBSTONE);
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_TOMBSTONE);
+    if (!perf_removeOdd(&films, &users, 101, PERF_TEST_ELEMENTS) || !userTable_equals(&users, &reference)) {
+        failed = true;
+    }
+    perf_freeCatalog(series, &films, &users);
+
+    if (failed) {
+        end_test(test_section, "PERF_REMOVE_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_REMOVE_3", true);
+    }
+
+    // TEST 4: Keep the positions referenced by logs and recommenders
+    failed = false;
+    start_test(test_section, "PERF_REMOVE_4", "Keep the positions referenced by logs and recommenders");
+
+    perf_initCatalog(series, &films, &users, 20, 20);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    viewLog_enableUserIndex(&views);
+    perf_addViews(&views, &films, &users, 200, 7);
+    for (i = 0; i < 200; i++) {
+        names[i] = viewLog_getUser(&views, i)->username;
+    }
+    if (users.references != 1 || films.references != 1) {
+        failed = true;
+    }
+
+    // The other elements can not be moved
+    userTable_setRemoveMode(&users, TABLE_REMOVE_SWAP);
+    if (userTable_remove(&users, &users.elements[3]) != ERR_INVALID || users.size != 20
+            || userTable_find(&users, "user3") != &users.elements[3]) {
+        failed = true;
+    }
+    userTable_setRemoveMode(&users, TABLE_REMOVE_SHIFT);
+    if (userTable_remove(&users, &users.elements[3]) != ERR_INVALID
+            || filmTable_remove(&films, &films.elements[3]) != ERR_INVALID || films.size != 20) {
+        failed = true;
+    }
+
+    // Tombstones keep the positions, and the table is not compacted
+    userTable_setRemoveMode(&users, TABLE_REMOVE_TOMBSTONE);
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_TOMBSTONE);
+    for (i = 0; i < 15; i++) {
+        if (userTable_remove(&users, &users.elements[i]) != OK) {
+            failed = true;
+        }
+    }
+    if (filmTable_remove(&films, &films.elements[3]) != OK || users.size != 20 || users.removed != 15 
+            || userTable_compact(&users) != ERR_INVALID || filmTable_compact(&films) != ERR_INVALID) {
+        failed = true;
+    }
+    userTable_setRemoveMode(&users, TABLE_REMOVE_SHIFT);
+    if (users.size != 20 || userTable_find(&users, "user17") != &users.elements[17]) {
+        failed = true;
+    }
+    for (i = 0; i < 200; i++) {
+        user = *viewLog_getUser(&views, i);
+        if ((views.elements[i].userId < 15) ? user.username != NULL : user.username != names[i]) {
+            failed = true;
+        }
+    }
+
+    // Once the log is released, the tables can be compacted
+    viewLog_free(&views);
+    if (users.references != 0 || films.references != 0 || userTable_compact(&users) != OK || users.size != 5
+            || filmTable_compact(&films) != OK || films.size != 19) {
+        failed = true;
+    }
+
+    // Recommenders keep the positions too
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_SHIFT);
+    recommender_init(&recommender, &users, &films);
+    if (filmTable_remove(&films, &films.elements[0]) != ERR_INVALID || films.size != 19) {
+        failed = true;
+    }
+    recommender_free(&recommender);
+    if (films.references != 0 || filmTable_remove(&films, &films.elements[0]) != OK || films.size != 18) {
+        failed = true;
+    }
+    perf_freeCatalog(series, &films, &users);
+
+    if (failed) {
+        end_test(test_section, "PERF_REMOVE_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_REMOVE_4", true);
+    }
+
+    // TEST 5: Films are taken out of the lists of genres and series by their offset
+    failed = false;
+    start_test(test_section, "PERF_REMOVE_5", "Remove films from the lists in constant time");
+
+    perf_initCatalog(series, &films, &users, PERF_TEST_ELEMENTS, 1);
+    for (mode = TABLE_REMOVE_SWAP; mode <= TABLE_REMOVE_TOMBSTONE; mode++) {
+        filmTable_setRemoveMode(&films, (tRemoveMode)mode);
+        for (i = 0; i < 100; i++) {
+            // Scattered films, not yet removed
+            position = (i * 37 + mode) % films.size;
+            while (films.elements[position].title == NULL) {
+                position = (position + 1) % films.size;
+            }
+            list = filmTable_getGenreFilms(&films, films.elements[position].series->genre);
+            for (j = 0; list->elements[j] != position; j++);
+            last = list->elements[list->size - 1];
+            size = list->size;
+
+            // The last film of the list takes the offset of the removed one. 
+            // In TABLE_REMOVE_SWAP mode it can also be the film that moves
+            if (mode == TABLE_REMOVE_SWAP && last == films.size - 1) {
+                last = position;
+            }
+            if (filmTable_remove(&films, &films.elements[position]) != OK || list->size != size - 1
+                    || (j < list->size && list->elements[j] != last)) {
+                failed = true;
+            }
+        }
+        if (!perf_checkFilmIndexes(&films, series)) {
+            failed = true;
+        }
+    }
+
+    // Shifting keeps the order of the lists
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_SHIFT);
+    list = filmTable_getSeriesFilms(&films, &series[0]);
+    last = films.elements[list->elements[list->size - 1]].titleHash;
+    filmTable_remove(&films, &films.elements[list->elements[0]]);
+    if (films.elements[list->elements[list->size - 1]].titleHash != last || !perf_checkFilmIndexes(&films, series)) {
+        failed = true;
+    }
+    perf_freeCatalog(series, &films, &users);
+
+    if (failed) {
+        end_test(test_section, "PERF_REMOVE_5", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_REMOVE_5", true);
+    }
+
+    userTable_free(&reference);
+
+    return passed;
+}
+
+// Run tests for the bulk loader of delimited files
+bool run_perf_loader(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i;
+    char longName[LOADER_MAX_LINE + 10];
+    FILE* file;
+    tLoaderStats stats;
+    tSeriesTable series;
+    tFilmTable films;
+    tUserTable users;
+    tViewLog views;
+    tFilm* film;
+    tUser* user;
+
+    seriesTable_init(&series);
+    filmTable_init(&films);
+    userTable_init(&users);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+
+    // TEST 1: Load users, series and films
+    failed = false;
+    start_test(test_section, "PERF_LOADER_1", "Load users, series and films");
+
+    file = tmpfile();
+    if (file == NULL) {
+        failed = true;
+    }
+    else {
+        fprintf(file, "# title,genre\nChernobyl,3\r\nBlack Mirror,1\n\nChernobyl,2\nBad genre,9\nMissing genre\n");
+        rewind(file);
+        if (loader_loadSeries(file, ',', &series, &stats) != OK || stats.records != 5 || stats.loaded != 2
+                || stats.skipped != 3 || seriesTable_size(&series) != 2 
+                || seriesTable_find(&series, "Black Mirror")->genre != SCIENCE_FICTION) {
+            failed = true;
+        }
+        fclose(file);
+    }
+
+    file = tmpfile();
+    if (file == NULL) {
+        failed = true;
+    }
+    else {
+        fprintf(file, "1:23:45\t60\tChernobyl\nThe National Anthem\t44\tBlack Mirror\nNo series\t10\tOther\n");
+        fprintf(file, "Bad length\tten\tChernobyl\nToo long\t4294967386\tChernobyl\n1:23:45\t60\tChernobyl");
+        rewind(file);
+        if (loader_loadFilms(file, '\t', &series, &films, &stats) != OK || stats.records != 6 
+                || stats.loaded != 2 || filmTable_size(&films) != 2 || filmTable_find(&films, "Too long") != NULL) {
+            failed = true;
+        }
+        film = filmTable_find(&films, "The National Anthem");
+        if (film == NULL || film->lengthInMin != 44 || film->series != seriesTable_find(&series, "Black Mirror")) {
+            failed = true;
+        }
+        fclose(file);
+    }
+
+    // Lines longer than the maximum are skipped
+    file = tmpfile();
+    if (file == NULL) {
+        failed = true;
+    }
+    else {
+        memset(longName, 'a', sizeof(longName) - 1);
+        longName[sizeof(longName) - 1] = '\0';
+        fprintf(file, "%s,Long,long@uoc.edu\n", longName);
+        for (i = 0; i < PERF_TEST_ELEMENTS * 20; i++) {
+            fprintf(file, "user%d,Name %d,user%d@uoc.edu\n", i, i, i);
+        }
+        fprintf(file, "user0,Duplicated,dup@uoc.edu\nbad,record\n");
+        rewind(file);
+        if (loader_loadUsers(file, ',', &users, &stats) != OK || stats.records != PERF_TEST_ELEMENTS * 20 + 3
+                || stats.loaded != PERF_TEST_ELEMENTS * 20 || userTable_size(&users) != PERF_TEST_ELEMENTS * 20) {
+            failed = true;
+        }
+        user = userTable_find(&users, "user12345");
+        if (user == NULL || strcmp(user->name, "Name 12345") != 0 || strcmp(user->mail, "user12345@uoc.edu") != 0) {
+            failed = true;
+        }
+        fclose(file);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_LOADER_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_LOADER_1", true);
+    }
+
+    // TEST 2: Load views
+    failed = false;
+    start_test(test_section, "PERF_LOADER_2", "Load views");
+
+    file = tmpfile();
+    if (file == NULL) {
+        failed = true;
+    }
+    else {
+        for (i = 0; i < PERF_TEST_ELEMENTS * 50; i++) {
+            fprintf(file, "user%d;%s;2019-10-%02d %02d:%02d;%d;%d\n", i % (PERF_TEST_ELEMENTS * 20), 
+                (i % 2 == 0) ? "1:23:45" : "The National Anthem", 1 + i % 28, i % 24, i % 60, i % 10 - 1, i % 60);
+        }
+        fprintf(file, "nobody;1:23:45;2019-10-01 10:00;5;10\n");
+        fprintf(file, "user1;1:23:45;2019-13-01 10:00;5;10\n");
+        fprintf(file, "user1;1:23:45;2019-10-01 10:00;high;10\n");
+        // Scores out of range and numbers that do not fit
+        fprintf(file, "user1;1:23:45;2019-10-01 10:00;10;10\n");
+        fprintf(file, "user1;1:23:45;2019-10-01 10:00;-40000;10\n");
+        fprintf(file, "user1;1:23:45;2019-10-01 10:00;-4294967295;10\n");
+        fprintf(file, "user1;1:23:45;2019-10-01 10:00;5;4294967306\n");
+        fprintf(file, "user1;1:23:45;2019-10-01 10:00;9;99999999999999999999\n");
+        // The highest score
+        fprintf(file, "user1;1:23:45;2019-10-01 10:00;9;10\n");
+        rewind(file);
+        if (loader_loadViews(file, ';', &users, &films, &views, &stats) != OK || stats.loaded != PERF_TEST_ELEMENTS * 50 + 1
+                || stats.skipped != 8 || views.size != PERF_TEST_ELEMENTS * 50 + 1
+                || views.elements[PERF_TEST_ELEMENTS * 50].score != 9) {
+            failed = true;
+        }
+        for (i = 0; i < views.size && !failed; i += 997) {
+            if (viewLog_getUser(&views, i) != &users.elements[i % (PERF_TEST_ELEMENTS * 20)]
+                    || strcmp(viewLog_getFilm(&views, i)->title, (i % 2 == 0) ? "1:23:45" : "The National Anthem") != 0
+                    || views.elements[i].score != i % 10 - 1 || views.elements[i].minutes != i % 60
+                    || views.elements[i].timestamp.day != 1 + i % 28 || views.elements[i].timestamp.hour != i % 24
+                    || views.elements[i].timestamp.minute != i % 60 || views.elements[i].timestamp.year != 2019) {
+                failed = true;
+            }
+        }
+        fclose(file);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_LOADER_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_LOADER_2", true);
+    }
+
+    viewLog_free(&views);
+    filmTable_free(&films);
+    userTable_free(&users);
+    seriesTable_free(&series);
+
+    return passed;
+}
+
+// Run tests for the binary snapshots of the dataset
+bool run_perf_snapshot(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    int i, j;
+    unsigned int seed = 21;
+    const char* path = "perf_snapshot.bin";
+    tSeries series[PERF_TEST_SERIES];
+    tSeriesTable seriesTable, loadedSeries;
+    tFilmTable films, loadedFilms;
+    tUserTable users, loadedUsers;
+    tViewLog views, loadedViews;
+    tView* view;
+    tView* loadedView;
+    tUser* user;
+    FILE* file;
+    char data[16];
+    char truncated[200];
+
+    perf_initCatalog(series, &films, &users, 60, 200);
+    seriesTable_init(&seriesTable);
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        seriesTable_add(&seriesTable, &series[i]);
+    }
+    for (i = 0; i < users.size; i += 3) {
+        for (j = 0; j < i % 7; j++) {
+            user_addFavorite(&users.elements[i], films.elements[perf_random(&seed) % films.size]);
+        }
+    }
+    // A removed user leaves a tombstone, not saved in the snapshot
+    userTable_setRemoveMode(&users, TABLE_REMOVE_TOMBSTONE);
+    userTable_remove(&users, &users.elements[1]);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    perf_addViews(&views, &films, &users, PERF_TEST_ELEMENTS * 5, 8);
+
+    // TEST 1: Save and load a dataset
+    failed = false;
+    start_test(test_section, "PERF_SNAPSHOT_1", "Save and load a snapshot of the dataset");
+
+    if (snapshot_save(path, &seriesTable, &films, &users, &views) != OK
+            || snapshot_load(path, &loadedSeries, &loadedFilms, &loadedUsers, &loadedViews) != OK) {
+        failed = true;
+    }
+    else {
+        if (seriesTable_size(&loadedSeries) != PERF_TEST_SERIES || filmTable_size(&loadedFilms) != 60
+                || userTable_size(&loadedUsers) != 199 || loadedViews.size != views.size
+                || loadedViews.users != &loadedUsers || !userTable_equals(&users, &loadedUsers)) {
+            failed = true;
+        }
+        for (i = 0; i < films.size && !failed; i++) {
+            if (!film_equals(&films.elements[i], &loadedFilms.elements[i]) 
+                    || films.elements[i].lengthInMin != loadedFilms.elements[i].lengthInMin
+                    || !series_equals(films.elements[i].series, loadedFilms.elements[i].series)
+                    || loadedFilms.elements[i].series != seriesTable_find(&loadedSeries, films.elements[i].series->title)) {
+                failed = true;
+            }
+        }
+        for (i = 0; i < users.size && !failed; i++) {
+            if (users.elements[i].username == NULL) {
+                continue;
+            }
+            user = userTable_find(&loadedUsers, users.elements[i].username);
+            if (user == NULL || !user_equals(user, &users.elements[i])
+                    || !favoriteStack_compare(user->favorites, users.elements[i].favorites)
+                    || user_getFavsLengthInMin(user) != user_getFavsLengthInMin(&users.elements[i])
+                    || user_getFavoriteGenre(user) != user_getFavoriteGenre(&users.elements[i])) {
+                failed = true;
+            }
+        }
+        for (i = 0; i < views.size && !failed; i++) {
+            view = &views.elements[i];
+            loadedView = &loadedViews.elements[i];
+            if (!user_equals(viewLog_getUser(&views, i), viewLog_getUser(&loadedViews, i))
+                    || !film_equals(viewLog_getFilm(&views, i), viewLog_getFilm(&loadedViews, i))
+                    || view->score != loadedView->score || view->minutes != loadedView->minutes
+                    || memcmp(&view->timestamp, &loadedView->timestamp, sizeof(tDateTime)) != 0) {
+                failed = true;
+            }
+        }
+        viewLog_free(&loadedViews);
+        userTable_free(&loadedUsers);
+        filmTable_free(&loadedFilms);
+        seriesTable_free(&loadedSeries);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_SNAPSHOT_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SNAPSHOT_1", true);
+    }
+
+    // TEST 2: Reject files that are not valid snapshots
+    failed = false;
+    start_test(test_section, "PERF_SNAPSHOT_2", "Reject invalid snapshots");
+
+    remove(path);
+    if (snapshot_load(path, &loadedSeries, &loadedFilms, &loadedUsers, &loadedViews) != ERR_NOT_FOUND) {
+        failed = true;
+    }
+
+    // A file with other content
+    file = fopen(path, "wb");
+    if (file == NULL) {
+        failed = true;
+    }
+    else {
+        memset(data, 'x', sizeof(data));
+        fwrite(data, 1, sizeof(data), file);
+        fclose(file);
+        if (snapshot_load(path, &loadedSeries, &loadedFilms, &loadedUsers, &loadedViews) != ERR_INVALID) {
+            failed = true;
+        }
+    }
+
+    // A truncated snapshot
+    if (snapshot_save(path, &seriesTable, &films, &users, &views) != OK) {
+        failed = true;
+    }
+    else {
+        // Keep only the first bytes of the file
+        file = fopen(path, "rb");
+        if (file == NULL || fread(truncated, 1, sizeof(truncated), file) != sizeof(truncated)) {
+            failed = true;
+        }
+        if (file != NULL) {
+            fclose(file);
+        }
+        file = fopen(path, "wb");
+        if (file == NULL) {
+            failed = true;
+        }
+        else {
+            fwrite(truncated, 1, sizeof(truncated), file);
+            fclose(file);
+            if (snapshot_load(path, &loadedSeries, &loadedFilms, &loadedUsers, &loadedViews) != ERR_INVALID) {
+                failed = true;
+            }
+        }
+    }
+    if (loadedSeries.size != 0 || loadedFilms.size != 0 || loadedUsers.size != 0 || loadedViews.size != 0) {
+        failed = true;
+    }
+    remove(path);
+
+    if (failed) {
+        end_test(test_section, "PERF_SNAPSHOT_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SNAPSHOT_2", true);
+    }
+
+    viewLog_free(&views);
+    seriesTable_free(&seriesTable);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the journal of views
+bool run_perf_journal(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    unsigned int replayed;
+    const char* path = "perf_journal.bin";
+    const char* snapshotPath = "perf_journal_snapshot.bin";
+    tSeries series[PERF_TEST_SERIES];
+    tSeriesTable seriesTable, loadedSeries;
+    tFilmTable films, loadedFilms;
+    tUserTable users, loadedUsers;
+    tViewLog views, replayedViews, loadedViews;
+    tJournal journal;
+    tView view;
+    tDateTime dt;
+    FILE* file;
+    int i;
+
+    perf_initCatalog(series, &films, &users, 40, 50);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    viewLog_init(&replayedViews);
+    viewLog_bind(&replayedViews, &users, &films);
+    remove(path);
+
+    // TEST 1: Write the views to a journal and replay them
+    failed = false;
+    start_test(test_section, "PERF_JOURNAL_1", "Write views to a journal and replay them");
+
+    if (journal_open(&journal, path, 100, 0) != OK || viewLog_attachJournal(&views, &journal) != OK) {
+        failed = true;
+    }
+    else {
+        perf_addViews(&views, &films, &users, PERF_TEST_ELEMENTS, 13);
+
+        // One sync per group of 100 views
+        if (journal.records != PERF_TEST_ELEMENTS || journal.syncs != PERF_TEST_ELEMENTS / 100 || journal.pending != 0) {
+            failed = true;
+        }
+        perf_addViews(&views, &films, &users, 10, 14);
+        if (journal.pending != 10 || journal_close(&journal) != OK || journal.syncs != PERF_TEST_ELEMENTS / 100 + 1) {
+            failed = true;
+        }
+        viewLog_attachJournal(&views, NULL);
+    }
+
+    if (journal_replay(path, &replayedViews, &replayed) != OK || replayed != PERF_TEST_ELEMENTS + 10
+            || !perf_equalViews(&views, &replayedViews)) {
+        failed = true;
+    }
+
+    // An unbound log can not use a journal
+    viewLog_init(&loadedViews);
+    if (viewLog_attachJournal(&loadedViews, &journal) != ERR_INVALID 
+            || journal_replay(path, &loadedViews, &replayed) != ERR_INVALID) {
+        failed = true;
+    }
+    viewLog_free(&loadedViews);
+
+    if (failed) {
+        end_test(test_section, "PERF_JOURNAL_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_JOURNAL_1", true);
+    }
+
+    // TEST 2: Recover from partial records
+    failed = false;
+    start_test(test_section, "PERF_JOURNAL_2", "Recover a journal with a partial record");
+
+    // A crash in the middle of a record
+    file = fopen(path, "ab");
+    if (file == NULL) {
+        failed = true;
+    }
+    else {
+        fwrite("partial", 1, 7, file);
+        fclose(file);
+    }
+    viewLog_free(&replayedViews);
+    viewLog_init(&replayedViews);
+    viewLog_bind(&replayedViews, &users, &films);
+    if (journal_replay(path, &replayedViews, &replayed) != OK || replayed != PERF_TEST_ELEMENTS + 10) {
+        failed = true;
+    }
+
+    // Opening the journal removes the partial record
+    if (journal_open(&journal, path, 0, 0) != OK) {
+        failed = true;
+    }
+    else {
+        viewLog_attachJournal(&views, &journal);
+        perf_addViews(&views, &films, &users, 5, 15);
+        viewLog_attachJournal(&views, NULL);
+        if (journal.syncs != 0 || journal_close(&journal) != OK || journal.syncs != 1) {
+            failed = true;
+        }
+        viewLog_free(&replayedViews);
+        viewLog_init(&replayedViews);
+        viewLog_bind(&replayedViews, &users, &films);
+        if (journal_replay(path, &replayedViews, &replayed) != OK || replayed != PERF_TEST_ELEMENTS + 15
+                || !perf_equalViews(&views, &replayedViews)) {
+            failed = true;
+        }
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_JOURNAL_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_JOURNAL_2", true);
+    }
+
+    // TEST 3: Replay the journal on top of a snapshot
+    failed = false;
+    start_test(test_section, "PERF_JOURNAL_3", "Replay a journal on top of a snapshot");
+
+    seriesTable_init(&seriesTable);
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        seriesTable_add(&seriesTable, &series[i]);
+    }
+    if (snapshot_save(snapshotPath, &seriesTable, &films, &users, &views) != OK || journal_open(&journal, path, 1, 0) != OK) {
+        failed = true;
+    }
+    else {
+        // Views after the snapshot are only in the journal
+        if (journal_reset(&journal) != OK) {
+            failed = true;
+        }
+        viewLog_attachJournal(&views, &journal);
+        perf_addViews(&views, &films, &users, 20, 16);
+        viewLog_attachJournal(&views, NULL);
+        if (journal.syncs != 20 || journal_close(&journal) != OK) {
+            failed = true;
+        }
+
+        if (snapshot_load(snapshotPath, &loadedSeries, &loadedFilms, &loadedUsers, &loadedViews) != OK
+                || journal_replay(path, &loadedViews, &replayed) != OK || replayed != 20 
+                || !perf_equalViews(&views, &loadedViews)) {
+            failed = true;
+        }
+        viewLog_free(&loadedViews);
+        userTable_free(&loadedUsers);
+        filmTable_free(&loadedFilms);
+        seriesTable_free(&loadedSeries);
+    }
+    seriesTable_free(&seriesTable);
+    remove(snapshotPath);
+    remove(path);
+
+    if (failed) {
+        end_test(test_section, "PERF_JOURNAL_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_JOURNAL_3", true);
+    }
+
+    // TEST 4: Replay a journal on top of a snapshot of tables with removed elements
+    failed = false;
+    start_test(test_section, "PERF_JOURNAL_4", "Replay a journal on top of a snapshot without the removed elements");
+
+    viewLog_free(&views);
+    viewLog_free(&replayedViews);
+    perf_freeCatalog(series, &films, &users);
+    perf_initCatalog(series, &films, &users, 40, 50);
+    userTable_setRemoveMode(&users, TABLE_REMOVE_TOMBSTONE);
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_TOMBSTONE);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+
+    // The snapshot drops the tombstones, so the positions of the other elements change
+    for (i = 0; i < 10; i++) {
+        userTable_remove(&users, &users.elements[i]);
+        filmTable_remove(&films, &films.elements[i]);
+    }
+    dt = dateTime_make(1, 10, 2019, 12, 0);
+    for (i = 0; i < 100; i++) {
+        view_initRef(&view, &dt, i % 10, &users.elements[10 + i % 40], &films.elements[10 + i % 30]);
+        view.minutes = (unsigned short)i;
+        viewLog_add(&views, &view);
+    }
+    seriesTable_init(&seriesTable);
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        seriesTable_add(&seriesTable, &series[i]);
+    }
+    remove(path);
+    if (snapshot_save(snapshotPath, &seriesTable, &films, &users, &views) != OK || journal_open(&journal, path, 0, 0) != OK) {
+        failed = true;
+    }
+    else {
+        viewLog_attachJournal(&views, &journal);
+        for (i = 0; i < 50; i++) {
+            view_initRef(&view, &dt, (i + 3) % 10, &users.elements[49 - i % 40], &films.elements[39 - i % 30]);
+            viewLog_add(&views, &view);
+        }
+        viewLog_attachJournal(&views, NULL);
+        if (journal_close(&journal) != OK) {
+            failed = true;
+        }
+
+        if (snapshot_load(snapshotPath, &loadedSeries, &loadedFilms, &loadedUsers, &loadedViews) != OK
+                || loadedUsers.size != 40 || journal_replay(path, &loadedViews, &replayed) != OK || replayed != 50 
+                || !perf_equalViews(&views, &loadedViews)) {
+            failed = true;
+        }
+        viewLog_free(&loadedViews);
+        userTable_free(&loadedUsers);
+        filmTable_free(&loadedFilms);
+        seriesTable_free(&loadedSeries);
+
+        // A user removed after the views were journaled is not found
+        userTable_remove(&users, &users.elements[49]);
+        viewLog_init(&replayedViews);
+        viewLog_bind(&replayedViews, &users, &films);
+        if (journal_replay(path, &replayedViews, &replayed) != ERR_INVALID || replayed != 0) {
+            failed = true;
+        }
+    }
+    seriesTable_free(&seriesTable);
+    remove(snapshotPath);
+    remove(path);
+
+    if (failed) {
+        end_test(test_section, "PERF_JOURNAL_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_JOURNAL_4", true);
+    }
+
+    viewLog_free(&views);
+    viewLog_free(&replayedViews);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the time index of the views
+bool run_perf_timeIndex(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tViewLog scanned, indexed, timeOnly;
+    tViewLog* logs[3];
+    const tViewTimeEntry* first;
+    unsigned int count, expected;
+    unsigned int seed = 21;
+    tPackedDateTime from, to = 0, timestamp;
+    tDateTime dt;
+    int i, j, k;
+
+    perf_initCatalog(series, &films, &users, 40, 50);
+
+    // A log without indexes, a log with all the indexes and a log with only the time index
+    viewLog_init(&scanned);
+    viewLog_bind(&scanned, &users, &films);
+    viewLog_init(&indexed);
+    viewLog_bind(&indexed, &users, &films);
+    viewLog_init(&timeOnly);
+    viewLog_bind(&timeOnly, &users, &films);
+    logs[0] = &scanned;
+    logs[1] = &indexed;
+    logs[2] = &timeOnly;
+
+    // TEST 1: Build the time index
+    failed = false;
+    start_test(test_section, "PERF_TIME_1", "Sort the views by timestamp");
+
+    // Pack and build dates without memory
+    dt = dateTime_make(1, 3, 2020, 0, 0);
+    timestamp = dateTime_pack(&dt);
+    dt = dateTime_unpack(timestamp - 1);
+    if (dt.day != 29 || dt.month != 2 || dt.year != 2020 || dt.hour != 23 || dt.minute != 59) {
+        failed = true;
+    }
+
+    if (viewLog_findRange(&indexed, 0, timestamp, &first, &count) != ERR_INVALID) {
+        failed = true;
+    }
+
+    // Some of the views are added before enabling the indexes
+    perf_addRandomViews(logs, 3, &films, &users, PERF_TEST_ELEMENTS / 2, 22);
+    if (viewLog_enableTimeIndex(&indexed) != OK || viewLog_enableUserIndex(&indexed) != OK 
+            || viewLog_enableColumns(&indexed) != OK || viewLog_enableTimeIndex(&timeOnly) != OK) {
+        failed = true;
+    }
+    perf_addRandomViews(logs, 3, &films, &users, PERF_TEST_ELEMENTS / 2, 23);
+    perf_addViews(&timeOnly, &films, &users, 10, 24);
+    viewLog_shrinkToFit(&timeOnly);
+
+    // Entries are sorted by timestamp, and then by position
+    if (viewLog_findRange(&timeOnly, 0, 0xFFFFFFFFu, &first, &count) != OK || count != timeOnly.size) {
+        failed = true;
+    }
+    for (i = 0; !failed && i < (int)count; i++) {
+        if (first[i].timestamp != dateTime_pack(&timeOnly.elements[first[i].position].timestamp)
+                || (i > 0 && (first[i - 1].timestamp > first[i].timestamp 
+                    || (first[i - 1].timestamp == first[i].timestamp && first[i - 1].position >= first[i].position)))) {
+            failed = true;
+        }
+    }
+
+    // Ranges give the same number of views than a scan
+    for (i = 0; !failed && i < 50; i++) {
+        dt = dateTime_make(1 + perf_random(&seed) % 28, 10, 2019, perf_random(&seed) % 24, 0);
+        from = dateTime_pack(&dt);
+        to = from + perf_random(&seed) % (3 * DATETIME_MINUTES_PER_DAY);
+        expected = 0;
+        for (j = 0; j < (int)indexed.size; j++) {
+            timestamp = dateTime_pack(&indexed.elements[j].timestamp);
+            expected += (timestamp >= from && timestamp < to);
+        }
+        if (viewLog_findRange(&indexed, from, to, &first, &count) != OK || count != expected) {
+            failed = true;
+        }
+        for (j = 0; j < (int)count; j++) {
+            if (first[j].timestamp < from || first[j].timestamp >= to) {
+                failed = true;
+            }
+        }
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_TIME_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TIME_1", true);
+    }
+
+    // TEST 2: Favorites in a range of time
+    failed = false;
+    start_test(test_section, "PERF_TIME_2", "Get the favorites of the users in a range of time");
+
+    // The whole range of time gives the same favorites than the whole log
+    for (k = 0; k < users.size; k++) {
+        if (viewLog_getFavFilmInRange(&indexed, &users.elements[k], 0, 0xFFFFFFFFu) != viewLog_getFavFilm(&scanned, &users.elements[k])
+                || viewLog_getFavGenreInRange(&indexed, &users.elements[k], 0, 0xFFFFFFFFu) != viewLog_getFavGenre(&scanned, &users.elements[k])) {
+            failed = true;
+        }
+    }
+
+    // The views in the last 24 hours, the last week and shorter ranges
+    dt = dateTime_make(28, 10, 2019, 23, 59);
+    for (i = 0; !failed && i < 30; i++) {
+        to = dateTime_pack(&dt) + 1;
+        if (i == 0) {
+            from = to - DATETIME_MINUTES_PER_DAY;
+        }
+        else if (i == 1) {
+            from = to - 7 * DATETIME_MINUTES_PER_DAY;
+        }
+        else {
+            from = to - 1 - perf_random(&seed) % (28 * DATETIME_MINUTES_PER_DAY);
+            to = from + perf_random(&seed) % (2 * DATETIME_MINUTES_PER_DAY);
+        }
+        for (k = 0; k < users.size; k++) {
+            if (viewLog_getFavFilmInRange(&scanned, &users.elements[k], from, to) != viewLog_getFavFilmInRange(&indexed, &users.elements[k], from, to)
+                    || viewLog_getFavFilmInRange(&scanned, &users.elements[k], from, to) != viewLog_getFavFilmInRange(&timeOnly, &users.elements[k], from, to)
+                    || viewLog_getFavGenreInRange(&scanned, &users.elements[k], from, to) != viewLog_getFavGenreInRange(&indexed, &users.elements[k], from, to)
+                    || viewLog_getFavGenreInRange(&scanned, &users.elements[k], from, to) != viewLog_getFavGenreInRange(&timeOnly, &users.elements[k], from, to)) {
+                failed = true;
+            }
+        }
+    }
+
+    // An empty range has no favorites
+    if (viewLog_getFavFilmInRange(&indexed, &users.elements[0], to, to) != NULL 
+            || viewLog_getFavGenreInRange(&indexed, &users.elements[0], to, to) != GENRE_NOT_FOUND) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_TIME_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TIME_2", true);
+    }
+
+    viewLog_free(&scanned);
+    viewLog_free(&indexed);
+    viewLog_free(&timeOnly);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the tables shared between threads
+bool run_perf_concurrent(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tViewLog views;
+    tRWLock lock;
+    tPerfShared shared[PERF_TEST_READERS + 1];
+    tThread threads[PERF_TEST_READERS + 1];
+    tSeries otherSeries[PERF_TEST_SERIES];
+    tFilmTable otherFilms;
+    tUserTable otherUsers, copyUsers;
+    tRWLock otherLock;
+    tPerfCompare compare[4];
+    tFilm* film;
+    int i;
+
+    perf_initCatalog(series, &films, &users, 40, 50);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    viewLog_enableUserIndex(&views);
+    perf_addViews(&views, &films, &users, PERF_TEST_ELEMENTS, 31);
+
+    // TEST 1: Reentrant locks
+    failed = false;
+    start_test(test_section, "PERF_CONCURRENT_1", "Share a reentrant lock between the tables");
+
+    if (rwlock_init(&lock) != OK) {
+        failed = true;
+    }
+    userTable_setLock(&users, &lock);
+    filmTable_setLock(&films, &lock);
+    viewLog_setLock(&views, &lock);
+
+    // The functions of the tables take the lock again
+    rwlock_writeLock(&lock);
+    film = filmTable_find(&films, "film3");
+    if (film == NULL || userTable_addFavorite(&users, "user7", *film) != OK 
+            || userTable_addFavorite(&users, "nobody", *film) != ERR_NOT_FOUND
+            || user_getFavsLengthInMin(userTable_find(&users, "user7")) != film->lengthInMin) {
+        failed = true;
+    }
+    rwlock_writeUnlock(&lock);
+
+    rwlock_readLock(&lock);
+    rwlock_readLock(&lock);
+    if (userTable_size(&users) != 50 || !userTable_equals(&users, &users) || viewLog_getFavFilm(&views, &users.elements[0]) == NULL) {
+        failed = true;
+    }
+    rwlock_readUnlock(&lock);
+    rwlock_readUnlock(&lock);
+
+    if (failed) {
+        end_test(test_section, "PERF_CONCURRENT_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_CONCURRENT_1", true);
+    }
+
+    // TEST 2: Readers and a writer
+    failed = false;
+    start_test(test_section, "PERF_CONCURRENT_2", "Query the tables while a thread changes them");
+
+    for (i = 0; i <= PERF_TEST_READERS; i++) {
+        shared[i].lock = &lock;
+        shared[i].series = series;
+        shared[i].films = &films;
+        shared[i].users = &users;
+        shared[i].views = &views;
+        shared[i].numFilms = 40;
+        shared[i].numUsers = 50;
+        shared[i].seed = 41 + i;
+        shared[i].errors = 0;
+        if (thread_create(&threads[i], i == 0 ? perf_writerThread : perf_readerThread, &shared[i]) != OK) {
+            failed = true;
+        }
+    }
+    for (i = 0; i <= PERF_TEST_READERS; i++) {
+        thread_join(&threads[i]);
+        if (shared[i].errors != 0) {
+            failed = true;
+        }
+    }
+
+    // All the changes of the writer are in the tables
+    if (userTable_size(&users) != 50 + PERF_TEST_OPERATIONS || filmTable_size(&films) != 40 + PERF_TEST_OPERATIONS 
+            || views.size != PERF_TEST_ELEMENTS + PERF_TEST_OPERATIONS
+            || viewLog_getFavFilm(&views, userTable_find(&users, "newUser1999")) != filmTable_find(&films, "newFilm1999")) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_CONCURRENT_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_CONCURRENT_2", true);
+    }
+
+    // TEST 3: Compare tables with their own locks
+    failed = false;
+    start_test(test_section, "PERF_CONCURRENT_3", "Compare tables with their own locks from several threads");
+
+    perf_initCatalog(otherSeries, &otherFilms, &otherUsers, 40, 50);
+    if (rwlock_init(&otherLock) != OK) {
+        failed = true;
+    }
+    userTable_setLock(&otherUsers, &otherLock);
+
+    // Users and otherUsers have the same initial users
+    userTable_init(&copyUsers);
+    for (i = 0; i < 50; i++) {
+        userTable_add(&copyUsers, &users.elements[i]);
+    }
+    userTable_setLock(&copyUsers, &lock);
+
+    // Threads compare the tables in both orders, while others wait to write them
+    for (i = 0; i < 4; i++) {
+        compare[i].users1 = (i % 2 == 0) ? &copyUsers : &otherUsers;
+        compare[i].users2 = (i % 2 == 0) ? &otherUsers : &copyUsers;
+        compare[i].writer = (i >= 2);
+        compare[i].errors = 0;
+    }
+    for (i = 0; i < 4; i++) {
+        if (thread_create(&threads[i], perf_compareThread, &compare[i]) != OK) {
+            failed = true;
+        }
+    }
+    for (i = 0; i < 4; i++) {
+        thread_join(&threads[i]);
+        if (compare[i].errors != 0) {
+            failed = true;
+        }
+    }
+
+    userTable_setLock(&copyUsers, NULL);
+    userTable_setLock(&otherUsers, NULL);
+    userTable_free(&copyUsers);
+    perf_freeCatalog(otherSeries, &otherFilms, &otherUsers);
+    rwlock_free(&otherLock);
+
+    if (failed) {
+        end_test(test_section, "PERF_CONCURRENT_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_CONCURRENT_3", true);
+    }
+
+    userTable_setLock(&users, NULL);
+    filmTable_setLock(&films, NULL);
+    viewLog_setLock(&views, NULL);
+    rwlock_free(&lock);
+    viewLog_free(&views);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the sharded log of views
+bool run_perf_sharded(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tViewLog views, merged;
+    tShardedViewLog sharded;
+    tPerfProducer producers[PERF_TEST_PRODUCERS];
+    tThread threads[PERF_TEST_PRODUCERS];
+    tView view;
+    unsigned int i, j;
+
+    perf_initCatalog(series, &films, &users, 40, 50);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    perf_addViews(&views, &films, &users, PERF_TEST_ELEMENTS, 51);
+
+    // TEST 1: Same results than a single log
+    failed = false;
+    start_test(test_section, "PERF_SHARDED_1", "Get the same favorites than a single log");
+
+    if (shardedViewLog_init(&sharded, 0, &users, &films) != ERR_INVALID 
+            || shardedViewLog_init(&sharded, 7, &users, &films) != OK) {
+        failed = true;
+    }
+    for (i = 0; i < views.size; i++) {
+        view = views.elements[i];
+        view.user = viewLog_getUser(&views, i);
+        view.film = viewLog_getFilm(&views, i);
+        if (shardedViewLog_add(&sharded, &view) != OK) {
+            failed = true;
+        }
+        if (i == views.size / 2 && shardedViewLog_enableUserIndex(&sharded) != OK) {
+            failed = true;
+        }
+    }
+    if (shardedViewLog_size(&sharded) != views.size) {
+        failed = true;
+    }
+
+    // Ties are solved by the order of the views in the whole log
+    for (i = 0; i < (unsigned int)users.size; i++) {
+        if (shardedViewLog_getFavFilm(&sharded, &users.elements[i]) != viewLog_getFavFilm(&views, &users.elements[i])
+                || shardedViewLog_getFavGenre(&sharded, &users.elements[i]) != viewLog_getFavGenre(&views, &users.elements[i])) {
+            failed = true;
+        }
+    }
+
+    // Merging the shards gives back the single log
+    viewLog_init(&merged);
+    viewLog_bind(&merged, &users, &films);
+    if (shardedViewLog_merge(&sharded, &merged) != OK || !perf_equalViews(&views, &merged)
+            || shardedViewLog_merge(&sharded, &merged) != ERR_INVALID) {
+        failed = true;
+    }
+    viewLog_free(&merged);
+    shardedViewLog_free(&sharded);
+
+    if (failed) {
+        end_test(test_section, "PERF_SHARDED_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SHARDED_1", true);
+    }
+
+    // TEST 2: Many producers
+    failed = false;
+    start_test(test_section, "PERF_SHARDED_2", "Add views from many threads");
+
+    if (shardedViewLog_init(&sharded, 4, &users, &films) != OK) {
+        failed = true;
+    }
+    for (i = 0; i < PERF_TEST_PRODUCERS; i++) {
+        producers[i].sharded = &sharded;
+        producers[i].views = &views;
+        producers[i].first = i;
+        producers[i].errors = 0;
+        if (thread_create(&threads[i], perf_producerThread, &producers[i]) != OK) {
+            failed = true;
+        }
+    }
+    for (i = 0; i < PERF_TEST_PRODUCERS; i++) {
+        thread_join(&threads[i]);
+        if (producers[i].errors != 0) {
+            failed = true;
+        }
+    }
+
+    // Sequences are increasing in each shard and cover all the views
+    if (shardedViewLog_size(&sharded) != views.size || sharded.next != views.size) {
+        failed = true;
+    }
+    for (i = 0; i < sharded.count; i++) {
+        for (j = 1; j < sharded.shards[i].sequence.size; j++) {
+            if (sharded.shards[i].sequence.elements[j - 1] >= sharded.shards[i].sequence.elements[j]) {
+                failed = true;
+            }
+        }
+    }
+
+    // The merged log gives the same favorites than the shards
+    viewLog_init(&merged);
+    viewLog_bind(&merged, &users, &films);
+    if (shardedViewLog_merge(&sharded, &merged) != OK || merged.size != views.size) {
+        failed = true;
+    }
+    for (i = 0; i < (unsigned int)users.size; i++) {
+        if (shardedViewLog_getFavFilm(&sharded, &users.elements[i]) != viewLog_getFavFilm(&merged, &users.elements[i])
+                || shardedViewLog_getFavGenre(&sharded, &users.elements[i]) != viewLog_getFavGenre(&views, &users.elements[i])) {
+            failed = true;
+        }
+    }
+    viewLog_free(&merged);
+    shardedViewLog_free(&sharded);
+
+    if (failed) {
+        end_test(test_section, "PERF_SHARDED_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SHARDED_2", true);
+    }
+
+    viewLog_free(&views);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the parallel reports of a log
+bool run_perf_report(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tViewLog views, unbound;
+    tLogReport report;
+    unsigned int genreViews[GENRE_QTY] = { 0 };
+    unsigned long long seriesMinutes[PERF_TEST_SERIES] = { 0 };
+    long long scoreSum[40] = { 0 };
+    unsigned int filmViews[40] = { 0 };
+    unsigned int i, threads;
+    tGenre topGenre = GENRE_NOT_FOUND;
+    tFilm* film;
+    float average;
+
+    perf_initCatalog(series, &films, &users, 40, 50);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    perf_addViews(&views, &films, &users, 20 * PERF_TEST_ELEMENTS, 61);
+
+    // Expected values, computed with a simple scan
+    for (i = 0; i < views.size; i++) {
+        film = viewLog_getFilm(&views, i);
+        genreViews[series_getGenre(film->series)]++;
+        seriesMinutes[film->series - series] += views.elements[i].minutes;
+        scoreSum[views.elements[i].filmId] += views.elements[i].score;
+        filmViews[views.elements[i].filmId]++;
+    }
+    for (i = 0; i < GENRE_QTY; i++) {
+        if (genreViews[i] > (topGenre == GENRE_NOT_FOUND ? 0 : genreViews[topGenre])) {
+            topGenre = (tGenre)i;
+        }
+    }
+
+    // TEST 1: Reports with one and many threads
+    failed = false;
+    start_test(test_section, "PERF_REPORT_1", "Build the reports of a log with one and many threads");
+
+    viewLog_init(&unbound);
+    if (logReport_build(&report, &unbound, 1) != ERR_INVALID || logReport_build(&report, &views, 0) != ERR_INVALID) {
+        failed = true;
+    }
+    viewLog_free(&unbound);
+
+    for (threads = 1; threads <= 8; threads *= 2) {
+        // The last run scans the columns
+        if (threads == 8) {
+            viewLog_enableColumns(&views);
+        }
+        if (logReport_build(&report, &views, threads) != OK) {
+            failed = true;
+            continue;
+        }
+
+        if (logReport_getTopGenre(&report) != topGenre) {
+            failed = true;
+        }
+        for (i = 0; i < PERF_TEST_SERIES; i++) {
+            if (logReport_getSeriesMinutes(&report, &series[i]) != seriesMinutes[i]) {
+                failed = true;
+            }
+        }
+        for (i = 0; i < 40; i++) {
+            average = filmViews[i] == 0 ? 0.0f : (float)scoreSum[i] / (float)filmViews[i];
+            if (logReport_getAverageScore(&report, &films.elements[i]) != average) {
+                failed = true;
+            }
+        }
+        for (i = 0; i < (unsigned int)users.size; i++) {
+            if (logReport_getFavFilm(&report, &users.elements[i]) != viewLog_getFavFilm(&views, &users.elements[i])
+                    || logReport_getFavGenre(&report, &users.elements[i]) != viewLog_getFavGenre(&views, &users.elements[i])) {
+                failed = true;
+            }
+        }
+        logReport_free(&report);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_REPORT_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_REPORT_1", true);
+    }
+
+    viewLog_free(&views);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the top-K queries
+bool run_perf_topK(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tSeries* topSeries[PERF_TEST_SERIES];
+    unsigned int topCounts[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tViewLog views, unbound;
+    tLogReport report;
+    tTopK top;
+    tRankEntry all[PERF_TEST_ELEMENTS];
+    tRankEntry best[50];
+    tFilm* topFilms[10];
+    unsigned int seriesCounts[PERF_TEST_SERIES];
+    unsigned int i, j, count, size;
+    unsigned int seed = 71;
+    tUser* user;
+
+    perf_initCatalog(series, &films, &users, 40, 50);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    perf_addViews(&views, &films, &users, PERF_TEST_ELEMENTS, 72);
+
+    // TEST 1: Bounded selection
+    failed = false;
+    start_test(test_section, "PERF_TOPK_1", "Select the best elements of a sequence");
+
+    // Scores with many ties
+    topK_init(&top, 10);
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        all[i].score = perf_random(&seed) % 100;
+        all[i].order = i;
+        all[i].id = i;
+        topK_add(&top, all[i].score, all[i].order, all[i].id);
+    }
+    qsort(all, PERF_TEST_ELEMENTS, sizeof(tRankEntry), perf_rankCmp);
+    if (!perf_checkTopK(&top, all, PERF_TEST_ELEMENTS, 10)) {
+        failed = true;
+    }
+    topK_free(&top);
+
+    // One entry per id, with its best score
+    topK_init(&top, 10);
+    for (i = 0; i < 50; i++) {
+        best[i].score = -1;
+    }
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        j = perf_random(&seed) % 50;
+        all[i].score = perf_random(&seed) % 1000;
+        topK_update(&top, all[i].score, i, j);
+        if (all[i].score > best[j].score) {
+            best[j].score = all[i].score;
+            best[j].order = i;
+            best[j].id = j;
+        }
+    }
+    qsort(best, 50, sizeof(tRankEntry), perf_rankCmp);
+    if (!perf_checkTopK(&top, best, 50, 10)) {
+        failed = true;
+    }
+    topK_free(&top);
+
+    // No entries
+    topK_init(&top, 0);
+    topK_add(&top, 1, 0, 0);
+    if (top.size != 0) {
+        failed = true;
+    }
+    topK_free(&top);
+
+    if (failed) {
+        end_test(test_section, "PERF_TOPK_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TOPK_1", true);
+    }
+
+    // TEST 2: Top films of each user
+    failed = false;
+    start_test(test_section, "PERF_TOPK_2", "Get the top films of each user");
+
+    viewLog_init(&unbound);
+    if (viewLog_getTopFilms(&unbound, &users.elements[0], 5, topFilms, &count) != ERR_INVALID) {
+        failed = true;
+    }
+    viewLog_free(&unbound);
+
+    // Without and with the index of views per user
+    for (j = 0; j < 2; j++) {
+        if (j == 1) {
+            viewLog_enableUserIndex(&views);
+        }
+        for (i = 0; i < (unsigned int)users.size; i++) {
+            user = &users.elements[i];
+
+            // Best view of each film, in the order of the log
+            for (size = 0; size < 40; size++) {
+                best[size].score = 0;
+                best[size].order = 0;
+                best[size].id = size;
+            }
+            for (size = 0; size < views.size; size++) {
+                if (views.elements[size].userId == i && views.elements[size].score > best[views.elements[size].filmId].score) {
+                    best[views.elements[size].filmId].score = views.elements[size].score;
+                    best[views.elements[size].filmId].order = size;
+                }
+            }
+            qsort(best, 40, sizeof(tRankEntry), perf_rankCmp);
+            for (size = 0; size < 40 && best[size].score > 0; size++);
+
+            if (viewLog_getTopFilms(&views, user, 5, topFilms, &count) != OK || count != (size < 5 ? size : 5)
+                    || (count > 0 && topFilms[0] != viewLog_getFavFilm(&views, user))) {
+                failed = true;
+                continue;
+            }
+            for (size = 0; size < count; size++) {
+                if (topFilms[size] != &films.elements[best[size].id]) {
+                    failed = true;
+                }
+            }
+        }
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_TOPK_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TOPK_2", true);
+    }
+
+    // TEST 3: Top series of the favorites and trending films
+    failed = false;
+    start_test(test_section, "PERF_TOPK_3", "Get the top series of the favorites and the trending films");
+
+    // Favorites with a different number of films of each series
+    user = &users.elements[3];
+    memset(seriesCounts, 0, sizeof(seriesCounts));
+    for (i = 0; i < 100; i++) {
+        j = (perf_random(&seed) % 40) * (perf_random(&seed) % 2) % 40;
+        user_addFavorite(user, films.elements[j]);
+        seriesCounts[films.elements[j].series - series]++;
+    }
+    if (user_getTopSeries(user, 3, topSeries, topCounts, &count) != OK || count != 3) {
+        failed = true;
+    }
+    for (i = 0; !failed && i < count; i++) {
+        // No series out of the top has more favorites
+        if (topCounts[i] != seriesCounts[topSeries[i] - series] || (i > 0 && topCounts[i] > topCounts[i - 1])) {
+            failed = true;
+        }
+        for (j = 0; j < PERF_TEST_SERIES; j++) {
+            if (seriesCounts[j] > topCounts[count - 1] && seriesCounts[j] > 0 
+                    && &series[j] != topSeries[0] && &series[j] != topSeries[1] && &series[j] != topSeries[2]) {
+                failed = true;
+            }
+        }
+    }
+    if (user_getTopSeries(&users.elements[4], 3, topSeries, NULL, &count) != OK || count != 0) {
+        failed = true;
+    }
+
+    // Films with the most views
+    if (logReport_build(&report, &views, 1) != OK || logReport_getTopFilms(&report, 10, topFilms, &count) != OK || count != 10) {
+        failed = true;
+    }
+    else {
+        for (i = 0; i < 40; i++) {
+            best[i].score = report.filmStats[i].views;
+            best[i].order = i;
+            best[i].id = i;
+        }
+        qsort(best, 40, sizeof(tRankEntry), perf_rankCmp);
+        for (i = 0; i < count; i++) {
+            if (topFilms[i] != &films.elements[best[i].id]) {
+                failed = true;
+            }
+        }
+    }
+    logReport_free(&report);
+
+    if (failed) {
+        end_test(test_section, "PERF_TOPK_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TOPK_3", true);
+    }
+
+    viewLog_free(&views);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the indexes of genres and series of the films
+bool run_perf_filmIndexes(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tSeries copy;
+    tSeries* released;
+    tFilmTable films;
+    tUserTable users;
+    tFilm film;
+    tPostings* list;
+    char name[32];
+    unsigned int i;
+    int mode;
+
+    // TEST 1: Lists of films of each genre and series
+    failed = false;
+    start_test(test_section, "PERF_FILMINDEX_1", "Get the films of each genre and series");
+
+    perf_initCatalog(series, &films, &users, 120, 10);
+    if (!perf_checkFilmIndexes(&films, series)) {
+        failed = true;
+    }
+
+    // Films are added in order, so the lists are in the order of the table
+    list = filmTable_getSeriesFilms(&films, &series[2]);
+    for (i = 0; list != NULL && i < list->size; i++) {
+        if (list->elements[i] != 2 + i * PERF_TEST_SERIES) {
+            failed = true;
+        }
+    }
+    if (list == NULL || filmTable_getGenreFilms(&films, GENRE_NOT_FOUND) != NULL) {
+        failed = true;
+    }
+
+    // An equal copy of a series shares the list of the series
+    series_init(&copy, series[1].title, series[1].genre);
+    film_init(&film, "copyFilm", 90, &copy);
+    if (filmTable_add(&films, &film) != OK || filmTable_getSeriesFilms(&films, &copy) != filmTable_getSeriesFilms(&films, &series[1])
+            || !perf_checkFilmIndexes(&films, series)) {
+        failed = true;
+    }
+    filmTable_remove(&films, &film);
+    film_free(&film);
+    series_free(&copy);
+    perf_freeCatalog(series, &films, &users);
+
+    if (failed) {
+        end_test(test_section, "PERF_FILMINDEX_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FILMINDEX_1", true);
+    }
+
+    // TEST 2: Keep the lists up to date when removing films
+    failed = false;
+    start_test(test_section, "PERF_FILMINDEX_2", "Update the films of each genre and series when removing films");
+
+    for (mode = TABLE_REMOVE_SHIFT; mode <= TABLE_REMOVE_TOMBSTONE; mode++) {
+        perf_initCatalog(series, &films, &users, 120, 10);
+        filmTable_setRemoveMode(&films, (tRemoveMode)mode);
+        if (!perf_removeOdd(&films, &users, 120, 10) || !perf_checkFilmIndexes(&films, series)) {
+            failed = true;
+        }
+
+        // Compacting the tombstones moves the films
+        filmTable_compact(&films);
+        if (!perf_checkFilmIndexes(&films, series)) {
+            failed = true;
+        }
+
+        // The removed films can be added again
+        for (i = 1; i < 120; i += 2) {
+            sprintf(name, "film%u", i);
+            film_init(&film, name, 30, &series[i % PERF_TEST_SERIES]);
+            if (filmTable_add(&films, &film) != OK) {
+                failed = true;
+            }
+            film_free(&film);
+        }
+        if (!perf_checkFilmIndexes(&films, series)) {
+            failed = true;
+        }
+        perf_freeCatalog(series, &films, &users);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FILMINDEX_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FILMINDEX_2", true);
+    }
+
+    // TEST 3: Series released after their last film is removed are not read
+    failed = false;
+    start_test(test_section, "PERF_FILMINDEX_3", "Remove the lists of series with no films");
+
+    for (mode = TABLE_REMOVE_SHIFT; mode <= TABLE_REMOVE_TOMBSTONE; mode++) {
+        perf_initCatalog(series, &films, &users, 0, 0);
+        filmTable_setRemoveMode(&films, (tRemoveMode)mode);
+        released = (tSeries*)malloc(sizeof(tSeries));
+        if (released == NULL || series_init(released, "Released series", DRAMA) != OK) {
+            failed = true;
+            free(released);
+            perf_freeCatalog(series, &films, &users);
+            continue;
+        }
+
+        // The list of the released series is the first one, so the last list moves
+        for (i = 0; i < 3; i++) {
+            sprintf(name, "released%u", i);
+            film_init(&film, name, 30, (i < 2) ? released : &series[i]);
+            filmTable_add(&films, &film);
+            film_free(&film);
+        }
+        filmTable_remove(&films, filmTable_find(&films, "released0"));
+        filmTable_remove(&films, filmTable_find(&films, "released1"));
+        if (films.bySeries.size != 1 || filmTable_getSeriesFilms(&films, released) != NULL 
+                || !perf_checkFilmIndexes(&films, series)) {
+            failed = true;
+        }
+        series_free(released);
+        free(released);
+
+        // A new series with the same title gets its own list
+        series_init(&copy, "Released series", DRAMA);
+        film_init(&film, "copyFilm", 90, &copy);
+        if (filmTable_add(&films, &film) != OK || films.bySeries.size != 2) {
+            failed = true;
+        }
+        list = filmTable_getSeriesFilms(&films, &copy);
+        if (list == NULL || list->size != 1 || films.elements[list->elements[0]].series != &copy 
+                || !perf_checkFilmIndexes(&films, series)) {
+            failed = true;
+        }
+        filmTable_remove(&films, &film);
+        film_free(&film);
+        series_free(&copy);
+        perf_freeCatalog(series, &films, &users);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FILMINDEX_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FILMINDEX_3", true);
+    }
+
+    return passed;
+}
+
+// Run tests for the batch additions
+bool run_perf_addMany(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films, batchFilms;
+    tUserTable users, batchUsers;
+    tViewLog views, batchViews;
+    tUser* newUsers;
+    tFilm* newFilms;
+    tView* newViews;
+    tError* results;
+    tUser missing;
+    tDateTime dt;
+    char name[32];
+    unsigned int i;
+    unsigned int seed = 81;
+
+    perf_initCatalog(series, &films, &users, 40, 50);
+    newUsers = (tUser*)malloc(PERF_TEST_ELEMENTS * sizeof(tUser));
+    newFilms = (tFilm*)malloc(PERF_TEST_ELEMENTS * sizeof(tFilm));
+    newViews = (tView*)malloc(PERF_TEST_ELEMENTS * sizeof(tView));
+    results = (tError*)malloc(PERF_TEST_ELEMENTS * sizeof(tError));
+
+    // Every 10th element repeats an earlier one, and the first one is already in the tables
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        sprintf(name, "batch%u", (i % 10 == 9) ? i / 2 : i);
+        user_init(&newUsers[i], i == 0 ? "user0" : name, "name", "mail@uoc.edu");
+        film_init(&newFilms[i], i == 0 ? "film0" : name, 60, &series[i % PERF_TEST_SERIES]);
+    }
+
+    // TEST 1: Add users and films in batches
+    failed = false;
+    start_test(test_section, "PERF_ADDMANY_1", "Add users and films in batches");
+
+    userTable_init(&batchUsers);
+    filmTable_init(&batchFilms);
+    for (i = 0; i < (unsigned int)users.size; i++) {
+        userTable_add(&batchUsers, &users.elements[i]);
+        filmTable_add(&batchFilms, &films.elements[i % films.size]);
+    }
+
+    // The same results than adding one by one
+    if (userTable_addMany(&batchUsers, newUsers, PERF_TEST_ELEMENTS, results) != ERR_DUPLICATED) {
+        failed = true;
+    }
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        if (results[i] != userTable_add(&users, &newUsers[i])) {
+            failed = true;
+        }
+    }
+    if (filmTable_addMany(&batchFilms, newFilms, PERF_TEST_ELEMENTS, results) != ERR_DUPLICATED) {
+        failed = true;
+    }
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        if (results[i] != filmTable_add(&films, &newFilms[i])) {
+            failed = true;
+        }
+    }
+    if (!userTable_equals(&users, &batchUsers) || filmTable_size(&films) != filmTable_size(&batchFilms)
+            || results[0] != ERR_DUPLICATED || results[9] != ERR_DUPLICATED || results[19] != OK) {
+        failed = true;
+    }
+    for (i = 0; i < (unsigned int)films.size; i++) {
+        if (filmTable_find(&batchFilms, films.elements[i].title) == NULL) {
+            failed = true;
+        }
+    }
+
+    // A batch with no duplicates
+    if (userTable_addMany(&batchUsers, newUsers, 0, NULL) != OK) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_ADDMANY_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_ADDMANY_1", true);
+    }
+
+    // TEST 2: Add views in batches
+    failed = false;
+    start_test(test_section, "PERF_ADDMANY_2", "Add views in batches");
+
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    viewLog_init(&batchViews);
+    viewLog_bind(&batchViews, &users, &films);
+    viewLog_enableUserIndex(&batchViews);
+
+    // One of the views has a user that is not in the table
+    user_init(&missing, "missing", "name", "mail@uoc.edu");
+    dt = dateTime_make(1, 10, 2019, 22, 30);
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        view_initRef(&newViews[i], &dt, perf_random(&seed) % 10 - 1, i == 500 ? &missing : &users.elements[perf_random(&seed) % users.size], 
+            &films.elements[perf_random(&seed) % films.size]);
+    }
+
+    if (viewLog_addMany(&batchViews, newViews, PERF_TEST_ELEMENTS, results) != ERR_NOT_FOUND 
+            || results[500] != ERR_NOT_FOUND || batchViews.size != PERF_TEST_ELEMENTS - 1
+            || batchViews.capacity != table_growCapacity(0, PERF_TEST_ELEMENTS)) {
+        failed = true;
+    }
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        viewLog_add(&views, &newViews[i]);
+        if (i != 500 && results[i] != OK) {
+            failed = true;
+        }
+    }
+    if (!perf_equalViews(&views, &batchViews)) {
+        failed = true;
+    }
+    for (i = 0; i < 50; i++) {
+        if (viewLog_getFavFilm(&views, &users.elements[i]) != viewLog_getFavFilm(&batchViews, &users.elements[i])) {
+            failed = true;
+        }
+    }
+    user_free(&missing);
+
+    if (failed) {
+        end_test(test_section, "PERF_ADDMANY_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_ADDMANY_2", true);
+    }
+
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        user_free(&newUsers[i]);
+        film_free(&newFilms[i]);
+    }
+    free(newUsers);
+    free(newFilms);
+    free(newViews);
+    free(results);
+    viewLog_free(&views);
+    viewLog_free(&batchViews);
+    userTable_free(&batchUsers);
+    filmTable_free(&batchFilms);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Run tests for the accounting of the memory of the library
+bool run_perf_memory(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tViewLog views;
+    tMemStats before[MEM_SUBSYSTEM_QTY + 1];
+    tMemStats stats, total;
+    tUser user;
+    tFilm film, copy;
+    tView view;
+    tDateTime dt;
+    tError err;
+    char line[256];
+    FILE* fout;
+    void* ptr;
+    unsigned int i, lines, releases, internSize;
+    unsigned int size, filmSize, viewSize;
+    unsigned long long fingerprint;
+    bool failures;
+
+    dt = dateTime_make(1, 10, 2019, 22, 30);
+
+    // The free nodes of the pool keep references to the titles of their last films
+    favoriteNodePool_release();
+
+    // TEST 1: Count the memory of each subsystem
+    failed = false;
+    start_test(test_section, "PERF_MEM_1", "Count the memory of each subsystem");
+
+    perf_getMemStats(before);
+    perf_initCatalog(series, &films, &users, PERF_TEST_ELEMENTS, PERF_TEST_ELEMENTS);
+
+    mem_getStats(MEM_USER, &stats);
+    if (stats.liveBlocks < before[MEM_USER].liveBlocks + 2 * PERF_TEST_ELEMENTS || stats.highWater < stats.liveBytes
+            || stats.allocations < before[MEM_USER].allocations + 2 * PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    mem_getStats(MEM_FILM, &stats);
+    if (stats.liveBytes < before[MEM_FILM].liveBytes + PERF_TEST_ELEMENTS * sizeof(tFilm)) {
+        failed = true;
+    }
+    mem_getStats(MEM_INTERN, &stats);
+    if (stats.liveBlocks < before[MEM_INTERN].liveBlocks + PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+
+    // The total is the sum of the subsystems
+    mem_getTotalStats(&total);
+    for (i = 0; i < MEM_SUBSYSTEM_QTY; i++) {
+        mem_getStats((tMemSubsystem)i, &stats);
+        total.liveBytes -= stats.liveBytes;
+        total.liveBlocks -= stats.liveBlocks;
+        total.allocations -= stats.allocations;
+    }
+    if (total.liveBytes != 0 || total.liveBlocks != 0 || total.allocations != 0) {
+        failed = true;
+    }
+
+    perf_freeCatalog(series, &films, &users);
+    if (!perf_sameLiveMemory(before)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_MEM_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_MEM_1", true);
+    }
+
+    // TEST 2: Use a custom allocator
+    failed = false;
+    start_test(test_section, "PERF_MEM_2", "Use a custom allocator");
+
+    perfAllocator.allocations = 0;
+    perfAllocator.releases = 0;
+    perfAllocator.remaining = -1;
+    perf_getMemStats(before);
+    mem_setAllocator(&perfAllocatorFns);
+    perf_initCatalog(series, &films, &users, 100, 100);
+    ptr = mem_alloc(MEM_REPORT, 100);
+    mem_setAllocator(NULL);
+
+    if (perfAllocator.allocations < 300 || ptr == NULL) {
+        failed = true;
+    }
+
+    // The blocks are released with the allocator that created them
+    releases = perfAllocator.releases;
+    mem_free(ptr);
+    if (perfAllocator.releases != releases + 1) {
+        failed = true;
+    }
+    perf_freeCatalog(series, &films, &users);
+    if (perfAllocator.releases < 300 || !perf_sameLiveMemory(before)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_MEM_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_MEM_2", true);
+    }
+
+    // TEST 3: Release the memory when an allocation fails
+    failed = false;
+    start_test(test_section, "PERF_MEM_3", "Release the memory when an allocation fails");
+
+    perf_initCatalog(series, &films, &users, 10, 10);
+    perf_getMemStats(before);
+    failures = false;
+    for (i = 0; i < 8; i++) {
+        perfAllocator.remaining = (int)i;
+        mem_setAllocator(&perfAllocatorFns);
+        err = user_init(&user, "failing", "name", "mail@uoc.edu");
+        mem_setAllocator(NULL);
+        if (err == OK) {
+            user_free(&user);
+        } else if (err == ERR_MEMORY_ERROR && user.username == NULL && user.name == NULL && user.mail == NULL) {
+            failures = true;
+        } else {
+            failed = true;
+        }
+        if (!perf_sameLiveMemory(before)) {
+            failed = true;
+        }
+
+        perfAllocator.remaining = (int)i;
+        mem_setAllocator(&perfAllocatorFns);
+        err = view_init(&view, &dt, 5, &users.elements[0], &films.elements[0]);
+        mem_setAllocator(NULL);
+        if (err == OK) {
+            view_free(&view);
+        } else if (err == ERR_MEMORY_ERROR && view.user == NULL && view.film == NULL) {
+            failures = true;
+        } else {
+            failed = true;
+        }
+        if (!perf_sameLiveMemory(before)) {
+            failed = true;
+        }
+    }
+    perfAllocator.remaining = -1;
+    if (!failures) {
+        failed = true;
+    }
+    perf_freeCatalog(series, &films, &users);
+
+    if (failed) {
+        end_test(test_section, "PERF_MEM_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_MEM_3", true);
+    }
+
+    // TEST 4: Release the strings of the tables and the views
+    failed = false;
+    start_test(test_section, "PERF_MEM_4", "Release the strings of the tables and the views");
+
+    internSize = intern_size();
+    perf_getMemStats(before);
+    series_init(&series[0], "memseries0", COMEDY);
+    series_init(&series[1], "memseries1", DRAMA);
+    userTable_init(&users);
+    filmTable_init(&films);
+    viewLog_init(&views);
+    for (i = 0; i < 50; i++) {
+        sprintf(line, "memuser%u", i);
+        user_init(&user, line, "name", "mail@uoc.edu");
+        userTable_add(&users, &user);
+        sprintf(line, "memfilm%u", i);
+        film_init(&film, line, 60, &series[0]);
+        filmTable_add(&films, &film);
+        // A log that is not bound keeps its own copies
+        view_initRef(&view, &dt, 5, &user, &film);
+        viewLog_add(&views, &view);
+        user_free(&user);
+        film_free(&film);
+    }
+
+    // Copy a film
+    film_init(&copy, "other", 30, &series[1]);
+    if (film_cpy(&copy, &films.elements[0]) != OK || !film_equals(&copy, &films.elements[0]) 
+            || copy.series != films.elements[0].series) {
+        failed = true;
+    }
+    film_free(&copy);
+
+    viewLog_free(&views);
+    userTable_free(&users);
+    filmTable_free(&films);
+    series_free(&series[0]);
+    series_free(&series[1]);
+    if (intern_size() != internSize || !perf_sameLiveMemory(before)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_MEM_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_MEM_4", true);
+    }
+
+    // TEST 5: Dump the counters of the memory
+    failed = false;
+    start_test(test_section, "PERF_MEM_5", "Dump the counters of the memory");
+
+    fout = tmpfile();
+    if (fout == NULL) {
+        failed = true;
+    } else {
+        mem_dump(fout);
+        rewind(fout);
+        lines = 0;
+        while (fgets(line, sizeof(line), fout) != NULL) {
+            if (lines > 0 && lines <= MEM_SUBSYSTEM_QTY 
+                    && strncmp(line, mem_subsystemName((tMemSubsystem)(lines - 1)), strlen(mem_subsystemName((tMemSubsystem)(lines - 1)))) != 0) {
+                failed = true;
+            }
+            if (lines == MEM_SUBSYSTEM_QTY + 1 && strncmp(line, "total", 5) != 0) {
+                failed = true;
+            }
+            lines++;
+        }
+        fclose(fout);
+        if (lines != MEM_SUBSYSTEM_QTY + 2) {
+            failed = true;
+        }
+    }
+    if (strcmp(mem_subsystemName(MEM_FILM), "film") != 0) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_MEM_5", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_MEM_5", true);
+    }
+
+    // TEST 6: Leave the tables unchanged when an element can not be copied
+    failed = false;
+    start_test(test_section, "PERF_MEM_6", "Leave the tables unchanged when an element can not be copied");
+
+    perf_getMemStats(before);
+    perf_initCatalog(series, &films, &users, 10, 10);
+    viewLog_init(&views);
+
+    // With the space reserved, only the copies of the elements allocate memory
+    userTable_reserve(&users, users.size + 8);
+    filmTable_reserve(&films, films.size + 8);
+    viewLog_reserve(&views, 8);
+    failures = false;
+    for (i = 0; i < 8; i++) {
+        sprintf(line, "failing%u", i);
+        user_init(&user, line, "name", "mail@uoc.edu");
+        film_init(&film, line, 90, &series[0]);
+        view_initRef(&view, &dt, 5, &users.elements[0], &films.elements[0]);
+        size = (unsigned int)users.size;
+        fingerprint = users.fingerprint;
+        filmSize = (unsigned int)films.size;
+        viewSize = views.size;
+
+        perfAllocator.remaining = (int)i;
+        mem_setAllocator(&perfAllocatorFns);
+        err = userTable_add(&users, &user);
+        mem_setAllocator(NULL);
+        if (err == OK) {
+            if (users.size != size + 1 || userTable_find(&users, line) != &users.elements[size]) {
+                failed = true;
+            }
+        } else if (err == ERR_MEMORY_ERROR && users.size == size && users.fingerprint == fingerprint 
+                && userTable_find(&users, line) == NULL) {
+            failures = true;
+        } else {
+            failed = true;
+        }
+
+        perfAllocator.remaining = (int)i / 2;
+        mem_setAllocator(&perfAllocatorFns);
+        err = filmTable_add(&films, &film);
+        mem_setAllocator(NULL);
+        if (err == OK) {
+            if (films.size != filmSize + 1 || filmTable_find(&films, line) != &films.elements[filmSize]) {
+                failed = true;
+            }
+        } else if (err == ERR_MEMORY_ERROR && films.size == filmSize && filmTable_find(&films, line) == NULL) {
+            failures = true;
+        } else {
+            failed = true;
+        }
+
+        perfAllocator.remaining = (int)i;
+        mem_setAllocator(&perfAllocatorFns);
+        err = viewLog_add(&views, &view);
+        mem_setAllocator(NULL);
+        if (err == OK) {
+            if (views.size != viewSize + 1 || views.elements[viewSize].user == NULL) {
+                failed = true;
+            }
+        } else if (err == ERR_MEMORY_ERROR && views.size == viewSize) {
+            failures = true;
+        } else {
+            failed = true;
+        }
+
+        user_free(&user);
+        film_free(&film);
+    }
+    perfAllocator.remaining = -1;
+    if (!failures || views.size == 0) {
+        failed = true;
+    }
+    viewLog_free(&views);
+    perf_freeCatalog(series, &films, &users);
+    if (!perf_sameLiveMemory(before)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_MEM_6", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_MEM_6", true);
+    }
+
+    return passed;
+}
+
+// Run tests for the latency histograms of the entry points
+bool run_perf_trace(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tTraceHistogram histogram;
+    tThread threads[4];
+    unsigned int calls[TRACE_POINT_QTY];
+    unsigned long long value, low, high;
+    unsigned int i, bucket, lines;
+    char line[256];
+    FILE* fout;
+
+    // TEST 1: Get the buckets of the values
+    failed = false;
+    start_test(test_section, "PERF_TRACE_1", "Get the buckets of the values");
+
+    for (value = 0; value < 100000000ull && !failed; value = value + 1 + value / 100) {
+        bucket = traceHistogram_bucket(value);
+        low = traceHistogram_bucketLow(bucket);
+        high = traceHistogram_bucketLow(bucket + 1);
+        // The value is in its bucket, that is at most 1/8 of the value wide
+        if (bucket + 1 >= TRACE_BUCKETS || low > value || high <= value || (high - low) * 8 > low + 8) {
+            failed = true;
+        }
+    }
+    if (traceHistogram_bucket(~0ull) != TRACE_BUCKETS - 1 || traceHistogram_bucketLow(traceHistogram_bucket(1ull << 40)) != 1ull << 40) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_TRACE_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TRACE_1", true);
+    }
+
+    // TEST 2: Get the percentiles of the records
+    failed = false;
+    start_test(test_section, "PERF_TRACE_2", "Get the percentiles of the records");
+
+    trace_reset();
+    for (i = 1; i <= 1000; i++) {
+        trace_record(TRACE_USER_FIND, i);
+    }
+    trace_getHistogram(TRACE_USER_FIND, &histogram);
+    if (histogram.count != 1000 || histogram.totalNs != 500500 || histogram.maxNs != 1000) {
+        failed = true;
+    }
+    value = traceHistogram_percentile(&histogram, 0.5);
+    if (value < 500 || value > 500 + 500 / 8) {
+        failed = true;
+    }
+    value = traceHistogram_percentile(&histogram, 0.99);
+    if (value < 990 || value > 1000) {
+        failed = true;
+    }
+    if (traceHistogram_percentile(&histogram, 1.0) != 1000 || traceHistogram_percentile(&histogram, 0.0) != 1) {
+        failed = true;
+    }
+    trace_getHistogram(TRACE_USER_ADD, &histogram);
+    if (histogram.count != 0 || traceHistogram_percentile(&histogram, 0.5) != 0) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_TRACE_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TRACE_2", true);
+    }
+
+    // TEST 3: Merge the records of several threads
+    failed = false;
+    start_test(test_section, "PERF_TRACE_3", "Merge the records of several threads");
+
+    for (i = 0; i < 4; i++) {
+        if (thread_create(&threads[i], perf_traceThread, NULL) != OK) {
+            failed = true;
+        }
+    }
+    for (i = 0; i < 4; i++) {
+        thread_join(&threads[i]);
+    }
+    trace_getHistogram(TRACE_FILM_ADD, &histogram);
+    if (histogram.count != 4 * PERF_TRACE_RECORDS || histogram.maxNs != PERF_TRACE_RECORDS
+            || histogram.totalNs != 4ull * PERF_TRACE_RECORDS * (PERF_TRACE_RECORDS + 1) / 2) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_TRACE_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TRACE_3", true);
+    }
+
+    // TEST 4: Trace the calls to the entry points
+    failed = false;
+    start_test(test_section, "PERF_TRACE_4", "Trace the calls to the entry points");
+
+    perf_initCatalog(series, &films, &users, 10, 10);
+    trace_reset();
+    memset(calls, 0, sizeof(calls));
+    trace_setCallback(perf_traceCallback, calls);
+    for (i = 0; i < 100; i++) {
+        userTable_find(&users, "user5");
+        filmTable_find(&films, "film5");
+    }
+    user_getFavoriteGenre(&users.elements[0]);
+    trace_record(TRACE_VIEW_ADD, 10);
+    trace_setCallback(NULL, NULL);
+    trace_record(TRACE_VIEW_ADD, 10);
+
+#ifdef UOCFLIX_TRACE
+    // The entry points are instrumented
+    if (calls[TRACE_USER_FIND] != 100 || calls[TRACE_FILM_FIND] != 100 || calls[TRACE_USER_GET_FAVORITE_GENRE] != 1) {
+        failed = true;
+    }
+    trace_getHistogram(TRACE_USER_FIND, &histogram);
+    if (histogram.count != 100) {
+        failed = true;
+    }
+#else
+    // Without instrumentation, only the direct records are seen
+    if (calls[TRACE_USER_FIND] != 0 || calls[TRACE_FILM_FIND] != 0) {
+        failed = true;
+    }
+    trace_getHistogram(TRACE_USER_FIND, &histogram);
+    if (histogram.count != 0) {
+        failed = true;
+    }
+#endif
+    if (calls[TRACE_VIEW_ADD] != 1) {
+        failed = true;
+    }
+    trace_getHistogram(TRACE_VIEW_ADD, &histogram);
+    if (histogram.count != 2) {
+        failed = true;
+    }
+    perf_freeCatalog(series, &films, &users);
+
+    if (failed) {
+        end_test(test_section, "PERF_TRACE_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TRACE_4", true);
+    }
+
+    // TEST 5: Dump the histograms
+    failed = false;
+    start_test(test_section, "PERF_TRACE_5", "Dump the histograms");
+
+    trace_reset();
+    trace_record(TRACE_USER_ADD, 100);
+    trace_record(TRACE_VIEW_GET_FAV_FILM, 200);
+    fout = tmpfile();
+    if (fout == NULL) {
+        failed = true;
+    } else {
+        trace_dump(fout);
+        rewind(fout);
+        lines = 0;
+        while (fgets(line, sizeof(line), fout) != NULL) {
+            if ((lines == 1 && strncmp(line, trace_pointName(TRACE_USER_ADD), strlen(trace_pointName(TRACE_USER_ADD))) != 0)
+                    || (lines == 2 && strncmp(line, "viewLog_getFavFilm ", 19) != 0)) {
+                failed = true;
+            }
+            lines++;
+        }
+        fclose(fout);
+        if (lines != 3) {
+            failed = true;
+        }
+    }
+    trace_reset();
+
+    if (failed) {
+        end_test(test_section, "PERF_TRACE_5", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_TRACE_5", true);
+    }
+
+    return passed;
+}
+
+// Fill a table of users and a table of films, that can be bound to an arena
+static void perf_fillArenaTables(tSeries* series, tFilmTable* films, tUserTable* users, int count) {
+    int i;
+    char name[32];
+    tFilm film;
+    tUser user;
+
+    for (i = 0; i < count; i++) {
+        sprintf(name, "arenafilm%d", i);
+        film_init(&film, name, 30 + i % 60, &series[i % PERF_TEST_SERIES]);
+        filmTable_add(films, &film);
+        film_free(&film);
+
+        sprintf(name, "arenauser%d", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_add(users, &user);
+        user_free(&user);
+    }
+}
+
+// Run tests for the arenas of the tables
+bool run_perf_arena(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films, filmsArena;
+    tUserTable users, usersArena;
+    tArena arena;
+    tMemStats before[MEM_SUBSYSTEM_QTY + 1];
+    tMemStats stats;
+    tFilm* film;
+    tUser user;
+    char name[32];
+    char* blocks[3];
+    int i;
+    unsigned int internSize;
+
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        sprintf(name, "arenaseries%d", i);
+        series_init(&series[i], name, (tGenre)(i + 1));
+    }
+
+    // The free nodes of the pool keep references to the titles of their last films
+    favoriteNodePool_release();
+
+    // TEST 1: Allocate blocks in an arena
+    failed = false;
+    start_test(test_section, "PERF_ARENA_1", "Allocate blocks in an arena");
+
+    perf_getMemStats(before);
+    arena_init(&arena, 1024);
+    blocks[0] = (char*)arena_alloc(&arena, 10);
+    blocks[1] = (char*)arena_alloc(&arena, 3);
+    // Bigger than a chunk
+    blocks[2] = (char*)arena_alloc(&arena, 5000);
+    if (blocks[0] == NULL || blocks[1] == NULL || blocks[2] == NULL) {
+        failed = true;
+    } else {
+        for (i = 0; i < 3; i++) {
+            if (((size_t)blocks[i] % 16) != 0) {
+                failed = true;
+            }
+        }
+        memset(blocks[0], 'a', 10);
+        memset(blocks[1], 'b', 3);
+        memset(blocks[2], 'c', 5000);
+        if (blocks[0][9] != 'a' || blocks[1][0] != 'b' || blocks[2][4999] != 'c') {
+            failed = true;
+        }
+    }
+    // The free space of the first chunk is still used after the big block
+    if (arena_alloc(&arena, 16) != blocks[1] + 16 || arena_used(&arena) < 5000 + 48) {
+        failed = true;
+    }
+    mem_getStats(MEM_ARENA, &stats);
+    if (stats.liveBlocks != before[MEM_ARENA].liveBlocks + 2) {
+        failed = true;
+    }
+
+    arena_free(&arena);
+    mem_getStats(MEM_ARENA, &stats);
+    if (arena_used(&arena) != 0 || stats.liveBytes != before[MEM_ARENA].liveBytes 
+            || stats.liveBlocks != before[MEM_ARENA].liveBlocks) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_ARENA_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_ARENA_1", true);
+    }
+
+    // TEST 2: Allocate the elements of the tables in an arena
+    failed = false;
+    start_test(test_section, "PERF_ARENA_2", "Allocate the elements of the tables in an arena");
+
+    perf_getMemStats(before);
+    arena_init(&arena, 0);
+    userTable_init(&usersArena);
+    filmTable_init(&filmsArena);
+    userTable_setArena(&usersArena, &arena);
+    filmTable_setArena(&filmsArena, &arena);
+    perf_fillArenaTables(series, &filmsArena, &usersArena, PERF_TEST_ELEMENTS);
+
+    // Only the chunks of the arena are counted
+    mem_getStats(MEM_USER, &stats);
+    if (stats.liveBlocks != before[MEM_USER].liveBlocks) {
+        failed = true;
+    }
+    mem_getStats(MEM_FILM, &stats);
+    if (stats.liveBlocks != before[MEM_FILM].liveBlocks) {
+        failed = true;
+    }
+    mem_getStats(MEM_ARENA, &stats);
+    if (stats.liveBytes < before[MEM_ARENA].liveBytes + PERF_TEST_ELEMENTS * sizeof(tFilm)
+            || arena_used(&arena) < PERF_TEST_ELEMENTS * (sizeof(tFilm) + sizeof(tUser))) {
+        failed = true;
+    }
+
+    if (userTable_size(&usersArena) != PERF_TEST_ELEMENTS || filmTable_size(&filmsArena) != PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        sprintf(name, "arenauser%d", i);
+        if (userTable_find(&usersArena, name) == NULL || strcmp(userTable_find(&usersArena, name)->username, name) != 0) {
+            failed = true;
+        }
+        sprintf(name, "arenafilm%d", i);
+        film = filmTable_find(&filmsArena, name);
+        if (film == NULL || film->lengthInMin != (unsigned int)(30 + i % 60)) {
+            failed = true;
+        }
+    }
+    if (!perf_checkFilmIndexes(&filmsArena, series)) {
+        failed = true;
+    }
+
+    // The tables are released before the arena
+    userTable_free(&usersArena);
+    filmTable_free(&filmsArena);
+    arena_free(&arena);
+    mem_getStats(MEM_ARENA, &stats);
+    if (!perf_sameLiveMemory(before) || stats.liveBytes != before[MEM_ARENA].liveBytes) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_ARENA_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_ARENA_2", true);
+    }
+
+    // TEST 3: Change the tables of an arena
+    failed = false;
+    start_test(test_section, "PERF_ARENA_3", "Change the tables of an arena");
+
+    perf_getMemStats(before);
+    arena_init(&arena, 4096);
+    userTable_init(&users);
+    filmTable_init(&films);
+    userTable_init(&usersArena);
+    filmTable_init(&filmsArena);
+    userTable_setArena(&usersArena, &arena);
+    filmTable_setArena(&filmsArena, &arena);
+    userTable_setRemoveMode(&users, TABLE_REMOVE_TOMBSTONE);
+    userTable_setRemoveMode(&usersArena, TABLE_REMOVE_TOMBSTONE);
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_SWAP);
+    filmTable_setRemoveMode(&filmsArena, TABLE_REMOVE_SWAP);
+    perf_fillArenaTables(series, &films, &users, PERF_TEST_ELEMENTS);
+    perf_fillArenaTables(series, &filmsArena, &usersArena, PERF_TEST_ELEMENTS);
+
+    for (i = 0; i < PERF_TEST_ELEMENTS; i += 3) {
+        sprintf(name, "arenauser%d", i);
+        if (userTable_remove(&users, userTable_find(&users, name)) != OK
+                || userTable_remove(&usersArena, userTable_find(&usersArena, name)) != OK) {
+            failed = true;
+        }
+        sprintf(name, "arenafilm%d", i);
+        if (filmTable_remove(&films, filmTable_find(&films, name)) != OK
+                || filmTable_remove(&filmsArena, filmTable_find(&filmsArena, name)) != OK) {
+            failed = true;
+        }
+    }
+    userTable_compact(&users);
+    userTable_compact(&usersArena);
+    if (userTable_shrinkToFit(&usersArena) != OK || filmTable_shrinkToFit(&filmsArena) != OK) {
+        failed = true;
+    }
+
+    if (!userTable_equals(&users, &usersArena) || filmTable_size(&films) != filmTable_size(&filmsArena)
+            || !perf_checkFilmIndexes(&filmsArena, series)) {
+        failed = true;
+    }
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        sprintf(name, "arenafilm%d", i);
+        if ((filmTable_find(&filmsArena, name) == NULL) != (i % 3 == 0)) {
+            failed = true;
+        }
+    }
+
+    userTable_free(&users);
+    filmTable_free(&films);
+    userTable_free(&usersArena);
+    filmTable_free(&filmsArena);
+    arena_free(&arena);
+    if (!perf_sameLiveMemory(before)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_ARENA_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_ARENA_3", true);
+    }
+
+    // TEST 4: Keep the favorites and the strings out of the arena
+    failed = false;
+    start_test(test_section, "PERF_ARENA_4", "Keep the favorites and the strings out of the arena");
+
+    internSize = intern_size();
+    arena_init(&arena, 0);
+    filmTable_init(&films);
+    userTable_init(&usersArena);
+    userTable_setArena(&usersArena, &arena);
+    perf_fillArenaTables(series, &films, &usersArena, 100);
+    for (i = 0; i < 100; i++) {
+        sprintf(name, "arenauser%d", i);
+        if (userTable_addFavorite(&usersArena, name, films.elements[i]) != OK
+                || userTable_addFavorite(&usersArena, name, films.elements[(i + 1) % 100]) != OK) {
+            failed = true;
+        }
+    }
+    if (user_getFavsLengthInMin(userTable_find(&usersArena, "arenauser0")) != 30 + 31) {
+        failed = true;
+    }
+
+    // The nodes of the favorites go back to the pool, that outlives the arena
+    userTable_free(&usersArena);
+    arena_free(&arena);
+    if (favoriteNodePool_available() < 200) {
+        failed = true;
+    }
+
+    // Reuse the nodes released with the table in a table out of the arena
+    userTable_init(&users);
+    for (i = 0; i < 100; i++) {
+        sprintf(name, "arenauser%d", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_add(&users, &user);
+        user_free(&user);
+        if (userTable_addFavorite(&users, name, films.elements[i]) != OK) {
+            failed = true;
+        }
+    }
+    if (user_getFavsLengthInMin(userTable_find(&users, "arenauser1")) != 31
+            || strcmp(userTable_find(&users, "arenauser1")->username, "arenauser1") != 0) {
+        failed = true;
+    }
+    userTable_free(&users);
+    filmTable_free(&films);
+    favoriteNodePool_release();
+    if (intern_size() != internSize) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_ARENA_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_ARENA_4", true);
+    }
+
+    for (i = 0; i < PERF_TEST_SERIES; i++) {
+        series_free(&series[i]);
+    }
+
+    return passed;
+}
+
+// Check the cached hash and length of the keys of the elements of the tables
+static bool perf_checkCachedKeys(tFilmTable* films, tUserTable* users) {
+    unsigned int i;
+
+    for (i = 0; i < users->size; i++) {
+        if (users->elements[i].username != NULL && (users->elements[i].usernameHash != hash_string(users->elements[i].username)
+                || users->elements[i].usernameLength != strlen(users->elements[i].username)
+                || userTable_find(users, users->elements[i].username) != &users->elements[i])) {
+            return false;
+        }
+    }
+    for (i = 0; i < films->size; i++) {
+        if (films->elements[i].title != NULL && (films->elements[i].titleHash != hash_string(films->elements[i].title)
+                || films->elements[i].titleLength != strlen(films->elements[i].title)
+                || filmTable_find(films, films->elements[i].title) != &films->elements[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Run tests for the cached hash and length of the keys of users and films
+bool run_perf_keys(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tUser user, userCopy;
+    tFilm film, filmCopy, filmLong;
+    char* longTitle;
+    char name[32];
+    unsigned int i;
+
+    // TEST 1: Cache the hash and the length of the keys
+    failed = false;
+    start_test(test_section, "PERF_KEYS_1", "Cache the hash and the length of the keys");
+
+    perf_initCatalog(series, &films, &users, 0, 0);
+    user_init(&user, "cachedkey", "name", "mail@uoc.edu");
+    user_init(&userCopy, "cachedkez", "name", "mail@uoc.edu");
+    film_init(&film, "Cached key", 60, &series[0]);
+    film_init(&filmCopy, "Other title", 60, &series[0]);
+    if (user.usernameHash != hash_string("cachedkey") || user.usernameLength != 9
+            || intern_hash(user.username) != user.usernameHash || intern_length(user.username) != 9
+            || film.titleHash != hash_string("Cached key") || film.titleLength != 10) {
+        failed = true;
+    }
+    if (user_equals(&user, &userCopy) || film_equals(&film, &filmCopy)) {
+        failed = true;
+    }
+
+    // Copies keep the same values
+    if (user_cpy(&userCopy, &user) != OK || film_cpy(&filmCopy, &film) != OK
+            || userCopy.usernameHash != user.usernameHash || userCopy.usernameLength != user.usernameLength
+            || filmCopy.titleHash != film.titleHash || filmCopy.titleLength != film.titleLength
+            || !user_equals(&user, &userCopy) || !film_equals(&film, &filmCopy)) {
+        failed = true;
+    }
+
+    // The length of long titles is limited
+    longTitle = (char*)malloc(FILM_MAX_TITLE_LENGTH + 11);
+    if (longTitle == NULL) {
+        failed = true;
+    } else {
+        memset(longTitle, 'x', FILM_MAX_TITLE_LENGTH + 10);
+        longTitle[FILM_MAX_TITLE_LENGTH + 10] = '\0';
+        film_init(&filmLong, longTitle, 60, &series[0]);
+        if (filmLong.titleLength != FILM_MAX_TITLE_LENGTH || intern_length(filmLong.title) != FILM_MAX_TITLE_LENGTH + 10
+                || filmLong.titleHash != hash_string(longTitle) || film_equals(&filmLong, &film)) {
+            failed = true;
+        }
+        film_free(&filmLong);
+        free(longTitle);
+    }
+
+    user_free(&user);
+    user_free(&userCopy);
+    film_free(&film);
+    film_free(&filmCopy);
+
+    if (failed) {
+        end_test(test_section, "PERF_KEYS_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_KEYS_1", true);
+    }
+
+    // TEST 2: Keep the cached keys when the elements are moved
+    failed = false;
+    start_test(test_section, "PERF_KEYS_2", "Keep the cached keys when the elements are moved");
+
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        sprintf(name, "film%u", i);
+        film_init(&film, name, 30, &series[i % PERF_TEST_SERIES]);
+        filmTable_add(&films, &film);
+        film_free(&film);
+        sprintf(name, "user%u", i);
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_add(&users, &user);
+        user_free(&user);
+    }
+    if (!perf_checkCachedKeys(&films, &users)) {
+        failed = true;
+    }
+
+    userTable_setRemoveMode(&users, TABLE_REMOVE_SWAP);
+    filmTable_setRemoveMode(&films, TABLE_REMOVE_TOMBSTONE);
+    for (i = 0; i < PERF_TEST_ELEMENTS; i += 4) {
+        sprintf(name, "film%u", i);
+        filmTable_remove(&films, filmTable_find(&films, name));
+        sprintf(name, "user%u", i);
+        userTable_remove(&users, userTable_find(&users, name));
+    }
+    filmTable_compact(&films);
+    if (filmTable_size(&films) != PERF_TEST_ELEMENTS - PERF_TEST_ELEMENTS / 4 
+            || userTable_size(&users) != PERF_TEST_ELEMENTS - PERF_TEST_ELEMENTS / 4
+            || !perf_checkCachedKeys(&films, &users)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_KEYS_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_KEYS_2", true);
+    }
+
+    // TEST 3: Add users and films filled by hand
+    failed = false;
+    start_test(test_section, "PERF_KEYS_3", "Add users and films filled by hand");
+
+    // As the loaders, only the strings are set
+    strcpy(name, "handuser");
+    user.username = name;
+    user.name = "name";
+    user.mail = "mail@uoc.edu";
+    if (userTable_add(&users, &user) != OK || userTable_add(&users, &user) != ERR_DUPLICATED) {
+        failed = true;
+    }
+    strcpy(name, "handfilm");
+    film.title = name;
+    film.lengthInMin = 45;
+    film.series = &series[1];
+    if (filmTable_add(&films, &film) != OK || filmTable_add(&films, &film) != ERR_DUPLICATED) {
+        failed = true;
+    }
+    if (userTable_find(&users, "handuser") == NULL || filmTable_find(&films, "handfilm") == NULL
+            || !perf_checkCachedKeys(&films, &users)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_KEYS_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_KEYS_3", true);
+    }
+
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Characters of the names of the tests of the normalization, with blanks and non ASCII characters
+static const char perfNameChars[] = "  \tabzAZmM-'\xc3\xa9\xc3\x80";
+
+// Normalize a name one character at a time, as a reference
+static void perf_normalizeName(const char* name, char* result) {
+    size_t start = 0, end, i;
+    bool startOfWord = true;
+
+    end = strlen(name);
+    while (start < end && isblank((unsigned char)name[start])) {
+        start++;
+    }
+    while (end > start && isblank((unsigned char)name[end - 1])) {
+        end--;
+    }
+    for (i = start; i < end; i++) {
+        if (isblank((unsigned char)name[i])) {
+            result[i - start] = name[i];
+            startOfWord = true;
+        } else {
+            result[i - start] = (char)(startOfWord ? toupper((unsigned char)name[i]) : tolower((unsigned char)name[i]));
+            startOfWord = false;
+        }
+    }
+    result[end - start] = '\0';
+}
+
+// Run tests for the normalization of the names of the users
+bool run_perf_names(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tUser users[200];
+    char name[128];
+    char expected[200][128];
+    unsigned int i, j, length;
+    unsigned int seed = 7;
+    tMemStats before, after;
+    const char* cases[][2] = {
+        { "", "" },
+        { "     ", "" },
+        { "\t a \t", "A" },
+        { "x", "X" },
+        { "                         leading blanks AND a long NAME", "Leading Blanks And A Long Name" },
+        { "exactly sixteen!", "Exactly Sixteen!" },
+        { "\xc3\xa0lex MART\xc3\x8d  o'NEIL", "\xc3\xa0lex Mart\xc3\x8d  O'neil" }
+    };
+
+    // TEST 1: Normalize names with any length and characters
+    failed = false;
+    start_test(test_section, "PERF_NAMES_1", "Normalize names with any length and characters");
+
+    for (i = 0; i < 200; i++) {
+        // Names from 0 to 99 characters, so they do not fill the blocks of the vector version
+        length = i % 100;
+        for (j = 0; j < length; j++) {
+            name[j] = perfNameChars[perf_random(&seed) % (sizeof(perfNameChars) - 1)];
+        }
+        name[length] = '\0';
+        // Names without non ASCII characters, that use the vector version for whole blocks
+        if (i >= 100) {
+            for (j = 0; j < length; j++) {
+                if ((unsigned char)name[j] >= 0x80) {
+                    name[j] = 'q';
+                }
+            }
+        }
+        perf_normalizeName(name, expected[i]);
+        user_init(&users[i], "normalized", name, "mail@uoc.edu");
+        if (user_trimCapitalizeName(&users[i]) != OK || strcmp(users[i].name, expected[i]) != 0) {
+            failed = true;
+        }
+        user_free(&users[i]);
+    }
+
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        user_init(&users[0], "normalized", cases[i][0], "mail@uoc.edu");
+        if (user_trimCapitalizeName(&users[0]) != OK || strcmp(users[0].name, cases[i][1]) != 0) {
+            failed = true;
+        }
+        user_free(&users[0]);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_NAMES_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_NAMES_1", true);
+    }
+
+    // TEST 2: Normalize the names of an array of users in place
+    failed = false;
+    start_test(test_section, "PERF_NAMES_2", "Normalize the names of an array of users in place");
+
+    for (i = 0; i < 200; i++) {
+        sprintf(name, "  %u  joAN pere GAbriel de la MUNTANYA  %u ", i, i);
+        perf_normalizeName(name, expected[i]);
+        user_init(&users[i], "normalized", name, "mail@uoc.edu");
+    }
+
+    mem_getTotalStats(&before);
+    if (user_trimCapitalizeNames(users, 200) != OK || user_trimCapitalizeNames(NULL, 0) != OK) {
+        failed = true;
+    }
+    mem_getTotalStats(&after);
+    if (after.allocations != before.allocations || after.liveBlocks != before.liveBlocks) {
+        failed = true;
+    }
+    for (i = 0; i < 200; i++) {
+        if (strcmp(users[i].name, expected[i]) != 0) {
+            failed = true;
+        }
+        user_free(&users[i]);
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_NAMES_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_NAMES_2", true);
+    }
+
+    return passed;
+}
+
+// Run tests for the fingerprints of the stacks of favorites and the tables of users
+bool run_perf_fingerprints(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users, usersReversed;
+    tFavoriteStack stack1, stack2, copy;
+    tFavorite favorite;
+    tUser user;
+    unsigned long long fingerprint;
+    char name[32];
+    int i;
+
+    perf_initCatalog(series, &films, &users, 10, PERF_TEST_ELEMENTS);
+
+    // TEST 1: Keep an order sensitive fingerprint of the stacks
+    failed = false;
+    start_test(test_section, "PERF_FINGERPRINT_1", "Keep an order sensitive fingerprint of the stacks");
+
+    if (FAVORITE_FINGERPRINT_MULTIPLIER * FAVORITE_FINGERPRINT_INVERSE != 1) {
+        failed = true;
+    }
+
+    favoriteStack_create(&stack1);
+    favoriteStack_create(&stack2);
+    if (stack1.fingerprint != 0 || !favoriteStack_compare(stack1, stack2)) {
+        failed = true;
+    }
+    // The same films in a different order
+    for (i = 0; i < 3; i++) {
+        favorite_init(&favorite, films.elements[i]);
+        favoriteStack_push(&stack1, favorite);
+        favorite_free(&favorite);
+        favorite_init(&favorite, films.elements[2 - i]);
+        favoriteStack_push(&stack2, favorite);
+        favorite_free(&favorite);
+    }
+    if (stack1.fingerprint == stack2.fingerprint || favoriteStack_compare(stack1, stack2)) {
+        failed = true;
+    }
+
+    // A pop undoes a push
+    fingerprint = stack1.fingerprint;
+    favorite_init(&favorite, films.elements[5]);
+    favoriteStack_push(&stack1, favorite);
+    favorite_free(&favorite);
+    if (stack1.fingerprint == fingerprint || favoriteStack_pop(&stack1) != OK || stack1.fingerprint != fingerprint) {
+        failed = true;
+    }
+
+    // Copies have the same fingerprint
+    if (favoriteStack_duplicate(&copy, stack1) != OK || copy.fingerprint != stack1.fingerprint 
+            || !favoriteStack_compare(copy, stack1)) {
+        failed = true;
+    }
+    while (!favoriteStack_empty(copy)) {
+        favoriteStack_pop(&copy);
+    }
+    if (copy.fingerprint != 0) {
+        failed = true;
+    }
+
+    favoriteStack_free(&stack1);
+    favoriteStack_free(&stack2);
+    favoriteStack_free(&copy);
+
+    if (failed) {
+        end_test(test_section, "PERF_FINGERPRINT_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FINGERPRINT_1", true);
+    }
+
+    // TEST 2: Keep an order insensitive fingerprint of the tables of users
+    failed = false;
+    start_test(test_section, "PERF_FINGERPRINT_2", "Keep an order insensitive fingerprint of the tables of users");
+
+    userTable_init(&usersReversed);
+    for (i = PERF_TEST_ELEMENTS - 1; i >= 0; i--) {
+        userTable_add(&usersReversed, &users.elements[i]);
+    }
+    if (users.fingerprint != usersReversed.fingerprint || !userTable_equals(&users, &usersReversed)) {
+        failed = true;
+    }
+
+    // Same size, but a different user
+    fingerprint = usersReversed.fingerprint;
+    userTable_setRemoveMode(&usersReversed, TABLE_REMOVE_SWAP);
+    userTable_remove(&usersReversed, userTable_find(&usersReversed, "user7"));
+    user_init(&user, "otheruser", "name", "mail@uoc.edu");
+    userTable_add(&usersReversed, &user);
+    if (userTable_size(&usersReversed) != userTable_size(&users) || usersReversed.fingerprint == fingerprint
+            || userTable_equals(&users, &usersReversed) || userTable_equals(&usersReversed, &users)) {
+        failed = true;
+    }
+
+    // Moving the users does not change the fingerprint
+    userTable_remove(&usersReversed, &user);
+    user_free(&user);
+    user_init(&user, "user7", "name", "mail@uoc.edu");
+    userTable_add(&usersReversed, &user);
+    user_free(&user);
+    userTable_setRemoveMode(&usersReversed, TABLE_REMOVE_TOMBSTONE);
+    for (i = 0; i < 10; i++) {
+        sprintf(name, "user%d", i * 3);
+        userTable_remove(&usersReversed, userTable_find(&usersReversed, name));
+        user_init(&user, name, "name", "mail@uoc.edu");
+        userTable_add(&usersReversed, &user);
+        user_free(&user);
+    }
+    userTable_compact(&usersReversed);
+    if (usersReversed.fingerprint != fingerprint || !userTable_equals(&users, &usersReversed)) {
+        failed = true;
+    }
+
+    userTable_free(&usersReversed);
+    if (usersReversed.fingerprint != 0) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FINGERPRINT_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FINGERPRINT_2", true);
+    }
+
+    // TEST 3: Keep the fingerprints of the favorites of the users
+    failed = false;
+    start_test(test_section, "PERF_FINGERPRINT_3", "Keep the fingerprints of the favorites of the users");
+
+    for (i = 0; i < 10; i++) {
+        userTable_addFavorite(&users, "user1", films.elements[i]);
+        user_addFavorite(&users.elements[2], films.elements[i]);
+    }
+    user_addFavorite(&users.elements[2], films.elements[0]);
+    if (favoriteStack_compare(users.elements[1].favorites, users.elements[2].favorites)) {
+        failed = true;
+    }
+    user_popFavorite(&users.elements[2]);
+    if (users.elements[1].favorites.fingerprint != users.elements[2].favorites.fingerprint
+            || !favoriteStack_compare(users.elements[1].favorites, users.elements[2].favorites)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_FINGERPRINT_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_FINGERPRINT_3", true);
+    }
+
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Add a view of a user of a film to a log, at a given minute of a day
+static tError perf_addView(tViewLog* viewLog, tUser* user, tFilm* film, int minute) {
+    tView view;
+    tDateTime dt;
+
+    dt = dateTime_make(1, 10, 2019, (unsigned char)(minute / 60), (unsigned char)(minute % 60));
+    view_initRef(&view, &dt, 3, user, film);
+    return viewLog_add(viewLog, &view);
+}
+
+// Check the counts of the views of a recommender are the pairs of films watched by the same users of a log
+static bool perf_checkRecommendViews(tRecommender* recommender, tViewLog* viewLog, tFilmTable* films, tUserTable* users) {
+    bool* watched;
+    unsigned int i, a, b, users1, users2;
+    bool ok = true;
+
+    watched = (bool*)calloc((size_t)users->size * films->size, sizeof(bool));
+    if (watched == NULL) {
+        return false;
+    }
+    for (i = 0; i < viewLog->size; i++) {
+        a = (unsigned int)(viewLog_getUser(viewLog, i) - users->elements);
+        b = (unsigned int)(viewLog_getFilm(viewLog, i) - films->elements);
+        watched[a * films->size + b] = true;
+    }
+
+    for (a = 0; a < films->size && ok; a++) {
+        for (b = 0; b < films->size && ok; b++) {
+            users1 = 0;
+            users2 = 0;
+            for (i = 0; i < users->size; i++) {
+                if (watched[i * films->size + a]) {
+                    users1++;
+                    if (a != b && watched[i * films->size + b]) {
+                        users2++;
+                    }
+                }
+            }
+            if (recommender_getUserCount(recommender, RECOMMEND_VIEWS, &films->elements[a]) != users1
+                    || recommender_getPairCount(recommender, RECOMMEND_VIEWS, &films->elements[a], 
+                                                &films->elements[b]) != users2) {
+                ok = false;
+            }
+        }
+    }
+
+    free(watched);
+    return ok;
+}
+
+// Run tests for the recommender of films and series
+bool run_perf_recommend(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users, otherUsers;
+    tViewLog viewLog, otherLog;
+    tRecommender recommender, otherRecommender;
+    tFilm* top[4];
+    tSeries* topSeries[4];
+    unsigned int counts[4];
+    unsigned int count;
+    tMemStats before[MEM_SUBSYSTEM_QTY + 1];
+    tMemStats stats, after;
+    int i;
+
+    perf_getMemStats(before);
+    perf_initCatalog(series, &films, &users, 40, 50);
+
+    // TEST 1: Count the films watched by the same users
+    failed = false;
+    start_test(test_section, "PERF_RECOMMEND_1", "Count the films watched by the same users");
+
+    viewLog_init(&viewLog);
+    viewLog_bind(&viewLog, &users, &films);
+    recommender_init(&recommender, &users, &films);
+    if (viewLog_attachRecommender(&viewLog, &recommender) != OK) {
+        failed = true;
+    }
+
+    // user0 watches film1 twice, that is counted once
+    perf_addView(&viewLog, &users.elements[0], &films.elements[0], 0);
+    perf_addView(&viewLog, &users.elements[0], &films.elements[1], 1);
+    perf_addView(&viewLog, &users.elements[0], &films.elements[1], 2);
+    perf_addView(&viewLog, &users.elements[0], &films.elements[2], 3);
+    perf_addView(&viewLog, &users.elements[1], &films.elements[0], 4);
+    perf_addView(&viewLog, &users.elements[1], &films.elements[1], 5);
+    perf_addView(&viewLog, &users.elements[2], &films.elements[0], 6);
+    perf_addView(&viewLog, &users.elements[2], &films.elements[3], 7);
+
+    if (recommender_getUserCount(&recommender, RECOMMEND_VIEWS, &films.elements[0]) != 3
+            || recommender_getUserCount(&recommender, RECOMMEND_VIEWS, &films.elements[1]) != 2
+            || recommender_getUserCount(&recommender, RECOMMEND_VIEWS, &films.elements[4]) != 0
+            || recommender_getPairCount(&recommender, RECOMMEND_VIEWS, &films.elements[0], &films.elements[1]) != 2
+            || recommender_getPairCount(&recommender, RECOMMEND_VIEWS, &films.elements[1], &films.elements[0]) != 2
+            || recommender_getPairCount(&recommender, RECOMMEND_VIEWS, &films.elements[1], &films.elements[1]) != 0
+            || recommender_getPairCount(&recommender, RECOMMEND_VIEWS, &films.elements[1], &films.elements[3]) != 0
+            || recommender_getPairCount(&recommender, RECOMMEND_FAVORITES, &films.elements[0], &films.elements[1]) != 0) {
+        failed = true;
+    }
+
+    // The most watched first, and ties to the first film of the table
+    if (recommender_getFilms(&recommender, RECOMMEND_VIEWS, &films.elements[0], 4, top, counts, &count) != OK
+            || count != 3 || top[0] != &films.elements[1] || counts[0] != 2 || top[1] != &films.elements[2] 
+            || counts[1] != 1 || top[2] != &films.elements[3] || counts[2] != 1) {
+        failed = true;
+    }
+    if (recommender_getFilms(&recommender, RECOMMEND_VIEWS, &films.elements[0], 1, top, NULL, &count) != OK
+            || count != 1 || top[0] != &films.elements[1]) {
+        failed = true;
+    }
+    if (recommender_getFilms(&recommender, RECOMMEND_VIEWS, &films.elements[4], 4, top, counts, &count) != OK
+            || count != 0) {
+        failed = true;
+    }
+
+    // The series of film i is series i
+    if (recommender_getSeries(&recommender, &series[0], 4, topSeries, counts, &count) != OK || count != 3 
+            || !series_equals(topSeries[0], &series[1]) || counts[0] != 2 
+            || !series_equals(topSeries[1], &series[2]) || counts[1] != 1
+            || !series_equals(topSeries[2], &series[3]) || counts[2] != 1) {
+        failed = true;
+    }
+    if (recommender_getSeries(&recommender, &series[4], 4, topSeries, counts, &count) != OK || count != 0) {
+        failed = true;
+    }
+
+    // Removing views
+    if (recommender_removeView(&recommender, 0, 1) != OK 
+            || recommender_getPairCount(&recommender, RECOMMEND_VIEWS, &films.elements[0], &films.elements[1]) != 2
+            || recommender_removeView(&recommender, 0, 1) != OK 
+            || recommender_getPairCount(&recommender, RECOMMEND_VIEWS, &films.elements[0], &films.elements[1]) != 1
+            || recommender_getUserCount(&recommender, RECOMMEND_VIEWS, &films.elements[1]) != 1
+            || recommender_removeView(&recommender, 0, 1) != ERR_NOT_FOUND
+            || recommender_removeView(&recommender, 3, 0) != ERR_NOT_FOUND) {
+        failed = true;
+    }
+    if (recommender_getSeries(&recommender, &series[0], 4, topSeries, counts, &count) != OK || count != 3 
+            || counts[0] != 1 || counts[1] != 1 || counts[2] != 1) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_RECOMMEND_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_RECOMMEND_1", true);
+    }
+
+    // TEST 2: Count the views already in a log
+    failed = false;
+    start_test(test_section, "PERF_RECOMMEND_2", "Count the views already in a log");
+
+    viewLog_attachRecommender(&viewLog, NULL);
+    recommender_free(&recommender);
+    recommender_init(&recommender, &users, &films);
+    viewLog_attachRecommender(&viewLog, &recommender);
+    perf_addViews(&viewLog, &films, &users, 1000, 7);
+
+    viewLog_init(&otherLog);
+    viewLog_bind(&otherLog, &users, &films);
+    for (i = 0; i < (int)viewLog.size; i++) {
+        perf_addView(&otherLog, viewLog_getUser(&viewLog, i), viewLog_getFilm(&viewLog, i), i);
+    }
+    recommender_init(&otherRecommender, &users, &films);
+    if (viewLog_attachRecommender(&otherLog, &otherRecommender) != OK) {
+        failed = true;
+    }
+
+    if (!perf_checkRecommendViews(&recommender, &viewLog, &films, &users) 
+            || !perf_checkRecommendViews(&otherRecommender, &otherLog, &films, &users)) {
+        failed = true;
+    }
+
+    // Only the logs bound to the tables of the recommender
+    viewLog_attachRecommender(&otherLog, NULL);
+    recommender_free(&otherRecommender);
+    userTable_init(&otherUsers);
+    recommender_init(&otherRecommender, &otherUsers, &films);
+    if (viewLog_attachRecommender(&otherLog, &otherRecommender) != ERR_INVALID || otherLog.recommender != NULL) {
+        failed = true;
+    }
+    viewLog_free(&otherLog);
+    viewLog_init(&otherLog);
+    if (viewLog_attachRecommender(&otherLog, &recommender) != ERR_INVALID) {
+        failed = true;
+    }
+    viewLog_free(&otherLog);
+    recommender_free(&otherRecommender);
+
+    if (failed) {
+        end_test(test_section, "PERF_RECOMMEND_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_RECOMMEND_2", true);
+    }
+
+    // TEST 3: Count the favorites of the users
+    failed = false;
+    start_test(test_section, "PERF_RECOMMEND_3", "Count the favorites of the users");
+
+    user_addFavorite(&users.elements[5], films.elements[7]);
+    user_addFavorite(&users.elements[5], films.elements[8]);
+    if (userTable_attachRecommender(&users, &recommender) != OK 
+            || recommender_getPairCount(&recommender, RECOMMEND_FAVORITES, &films.elements[7], &films.elements[8]) != 1) {
+        failed = true;
+    }
+    userTable_addFavorite(&users, "user6", films.elements[8]);
+    userTable_addFavorite(&users, "user6", films.elements[7]);
+    userTable_addFavorite(&users, "user6", films.elements[9]);
+    if (recommender_getPairCount(&recommender, RECOMMEND_FAVORITES, &films.elements[7], &films.elements[8]) != 2
+            || recommender_getPairCount(&recommender, RECOMMEND_FAVORITES, &films.elements[9], &films.elements[8]) != 1
+            || recommender_getUserCount(&recommender, RECOMMEND_FAVORITES, &films.elements[8]) != 2) {
+        failed = true;
+    }
+    if (recommender_getFilms(&recommender, RECOMMEND_FAVORITES, &films.elements[8], 4, top, counts, &count) != OK
+            || count != 2 || top[0] != &films.elements[7] || counts[0] != 2 || top[1] != &films.elements[9]) {
+        failed = true;
+    }
+
+    // Favorites popped from the user are removed from the recommender
+    user_popFavorite(&users.elements[6]);
+    if (recommender_removeFavorite(&recommender, 6, 9) != OK
+            || recommender_getPairCount(&recommender, RECOMMEND_FAVORITES, &films.elements[9], &films.elements[8]) != 0
+            || recommender_removeFavorite(&recommender, 6, 9) != ERR_NOT_FOUND) {
+        failed = true;
+    }
+
+    // Only the recommenders bound to the table
+    recommender_init(&otherRecommender, &otherUsers, &films);
+    if (userTable_attachRecommender(&users, &otherRecommender) != ERR_INVALID || users.recommender != &recommender) {
+        failed = true;
+    }
+    recommender_free(&otherRecommender);
+    userTable_attachRecommender(&users, NULL);
+    userTable_addFavorite(&users, "user5", films.elements[9]);
+    if (recommender_getUserCount(&recommender, RECOMMEND_FAVORITES, &films.elements[9]) != 0) {
+        failed = true;
+    }
+    userTable_free(&otherUsers);
+
+    if (failed) {
+        end_test(test_section, "PERF_RECOMMEND_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_RECOMMEND_3", true);
+    }
+
+    // TEST 4: Release the memory of the recommender
+    failed = false;
+    start_test(test_section, "PERF_RECOMMEND_4", "Release the memory of the recommender");
+
+    // Removing views does not allocate memory
+    mem_getStats(MEM_RECOMMEND, &stats);
+    for (i = 0; i < (int)viewLog.size; i++) {
+        recommender_removeView(&recommender, (unsigned int)(viewLog_getUser(&viewLog, i) - users.elements), 
+                               (unsigned int)(viewLog_getFilm(&viewLog, i) - films.elements));
+    }
+    mem_getStats(MEM_RECOMMEND, &after);
+    if (after.allocations != stats.allocations) {
+        failed = true;
+    }
+    for (i = 0; i < (int)films.size; i++) {
+        if (recommender_getUserCount(&recommender, RECOMMEND_VIEWS, &films.elements[i]) != 0) {
+            failed = true;
+        }
+    }
+
+    viewLog_free(&viewLog);
+    recommender_free(&recommender);
+    perf_freeCatalog(series, &films, &users);
+    mem_getStats(MEM_RECOMMEND, &stats);
+    if (stats.liveBytes != before[MEM_RECOMMEND].liveBytes || stats.liveBlocks != before[MEM_RECOMMEND].liveBlocks) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_RECOMMEND_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_RECOMMEND_4", true);
+    }
+
+    return passed;
+}
+
+// Run tests for the queue of views in front of a log
+bool run_perf_ingest(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tFilmTable films;
+    tUserTable users;
+    tViewLog views, ingested;
+    tViewIngest ingest;
+    tPerfProducer producers[PERF_TEST_PRODUCERS];
+    tThread threads[PERF_TEST_PRODUCERS];
+    unsigned int last[PERF_TEST_PRODUCERS];
+    bool* seen;
+    tPackedDateTime first;
+    tView view;
+    tUser user;
+    unsigned int i, position;
+
+    perf_initCatalog(series, &films, &users, 100, 100);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    perf_addViews(&views, &films, &users, 5000, 11);
+
+    // TEST 1: Add views through the queue
+    failed = false;
+    start_test(test_section, "PERF_INGEST_1", "Add views through the queue");
+
+    viewLog_init(&ingested);
+    viewLog_bind(&ingested, &users, &films);
+    if (viewIngest_init(&ingest, &ingested, 0) != ERR_INVALID 
+            || viewIngest_init(&ingest, &ingested, VIEWINGEST_MAX_CAPACITY + 1) != ERR_INVALID) {
+        failed = true;
+    }
+
+    // A small queue, that gets full many times
+    if (viewIngest_init(&ingest, &ingested, 5) != OK || ingest.capacity != 8) {
+        failed = true;
+    }
+    else {
+        for (i = 0; i < views.size; i++) {
+            view = views.elements[i];
+            view.user = viewLog_getUser(&views, i);
+            view.film = viewLog_getFilm(&views, i);
+            if (viewIngest_add(&ingest, &view) != OK) {
+                failed = true;
+            }
+        }
+        if (viewIngest_flush(&ingest) != OK || viewIngest_pending(&ingest) != 0 
+                || !perf_equalViews(&views, &ingested)) {
+            failed = true;
+        }
+        viewIngest_free(&ingest);
+    }
+    viewLog_free(&ingested);
+
+    if (failed) {
+        end_test(test_section, "PERF_INGEST_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_INGEST_1", true);
+    }
+
+    // TEST 2: Queue views from many threads
+    failed = false;
+    start_test(test_section, "PERF_INGEST_2", "Queue views from many threads");
+
+    viewLog_init(&ingested);
+    viewLog_bind(&ingested, &users, &films);
+    if (viewIngest_init(&ingest, &ingested, 64) != OK) {
+        failed = true;
+    }
+    else {
+        for (i = 0; i < PERF_TEST_PRODUCERS; i++) {
+            producers[i].ingest = &ingest;
+            producers[i].views = &views;
+            producers[i].first = i;
+            producers[i].errors = 0;
+            if (thread_create(&threads[i], perf_ingestThread, &producers[i]) != OK) {
+                failed = true;
+            }
+        }
+        for (i = 0; i < PERF_TEST_PRODUCERS; i++) {
+            thread_join(&threads[i]);
+            if (producers[i].errors != 0) {
+                failed = true;
+            }
+        }
+        if (viewIngest_flush(&ingest) != OK || ingested.size != views.size) {
+            failed = true;
+        }
+
+        // The views have different timestamps, that give their position in the log they come from. 
+        // Each view is added once, and the views of each thread keep their order
+        seen = (bool*)calloc(views.size, sizeof(bool));
+        first = dateTime_pack(&views.elements[0].timestamp);
+        for (i = 0; i < PERF_TEST_PRODUCERS; i++) {
+            last[i] = i;
+        }
+        for (i = 0; seen != NULL && i < ingested.size && !failed; i++) {
+            position = dateTime_pack(&ingested.elements[i].timestamp) - first;
+            if (position >= views.size || seen[position] || position < last[position % PERF_TEST_PRODUCERS]
+                    || ingested.elements[i].userId != views.elements[position].userId
+                    || ingested.elements[i].filmId != views.elements[position].filmId) {
+                failed = true;
+            }
+            else {
+                seen[position] = true;
+                last[position % PERF_TEST_PRODUCERS] = position;
+            }
+        }
+        free(seen);
+        viewIngest_free(&ingest);
+    }
+    viewLog_free(&ingested);
+
+    if (failed) {
+        end_test(test_section, "PERF_INGEST_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_INGEST_2", true);
+    }
+
+    // TEST 3: Report the views that could not be added
+    failed = false;
+    start_test(test_section, "PERF_INGEST_3", "Report the views that could not be added");
+
+    viewLog_init(&ingested);
+    viewLog_bind(&ingested, &users, &films);
+    user_init(&user, "nobody", "name", "mail@uoc.edu");
+    if (viewIngest_init(&ingest, &ingested, 16) != OK) {
+        failed = true;
+    }
+    else {
+        for (i = 0; i < 10; i++) {
+            view = views.elements[i];
+            view.user = (i == 3 || i == 7) ? &user : viewLog_getUser(&views, i);
+            view.film = viewLog_getFilm(&views, i);
+            viewIngest_add(&ingest, &view);
+        }
+        if (viewIngest_flush(&ingest) != ERR_NOT_FOUND || viewIngest_failed(&ingest) != 2 || ingested.size != 8) {
+            failed = true;
+        }
+
+        // The error is reported once
+        if (viewIngest_flush(&ingest) != OK) {
+            failed = true;
+        }
+        viewIngest_free(&ingest);
+    }
+    user_free(&user);
+    viewLog_free(&ingested);
+
+    if (failed) {
+        end_test(test_section, "PERF_INGEST_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_INGEST_3", true);
+    }
+
+    // TEST 4: Add the queued views when the queue is released
+    failed = false;
+    start_test(test_section, "PERF_INGEST_4", "Add the queued views when the queue is released");
+
+    viewLog_init(&ingested);
+    viewLog_bind(&ingested, &users, &films);
+    if (viewIngest_init(&ingest, &ingested, 1024) != OK) {
+        failed = true;
+    }
+    else {
+        for (i = 0; i < 1000; i++) {
+            view = views.elements[i];
+            view.user = viewLog_getUser(&views, i);
+            view.film = viewLog_getFilm(&views, i);
+            viewIngest_add(&ingest, &view);
+        }
+        viewIngest_free(&ingest);
+        if (ingested.size != 1000) {
+            failed = true;
+        }
+        for (i = 0; i < ingested.size && !failed; i++) {
+            if (ingested.elements[i].userId != views.elements[i].userId 
+                    || ingested.elements[i].filmId != views.elements[i].filmId) {
+                failed = true;
+            }
+        }
+    }
+    viewLog_free(&ingested);
+
+    if (failed) {
+        end_test(test_section, "PERF_INGEST_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_INGEST_4", true);
+    }
+
+    viewLog_free(&views);
+    perf_freeCatalog(series, &films, &users);
+
+    return passed;
+}
+
+// Add the views of a bound log to another log bound to the same tables
+static void perf_copyViews(tViewLog* from, tViewLog* to) {
+    unsigned int i;
+    tView view;
+
+    for (i = 0; i < from->size; i++) {
+        view = from->elements[i];
+        view.user = viewLog_getUser(from, i);
+        view.film = viewLog_getFilm(from, i);
+        viewLog_add(to, &view);
+    }
+}
+
+// Check the queries of a log with sealed views give the same results than a log without them
+static bool perf_equalSealedQueries(tViewLog* views, tViewLog* sealed, tUserTable* users, 
+                                    tPackedDateTime from, tPackedDateTime to) {
+    unsigned int i, j, count1, count2;
+    tFilm* top1[5];
+    tFilm* top2[5];
+
+    for (i = 0; i < (unsigned int)users->size; i++) {
+        if (viewLog_getFavFilm(views, &users->elements[i]) != viewLog_getFavFilm(sealed, &users->elements[i])
+                || viewLog_getFavGenre(views, &users->elements[i]) != viewLog_getFavGenre(sealed, &users->elements[i])
+                || viewLog_getFavFilmInRange(views, &users->elements[i], from, to) 
+                    != viewLog_getFavFilmInRange(sealed, &users->elements[i], from, to)
+                || viewLog_getFavGenreInRange(views, &users->elements[i], from, to) 
+                    != viewLog_getFavGenreInRange(sealed, &users->elements[i], from, to)) {
+            return false;
+        }
+        if (viewLog_getTopFilms(views, &users->elements[i], 5, top1, &count1) != OK
+                || viewLog_getTopFilms(sealed, &users->elements[i], 5, top2, &count2) != OK || count1 != count2) {
+            return false;
+        }
+        for (j = 0; j < count1; j++) {
+            if (top1[j] != top2[j]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Views decoded from the segments of a log
+typedef struct {
+    unsigned int count;
+    tViewRecord records[PERF_TEST_ELEMENTS];
+} tPerfRecords;
+
+// Keep a view decoded from a segment
+static void perf_keepRecord(const tViewRecord* record, void* context) {
+    tPerfRecords* records = (tPerfRecords*)context;
+
+    if (records->count < PERF_TEST_ELEMENTS) {
+        records->records[records->count] = *record;
+    }
+    records->count++;
+}
+
+// Run tests for the compressed segments of sealed views
+bool run_perf_segments(tTestSection* test_section) {
+    bool passed = true, failed = false;
+    tSeries series[PERF_TEST_SERIES];
+    tSeriesTable seriesTable;
+    tFilmTable films;
+    tUserTable users;
+    tViewLog views, sealed, unbound;
+    tLogReport report1, report2;
+    tPerfRecords* records;
+    tMemStats before[MEM_SUBSYSTEM_QTY + 1];
+    tMemStats stats;
+    tPackedDateTime first, limit;
+    tPostings* postings;
+    const tViewTimeEntry* entries;
+    size_t bytes;
+    tView* view;
+    tView copy;
+    unsigned int i, j, count, threads;
+
+    perf_getMemStats(before);
+    perf_initCatalog(series, &films, &users, 100, 200);
+    viewLog_init(&views);
+    viewLog_bind(&views, &users, &films);
+    perf_addViews(&views, &films, &users, 5000, 13);
+    first = dateTime_pack(&views.elements[0].timestamp);
+    records = (tPerfRecords*)malloc(sizeof(tPerfRecords));
+
+    // TEST 1: Seal the oldest views in compressed segments
+    failed = false;
+    start_test(test_section, "PERF_SEGMENT_1", "Seal the oldest views in compressed segments");
+
+    viewLog_init(&unbound);
+    if (viewLog_seal(&unbound, first + 10) != ERR_INVALID) {
+        failed = true;
+    }
+    viewLog_free(&unbound);
+
+    viewLog_init(&sealed);
+    viewLog_bind(&sealed, &users, &films);
+    perf_copyViews(&views, &sealed);
+
+    // Views have a timestamp a minute after the previous one
+    if (viewLog_seal(&sealed, first + 2000) != OK || sealed.segmentCount != 1 || sealed.sealedSize != 2000
+            || sealed.size != 3000 || viewLog_getUser(&sealed, 0) != viewLog_getUser(&views, 2000)
+            || viewLog_seal(&sealed, first + 3500) != OK || sealed.segmentCount != 2 || sealed.sealedSize != 3500
+            || viewLog_seal(&sealed, first + 100) != OK || sealed.segmentCount != 2) {
+        failed = true;
+    }
+    if (!perf_equalSealedQueries(&views, &sealed, &users, first + 1000, first + 4000)
+            || !perf_equalSealedQueries(&views, &sealed, &users, first + 2500, first + 2700)) {
+        failed = true;
+    }
+
+    // A few bytes per view instead of a tView
+    bytes = 0;
+    for (i = 0; i < sealed.segmentCount; i++) {
+        bytes += viewSegment_bytes(&sealed.segments[i]);
+    }
+    if (bytes * 4 > sealed.sealedSize * sizeof(tView)) {
+        failed = true;
+    }
+
+    // The views that are not sealed can be sealed too
+    viewLog_shrinkToFit(&sealed);
+    if (viewLog_seal(&sealed, first + 5000) != OK || sealed.size != 0 || sealed.sealedSize != 5000
+            || !perf_equalSealedQueries(&views, &sealed, &users, first, first + 5000)) {
+        failed = true;
+    }
+    viewLog_free(&sealed);
+    if (sealed.segmentCount != 0 || sealed.segments != NULL || sealed.sealedSize != 0) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_SEGMENT_1", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SEGMENT_1", true);
+    }
+
+    // TEST 2: Decode the views of a segment
+    failed = false;
+    start_test(test_section, "PERF_SEGMENT_2", "Decode the views of a segment");
+
+    viewLog_init(&sealed);
+    viewLog_bind(&sealed, &users, &films);
+    for (i = 0; i < PERF_TEST_ELEMENTS; i++) {
+        copy = views.elements[i];
+        copy.user = viewLog_getUser(&views, i);
+        copy.film = viewLog_getFilm(&views, i);
+        copy.minutes = (unsigned short)(i * 7);
+        // Some views out of order
+        if (i % 10 == 5) {
+            copy.timestamp = views.elements[i + 500].timestamp;
+        }
+        viewLog_add(&sealed, &copy);
+    }
+    limit = first + PERF_TEST_ELEMENTS + 500;
+    if (records == NULL || viewLog_seal(&sealed, limit) != OK || sealed.sealedSize != PERF_TEST_ELEMENTS) {
+        failed = true;
+    }
+    else {
+        records->count = 0;
+        viewSegment_visit(&sealed.segments[0], VIEWSEGMENT_ALL_USERS, 0, 0xFFFFFFFFu, perf_keepRecord, records);
+        if (records->count != PERF_TEST_ELEMENTS) {
+            failed = true;
+        }
+        for (i = 0; i < PERF_TEST_ELEMENTS && !failed; i++) {
+            view = &views.elements[i];
+            if (records->records[i].position != i || records->records[i].userId != view->userId
+                    || records->records[i].filmId != view->filmId || records->records[i].score != view->score
+                    || records->records[i].minutes != (unsigned short)(i * 7)
+                    || records->records[i].genre != (unsigned char)series_getGenre(film_getSeries(viewLog_getFilm(&views, i)))
+                    || records->records[i].timestamp != dateTime_pack(&views.elements[(i % 10 == 5) ? i + 500 : i].timestamp)) {
+                failed = true;
+            }
+        }
+
+        // Only the views of a user in a range of time
+        records->count = 0;
+        viewSegment_visit(&sealed.segments[0], views.elements[0].userId, first, first + 300, perf_keepRecord, records);
+        count = 0;
+        for (i = 0; i < 300; i++) {
+            if (views.elements[i].userId == views.elements[0].userId && i % 10 != 5) {
+                count++;
+            }
+        }
+        if (records->count != count || records->records[0].position != 0) {
+            failed = true;
+        }
+        for (i = 0; i < records->count && i < PERF_TEST_ELEMENTS; i++) {
+            if (records->records[i].userId != views.elements[0].userId || records->records[i].timestamp >= first + 300) {
+                failed = true;
+            }
+        }
+
+        // Nothing is decoded out of the range of the segment, or for users without views
+        records->count = 0;
+        viewSegment_visit(&sealed.segments[0], VIEWSEGMENT_ALL_USERS, limit, limit + 10, perf_keepRecord, records);
+        viewSegment_visit(&sealed.segments[0], (unsigned int)users.size, 0, 0xFFFFFFFFu, perf_keepRecord, records);
+        if (records->count != 0) {
+            failed = true;
+        }
+    }
+    viewLog_free(&sealed);
+
+    if (failed) {
+        end_test(test_section, "PERF_SEGMENT_2", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SEGMENT_2", true);
+    }
+
+    // TEST 3: Keep the indexes up to date when sealing
+    failed = false;
+    start_test(test_section, "PERF_SEGMENT_3", "Keep the indexes up to date when sealing");
+
+    viewLog_init(&sealed);
+    viewLog_bind(&sealed, &users, &films);
+    viewLog_enableColumns(&sealed);
+    viewLog_enableUserIndex(&sealed);
+    viewLog_enableTimeIndex(&sealed);
+    perf_copyViews(&views, &sealed);
+    if (viewLog_seal(&sealed, first + 1500) != OK || sealed.size != 3500) {
+        failed = true;
+    }
+    for (i = 0; i < sealed.size && !failed; i++) {
+        if (sealed.columns->userId[i] != sealed.elements[i].userId || sealed.columns->filmId[i] != sealed.elements[i].filmId
+                || sealed.elements[i].userId != views.elements[i + 1500].userId) {
+            failed = true;
+        }
+    }
+    count = 0;
+    for (i = 0; i < (unsigned int)users.size && !failed; i++) {
+        postings = viewLog_getUserViews(&sealed, &users.elements[i]);
+        for (j = 0; postings != NULL && j < postings->size; j++) {
+            if (postings->elements[j] >= sealed.size || sealed.elements[postings->elements[j]].userId != i
+                    || (j > 0 && postings->elements[j - 1] >= postings->elements[j])) {
+                failed = true;
+            }
+        }
+        count += (postings != NULL) ? postings->size : 0;
+    }
+    if (count != sealed.size) {
+        failed = true;
+    }
+    if (viewLog_findRange(&sealed, 0, 0xFFFFFFFFu, &entries, &count) != OK || count != sealed.size) {
+        failed = true;
+    }
+    for (i = 0; i < count && !failed; i++) {
+        if (entries[i].position != i || entries[i].timestamp != first + 1500 + i) {
+            failed = true;
+        }
+    }
+    if (!perf_equalSealedQueries(&views, &sealed, &users, first + 1000, first + 2000)) {
+        failed = true;
+    }
+
+    // Views added after sealing
+    viewLog_init(&unbound);
+    viewLog_bind(&unbound, &users, &films);
+    perf_addViews(&unbound, &films, &users, 500, 17);
+    perf_copyViews(&unbound, &views);
+    perf_copyViews(&unbound, &sealed);
+    if (!perf_equalSealedQueries(&views, &sealed, &users, first, first + 0x10000)) {
+        failed = true;
+    }
+    viewLog_free(&unbound);
+
+    if (failed) {
+        end_test(test_section, "PERF_SEGMENT_3", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SEGMENT_3", true);
+    }
+
+    // TEST 4: Build reports over sealed views
+    failed = false;
+    start_test(test_section, "PERF_SEGMENT_4", "Build reports over sealed views");
+
+    viewLog_seal(&sealed, first + 3000);
+    for (threads = 1; threads <= 4; threads *= 2) {
+        if (logReport_build(&report1, &views, threads) != OK) {
+            failed = true;
+            continue;
+        }
+        if (logReport_build(&report2, &sealed, threads) != OK) {
+            failed = true;
+            logReport_free(&report1);
+            continue;
+        }
+        if (memcmp(report1.genreViews, report2.genreViews, sizeof(report1.genreViews)) != 0 
+                || memcmp(report1.filmStats, report2.filmStats, films.size * sizeof(tFilmStats)) != 0
+                || memcmp(report1.favGenre, report2.favGenre, users.size * sizeof(tGenre)) != 0
+                || memcmp(report1.favFilm, report2.favFilm, users.size * sizeof(int)) != 0) {
+            failed = true;
+        }
+        logReport_free(&report1);
+        logReport_free(&report2);
+    }
+
+    // Snapshots do not store sealed views
+    seriesTable_init(&seriesTable);
+    if (snapshot_save("perf_segments.bin", &seriesTable, &films, &users, &sealed) != ERR_INVALID) {
+        failed = true;
+    }
+    seriesTable_free(&seriesTable);
+
+    if (failed) {
+        end_test(test_section, "PERF_SEGMENT_4", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SEGMENT_4", true);
+    }
+
+    viewLog_free(&sealed);
+    viewLog_free(&views);
+    perf_freeCatalog(series, &films, &users);
+    free(records);
+
+    // TEST 5: Release the memory of the segments
+    failed = false;
+    start_test(test_section, "PERF_SEGMENT_5", "Release the memory of the segments");
+
+    mem_getStats(MEM_SEGMENT, &stats);
+    if (stats.liveBytes != before[MEM_SEGMENT].liveBytes || stats.liveBlocks != before[MEM_SEGMENT].liveBlocks
+            || stats.allocations == before[MEM_SEGMENT].allocations || !perf_sameLiveMemory(before)) {
+        failed = true;
+    }
+
+    if (failed) {
+        end_test(test_section, "PERF_SEGMENT_5", false);
+        passed = false;
+    }
+    else {
+        end_test(test_section, "PERF_SEGMENT_5", true);
+    }
+
+    return passed;
+}
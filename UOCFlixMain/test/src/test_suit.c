@@ -12,5 +12,8 @@ bool run_all(tTestSuite* test_suite) {
     // Run tests for PR1
     ok = ok && run_pr1(test_suite);
     ok = ok && run_pr2(test_suite);   
+    
+    // Run tests for the performance extensions
+    ok = run_perf(test_suite) && ok;
     return ok;
 }
\ No newline at end of file